@@ -9,14 +9,16 @@ Usage:
 This will:
     1. Read from data/web_server/*.{html,css,js}
     2. Minify each file
-    3. Compress with GZIP
-    4. Generate include/webFiles.h with C++ arrays
+    3. Version references between assets (name -> name?v=<hash>)
+    4. Compress with GZIP
+    5. Generate include/webFiles.h with C++ arrays, ETag and URL hash
 """
 
 import os
 import glob
 import gzip
 import hashlib
+import re
 from pathlib import Path
 
 # Directories
@@ -29,6 +31,10 @@ CHECKSUM_FILE = DATA_DIR / "checksum.sha256"
 # File types to process
 FILE_TYPES = ["html", "css", "js"]
 
+# Hex digits of the content hash used in URLs (?v=) and in the ETag
+URL_HASH_LEN = 8
+ETAG_HASH_LEN = 16
+
 
 def hash_files(file_paths):
     """Generate SHA256 hash for multiple files."""
@@ -125,6 +131,45 @@ def minify(file_path, file_type):
     return content
 
 
+def content_hash(content):
+    """SHA256 hex digest of the final (minified, versioned) asset."""
+    return hashlib.sha256(content.encode("utf-8")).hexdigest()
+
+
+def version_references(assets):
+    """
+    Rewrite references between assets to hashed URLs.
+
+    "style.css" / 'nfc-tab.html' inside another asset becomes
+    "style.css?v=<hash>", so the server can mark versioned requests
+    immutable. Assets are resolved leaves first: a file is hashed
+    once every asset it references has its final hash.
+    """
+    names = list(assets.keys())
+    patterns = {
+        name: re.compile(r"([\"'])" + re.escape(name) + r"([\"'])") for name in names
+    }
+    hashes = {}
+
+    while len(hashes) < len(names):
+        progress = False
+        for name in names:
+            if name in hashes:
+                continue
+            deps = [d for d in names if d != name and patterns[d].search(assets[name])]
+            if any(d not in hashes for d in deps):
+                continue
+            for dep in deps:
+                url = f"{dep}?v={hashes[dep][:URL_HASH_LEN]}"
+                assets[name] = patterns[dep].sub(lambda m: m.group(1) + url + m.group(2), assets[name])
+            hashes[name] = content_hash(assets[name])
+            progress = True
+        if not progress:
+            raise RuntimeError("Circular references between web assets")
+
+    return hashes
+
+
 def process_files():
     """Main processing function."""
     
@@ -165,20 +210,25 @@ def process_files():
         header.write("// THIS FILE IS AUTOGENERATED - DO NOT MODIFY\n")
         header.write("// Regenerate with: python gen_webfiles.py\n\n")
         
+        # Minify everything first: references need the final hashes
+        assets = {}
+        for file_path in sorted(files_to_process):
+            file_path = Path(file_path)
+            assets[file_path.name] = minify(file_path, file_path.suffix[1:].lower())
+        
+        hashes = version_references(assets)
+        
         # Process each file
         total_original = 0
         total_compressed = 0
         
         for file_path in sorted(files_to_process):
             file_path = Path(file_path)
-            file_type = file_path.suffix[1:].lower()
-            
-            # Read and minify
-            minified = minify(file_path, file_type)
-            minified_bytes = minified.encode("utf-8")
+            minified_bytes = assets[file_path.name].encode("utf-8")
+            digest = hashes[file_path.name]
             
-            # Compress with GZIP
-            compressed = gzip.compress(minified_bytes)
+            # Compress with GZIP (fixed mtime: same input, same bytes)
+            compressed = gzip.compress(minified_bytes, mtime=0)
             
             # Get variable name
             var_name = file_path.stem.replace("-", "_") + "_web"
@@ -204,7 +254,9 @@ def process_files():
                 header.write(f"    {hex_values},\n")
             
             header.write(f"}};\n")
-            header.write(f"const uint32_t {var_name}_size = {compressed_size};\n\n")
+            header.write(f"const uint32_t {var_name}_size = {compressed_size};\n")
+            header.write(f"const char {var_name}_etag[] = \"\\\"{digest[:ETAG_HASH_LEN]}\\\"\";\n")
+            header.write(f"const char {var_name}_hash[] = \"{digest[:URL_HASH_LEN]}\";\n\n")
         
         # Write closing
         header.write("#endif // WEB_FILES_H\n")
@@ -21,6 +21,7 @@
  */
 
 #include "pn532_srix.h"
+#include <stage_metrics.h>
 
 // Static ACK pattern
 static const uint8_t pn532ack[] = {0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00};
@@ -28,17 +29,19 @@ static const uint8_t pn532response_firmwarevers[] = {0x00, 0x00, 0xFF, 0x06, 0xF
 
 // ========== CONSTRUCTORS ==========
 
-Arduino_PN532_SRIX::Arduino_PN532_SRIX(uint8_t irq, uint8_t reset) : _irq(irq), _reset(reset) {
+Arduino_PN532_SRIX::Arduino_PN532_SRIX(uint8_t irq, uint8_t reset, TwoWire *wire)
+    : _irq(irq), _reset(reset), _wire(wire), _fast(false), _wait_hook(nullptr), _wait_context(nullptr) {
     if (_irq != 255) pinMode(_irq, INPUT);
     if (_reset != 255) pinMode(_reset, OUTPUT);
 }
 
-Arduino_PN532_SRIX::Arduino_PN532_SRIX() : _irq(255), _reset(255) {}
+Arduino_PN532_SRIX::Arduino_PN532_SRIX()
+    : _irq(255), _reset(255), _wire(&Wire), _fast(false), _wait_hook(nullptr), _wait_context(nullptr) {}
 
 // ========== INITIALIZATION ==========
 
 bool Arduino_PN532_SRIX::init() {
-    // Note: Wire.begin() must be called BEFORE creating this object
+    // Note: the bus (wire->begin()) must be started BEFORE calling init()
     // Configure reset pin if available
     if (_reset != 255) {
         pinMode(_reset, OUTPUT);  // <-- AGGIUNGI QUESTA RIGA
@@ -66,26 +69,49 @@ bool Arduino_PN532_SRIX::SAMConfig() {
 
     if (!sendCommandCheckAck(_packetbuffer, 4)) { return false; }
 
-    readData(_packetbuffer, 8);
+    if (!readResponse(_packetbuffer, 8)) { return false; }
     return (_packetbuffer[6] == 0x15);
 }
 
 // ========== LOW-LEVEL I2C FUNCTIONS ==========
 
 void Arduino_PN532_SRIX::readData(uint8_t *buffer, uint8_t n) {
+    if (_fast) {
+        // Caller already waited for ready: one transaction, bulk copy
+        _wire->requestFrom((uint8_t)PN532_I2C_ADDRESS, (uint8_t)(n + 1));
+
+        // Discard RDY byte
+        _wire->read();
+
+        size_t got = _wire->readBytes(buffer, n);
+        if (got < n) memset(buffer + got, 0, n - got);
+        return;
+    }
+
     delay(2);
-    Wire.requestFrom((uint8_t)PN532_I2C_ADDRESS, (uint8_t)(n + 2));
+    _wire->requestFrom((uint8_t)PN532_I2C_ADDRESS, (uint8_t)(n + 2));
 
     // Discard RDY byte
-    Wire.read();
+    _wire->read();
 
     // Read data
     for (uint8_t i = 0; i < n; i++) {
         delay(1);
-        buffer[i] = Wire.read();
+        buffer[i] = _wire->read();
     }
 }
 
+bool Arduino_PN532_SRIX::readResponse(uint8_t *buffer, uint8_t n) {
+    // Legacy mode relies on the fixed delays inside readData()
+    if (_fast && !waitReady(PN532_SRIX_RESPONSE_TIMEOUT_MS)) {
+        SRIX_LIB_LOG("[PN532] Response timeout");
+        return false;
+    }
+
+    readData(buffer, n);
+    return true;
+}
+
 bool Arduino_PN532_SRIX::readACK() {
     uint8_t ackBuffer[6];
     readData(ackBuffer, 6);
@@ -113,11 +139,11 @@ bool Arduino_PN532_SRIX::isReady() {
     // --- POLLING MODE (No IRQ pin) ---
     if (_irq == 255) {
         // Request 1 byte from PN532 (Status Byte)
-        delayMicroseconds(500);
-        Wire.requestFrom((uint8_t)PN532_I2C_ADDRESS, (uint8_t)1);
+        if (!_fast) delayMicroseconds(500);
+        _wire->requestFrom((uint8_t)PN532_I2C_ADDRESS, (uint8_t)1);
 
         // If no response or bus locked, assume not ready
-        if (!Wire.available()) {
+        if (!_wire->available()) {
 #ifdef SRIX_LIB_DEBUG
             Serial.println("[PN532] isReady: No response from I2C (bus busy or chip offline)");
 #endif
@@ -125,7 +151,7 @@ bool Arduino_PN532_SRIX::isReady() {
         }
 
         // Read status byte
-        uint8_t status = Wire.read();
+        uint8_t status = _wire->read();
 
 #ifdef SRIX_LIB_DEBUG
         Serial.print("[PN532] Status byte: 0x");
@@ -156,6 +182,23 @@ bool Arduino_PN532_SRIX::isReady() {
 }
 
 bool Arduino_PN532_SRIX::waitReady(uint16_t timeout) {
+    METRIC_SCOPE(METRIC_PN532_WAIT_READY);
+
+    if (_fast && _wait_hook && _irq != 255) {
+        return _wait_hook(timeout, _wait_context);
+    }
+
+    if (_fast) {
+        // Fine-grained poll: IRQ pin read costs ~1us, status byte ~100us @100kHz
+        uint32_t start = millis();
+
+        while (!isReady()) {
+            if (timeout != 0 && (millis() - start) > timeout) return false;
+            delayMicroseconds(PN532_SRIX_FAST_POLL_US);
+        }
+        return true;
+    }
+
     uint16_t timer = 0;
 
     while (!isReady()) {
@@ -170,36 +213,45 @@ bool Arduino_PN532_SRIX::waitReady(uint16_t timeout) {
 }
 
 void Arduino_PN532_SRIX::writeCommand(uint8_t *command, uint8_t commandLength) {
+    uint8_t frame[PN532_SRIX_MAX_FRAME];
+    uint8_t len = 0;
     uint8_t checksum;
     commandLength++;
 
-    delay(2); // Wakeup delay
-
-    Wire.beginTransmission(PN532_I2C_ADDRESS);
+    if (!_fast) delay(2); // Wakeup delay
 
+    // Build the whole frame, then hand it to the bus in one write
     checksum = PN532_PREAMBLE + PN532_STARTCODE1 + PN532_STARTCODE2;
-    Wire.write(PN532_PREAMBLE);
-    Wire.write(PN532_STARTCODE1);
-    Wire.write(PN532_STARTCODE2);
+    frame[len++] = PN532_PREAMBLE;
+    frame[len++] = PN532_STARTCODE1;
+    frame[len++] = PN532_STARTCODE2;
 
-    Wire.write(commandLength);
-    Wire.write(~commandLength + 1);
+    frame[len++] = commandLength;
+    frame[len++] = ~commandLength + 1;
 
-    Wire.write(PN532_HOSTTOPN532);
+    frame[len++] = PN532_HOSTTOPN532;
     checksum += PN532_HOSTTOPN532;
 
     for (uint8_t i = 0; i < commandLength - 1; i++) {
-        Wire.write(command[i]);
+        frame[len++] = command[i];
         checksum += command[i];
     }
 
-    Wire.write((uint8_t)~checksum);
-    Wire.write(PN532_POSTAMBLE);
+    frame[len++] = ~checksum;
+    frame[len++] = PN532_POSTAMBLE;
 
-    Wire.endTransmission();
+    writeFrame(frame, len);
+}
+
+void Arduino_PN532_SRIX::writeFrame(const uint8_t *frame, uint8_t len) {
+    _wire->beginTransmission(PN532_I2C_ADDRESS);
+    _wire->write(frame, len);
+    _wire->endTransmission();
 }
 
 bool Arduino_PN532_SRIX::sendCommandCheckAck(uint8_t *command, uint8_t commandLenght, uint16_t timeout) {
+    METRIC_SCOPE(METRIC_PN532_COMMAND);
+
     // default timeout of one second
     // write the command
     writeCommand(command, commandLenght);
@@ -229,7 +281,7 @@ uint32_t Arduino_PN532_SRIX::getFirmwareVersion() {
 
     if (!sendCommandCheckAck(_packetbuffer, 1)) { return 0; }
 
-    readData(_packetbuffer, 12);
+    if (!readResponse(_packetbuffer, 12)) { return 0; }
 
     if (memcmp(_packetbuffer, pn532response_firmwarevers, 6) != 0) { return 0; }
 
@@ -254,6 +306,31 @@ bool Arduino_PN532_SRIX::setPassiveActivationRetries(uint8_t maxRetries) {
     return sendCommandCheckAck(_packetbuffer, 5);
 }
 
+int16_t Arduino_PN532_SRIX::exchange(uint8_t *command, uint8_t commandLength,
+                                     uint8_t *response, uint8_t maxResponse, uint16_t timeout) {
+    // Frame: 00 00 FF LEN LCS D5 <cmd+1> payload... DCS 00
+    uint8_t frameLength = 7 + maxResponse + 2;
+    if (frameLength > sizeof(_packetbuffer)) return -1;
+
+    if (!sendCommandCheckAck(command, commandLength, timeout)) return -1;
+
+    // Always wait here: the response can take the full RF timeout
+    if (!waitReady(timeout)) return -1;
+
+    readData(_packetbuffer, frameLength);
+
+    if (_packetbuffer[0] != 0x00 || _packetbuffer[1] != 0x00 || _packetbuffer[2] != 0xFF) return -1;
+    if ((uint8_t)(_packetbuffer[3] + _packetbuffer[4]) != 0x00) return -1;
+    if (_packetbuffer[5] != PN532_PN532TOHOST || _packetbuffer[6] != (uint8_t)(command[0] + 1)) return -1;
+
+    if (_packetbuffer[3] < 2) return -1;
+    uint8_t payload = _packetbuffer[3] - 2; // LEN counts TFI + response code
+    if (payload > maxResponse) payload = maxResponse;
+    memcpy(response, &_packetbuffer[7], payload);
+
+    return payload;
+}
+
 // ========== SRIX FUNCTIONS ==========
 
 bool Arduino_PN532_SRIX::SRIX_init() {
@@ -275,7 +352,7 @@ bool Arduino_PN532_SRIX::SRIX_initiate_select() {
 
     if (!sendCommandCheckAck(_packetbuffer, 3)) return false;
 
-    readData(_packetbuffer, 10);
+    if (!readResponse(_packetbuffer, 10)) return false;
 
     if (_packetbuffer[7] != 0x00) return false;
 
@@ -288,7 +365,7 @@ bool Arduino_PN532_SRIX::SRIX_initiate_select() {
 
     if (!sendCommandCheckAck(_packetbuffer, 3)) return false;
 
-    readData(_packetbuffer, 10);
+    if (!readResponse(_packetbuffer, 10)) return false;
 
     return (_packetbuffer[7] == 0x00);
 }
@@ -300,7 +377,7 @@ bool Arduino_PN532_SRIX::SRIX_read_block(uint8_t address, uint8_t *block) {
 
     if (!sendCommandCheckAck(_packetbuffer, 3)) return false;
 
-    readData(_packetbuffer, 13);
+    if (!readResponse(_packetbuffer, 13)) return false;
 
     if (_packetbuffer[7] != 0x00) return false;
 
@@ -312,6 +389,50 @@ bool Arduino_PN532_SRIX::SRIX_read_block(uint8_t address, uint8_t *block) {
     return true;
 }
 
+uint8_t Arduino_PN532_SRIX::SRIX_read_blocks(uint8_t start, uint8_t count, uint8_t *out) {
+    uint8_t done = 0;
+
+    // Legacy timing relies on per-call delays: keep the proven path
+    if (!_fast) {
+        while (done < count && SRIX_read_block(start + done, out + done * 4)) done++;
+        return done;
+    }
+
+    // Frame: PREAMBLE 00 FF LEN LCS D4 42 08 ADDR DCS POSTAMBLE
+    // Only ADDR and DCS change between blocks
+    const uint8_t len = 4; // TFI + CMD + READBLOCK + ADDR
+    uint8_t frame[11] = {
+        PN532_PREAMBLE, PN532_STARTCODE1, PN532_STARTCODE2,
+        len, (uint8_t)(~len + 1),
+        PN532_HOSTTOPN532, PN532_COMMAND_INCOMMUNICATETHRU, SRIX4K_READBLOCK,
+        0x00, 0x00, PN532_POSTAMBLE
+    };
+    const uint8_t dcs_base = PN532_HOSTTOPN532 + PN532_COMMAND_INCOMMUNICATETHRU + SRIX4K_READBLOCK;
+
+    while (done < count) {
+        uint8_t address = start + done;
+        frame[8] = address;
+        frame[9] = (uint8_t)(~(dcs_base + address) + 1);
+
+        writeFrame(frame, sizeof(frame));
+
+        // ACK, then response; next frame goes out as soon as this one is drained
+        if (!waitReady(PN532_SRIX_RESPONSE_TIMEOUT_MS) || !readACK()) break;
+        if (!readResponse(_packetbuffer, 13)) break;
+
+        // Reject stale/foreign frames: D5 43 <status>
+        if (_packetbuffer[5] != PN532_PN532TOHOST ||
+            _packetbuffer[6] != (PN532_COMMAND_INCOMMUNICATETHRU + 1) ||
+            _packetbuffer[7] != 0x00) break;
+
+        memcpy(out + done * 4, &_packetbuffer[8], 4);
+        done++;
+    }
+
+    SRIX_LIB_LOG("[SRIX_LIB] Batch read %d/%d blocks from %d", done, count, start);
+    return done;
+}
+
 bool Arduino_PN532_SRIX::SRIX_write_block(uint8_t address, uint8_t *block) {
     _packetbuffer[0] = PN532_COMMAND_INCOMMUNICATETHRU;
     _packetbuffer[1] = SRIX4K_WRITEBLOCK;
@@ -334,7 +455,7 @@ bool Arduino_PN532_SRIX::SRIX_get_uid(uint8_t *buffer) {
 
     if (!sendCommandCheckAck(_packetbuffer, 2)) return false;
 
-    readData(_packetbuffer, 16);
+    if (!readResponse(_packetbuffer, 16)) return false;
 
     if (_packetbuffer[7] != 0x00) return false;
 
@@ -46,32 +46,69 @@
 #define SRIX4K_WRITEBLOCK (0x09)
 #define SRIX4K_GETUID (0x0B)
 
+// Fast transport tuning
+#define PN532_SRIX_FAST_POLL_US (100)           // Ready poll interval in fast mode (us)
+#define PN532_SRIX_RESPONSE_TIMEOUT_MS (100)    // Max wait for a response frame in fast mode
+#define PN532_SRIX_MAX_FRAME (64 + 8)              // Command (packet buffer) + framing bytes
+
+// Optional blocking wait for the IRQ line (e.g. GPIO interrupt + task
+// notification). Returns true once the PN532 signals ready. context is
+// the pointer given to setWaitHook() (one waiter per PN532).
+typedef bool (*PN532_SRIX_WaitHook)(uint32_t timeout_ms, void *context);
+
 class Arduino_PN532_SRIX {
 public:
-    Arduino_PN532_SRIX(uint8_t irq, uint8_t reset);
+    // wire: bus the PN532 sits on (Wire1 for a second reader)
+    Arduino_PN532_SRIX(uint8_t irq, uint8_t reset, TwoWire *wire = &Wire);
     Arduino_PN532_SRIX();
 
     bool init();
     uint32_t getFirmwareVersion();
     bool setPassiveActivationRetries(uint8_t maxRetries);
 
+    // Fast transport: bulk I2C reads, no fixed delays, ready detection
+    // via IRQ pin (or status byte) before every frame. Default: off.
+    void setFastMode(bool enabled) { _fast = enabled; }
+    bool isFastMode() const { return _fast; }
+
+    // Fast mode + IRQ pin: sleep in the hook instead of polling the pin
+    void setWaitHook(PN532_SRIX_WaitHook hook, void *context = nullptr) {
+        _wait_hook = hook;
+        _wait_context = context;
+    }
+
+    // Generic command: send, check ACK, wait and copy the response
+    // payload (bytes after D5 <cmd+1>). Returns payload length or -1.
+    int16_t exchange(uint8_t *command, uint8_t commandLength,
+                     uint8_t *response, uint8_t maxResponse, uint16_t timeout = 100);
+
     bool SRIX_init();
     bool SRIX_initiate_select();
     bool SRIX_read_block(uint8_t address, uint8_t *block);
+    // Back-to-back block reads with a prebuilt frame (fast mode only,
+    // falls back to SRIX_read_block otherwise). Stops at the first
+    // failure; returns number of blocks stored in out (4 bytes each).
+    uint8_t SRIX_read_blocks(uint8_t start, uint8_t count, uint8_t *out);
     bool SRIX_write_block(uint8_t address, uint8_t *block);
     bool SRIX_get_uid(uint8_t *buffer);
 
 private:
     uint8_t _irq, _reset;
+    TwoWire *_wire;
     uint8_t _packetbuffer[64];
+    bool _fast;
+    PN532_SRIX_WaitHook _wait_hook;
+    void *_wait_context;
 
     // Low-level I2C functions (reimplemented from original)
     bool SAMConfig();
     void readData(uint8_t *buffer, uint8_t n);
+    bool readResponse(uint8_t *buffer, uint8_t n);
     bool readACK();
     bool isReady();
     bool waitReady(uint16_t timeout);
     void writeCommand(uint8_t *command, uint8_t commandLength);
+    void writeFrame(const uint8_t *frame, uint8_t len);
     bool sendCommandCheckAck(uint8_t *command, uint8_t commandLength, uint16_t timeout = 100);
 };
 
@@ -0,0 +1,150 @@
+#include "stage_metrics.h"
+
+// ============================================
+// STAGE NAMES
+// ============================================
+
+static const char* const STAGE_NAMES[METRIC_STAGE_COUNT] = {
+    "pn532_command",
+    "pn532_wait_ready",
+    "mifare_auth",
+    "mifare_reactivate",
+    "fs_save",
+    "fs_load",
+    "json_serialize",
+};
+
+const char* StageMetrics::stageName(MetricStage stage) {
+    return stage < METRIC_STAGE_COUNT ? STAGE_NAMES[stage] : "unknown";
+}
+
+// ============================================
+// BUCKETS
+// ============================================
+//
+// Values 0-3 get a bucket each. Above that every power of two is split
+// into SUB_BUCKETS equal ranges: 4,5,6,7 | 8-9,10-11,12-13,14-15 | ...
+
+uint8_t StageMetrics::bucketOf(uint32_t us) {
+    if (us < SUB_BUCKETS) {
+        return us;
+    }
+
+    uint8_t msb = 31 - __builtin_clz(us);
+    uint32_t index = (msb - SUB_BITS + 1) * SUB_BUCKETS + ((us >> (msb - SUB_BITS)) & (SUB_BUCKETS - 1));
+    return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+}
+
+uint32_t StageMetrics::bucketUpper(uint8_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+
+    uint8_t shift = bucket / SUB_BUCKETS - 1;
+    uint32_t lower = (uint32_t)(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lower + (1UL << shift) - 1;
+}
+
+#if METRICS_ENABLED
+
+// ============================================
+// STORAGE
+// ============================================
+
+StageMetrics::Stage StageMetrics::_stages[METRIC_STAGE_COUNT];
+portMUX_TYPE StageMetrics::_mux = portMUX_INITIALIZER_UNLOCKED;
+uint32_t StageMetrics::_cpu_mhz = 240;
+
+// ============================================
+// RECORDING
+// ============================================
+
+void StageMetrics::begin() {
+    uint32_t mhz = ESP.getCpuFreqMHz();
+    if (mhz > 0) {
+        _cpu_mhz = mhz;
+    }
+    reset();
+}
+
+void StageMetrics::record(MetricStage stage, uint32_t cycles) {
+    if (stage >= METRIC_STAGE_COUNT) return;
+
+    uint32_t us = cycles / _cpu_mhz;
+    uint8_t bucket = bucketOf(us);
+
+    portENTER_CRITICAL(&_mux);
+    Stage& s = _stages[stage];
+    if (s.count == 0 || us < s.min_us) s.min_us = us;
+    if (us > s.max_us) s.max_us = us;
+    s.count++;
+    s.sum_us += us;
+    s.buckets[bucket]++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void StageMetrics::reset() {
+    portENTER_CRITICAL(&_mux);
+    memset(_stages, 0, sizeof(_stages));
+    portEXIT_CRITICAL(&_mux);
+}
+
+// ============================================
+// SUMMARY
+// ============================================
+
+bool StageMetrics::summarize(MetricStage stage, Summary& out) {
+    memset(&out, 0, sizeof(out));
+    if (stage >= METRIC_STAGE_COUNT) return false;
+
+    // Copy under the lock, compute outside it
+    Stage s;
+    portENTER_CRITICAL(&_mux);
+    s = _stages[stage];
+    portEXIT_CRITICAL(&_mux);
+
+    if (s.count == 0) return false;
+
+    out.count = s.count;
+    out.min_us = s.min_us;
+    out.max_us = s.max_us;
+    out.mean_us = (uint32_t)(s.sum_us / s.count);
+
+    // Rank of the sample at p50 / p95 (1-based, rounded up)
+    uint32_t rank50 = (s.count + 1) / 2;
+    uint32_t rank95 = (uint32_t)(((uint64_t)s.count * 95 + 99) / 100);
+    uint32_t seen = 0;
+    bool have50 = false;
+
+    for (uint8_t b = 0; b < BUCKET_COUNT; b++) {
+        if (s.buckets[b] == 0) continue;
+        seen += s.buckets[b];
+
+        if (!have50 && seen >= rank50) {
+            out.p50_us = bucketUpper(b);
+            have50 = true;
+        }
+        if (seen >= rank95) {
+            out.p95_us = bucketUpper(b);
+            break;
+        }
+    }
+
+    // Bucket bounds are approximate, the extremes are exact
+    out.p50_us = constrain(out.p50_us, out.min_us, out.max_us);
+    out.p95_us = constrain(out.p95_us, out.min_us, out.max_us);
+    return true;
+}
+
+#else
+
+void StageMetrics::begin() {}
+void StageMetrics::record(MetricStage stage, uint32_t cycles) {}
+void StageMetrics::reset() {}
+
+bool StageMetrics::summarize(MetricStage stage, Summary& out) {
+    memset(&out, 0, sizeof(out));
+    return false;
+}
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ * StageMetrics - per-stage timing histograms for hot paths
+ *
+ * Lives in lib/ so both the PN532 SRIX driver and the application can
+ * record into the same table. Set METRICS_ENABLED in platformio.ini
+ * build_flags (not config.h): the library and src must agree.
+ */
+
+#ifndef STAGE_METRICS_H
+#define STAGE_METRICS_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+/**
+ * @brief Enable stage timing (0 = METRIC_SCOPE compiles to nothing)
+ */
+#ifndef METRICS_ENABLED
+    #define METRICS_ENABLED 1
+#endif
+
+/**
+ * @brief Instrumented stages (keep STAGE_NAMES in sync)
+ */
+enum MetricStage : uint8_t {
+    METRIC_PN532_COMMAND = 0,   ///< Arduino_PN532_SRIX::sendCommandCheckAck (write, ready, ACK)
+    METRIC_PN532_WAIT_READY,    ///< Arduino_PN532_SRIX::waitReady
+    METRIC_MIFARE_AUTH,         ///< MifareTool::authenticateBlock
+    METRIC_MIFARE_REACTIVATE,   ///< MifareTool::reactivateCard
+    METRIC_FS_SAVE,             ///< Dump save to LittleFS
+    METRIC_FS_LOAD,             ///< Dump load from LittleFS
+    METRIC_JSON_SERIALIZE,      ///< JSON reply / job result serialization
+    METRIC_STAGE_COUNT
+};
+
+/**
+ * @brief StageMetrics - Lock-light timing histograms
+ *
+ * Features:
+ * - CPU cycle counter timing (a few cycles per scope), stored in microseconds
+ * - Log-linear histogram (4 buckets per power of two, ~19% resolution)
+ *   for p50/p95 without keeping samples
+ * - count, min, max, mean exact
+ * - Safe from any task on either core (short spinlock per sample)
+ *
+ * Note: the cycle counter is per core. Scopes in tasks that migrate
+ * between cores mid-scope can record skewed samples; the NFC and
+ * serial tasks are pinned.
+ *
+ * Usage:
+ * @code
+ * bool Driver::command() {
+ *     METRIC_SCOPE(METRIC_PN532_COMMAND);
+ *     ...
+ * }
+ *
+ * StageMetrics::Summary s;
+ * StageMetrics::summarize(METRIC_PN532_COMMAND, s);
+ * @endcode
+ */
+class StageMetrics {
+public:
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr uint8_t SUB_BITS = 2;                     // 4 buckets per octave
+    static constexpr uint8_t SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr uint8_t BUCKET_COUNT = 96;                // Up to ~33 s per sample
+
+    /**
+     * @brief Percentile summary of one stage (microseconds)
+     */
+    struct Summary {
+        uint32_t count;
+        uint32_t min_us;
+        uint32_t p50_us;
+        uint32_t p95_us;
+        uint32_t max_us;
+        uint32_t mean_us;
+    };
+
+    /**
+     * @brief Cache the CPU frequency for cycle conversion (call once in setup())
+     */
+    static void begin();
+
+    /**
+     * @brief Add one sample
+     * @param stage Stage
+     * @param cycles Elapsed CPU cycles
+     */
+    static void record(MetricStage stage, uint32_t cycles);
+
+    /**
+     * @brief Compute count/min/p50/p95/max/mean for a stage
+     * @return false if the stage has no samples (or metrics are disabled)
+     */
+    static bool summarize(MetricStage stage, Summary& out);
+
+    /**
+     * @brief Clear every histogram
+     */
+    static void reset();
+
+    /**
+     * @brief Stage name for APIs ("pn532_command", ...)
+     */
+    static const char* stageName(MetricStage stage);
+
+    static constexpr bool enabled() { return METRICS_ENABLED; }
+
+    static inline uint32_t cycles() { return ESP.getCycleCount(); }
+
+    /**
+     * @brief Histogram bucket of a value (log-linear)
+     */
+    static uint8_t bucketOf(uint32_t us);
+
+    /**
+     * @brief Highest value that falls into a bucket
+     */
+    static uint32_t bucketUpper(uint8_t bucket);
+
+private:
+    struct Stage {
+        uint32_t count;
+        uint32_t min_us;
+        uint32_t max_us;
+        uint64_t sum_us;
+        uint32_t buckets[BUCKET_COUNT];
+    };
+
+#if METRICS_ENABLED
+    static Stage _stages[METRIC_STAGE_COUNT];
+    static portMUX_TYPE _mux;
+    static uint32_t _cpu_mhz;
+#endif
+};
+
+/**
+ * @brief RAII timer: records the scope's duration on exit
+ */
+class MetricScope {
+public:
+    explicit MetricScope(MetricStage stage) : _stage(stage), _start(StageMetrics::cycles()) {}
+    ~MetricScope() { StageMetrics::record(_stage, StageMetrics::cycles() - _start); }
+
+    MetricScope(const MetricScope&) = delete;
+    MetricScope& operator=(const MetricScope&) = delete;
+
+private:
+    MetricStage _stage;
+    uint32_t _start;
+};
+
+#define METRIC_CONCAT_INNER(a, b) a##b
+#define METRIC_CONCAT(a, b) METRIC_CONCAT_INNER(a, b)
+
+#if METRICS_ENABLED
+    #define METRIC_SCOPE(stage) MetricScope METRIC_CONCAT(_metric_scope_, __LINE__)(stage)
+#else
+    #define METRIC_SCOPE(stage) ((void)0)
+#endif
+
+#endif // STAGE_METRICS_H
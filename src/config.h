@@ -39,14 +39,40 @@
  */
 #define I2C_SDA_PIN         21      ///< I2C Data pin
 #define I2C_SCL_PIN         22      ///< I2C Clock pin
+#ifndef I2C_FAST_PROFILE
+#define I2C_FAST_PROFILE    false   ///< Opt-in 400kHz bus (short wires + 4.7k pull-ups required)
+#endif
+
+#if I2C_FAST_PROFILE
+#define I2C_FREQUENCY       400000  ///< I2C bus speed (Hz) - fast profile
+#else
 #define I2C_FREQUENCY       100000  ///< I2C bus speed (Hz) - 100kHz for PN532 stability
+#endif
 
 /**
  * @brief PN532 NFC Module Pins
  */
-#define PN532_IRQ_PIN       18      ///< PN532 interrupt pin (optional, not currently used)
+#define PN532_IRQ_PIN       18      ///< PN532 interrupt pin (SRIX ready detection)
 #define PN532_RESET_PIN     19      ///< PN532 hardware reset pin
 
+/**
+ * @brief Additional PN532 Readers
+ * Every PN532 answers on I2C address 0x24, so each reader needs its own
+ * bus: the two ESP32 I2C controllers bound the count to 2. Reader 0 uses
+ * the pins above on Wire, reader 1 the pins below on Wire1. Each reader
+ * gets its own NFC worker task, pinned to the core given here.
+ */
+#ifndef NFC_READER_COUNT
+#define NFC_READER_COUNT    1       ///< PN532 modules fitted (1-2)
+#endif
+#define NFC_MAX_READERS     2       ///< One PN532 per I2C controller
+#define NFC_READER0_CORE    1       ///< Reader 0 worker core (opposite of WiFi/web)
+#define NFC_READER1_SDA_PIN 32      ///< Reader 1 I2C Data pin (Wire1)
+#define NFC_READER1_SCL_PIN 33      ///< Reader 1 I2C Clock pin (Wire1)
+#define NFC_READER1_IRQ_PIN 34      ///< Reader 1 PN532 interrupt pin (input-only GPIO)
+#define NFC_READER1_RESET_PIN 25    ///< Reader 1 PN532 hardware reset pin
+#define NFC_READER1_CORE    0       ///< Reader 1 worker core (both cores busy in parallel jobs)
+
 /**
  * @brief LED Status Indicator
  */
@@ -70,6 +96,11 @@
 #define WIFI_RECONNECT_ATTEMPTS     3           ///< Number of reconnection attempts
 #define WIFI_RECONNECT_DELAY_MS     1000        ///< Delay between reconnect attempts
 
+#ifndef WIFI_BOOT_SERIAL_PROMPT
+    #define WIFI_BOOT_SERIAL_PROMPT false       ///< Ask for a network over Serial at boot when no saved one connects
+                                                ///< (pauses serial commands up to WIFI_CONNECT_TIMEOUT_MS; "wifi scan" does it on demand)
+#endif
+
 /**
  * @brief Access Point (AP) Mode Settings
  * Used when WiFi connection fails or on first boot
@@ -99,6 +130,21 @@
 #define SRIX_MAX_RETRY_ATTEMPTS     5           ///< Max retry attempts for SRIX operations
 #define SRIX_EEPROM_WRITE_DELAY_MS  15          ///< Delay after EEPROM write (chip spec)
 
+#ifndef SRIX_FAST_TRANSPORT
+#define SRIX_FAST_TRANSPORT         true        ///< Bulk I2C reads + IRQ ready polling (false = legacy fixed delays)
+#endif
+
+#ifndef SRIX_BATCH_READ
+#define SRIX_BATCH_READ             true        ///< Full reads via SRIX_read_blocks() (false = per-block loop)
+#endif
+
+#ifndef SRIX_ADAPTIVE_WRITE
+#define SRIX_ADAPTIVE_WRITE         true        ///< Skip unchanged blocks, poll write completion by read-back (false = fixed delay)
+#endif
+#ifndef SRIX_EEPROM_WRITE_TIMEOUT_MS
+#define SRIX_EEPROM_WRITE_TIMEOUT_MS 30         ///< Max wait for a block read-back after write (adaptive mode)
+#endif
+
 /**
  * @brief Mifare Classic Settings
  */
@@ -113,6 +159,15 @@
 #define NFC_WRITE_TIMEOUT_MS        10000       ///< Full tag write timeout
 #define NFC_POLL_INTERVAL_MS        200         ///< Polling interval for tag detection
 
+/**
+ * @brief Tag Detection Mode
+ * IRQ mode: GPIO interrupt on PN532_IRQ_PIN wakes the NFC task when the
+ * PN532 answers, instead of sleeping fixed intervals between polls
+ */
+#ifndef NFC_IRQ_DETECTION
+#define NFC_IRQ_DETECTION           true        ///< false = timed polling
+#endif
+
 
 // ========================================
 // WEB SERVER CONFIGURATION
@@ -160,6 +215,7 @@
 #define NFC_SRIX_DUMP_FOLDER        "/DUMPS/SRIX/"       ///< SRIX4K dumps
 #define NFC_MIFARE_DUMP_FOLDER      "/DUMPS/MIFARE/"     ///< Mifare Classic dumps
 #define NFC_KEYS_FILE               "/mifare_keys.json" ///< Mifare keys database
+#define NFC_CATALOG_FILE            "/nfc_catalog.bin"  ///< Dump catalog index (path, UID, size, CRC)
 #define NFC_MAX_DUMP_FILES          100                 ///< Maximum dump files before cleanup
 
 
@@ -177,7 +233,7 @@
 /**
  * @brief Boot & Timing
  */
-#define BOOT_DELAY_MS       100                 ///< Delay after each boot stage
+#define BOOT_DELAY_MS       100                 ///< Serial settle delay after Serial.begin()
 #define WATCHDOG_TIMEOUT_S  60                  ///< Watchdog timeout (0 = disabled)
 
 /**
@@ -192,6 +248,9 @@
 #define SERIAL_TASK_STACK_SIZE      4096        ///< Serial command task stack (bytes)
 #define SERIAL_TASK_PRIORITY        1           ///< Serial task priority (0-24)
 #define SERIAL_TASK_CORE            1           ///< Serial task CPU core (0 or 1)
+#define BOOT_NET_TASK_STACK_SIZE    8192        ///< Boot network task stack (WiFi scan/connect, deleted after boot)
+#define BOOT_NET_TASK_PRIORITY      1           ///< Boot network task priority (0-24)
+#define BOOT_NET_TASK_CORE          0           ///< Boot network task CPU core (WiFi core)
 
 
 // ========================================
@@ -237,6 +296,10 @@
     #warning "I2C_FREQUENCY outside recommended range (100-400 kHz)"
 #endif
 
+#if NFC_READER_COUNT < 1 || NFC_READER_COUNT > NFC_MAX_READERS
+    #error "NFC_READER_COUNT must be 1 or 2 (one PN532 per I2C controller)"
+#endif
+
 #if DEBUG_SKIP_AUTH == true && !defined(DEBUG)
     #warning "⚠️   DEBUG_SKIP_AUTH enabled in production build!   ⚠️"
 #endif
@@ -0,0 +1,362 @@
+#include "logger.h"
+#include <atomic>
+#include <LittleFS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// ========================================
+// RING BUFFER
+// ========================================
+//
+// Multi-producer / single-consumer byte ring. Positions are free-running
+// 32-bit counters, masked on access. A record is a 4-byte header
+// (length | COMMIT_FLAG) followed by the line, padded to 4 bytes.
+//
+//   producer: CAS reserve_pos forward by the record size (owns the space),
+//             copy the line, then publish the header
+//   drain:    output committed records from tail_pos, zero them, advance
+//
+// Consumed space is zeroed before it is handed back, so a header that is
+// reserved but not yet committed reads as 0 and the drain waits there.
+
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "LOG_RING_SIZE must be a power of two");
+
+namespace {
+
+constexpr uint32_t RING_MASK = LOG_RING_SIZE - 1;
+constexpr uint32_t COMMIT_FLAG = 0x80000000UL;
+constexpr size_t HEADER_SIZE = 4;
+constexpr size_t LINE_SIZE = LOG_BUFFER_SIZE + 64;     // Message + timestamp/level/module/colors
+
+alignas(4) uint8_t ring[LOG_RING_SIZE];
+std::atomic<uint32_t> reserve_pos(0);                  // Producers: end of reserved space
+std::atomic<uint32_t> tail_pos(0);                     // Drain: start of unread space
+std::atomic<uint32_t> dropped(0);                      // Lines lost to a full ring
+volatile bool running = false;                         // Drain task started
+
+StaticTask_t drain_tcb;
+StackType_t drain_stack[LOG_DRAIN_STACK_SIZE];
+
+const char* volatile file_path = nullptr;              // Set by enableFileLog()
+Logger::StreamSink volatile stream_sink = nullptr;
+void* volatile stream_context = nullptr;
+Logger::StreamSink volatile serial_sink = nullptr;     // Replaces Serial text output
+void* volatile serial_context = nullptr;
+
+// Drain task only
+File log_file;
+uint32_t reported_drops = 0;
+
+uint32_t align4(size_t n) {
+    return (n + 3) & ~3u;
+}
+
+uint32_t* headerAt(uint32_t pos) {
+    return (uint32_t*)(ring + (pos & RING_MASK));
+}
+
+void ringWrite(uint32_t pos, const void* src, size_t len) {
+    size_t offset = pos & RING_MASK;
+    size_t first = len < LOG_RING_SIZE - offset ? len : LOG_RING_SIZE - offset;
+    memcpy(ring + offset, src, first);
+    memcpy(ring, (const uint8_t*)src + first, len - first);
+}
+
+void ringRead(uint32_t pos, void* dst, size_t len) {
+    size_t offset = pos & RING_MASK;
+    size_t first = len < LOG_RING_SIZE - offset ? len : LOG_RING_SIZE - offset;
+    memcpy(dst, ring + offset, first);
+    memcpy((uint8_t*)dst + first, ring, len - first);
+}
+
+void ringZero(uint32_t pos, size_t len) {
+    size_t offset = pos & RING_MASK;
+    size_t first = len < LOG_RING_SIZE - offset ? len : LOG_RING_SIZE - offset;
+    memset(ring + offset, 0, first);
+    memset(ring, 0, len - first);
+}
+
+/**
+ * @brief Copy a line into the ring (any task, never blocks)
+ * @return false if the ring was full (line dropped and counted)
+ */
+bool push(const char* line, size_t len) {
+    if (len > LINE_SIZE) len = LINE_SIZE;
+    uint32_t size = HEADER_SIZE + align4(len);
+
+    uint32_t pos = reserve_pos.load(std::memory_order_relaxed);
+    do {
+        if (pos + size - tail_pos.load(std::memory_order_acquire) > LOG_RING_SIZE) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!reserve_pos.compare_exchange_weak(pos, pos + size,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed));
+
+    ringWrite(pos + HEADER_SIZE, line, len);
+    __atomic_store_n(headerAt(pos), (uint32_t)len | COMMIT_FLAG, __ATOMIC_RELEASE);
+    return true;
+}
+
+// ========================================
+// OUTPUT (DRAIN TASK)
+// ========================================
+
+int formatLine(char* out, size_t size, LogLevel level, const char* module, const char* message) {
+    // Select color and prefix for level
+    const char* color = COLOR_RESET;
+    const char* levelStr = "???";
+
+    switch (level) {
+        case LOG_LEVEL_CRITICAL:
+            color = COLOR_BOLD_RED;
+            levelStr = "CRIT";
+            break;
+        case LOG_LEVEL_ERROR:
+            color = COLOR_RED;
+            levelStr = "ERR ";
+            break;
+        case LOG_LEVEL_WARN:
+            color = COLOR_BOLD_YELLOW;
+            levelStr = "WARN";
+            break;
+        case LOG_LEVEL_INFO:
+            color = COLOR_GREEN;
+            levelStr = "INFO";
+            break;
+        case LOG_LEVEL_DEBUG:
+            color = COLOR_CYAN;
+            levelStr = "DBG ";
+            break;
+        case LOG_LEVEL_VERBOSE:
+            color = COLOR_GRAY;
+            levelStr = "VERB";
+            break;
+        default:
+            break;
+    }
+
+    #if LOG_TIMESTAMP_ENABLED
+        uint32_t timestamp = millis();
+        int len = snprintf(out, size, "%s[%5lu.%03lu] [%s] [%-8s] %s%s",
+                           color,
+                           (unsigned long)(timestamp / 1000),
+                           (unsigned long)(timestamp % 1000),
+                           levelStr,
+                           module,
+                           message,
+                           COLOR_RESET);
+    #else
+        int len = snprintf(out, size, "%s[%s] [%-8s] %s%s",
+                           color,
+                           levelStr,
+                           module,
+                           message,
+                           COLOR_RESET);
+    #endif
+
+    if (len < 0) return 0;
+    return (size_t)len < size ? len : size - 1;
+}
+
+void writeFile(const char* line, size_t len) {
+    const char* path = file_path;
+    if (!path) return;
+
+    if (!log_file) {
+        log_file = LittleFS.open(path, FILE_APPEND);
+        if (!log_file) {
+            file_path = nullptr;
+            Serial.printf("[LOGGER] Cannot open %s, file logging disabled\n", path);
+            return;
+        }
+    }
+
+    log_file.write((const uint8_t*)line, len);
+    log_file.write('\n');
+
+    // Rotate: keep one previous file
+    if (log_file.size() >= LOG_FILE_MAX_SIZE) {
+        log_file.close();
+
+        char previous[64];
+        snprintf(previous, sizeof(previous), "%s.1", path);
+        LittleFS.remove(previous);
+        LittleFS.rename(path, previous);
+    }
+}
+
+void writeSerial(const char* line, size_t len) {
+    Logger::StreamSink sink = serial_sink;
+    if (sink) {
+        sink(line, len, serial_context);
+        return;
+    }
+
+    Serial.write((const uint8_t*)line, len);
+    Serial.write('\n');
+}
+
+void output(const char* line, size_t len) {
+    writeSerial(line, len);
+
+    writeFile(line, len);
+
+    Logger::StreamSink sink = stream_sink;
+    if (sink) {
+        sink(line, len, stream_context);
+    }
+}
+
+/**
+ * @brief Write out every committed line
+ * @return Number of lines written
+ */
+size_t drain(char* line) {
+    size_t count = 0;
+    uint32_t tail = tail_pos.load(std::memory_order_relaxed);
+
+    while (tail != reserve_pos.load(std::memory_order_acquire)) {
+        uint32_t header = __atomic_load_n(headerAt(tail), __ATOMIC_ACQUIRE);
+        if (!(header & COMMIT_FLAG)) {
+            break;                          // Producer still copying
+        }
+
+        size_t len = header & ~COMMIT_FLAG;
+        uint32_t size = HEADER_SIZE + align4(len);
+
+        ringRead(tail + HEADER_SIZE, line, len);
+        line[len] = '\0';
+        output(line, len);
+
+        // Space goes back to producers only once the line is out (flush())
+        ringZero(tail, size);
+        tail += size;
+        tail_pos.store(tail, std::memory_order_release);
+        count++;
+    }
+
+    return count;
+}
+
+void reportDrops() {
+    uint32_t lost = dropped.load(std::memory_order_relaxed);
+    if (lost == reported_drops) return;
+
+    char message[48];
+    char line[LINE_SIZE];
+    snprintf(message, sizeof(message), "%lu lines dropped (ring full)",
+             (unsigned long)(lost - reported_drops));
+    output(line, formatLine(line, sizeof(line), LOG_LEVEL_WARN, "LOGGER", message));
+    reported_drops = lost;
+}
+
+void drainTask(void* parameter) {
+    char line[LINE_SIZE + 1];
+
+    for (;;) {
+        if (drain(line) > 0) {
+            if (log_file) log_file.flush();
+            continue;                       // More may have arrived while writing
+        }
+        reportDrops();
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+    }
+}
+
+} // namespace
+
+// ========================================
+// LOGGER
+// ========================================
+
+void Logger::log(LogLevel level, const char* module, const char* format, ...) {
+    // Buffer for formatted message
+    char buffer[LOG_BUFFER_SIZE];
+
+    // Format message with variadic args
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, LOG_BUFFER_SIZE, format, args);
+    va_end(args);
+
+    char line[LINE_SIZE];
+    emit(line, formatLine(line, sizeof(line), level, module, buffer));
+}
+
+void Logger::emit(const char* line, size_t len) {
+    #if LOG_ASYNC_ENABLED
+        if (running) {
+            push(line, len);
+            return;
+        }
+    #endif
+
+    writeSerial(line, len);
+}
+
+void Logger::begin() {
+    #if LOG_ASYNC_ENABLED
+        if (!running) {
+            TaskHandle_t task = xTaskCreateStaticPinnedToCore(
+                drainTask,
+                "LogDrain",
+                LOG_DRAIN_STACK_SIZE,
+                nullptr,
+                LOG_DRAIN_PRIORITY,
+                drain_stack,
+                &drain_tcb,
+                LOG_DRAIN_CORE
+            );
+            running = (task != nullptr);
+        }
+    #endif
+
+    Serial.println();
+    LOG_INFO("LOGGER", "Logging system initialized");
+    LOG_INFO("LOGGER", "Level: %s", getLevelName((LogLevel)LOG_LEVEL));
+    LOG_INFO("LOGGER", "Colors: %s", LOG_COLORS_ENABLED ? "enabled" : "disabled");
+    LOG_INFO("LOGGER", "Timestamp: %s", LOG_TIMESTAMP_ENABLED ? "enabled" : "disabled");
+    if (running) {
+        LOG_INFO("LOGGER", "Output: async (%d byte ring)", LOG_RING_SIZE);
+    } else {
+        LOG_INFO("LOGGER", "Output: synchronous");
+    }
+}
+
+bool Logger::flush(uint32_t timeout_ms) {
+    uint32_t start = millis();
+
+    while (running && tail_pos.load(std::memory_order_acquire) !=
+                      reserve_pos.load(std::memory_order_acquire)) {
+        if (millis() - start >= timeout_ms) {
+            return false;
+        }
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+uint32_t Logger::droppedCount() {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+void Logger::enableFileLog(const char* path) {
+    if (!running) {
+        LOG_WARN("LOGGER", "File log needs async output (LOG_ASYNC_ENABLED)");
+        return;
+    }
+    file_path = path;
+    LOG_INFO("LOGGER", "File log: %s (rotates at %d bytes)", path, LOG_FILE_MAX_SIZE);
+}
+
+void Logger::setStreamSink(StreamSink sink, void* context) {
+    stream_context = context;
+    stream_sink = sink;
+}
+
+void Logger::setSerialSink(StreamSink sink, void* context) {
+    serial_context = context;
+    serial_sink = sink;
+}
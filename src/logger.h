@@ -22,6 +22,8 @@
  * - Fully disableable in production (0 overhead)
  * - Compile-time filtering by level
  * - Printf-style formatting
+ * - Asynchronous output: callers only format and enqueue, a background
+ *   task writes to Serial / log file / stream sink
  * 
  * USAGE:
  *   LOG_INFO("NFC", "Tag detected: %s", uid);
@@ -74,6 +76,54 @@
     #define LOG_BUFFER_SIZE 256
 #endif
 
+/**
+ * @brief Asynchronous output (ring buffer + drain task)
+ *
+ * Producers format the line on their own stack and copy it into a
+ * lock-free ring; a low-priority task writes it out. A task logging in
+ * the middle of an I2C transaction never waits on the UART. When the
+ * ring is full the line is dropped and counted (Logger::droppedCount()).
+ * Set to 0 to write synchronously from the calling task (old behavior).
+ */
+#ifndef LOG_ASYNC_ENABLED
+    #define LOG_ASYNC_ENABLED 1
+#endif
+
+#ifndef LOG_RING_SIZE
+    #define LOG_RING_SIZE 8192              ///< Ring bytes (power of two)
+#endif
+
+#ifndef LOG_DRAIN_INTERVAL_MS
+    #define LOG_DRAIN_INTERVAL_MS 20        ///< Drain task poll period when idle
+#endif
+
+#ifndef LOG_DRAIN_STACK_SIZE
+    #define LOG_DRAIN_STACK_SIZE 4096       ///< Drain task stack (LittleFS writes)
+#endif
+
+#ifndef LOG_DRAIN_PRIORITY
+    #define LOG_DRAIN_PRIORITY 1            ///< Below every worker that logs
+#endif
+
+#ifndef LOG_DRAIN_CORE
+    #define LOG_DRAIN_CORE 1                ///< Keep UART work off the WiFi core
+#endif
+
+/**
+ * @brief Rotating log file on LittleFS (enable with Logger::enableFileLog())
+ */
+#ifndef LOG_FILE_ENABLED
+    #define LOG_FILE_ENABLED 0
+#endif
+
+#ifndef LOG_FILE_PATH
+    #define LOG_FILE_PATH "/system.log"     ///< Current log; previous one gets ".1"
+#endif
+
+#ifndef LOG_FILE_MAX_SIZE
+    #define LOG_FILE_MAX_SIZE 65536         ///< Rotate when the file grows past this
+#endif
+
 
 // ========================================
 // LOG LEVELS
@@ -238,76 +288,24 @@ typedef int LogLevel;
 
 class Logger {
 public:
+    /**
+     * @brief Receives every output line (NUL-terminated, no newline) from the drain task
+     */
+    typedef void (*StreamSink)(const char* line, size_t len, void* context);
+
     /**
      * @brief Internal function to print log messages
      * DO NOT call directly, use LOG_* macros instead
      */
-    static void log(LogLevel level, const char* module, const char* format, ...) {
-        // Buffer for formatted message
-        char buffer[LOG_BUFFER_SIZE];
-
-        // Format message with variadic args
-        va_list args;
-        va_start(args, format);
-        vsnprintf(buffer, LOG_BUFFER_SIZE, format, args);
-        va_end(args);
-
-        // Select color and prefix for level
-        const char* color = COLOR_RESET;
-        const char* levelStr = "???";
-
-        switch (level) {
-            case LOG_LEVEL_CRITICAL:
-                color = COLOR_BOLD_RED;
-                levelStr = "CRIT";
-                break;
-            case LOG_LEVEL_ERROR:
-                color = COLOR_RED;
-                levelStr = "ERR ";
-                break;
-            case LOG_LEVEL_WARN:
-                color = COLOR_BOLD_YELLOW;
-                levelStr = "WARN";
-                break;
-            case LOG_LEVEL_INFO:
-                color = COLOR_GREEN;
-                levelStr = "INFO";
-                break;
-            case LOG_LEVEL_DEBUG:
-                color = COLOR_CYAN;
-                levelStr = "DBG ";
-                break;
-            case LOG_LEVEL_VERBOSE:
-                color = COLOR_GRAY;
-                levelStr = "VERB";
-                break;
-            default:
-                break;
-        }
+    static void log(LogLevel level, const char* module, const char* format, ...);
 
-        // Build output
-        #if LOG_TIMESTAMP_ENABLED
-            uint32_t timestamp = millis();
-            uint32_t seconds = timestamp / 1000;
-            uint32_t millis_part = timestamp % 1000;
-
-            Serial.printf("%s[%5lu.%03lu] [%s] [%-8s] %s%s\n",
-                          color,
-                          seconds,
-                          millis_part,
-                          levelStr,
-                          module,
-                          buffer,
-                          COLOR_RESET);
-        #else
-            Serial.printf("%s[%s] [%-8s] %s%s\n",
-                          color,
-                          levelStr,
-                          module,
-                          buffer,
-                          COLOR_RESET);
-        #endif
-    }
+    /**
+     * @brief Queue one finished output line (newline is added on output)
+     *
+     * Writes synchronously until begin() has started the drain task, or
+     * always when LOG_ASYNC_ENABLED is 0.
+     */
+    static void emit(const char* line, size_t len);
 
     /**
      * @brief Hex dump of a byte buffer
@@ -340,21 +338,51 @@ public:
                                    (c >= 32 && c <= 126) ? c : '.');
             }
 
-            Serial.println(line);
+            emit(line, offset < (int)sizeof(line) ? offset : sizeof(line) - 1);
         }
     }
 
     /**
-     * @brief Initialize logger (optional, call in setup())
+     * @brief Initialize logger and start the drain task (call first in setup())
      */
-    static void begin() {
-        Serial.println();
-        LOG_INFO("LOGGER", "Logging system initialized");
-        LOG_INFO("LOGGER", "Level: %s", getLevelName((LogLevel)LOG_LEVEL));
-        LOG_INFO("LOGGER", "Colors: %s", LOG_COLORS_ENABLED ? "enabled" : "disabled");
-        LOG_INFO("LOGGER", "Timestamp: %s", LOG_TIMESTAMP_ENABLED ? "enabled" : "disabled");
-        Serial.println();
-    }
+    static void begin();
+
+    /**
+     * @brief Wait until every queued line has been written
+     * @param timeout_ms Maximum wait
+     * @return true if the ring is empty
+     *
+     * Call before restarting so the last lines are not lost.
+     */
+    static bool flush(uint32_t timeout_ms = 500);
+
+    /**
+     * @brief Lines lost because the ring was full (since boot)
+     */
+    static uint32_t droppedCount();
+
+    /**
+     * @brief Also append output to a rotating LittleFS file
+     * @param path Log file (previous file is kept as path + ".1")
+     *
+     * Call after LittleFS is mounted.
+     */
+    static void enableFileLog(const char* path = LOG_FILE_PATH);
+
+    /**
+     * @brief Install a stream sink (e.g. web log stream), nullptr to remove
+     * @param sink Called from the drain task for every line; must not block
+     * @param context Opaque pointer passed back to sink
+     */
+    static void setStreamSink(StreamSink sink, void* context);
+
+    /**
+     * @brief Replace the plain-text Serial output (e.g. framed binary mode), nullptr to restore
+     * @param sink Called instead of Serial.write for every line (drain task, or
+     *        the caller before begin()); may block on the UART like Serial.write
+     * @param context Opaque pointer passed back to sink
+     */
+    static void setSerialSink(StreamSink sink, void* context);
 
     static const char* getLevelName(int level) {
     switch (level) {
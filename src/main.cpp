@@ -12,6 +12,8 @@
 #include <LittleFS.h>
 #include <WiFi.h>
 #include <esp_task_wdt.h>
+#include <esp_heap_caps.h>
+#include <stage_metrics.h>                             // Stage timing histograms
 
 #include "webFiles.h"                                   // Web pages (gzipped)
 #include "config.h"                                     // Project configuration
@@ -21,9 +23,11 @@
 #include "modules/wifi/wifi_manager.h"
 #include "modules/led/led_manager.h"
 #include "modules/webserver/webserver_handler.h"
+#include "modules/webserver/nfc_job_engine.h"
 #include "modules/serial_commands/serial_commander.h"
 #include "modules/rfid/nfc_manager.h"
 #include "modules/rfid/mifare_keys_manager.h"
+#include "modules/boot/boot_profile.h"
 
 // ========================================
 // GLOBAL OBJECTS
@@ -32,6 +36,9 @@
 LedManager ledMgr;
 WiFiManager wifiMgr;
 NFCManager nfcMgr;
+#if NFC_READER_COUNT > 1
+NFCManager nfcMgr2(NFCReaderConfig::forIndex(1));     // Second PN532 on Wire1
+#endif
 MifareKeysManager mfkMgr;
 AsyncWebServer server(WEB_SERVER_PORT);
 WebServerHandler webHandler(server, wifiMgr, nfcMgr);
@@ -42,6 +49,7 @@ SerialCommander commander(wifiMgr, nfcMgr);
 // ========================================
 
 TaskHandle_t serialTaskHandle = NULL;
+TaskHandle_t netBootTaskHandle = NULL;
 
 // ========================================
 // TASK: SERIAL COMMANDER (Core 1)
@@ -51,6 +59,7 @@ TaskHandle_t serialTaskHandle = NULL;
  * @param parameter Unused task parameter
  * 
  * Runs on Core 1 to avoid blocking Core 0 (WiFi/WebServer).
+ * Started as soon as the readers are up, before WiFi has associated.
  * Handles serial commands from USB with 50ms polling interval.
  */
 void serialCommandTask(void* parameter) {
@@ -58,13 +67,110 @@ void serialCommandTask(void* parameter) {
 
     for(;;) {
         commander.handleCommands();
-        vTaskDelay(pdMS_TO_TICKS(50));  // 50ms polling interval
+        vTaskDelay(pdMS_TO_TICKS(commander.pollIntervalMs()));  // 50ms text, 2ms binary frames
     }
 
     // Should never reach here
     vTaskDelete(NULL);
 }
 
+// ========================================
+// MEMORY BUDGET
+// ========================================
+/**
+ * @brief Check the heap left once every module is up
+ *
+ * NFC jobs run from static pools (worker stack, job table, JSON arena),
+ * so what is free here is what the web server and WiFi have to work
+ * with for the rest of the uptime. The largest free block matters as
+ * much as the total: it bounds the biggest single allocation.
+ */
+void checkMemoryBudget() {
+    uint32_t freeHeap = ESP.getFreeHeap();
+    uint32_t largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    uint32_t minFree = ESP.getMinFreeHeap();
+
+    LOG_INFO("MEMORY", "Static pools: NFC worker %u bytes, tag dump %u bytes",
+             (unsigned)NFCJobEngine::staticFootprint(), (unsigned)NFCManager::MIFARE_4K_DUMP_SIZE);
+    LOG_INFO("MEMORY", "Heap: %u free, %u largest block, %u minimum",
+             freeHeap, largestBlock, minFree);
+
+    if (freeHeap < HEAP_CRITICAL_THRESHOLD || largestBlock < HEAP_CRITICAL_THRESHOLD) {
+        LOG_CRITICAL("MEMORY", "Budget exceeded: below %d bytes critical threshold",
+                     HEAP_CRITICAL_THRESHOLD);
+    } else if (freeHeap < HEAP_WARNING_THRESHOLD || largestBlock < HEAP_WARNING_THRESHOLD) {
+        LOG_WARN("MEMORY", "Budget tight: below %d bytes warning threshold",
+                 HEAP_WARNING_THRESHOLD);
+    } else {
+        LOG_INFO("MEMORY", "Budget OK (warning at %d bytes)", HEAP_WARNING_THRESHOLD);
+    }
+}
+
+// ========================================
+// TASK: NETWORK BOOT (Core 0, one-shot)
+// ========================================
+/**
+ * @brief WiFi association and web server start
+ *
+ * A saved network can take a scan plus WIFI_CONNECT_TIMEOUT_MS per
+ * candidate, so this runs on its own task while setup() brings up I2C,
+ * the readers and the serial commands.
+ */
+void bootNetwork() {
+    BootProfile::begin(BootProfile::STAGE_WIFI);
+    LOG_INFO("WIFI", "Initializing WiFi Manager on Core %d...", xPortGetCoreID());
+
+    wifiMgr.begin();
+    bool connected = wifiMgr.connectFromSaved();
+
+    #if WIFI_BOOT_SERIAL_PROMPT
+        if (!connected) {
+            // The prompt reads Serial itself
+            commander.disable();
+            wifiMgr.scanAndAskCredentials();
+            commander.enable();
+            connected = wifiMgr.isConnected();
+        }
+    #endif
+
+    if (connected) {
+        ledMgr.connected();
+
+        LOG_INFO("WIFI", "Connected to: %s", WiFi.SSID().c_str());
+        LOG_INFO("WIFI", "IP Address: %s", WiFi.localIP().toString().c_str());
+        LOG_INFO("WIFI", "RSSI: %d dBm", WiFi.RSSI());
+        LOG_INFO("WIFI", "Gateway: %s", WiFi.gatewayIP().toString().c_str());
+    } else {
+        wifiMgr.startAP();
+        ledMgr.blinking();
+        LOG_WARN("WIFI", "Connection failed - operating in offline mode");
+    }
+    BootProfile::end(BootProfile::STAGE_WIFI);
+
+    // ====== WEB SERVER ======
+    BootProfile::begin(BootProfile::STAGE_WEB_LISTEN);
+    webHandler.listen();
+    BootProfile::end(BootProfile::STAGE_WEB_LISTEN);
+
+    LOG_INFO("SETUP", "Web Interface: http://%s",
+             (connected ? WiFi.localIP() : WiFi.softAPIP()).toString().c_str());
+
+    if (BootProfile::complete()) {
+        checkMemoryBudget();
+    }
+}
+
+/**
+ * @brief One-shot task running bootNetwork(), deletes itself when done
+ * @param parameter Unused task parameter
+ */
+void networkBootTask(void* parameter) {
+    bootNetwork();
+
+    netBootTaskHandle = NULL;
+    vTaskDelete(NULL);
+}
+
 
 // ========================================
 // SETUP - ONE-TIME INITIALIZATION
@@ -72,9 +178,9 @@ void serialCommandTask(void* parameter) {
 
 void setup() {
     // ====== SERIAL INITIALIZATION ======
+    BootProfile::begin(BootProfile::STAGE_LOGGER);
     Serial.begin(SERIAL_BAUD);
-    delay(BOOT_DELAY_MS
-);  // Short delay for serial stability
+    delay(BOOT_DELAY_MS);  // Short delay for serial stability
 
     // Initialize logger
     Logger::begin();
@@ -83,12 +189,16 @@ void setup() {
     LOG_INFO("SETUP", "Chip: %s, CPU Freq: %d MHz", ESP.getChipModel(), ESP.getCpuFreqMHz());
     LOG_INFO("SETUP", "Free Heap: %d bytes", ESP.getFreeHeap());
 
+    StageMetrics::begin();
+    BootProfile::end(BootProfile::STAGE_LOGGER);
+
     // ====== LED MANAGER ======
     ledMgr.begin(LED_PIN);
     ledMgr.blinking();
     LOG_DEBUG("SETUP", "LED Manager initialized (Pin: %d)", LED_PIN);
 
     // ====== FILESYSTEM (LittleFS) ======
+    BootProfile::begin(BootProfile::STAGE_FILESYSTEM);
     LOG_INFO("FLASH", "Mounting filesystem...");
     LOG_DEBUG("FLASH", "Auto-format on fail: %s", 
               LITTLEFS_FORMAT_ON_FAIL ? "enabled" : "disabled");
@@ -123,6 +233,10 @@ void setup() {
     } else {
         // Mount successful
         LOG_INFO("FLASH", "Filesystem mounted successfully");
+
+        #if LOG_FILE_ENABLED
+            Logger::enableFileLog(LOG_FILE_PATH);
+        #endif
         
         size_t totalBytes = LittleFS.totalBytes();
         size_t usedBytes = LittleFS.usedBytes();
@@ -143,32 +257,80 @@ void setup() {
         }
     }
     
-    delay(BOOT_DELAY_MS
-);
+    BootProfile::end(BootProfile::STAGE_FILESYSTEM);
 
+    // ====== WEB ROUTES & NFC JOB ENGINE ======
+    // Registered now, the port opens once the network is up
+    BootProfile::begin(BootProfile::STAGE_WEB_ROUTES);
+    webHandler.begin();
+    commander.setJobEngine(webHandler.jobs());          // "system bench" / "nfc batch" submit NFC jobs
+    if (webHandler.jobs()) {
+        webHandler.jobs()->setLedManager(&ledMgr);      // Batch scan feedback
+    }
 
-    // ====== WIFI INITIALIZATION ======
-    LOG_INFO("WIFI", "Initializing WiFi Manager...");
-    LOG_DEBUG("WIFI", "Note: Serial Commander disabled during WiFi setup");
+    #if DEBUG_SKIP_AUTH
+        LOG_WARN("WEB", "⚠️   DEBUG MODE: Authentication disabled!   ⚠️");
+    #endif
+    BootProfile::end(BootProfile::STAGE_WEB_ROUTES);
 
-    wifiMgr.begin();
+    // ====== NETWORK (parallel) ======
+    LOG_INFO("TASK", "Starting network boot task...");
 
-    if (wifiMgr.autoConnect()) {
-        ledMgr.connected();
+    BaseType_t netResult = xTaskCreatePinnedToCore(
+        networkBootTask,             // Task function
+        "NetBoot",                   // Task name (for debugging)
+        BOOT_NET_TASK_STACK_SIZE,    // Stack size (freed after boot)
+        NULL,                        // Task parameters
+        BOOT_NET_TASK_PRIORITY,      // Priority
+        &netBootTaskHandle,          // Task handle
+        BOOT_NET_TASK_CORE           // Core ID (0 = WiFi core)
+    );
 
-        LOG_INFO("WIFI", "Connected to: %s", WiFi.SSID().c_str());
-        LOG_INFO("WIFI", "IP Address: %s", WiFi.localIP().toString().c_str());
-        LOG_INFO("WIFI", "RSSI: %d dBm", WiFi.RSSI());
-        LOG_INFO("WIFI", "Gateway: %s", WiFi.gatewayIP().toString().c_str());
+    // ====== I2C BUS INITIALIZATION ======
+    BootProfile::begin(BootProfile::STAGE_I2C);
+    LOG_INFO("I2C", "Initializing I2C bus...");
+    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
+    Wire.setClock(I2C_FREQUENCY);  // 100kHz default, 400kHz with I2C_FAST_PROFILE
+    LOG_INFO("I2C", "I2C initialized (SDA: %d, SCL: %d, Freq: %dkHz)", 
+             I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY);
+    BootProfile::end(BootProfile::STAGE_I2C);
 
-        delay(BOOT_DELAY_MS
-);
+    // ====== NFC MANAGER (PN532) ======
+    BootProfile::begin(BootProfile::STAGE_NFC);
+    LOG_INFO("NFC", "Initializing PN532 NFC module...");
+
+    if (!nfcMgr.begin()) {
+        LOG_ERROR("NFC", "PN532 initialization failed");
+        LOG_ERROR("NFC", "Check wiring: SDA=%d, SCL=%d, IRQ=%d, RST=%d", 
+                  I2C_SDA_PIN, I2C_SCL_PIN, PN532_IRQ, PN532_RF_REST);
+        LOG_WARN("NFC", "NFC operations will be unavailable");
     } else {
-        ledMgr.blinking();
-        LOG_WARN("WIFI", "Connection failed - operating in offline mode");
+        LOG_INFO("NFC", "PN532 initialized successfully");
+        LOG_DEBUG("NFC", "Firmware version checked");
+    }
+
+    #if NFC_READER_COUNT > 1
+        LOG_INFO("NFC", "Initializing second PN532 reader...");
+        if (!nfcMgr2.begin()) {
+            LOG_ERROR("NFC", "Reader 1 initialization failed");
+            LOG_ERROR("NFC", "Check wiring: SDA=%d, SCL=%d, IRQ=%d, RST=%d",
+                      NFC_READER1_SDA_PIN, NFC_READER1_SCL_PIN, NFC_READER1_IRQ_PIN, NFC_READER1_RESET_PIN);
+        }
+        // Own job engine and worker either way (jobs then fail with "not ready")
+        if (!webHandler.addReader(nfcMgr2)) {
+            LOG_WARN("NFC", "Reader 1 unavailable to the web API");
+        }
+    #endif
+    BootProfile::end(BootProfile::STAGE_NFC);
+
+    // No network task: connect here, now that the readers behind the web API are up
+    if (netResult != pdPASS) {
+        LOG_ERROR("TASK", "Failed to create network boot task, connecting inline");
+        bootNetwork();
     }
 
     // ====== SERIAL COMMANDER TASK ======
+    BootProfile::begin(BootProfile::STAGE_COMMANDS);
     LOG_INFO("TASK", "Creating Serial Commander task...");
 
     BaseType_t taskResult = xTaskCreatePinnedToCore(
@@ -187,29 +349,14 @@ void setup() {
     } else {
         LOG_ERROR("TASK", "Failed to create Serial Commander task!");
     }
+    BootProfile::end(BootProfile::STAGE_COMMANDS);
 
-    // ====== WEB SERVER ======
-    LOG_INFO("WEB", "Starting web server...");
-    webHandler.begin();
-    LOG_INFO("WEB", "Web server started on port %d", WEB_SERVER_PORT);
-
-    #if DEBUG_SKIP_AUTH
-        LOG_WARN("WEB", "⚠️   DEBUG MODE: Authentication disabled!   ⚠️");
-    #endif
-
-    delay(BOOT_DELAY_MS
-);
-
-    // ====== I2C BUS INITIALIZATION ======
-    LOG_INFO("I2C", "Initializing I2C bus...");
-    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
-    Wire.setClock(I2C_FREQUENCY);  // 100kHz for PN532 stability
-    LOG_INFO("I2C", "I2C initialized (SDA: %d, SCL: %d, Freq: %dkHz)", 
-             I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY);
-    delay(BOOT_DELAY_MS
-);
+    LOG_INFO("SETUP", "Serial Commands: Type 'help' for command list");
 
     // ====== MIFARE KEYS MANAGER ======
+    // Commands are already served: a Mifare read before this finishes
+    // loads the database itself (MifareKeysManager::ensureLoaded)
+    BootProfile::begin(BootProfile::STAGE_KEYS);
     LOG_INFO("KEYS", "Loading Mifare Classic keys...");
 
     if (!MifareKeysManager::begin()) {
@@ -218,32 +365,18 @@ void setup() {
     } else {
         LOG_INFO("KEYS", "Mifare keys loaded successfully");
     }
-
-    delay(BOOT_DELAY_MS
-);
-
-    // ====== NFC MANAGER (PN532) ======
-    LOG_INFO("NFC", "Initializing PN532 NFC module...");
-
-    if (!nfcMgr.begin()) {
-        LOG_ERROR("NFC", "PN532 initialization failed");
-        LOG_ERROR("NFC", "Check wiring: SDA=%d, SCL=%d, IRQ=%d, RST=%d", 
-                  I2C_SDA_PIN, I2C_SCL_PIN, PN532_IRQ, PN532_RF_REST);
-        LOG_WARN("NFC", "NFC operations will be unavailable");
-    } else {
-        LOG_INFO("NFC", "PN532 initialized successfully");
-        LOG_DEBUG("NFC", "Firmware version checked");
-    }
+    BootProfile::end(BootProfile::STAGE_KEYS);
 
     // ====== SETUP COMPLETE ======
     LOG_INFO("SETUP", "============================================");
-    LOG_INFO("SETUP", "✅ System initialization complete");
+    LOG_INFO("SETUP", "✅ Local initialization complete (network continues in background)");
     LOG_INFO("SETUP", "============================================");
-    LOG_INFO("SETUP", "");
-    LOG_INFO("SETUP", "Ready to accept commands:");
-    LOG_INFO("SETUP", "  - Web Interface: http://%s", WiFi.localIP().toString().c_str());
-    LOG_INFO("SETUP", "  - Serial Commands: Type 'help' for command list");
-    LOG_INFO("SETUP", "");
+
+    // ====== MEMORY BUDGET ======
+    // Checked by whichever boot path finishes last
+    if (BootProfile::complete()) {
+        checkMemoryBudget();
+    }
     Serial.flush();
 }
 
@@ -254,6 +387,7 @@ void setup() {
 
 void loop() {
 
+    MifareKeysManager::saveStats();  // Key hit counters, once a flush is due
     vTaskDelay(pdMS_TO_TICKS(100));  // Yield to scheduler
 
 }
\ No newline at end of file
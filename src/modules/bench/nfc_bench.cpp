@@ -0,0 +1,597 @@
+#include "nfc_bench.h"
+#include "modules/rfid/nfc_dump_file.h"
+#include "modules/webserver/zip_stream.h"
+#include "config.h"
+#include <LittleFS.h>
+#include <algorithm>
+#include <esp_heap_caps.h>
+#include <esp_idf_version.h>
+
+// Local minimum tracking of the heap (IDF 5.1+); older cores sample per iteration
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+    #define BENCH_HEAP_MONITOR 1
+#else
+    #define BENCH_HEAP_MONITOR 0
+#endif
+
+// ============================================
+// SCENARIO NAMES
+// ============================================
+
+// Indexed by Scenario - keep in sync with the enum
+static const char* const SCENARIO_NAMES[NFCBench::BENCH_SCENARIO_COUNT] = {
+    "srix_read",
+    "srix_write",
+    "srix_write_selective",
+    "mifare_read",
+    "mifare_read_nocache",
+    "mifare_keys",
+    "mifare_write",
+    "mifare_write_selective",
+    "dump_srix",
+    "dump_mifare",
+    "backup"
+};
+
+// Key search runs: simulated database size and position of the real key (-1: absent)
+static const struct {
+    uint16_t db_size;
+    int16_t position;
+} KEY_PROBES[] = {
+    {8, 0}, {8, 7}, {8, -1},
+    {32, 0}, {32, 16}, {32, 31}, {32, -1}
+};
+
+// Selective write targets: user data only (no SRIX OTP/counter blocks, no trailers)
+static const uint8_t SRIX_SELECTIVE_BLOCKS[] = {16, 17, 18, 19, 20, 21, 22, 23};
+static const uint8_t MIFARE_SELECTIVE_BLOCKS[] = {4, 5, 6};
+
+// Full write runs change every block from here on (0-4 lockable OTP, 5-6 counters)
+static constexpr uint8_t SRIX_FIRST_DATA_BLOCK = 7;
+
+/**
+ * @brief Invert blocks of a dump in place (applied twice: original again)
+ */
+static void invertBlocks(uint8_t* dump, const std::vector<uint8_t>& blocks, uint8_t block_size) {
+    for (uint8_t block : blocks) {
+        uint8_t* data = dump + block * block_size;
+        for (uint8_t i = 0; i < block_size; i++) {
+            data[i] ^= 0xFF;
+        }
+    }
+}
+
+/**
+ * @brief Sector holding a Mifare block (1K/4K layout)
+ */
+static int mifareSectorOf(uint16_t block) {
+    if (block < MifareTool::LARGE_SECTOR_BOUNDARY) {
+        return block / MifareTool::BLOCKS_PER_SMALL_SECTOR;
+    }
+    return MifareTool::LARGE_SECTOR_BOUNDARY / MifareTool::BLOCKS_PER_SMALL_SECTOR +
+           (block - MifareTool::LARGE_SECTOR_BOUNDARY) / MifareTool::BLOCKS_PER_LARGE_SECTOR;
+}
+
+// ============================================
+// STATIC STORAGE
+// ============================================
+
+std::atomic<bool> NFCBench::_running(false);
+NFCManager::TagInfo NFCBench::_saved_tag;
+uint8_t NFCBench::_saved_dump[NFCManager::MIFARE_4K_DUMP_SIZE];
+uint8_t NFCBench::_image[NFCManager::MIFARE_1K_DUMP_SIZE];
+uint8_t NFCBench::_pattern[NFCManager::MIFARE_4K_DUMP_SIZE];
+uint8_t NFCBench::_chunk[BACKUP_CHUNK_SIZE];
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+NFCBench::NFCBench(NFCManager& nfc) : _nfc(nfc) {
+    memset(&_series, 0, sizeof(_series));
+}
+
+// ============================================
+// PUBLIC METHODS
+// ============================================
+
+bool NFCBench::run(const Options& options, JsonDocument& out) {
+    uint32_t mask = options.scenarios & GROUP_ALL;
+    if (mask == 0) {
+        out["success"] = false;
+        out["message"] = "No scenarios selected";
+        return false;
+    }
+
+    if (_running.exchange(true)) {
+        out["success"] = false;
+        out["message"] = "Benchmark already running";
+        return false;
+    }
+
+    Options opts = options;
+    opts.iterations = constrain(options.iterations, 1, MAX_ITERATIONS);
+    if (opts.timeout_sec <= 0) {
+        opts.timeout_sec = DEFAULT_TIMEOUT_SEC;
+    }
+
+    // Keep the loaded dump: reads, loads and writes below replace it
+    _saved_tag = _nfc.currentTag();
+    if (_saved_tag.valid && _saved_tag.dump && _saved_tag.size <= sizeof(_saved_dump)) {
+        memcpy(_saved_dump, _saved_tag.dump, _saved_tag.size);
+        _saved_tag.dump = _saved_dump;
+    }
+
+    LOG_INFO("BENCH", "Starting: scenarios %08lX, %u iterations, writes %s",
+             (unsigned long)mask, opts.iterations, opts.allow_write ? "allowed" : "off");
+    unsigned long start = millis();
+
+    out["success"] = true;
+    out["build"] = __DATE__ " " __TIME__;
+    out["cpu_mhz"] = ESP.getCpuFreqMHz();
+    out["iterations"] = opts.iterations;
+    out["free_heap"] = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    JsonArray results = out["results"].to<JsonArray>();
+
+    // Tag scenarios first: storage runs reload synthetic Mifare images,
+    // which replaces the keys the handler learned from the tag
+    if (mask & (1UL << BENCH_SRIX_READ))              benchSrixRead(results, opts);
+    if (mask & (1UL << BENCH_SRIX_WRITE))             benchSrixWrite(results, opts, false);
+    if (mask & (1UL << BENCH_SRIX_WRITE_SELECTIVE))   benchSrixWrite(results, opts, true);
+    if (mask & (1UL << BENCH_MIFARE_READ))            benchMifareRead(results, opts, true);
+    if (mask & (1UL << BENCH_MIFARE_READ_NOCACHE))    benchMifareRead(results, opts, false);
+    if (mask & (1UL << BENCH_MIFARE_KEYS))            benchMifareKeys(results, opts);
+    if (mask & (1UL << BENCH_MIFARE_WRITE))           benchMifareWrite(results, opts, false);
+    if (mask & (1UL << BENCH_MIFARE_WRITE_SELECTIVE)) benchMifareWrite(results, opts, true);
+    if (mask & (1UL << BENCH_DUMP_SRIX))              benchDump(results, opts, NFCManager::PROTOCOL_SRIX);
+    if (mask & (1UL << BENCH_DUMP_MIFARE))            benchDump(results, opts, NFCManager::PROTOCOL_MIFARE_CLASSIC);
+    if (mask & (1UL << BENCH_BACKUP))                 benchBackup(results, opts);
+
+    if (_saved_tag.valid) {
+        _nfc.restoreCurrentTag(_saved_tag);
+    } else {
+        _nfc.clearCurrentTag();
+    }
+
+    unsigned long elapsed = millis() - start;
+    out["elapsed_ms"] = elapsed;
+    out["message"] = "Benchmark complete";
+
+    LOG_INFO("BENCH", "Complete: %u results in %lu ms", (unsigned)results.size(), elapsed);
+    _running = false;
+    return true;
+}
+
+bool NFCBench::parseScenarios(const String& list, uint32_t& mask) {
+    mask = 0;
+    bool all_known = true;
+    int pos = 0;
+    int len = list.length();
+
+    while (pos < len) {
+        int end = pos;
+        while (end < len && list[end] != ',' && list[end] != ' ') {
+            end++;
+        }
+
+        String name = list.substring(pos, end);
+        name.trim();
+        pos = end + 1;
+
+        if (name.isEmpty()) {
+            continue;
+        }
+
+        if (name == "all") {
+            mask |= GROUP_ALL;
+        } else if (name == "storage") {
+            mask |= GROUP_STORAGE;
+        } else if (name == "srix") {
+            mask |= GROUP_SRIX;
+        } else if (name == "mifare") {
+            mask |= GROUP_MIFARE;
+        } else {
+            bool found = false;
+            for (uint8_t i = 0; i < BENCH_SCENARIO_COUNT; i++) {
+                if (name == SCENARIO_NAMES[i]) {
+                    mask |= 1UL << i;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                LOG_WARN("BENCH", "Unknown scenario: '%s'", name.c_str());
+                all_known = false;
+            }
+        }
+    }
+
+    return all_known;
+}
+
+const char* NFCBench::scenarioName(Scenario scenario) {
+    if (scenario >= BENCH_SCENARIO_COUNT) {
+        return "unknown";
+    }
+    return SCENARIO_NAMES[scenario];
+}
+
+// ============================================
+// MEASUREMENT
+// ============================================
+
+template <typename Op>
+JsonObject NFCBench::measure(JsonArray results, const char* name, uint8_t iterations, Op op) {
+    return measure(results, name, iterations, []() {}, op);
+}
+
+template <typename Prepare, typename Op>
+JsonObject NFCBench::measure(JsonArray results, const char* name, uint8_t iterations,
+                             Prepare prepare, Op op) {
+    memset(&_series, 0, sizeof(_series));
+    _series.heap_start = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    _series.heap_min = _series.heap_start;
+
+    #if BENCH_HEAP_MONITOR
+        bool monitoring = (heap_caps_monitor_local_minimum_free_size_start() == ESP_OK);
+    #endif
+
+    LOG_DEBUG("BENCH", "%s: %u iterations", name, iterations);
+
+    for (uint8_t i = 0; i < iterations; i++) {
+        prepare();
+
+        uint32_t bytes = 0;
+        uint32_t start = micros();
+        bool ok = op(bytes);
+        uint32_t elapsed = micros() - start;
+
+        _series.total_us += elapsed;
+        if (ok) {
+            _series.latency_us[_series.ok++] = elapsed;
+            _series.bytes += bytes;
+        } else {
+            _series.failed++;
+        }
+
+        uint32_t heap = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+        if (heap < _series.heap_min) _series.heap_min = heap;
+
+        if (!ok && _series.ok == 0) {
+            LOG_WARN("BENCH", "%s: first iteration failed, stopping", name);
+            break;
+        }
+        yield();
+    }
+
+    #if BENCH_HEAP_MONITOR
+        if (monitoring) {
+            uint32_t low = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+            if (low < _series.heap_min) _series.heap_min = low;
+            heap_caps_monitor_local_minimum_free_size_stop();
+        }
+    #endif
+
+    JsonObject r = results.add<JsonObject>();
+    r["name"] = name;
+    r["ok"] = _series.ok;
+    r["failed"] = _series.failed;
+    r["total_ms"] = _series.total_us / 1000;
+
+    if (_series.ok > 0) {
+        uint32_t* samples = _series.latency_us;
+        uint8_t n = _series.ok;
+        std::sort(samples, samples + n);
+
+        uint64_t ok_us = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            ok_us += samples[i];
+        }
+
+        // Nearest-rank percentiles
+        r["ops_per_sec"] = ok_us ? (float)n * 1000000.0f / ok_us : 0.0f;
+        r["bytes_per_sec"] = ok_us ? (uint32_t)((uint64_t)_series.bytes * 1000000ULL / ok_us) : 0;
+        r["min_us"] = samples[0];
+        r["p50_us"] = samples[(n * 50 + 99) / 100 - 1];
+        r["p95_us"] = samples[(n * 95 + 99) / 100 - 1];
+        r["max_us"] = samples[n - 1];
+        r["mean_us"] = (uint32_t)(ok_us / n);
+    }
+
+    r["heap_peak"] = _series.heap_start - _series.heap_min;
+
+    LOG_INFO("BENCH", "%s: %u ok, %u failed, %lu ms", name, _series.ok, _series.failed,
+             (unsigned long)(_series.total_us / 1000));
+    return r;
+}
+
+template <typename Write>
+void NFCBench::measureWrites(JsonArray results, const char* name, uint8_t iterations,
+                             const std::vector<uint8_t>& blocks, uint8_t block_size, Write write) {
+    NFCManager::TagInfo pattern = _nfc.currentTag();
+    memcpy(_pattern, pattern.dump, pattern.size);
+    pattern.dump = _pattern;
+    bool inverted = false;
+
+    JsonObject r = measure(results, name, iterations,
+        [&]() {
+            invertBlocks(_pattern, blocks, block_size);
+            inverted = !inverted;
+            _nfc.restoreCurrentTag(pattern);
+        },
+        [&](uint32_t& bytes) {
+            bytes = blocks.size() * block_size;
+            return write();
+        });
+    r["blocks"] = blocks.size();
+
+    // Untimed: put the tag's own content back
+    if (inverted) {
+        invertBlocks(_pattern, blocks, block_size);
+    }
+    _nfc.restoreCurrentTag(pattern);
+    bool restored = write();
+    r["restored"] = restored;
+    if (!restored) {
+        LOG_WARN("BENCH", "%s: could not write the original content back", name);
+    }
+}
+
+void NFCBench::skip(JsonArray results, const char* name, const char* reason) {
+    JsonObject r = results.add<JsonObject>();
+    r["name"] = name;
+    r["skipped"] = reason;
+    LOG_INFO("BENCH", "%s skipped: %s", name, reason);
+}
+
+// ============================================
+// SCENARIOS: SRIX
+// ============================================
+
+void NFCBench::benchSrixRead(JsonArray results, const Options& options) {
+    measure(results, "srix_read", options.iterations, [&](uint32_t& bytes) {
+        NFCManager::TagInfo info;
+        bool ok = _nfc.readSRIX(info, options.timeout_sec, false).success;
+        bytes = info.size;
+        return ok;
+    });
+}
+
+void NFCBench::benchSrixWrite(JsonArray results, const Options& options, bool selective) {
+    const char* name = selective ? "srix_write_selective" : "srix_write";
+    if (!options.allow_write) {
+        skip(results, name, "writes not allowed");
+        return;
+    }
+
+    // The tag's own content is the base of the written pattern
+    NFCManager::TagInfo info;
+    if (!_nfc.readSRIX(info, options.timeout_sec, true).success) {
+        skip(results, name, "no SRIX tag");
+        return;
+    }
+
+    std::vector<uint8_t> blocks;
+    if (selective) {
+        blocks.assign(SRIX_SELECTIVE_BLOCKS, SRIX_SELECTIVE_BLOCKS + sizeof(SRIX_SELECTIVE_BLOCKS));
+        measureWrites(results, name, options.iterations, blocks, NFCManager::SRIX_BLOCK_SIZE, [&]() {
+            return _nfc.writeSRIXBlocksSelective(blocks).success;
+        });
+    } else {
+        const uint16_t block_count = NFCManager::SRIX_DUMP_SIZE / NFCManager::SRIX_BLOCK_SIZE;
+        for (uint16_t block = SRIX_FIRST_DATA_BLOCK; block < block_count; block++) {
+            blocks.push_back(block);
+        }
+        measureWrites(results, name, options.iterations, blocks, NFCManager::SRIX_BLOCK_SIZE, [&]() {
+            return _nfc.writeSRIX(_nfc.currentTag(), options.timeout_sec).success;
+        });
+    }
+}
+
+// ============================================
+// SCENARIOS: MIFARE
+// ============================================
+
+void NFCBench::benchMifareRead(JsonArray results, const Options& options, bool use_cache) {
+    const char* name = use_cache ? "mifare_read" : "mifare_read_nocache";
+
+    // Untimed warm-up: creates the handler, fills the key cache for the hit case
+    NFCManager::TagInfo info;
+    if (!_nfc.readMifare(info, options.timeout_sec, false).success) {
+        skip(results, name, "no Mifare tag");
+        return;
+    }
+
+    _nfc.setMifareKeyCacheEnabled(use_cache);
+    measure(results, name, options.iterations, [&](uint32_t& bytes) {
+        NFCManager::TagInfo tag;
+        bool ok = _nfc.readMifare(tag, options.timeout_sec, false).success;
+        bytes = tag.size;
+        return ok;
+    });
+    _nfc.setMifareKeyCacheEnabled(true);
+}
+
+void NFCBench::benchMifareKeys(JsonArray results, const Options& options) {
+    const char* name = "mifare_keys";
+
+    NFCManager::TagInfo info;
+    if (!_nfc.readMifare(info, options.timeout_sec, false).success) {
+        skip(results, name, "no Mifare tag");
+        return;
+    }
+
+    bool key_a = true;
+    uint8_t real_key[MifareTool::MIFARE_KEY_SIZE];
+    if (!_nfc.getMifareSectorKey(KEY_PROBE_SECTOR, key_a, real_key)) {
+        skip(results, name, "probe sector not readable");
+        return;
+    }
+
+    uint8_t keys[MAX_PROBE_KEYS * MifareTool::MIFARE_KEY_SIZE];
+
+    for (const auto& probe : KEY_PROBES) {
+        // Decoys that cannot match, real key at the probe position
+        for (uint16_t i = 0; i < probe.db_size; i++) {
+            uint8_t* key = keys + i * MifareTool::MIFARE_KEY_SIZE;
+            const uint8_t decoy[MifareTool::MIFARE_KEY_SIZE] = {0xB3, 0x4C, 0x5A, 0x00,
+                                                                (uint8_t)(i >> 8), (uint8_t)i};
+            memcpy(key, decoy, sizeof(decoy));
+            if (memcmp(key, real_key, sizeof(decoy)) == 0) {
+                key[3] = 0xFF;
+            }
+        }
+        if (probe.position >= 0) {
+            memcpy(keys + probe.position * MifareTool::MIFARE_KEY_SIZE, real_key, sizeof(real_key));
+        }
+
+        JsonObject r = measure(results, name, options.iterations, [&](uint32_t& bytes) {
+            int found = -1;
+            int code = _nfc.probeMifareKeys(KEY_PROBE_SECTOR, key_a, keys, probe.db_size, found);
+            return code == MifareTool::SUCCESS && found == probe.position;
+        });
+        r["db_size"] = probe.db_size;
+        r["position"] = probe.position;
+        r["key"] = key_a ? "A" : "B";
+    }
+}
+
+void NFCBench::benchMifareWrite(JsonArray results, const Options& options, bool selective) {
+    const char* name = selective ? "mifare_write_selective" : "mifare_write";
+    if (!options.allow_write) {
+        skip(results, name, "writes not allowed");
+        return;
+    }
+
+    NFCManager::TagInfo info;
+    if (!_nfc.readMifare(info, options.timeout_sec, true).success) {
+        skip(results, name, "no Mifare tag");
+        return;
+    }
+
+    std::vector<uint8_t> blocks;
+    if (selective) {
+        blocks.assign(MIFARE_SELECTIVE_BLOCKS, MIFARE_SELECTIVE_BLOCKS + sizeof(MIFARE_SELECTIVE_BLOCKS));
+        measureWrites(results, name, options.iterations, blocks, NFCManager::MIFARE_BLOCK_SIZE, [&]() {
+            return _nfc.writeMifareBlocksSelective(blocks).success;
+        });
+    } else {
+        // Data blocks of the sectors the read opened (no UID block, no trailers)
+        for (uint16_t block = 1; block < info.size / NFCManager::MIFARE_BLOCK_SIZE; block++) {
+            bool key_a = true;
+            uint8_t key[MifareTool::MIFARE_KEY_SIZE];
+            if (!NFCDumpDiff::isMifareTrailer(block) &&
+                _nfc.getMifareSectorKey(mifareSectorOf(block), key_a, key)) {
+                blocks.push_back(block);
+            }
+        }
+        if (blocks.empty()) {
+            skip(results, name, "no readable data sector");
+            return;
+        }
+        measureWrites(results, name, options.iterations, blocks, NFCManager::MIFARE_BLOCK_SIZE, [&]() {
+            return _nfc.writeMifare(_nfc.currentTag(), options.timeout_sec).success;
+        });
+    }
+}
+
+// ============================================
+// SCENARIOS: STORAGE
+// ============================================
+
+void NFCBench::benchDump(JsonArray results, const Options& options, NFCManager::Protocol protocol) {
+    bool srix = (protocol == NFCManager::PROTOCOL_SRIX);
+    const char* folder = srix ? NFC_SRIX_DUMP_FOLDER : NFC_MIFARE_DUMP_FOLDER;
+    NFCManager::TagInfo image = makeImage(protocol);
+
+    for (uint8_t binary = 0; binary < 2; binary++) {
+        String filename = String("_bench") + (binary ? NFCDumpFile::EXTENSION : (srix ? ".srix" : ".mfc"));
+        String path = String(folder) + filename;
+        const char* format = binary ? "binary" : "text";
+        char name[40];
+
+        // Save: remove the previous copy first (SRIX would add a _N suffix)
+        snprintf(name, sizeof(name), "dump_%s_%s_save", srix ? "srix" : "mifare", format);
+        JsonObject r = measure(results, name, options.iterations,
+            [&]() { LittleFS.remove(path); },
+            [&](uint32_t& bytes) {
+                bytes = image.size;
+                return (srix ? _nfc.saveSRIX(image, filename) : _nfc.saveMifare(image, filename)).success;
+            });
+
+        File file = LittleFS.open(path, FILE_READ);
+        if (file) {
+            r["file_bytes"] = file.size();
+            file.close();
+        }
+
+        snprintf(name, sizeof(name), "dump_%s_%s_load", srix ? "srix" : "mifare", format);
+        measure(results, name, options.iterations, [&](uint32_t& bytes) {
+            NFCManager::TagInfo info;
+            bool ok = (srix ? _nfc.loadSRIX(info, filename) : _nfc.loadMifare(info, filename)).success;
+            bytes = info.size;
+            return ok;
+        });
+
+        _nfc.deleteFile(filename, protocol);
+    }
+}
+
+void NFCBench::benchBackup(JsonArray results, const Options& options) {
+    size_t entries = 0;
+
+    JsonObject r = measure(results, "backup", options.iterations, [&](uint32_t& bytes) {
+        ZipStream zip("/");
+        size_t n;
+        while ((n = zip.read(_chunk, sizeof(_chunk))) > 0) {
+            bytes += n;
+        }
+        entries = zip.entryCount();
+        return zip.done();
+    });
+    r["entries"] = entries;
+}
+
+NFCManager::TagInfo NFCBench::makeImage(NFCManager::Protocol protocol) {
+    NFCManager::TagInfo info;
+    info.protocol = protocol;
+    info.valid = true;
+    info.timestamp = millis();
+    info.dump = _image;
+
+    if (protocol == NFCManager::PROTOCOL_SRIX) {
+        static const uint8_t uid[8] = {0xD0, 0x02, 0x1A, 0x5E, 0x42, 0x7C, 0x13, 0x08};
+        info.type = NFCManager::TAG_SRIX4K;
+        memcpy(info.uid, uid, sizeof(uid));
+        info.uid_length = sizeof(uid);
+        info.size = NFCManager::SRIX_DUMP_SIZE;
+
+        for (size_t i = 0; i < info.size; i++) {
+            _image[i] = (uint8_t)(i * 31 + 7);
+        }
+        return info;
+    }
+
+    // Mifare Classic 1K: manufacturer block, patterned data, transport trailers
+    static const uint8_t uid[4] = {0xB1, 0xE7, 0x5C, 0x01};
+    static const uint8_t trailer[NFCManager::MIFARE_BLOCK_SIZE] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x07, 0x80, 0x69, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+    };
+    info.type = NFCManager::TAG_MIFARE_1K;
+    memcpy(info.uid, uid, sizeof(uid));
+    info.uid_length = sizeof(uid);
+    info.size = NFCManager::MIFARE_1K_DUMP_SIZE;
+
+    for (size_t i = 0; i < info.size; i++) {
+        _image[i] = (uint8_t)(i * 31 + 7);
+    }
+    for (size_t block = 3; block < info.size / NFCManager::MIFARE_BLOCK_SIZE; block += 4) {
+        memcpy(_image + block * NFCManager::MIFARE_BLOCK_SIZE, trailer, sizeof(trailer));
+    }
+    memcpy(_image, uid, sizeof(uid));
+    _image[4] = uid[0] ^ uid[1] ^ uid[2] ^ uid[3];  // BCC
+    _image[5] = 0x08;                               // SAK
+    _image[6] = 0x04;                               // ATQA
+    _image[7] = 0x00;
+    return info;
+}
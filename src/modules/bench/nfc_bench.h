@@ -0,0 +1,231 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+#include "modules/rfid/nfc_manager.h"
+#include "logger.h"
+
+/**
+ * @brief NFCBench - Repeatable on-device benchmarks for NFC and storage paths
+ *
+ * Runs fixed scenarios N times and reports throughput, latency
+ * percentiles and peak heap use as JSON, so results from different
+ * firmware builds can be collected and compared (e.g. by a
+ * hardware-in-the-loop rig polling the job API).
+ *
+ * Scenarios:
+ * - srix_read / mifare_read            Full tag reads (tag in field)
+ * - mifare_read_nocache                Reads with the key cache bypassed (miss path)
+ * - mifare_keys                        Key search cost by database size and key position
+ * - srix_write / mifare_write          Full write path, every user data block changed (needs "write")
+ * - srix_write_selective / mifare_...  Selective write of a few data blocks, all changed (needs "write")
+ * - dump_srix / dump_mifare            Save/load of a synthetic dump, text vs .nfcb
+ * - backup                             Full filesystem ZIP generation (discarded)
+ *
+ * Groups: "storage" (default, no tag needed), "srix", "mifare", "all".
+ *
+ * Side effects:
+ * - The loaded dump is saved before the run and restored afterwards
+ * - Write scenarios alternate the tag between its own content and a copy
+ *   with the user data blocks inverted (SRIX blocks 0-6, Mifare block 0
+ *   and sector trailers are never changed), then write the original back.
+ *   Writing unchanged data would measure the skip-unchanged pre-read
+ *   instead of EEPROM writes, so every timed write changes its blocks.
+ * - Storage scenarios create and delete _bench.* files in the dump folders
+ *
+ * Thread Safety:
+ * - One run at a time (run() refuses while another is active)
+ * - Runs on the NFC job worker (JOB_BENCH), which owns the PN532: both the
+ *   web API and the serial "system bench" command submit a job
+ *
+ * Usage:
+ * @code
+ * NFCBench bench(nfcMgr);
+ * NFCBench::Options options = {NFCBench::GROUP_STORAGE, 10, 10, false};
+ * JsonDocument report;
+ * bench.run(options, report);
+ * @endcode
+ */
+class NFCBench {
+public:
+    // ============================================
+    // TYPES
+    // ============================================
+
+    /**
+     * @brief Benchmark scenarios (bit index in Options::scenarios)
+     */
+    enum Scenario : uint8_t {
+        BENCH_SRIX_READ = 0,
+        BENCH_SRIX_WRITE,
+        BENCH_SRIX_WRITE_SELECTIVE,
+        BENCH_MIFARE_READ,
+        BENCH_MIFARE_READ_NOCACHE,
+        BENCH_MIFARE_KEYS,
+        BENCH_MIFARE_WRITE,
+        BENCH_MIFARE_WRITE_SELECTIVE,
+        BENCH_DUMP_SRIX,
+        BENCH_DUMP_MIFARE,
+        BENCH_BACKUP,
+        BENCH_SCENARIO_COUNT
+    };
+
+    /**
+     * @brief Run parameters
+     */
+    struct Options {
+        uint32_t scenarios;             ///< Bitmask of (1 << Scenario)
+        uint8_t iterations;             ///< Repetitions per scenario (1..MAX_ITERATIONS)
+        int timeout_sec;                ///< Tag detection timeout per NFC operation
+        bool allow_write;               ///< Write scenarios are skipped unless set
+    };
+
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr uint8_t DEFAULT_ITERATIONS = 10;
+    static constexpr uint8_t MAX_ITERATIONS = 50;              // Latency samples kept per scenario
+    static constexpr int DEFAULT_TIMEOUT_SEC = 5;
+    static constexpr size_t BACKUP_CHUNK_SIZE = 1436;          // One TCP segment, like the HTTP filler
+    static constexpr uint8_t KEY_PROBE_SECTOR = 1;             // Sector used for key search runs
+    static constexpr uint16_t MAX_PROBE_KEYS = 32;             // Largest simulated key database
+
+    static constexpr uint32_t GROUP_SRIX =
+        (1UL << BENCH_SRIX_READ) | (1UL << BENCH_SRIX_WRITE) | (1UL << BENCH_SRIX_WRITE_SELECTIVE);
+    static constexpr uint32_t GROUP_MIFARE =
+        (1UL << BENCH_MIFARE_READ) | (1UL << BENCH_MIFARE_READ_NOCACHE) | (1UL << BENCH_MIFARE_KEYS) |
+        (1UL << BENCH_MIFARE_WRITE) | (1UL << BENCH_MIFARE_WRITE_SELECTIVE);
+    static constexpr uint32_t GROUP_STORAGE =
+        (1UL << BENCH_DUMP_SRIX) | (1UL << BENCH_DUMP_MIFARE) | (1UL << BENCH_BACKUP);
+    static constexpr uint32_t GROUP_ALL = GROUP_SRIX | GROUP_MIFARE | GROUP_STORAGE;
+
+    // ============================================
+    // PUBLIC METHODS
+    // ============================================
+
+    /**
+     * @brief Construct bench runner
+     * @param nfc NFC manager to exercise
+     */
+    explicit NFCBench(NFCManager& nfc);
+
+    /**
+     * @brief Run the selected scenarios
+     * @param options Scenarios, iterations, timeout, write permission
+     * @param out Report: {success, message, build, cpu_mhz, iterations, free_heap, results:[...]}
+     * @return false if nothing ran (another run active, empty selection)
+     *
+     * Each result: {name, ok, failed, total_ms, ops_per_sec, bytes_per_sec,
+     * min_us, p50_us, p95_us, max_us, mean_us, heap_peak}. Scenarios that
+     * cannot run report {name, skipped: reason}.
+     */
+    bool run(const Options& options, JsonDocument& out);
+
+    /**
+     * @brief Parse a scenario list ("srix_read,backup", "storage", "all")
+     * @param list Names or group names, separated by commas or spaces
+     * @param mask Output bitmask
+     * @return false if a name is unknown (mask holds the known ones)
+     */
+    static bool parseScenarios(const String& list, uint32_t& mask);
+
+    /**
+     * @brief Scenario name (e.g. "mifare_keys")
+     */
+    static const char* scenarioName(Scenario scenario);
+
+    /**
+     * @brief Check if a run is active
+     */
+    static bool isRunning() { return _running.load(); }
+
+private:
+    // ============================================
+    // MEASUREMENT
+    // ============================================
+
+    /**
+     * @brief Samples of the scenario being measured
+     */
+    struct Series {
+        uint32_t latency_us[MAX_ITERATIONS];
+        uint8_t ok;                     // Successful iterations (latency samples)
+        uint8_t failed;                 // Failed iterations
+        uint32_t bytes;                 // Payload bytes of successful iterations
+        uint32_t total_us;              // Sum of all iteration times
+        uint32_t heap_start;            // Free heap before the first iteration
+        uint32_t heap_min;              // Lowest free heap seen (sampling fallback)
+    };
+
+    /**
+     * @brief Time `iterations` calls of op and append the result
+     * @param op Callable bool(uint32_t& bytes): one iteration, true on success
+     * @return Result object (for scenario-specific fields)
+     *
+     * Stops early if the first iteration fails (no tag, setup error), so a
+     * missing tag costs one timeout instead of `iterations`.
+     */
+    template <typename Op>
+    JsonObject measure(JsonArray results, const char* name, uint8_t iterations, Op op);
+
+    /**
+     * @brief measure() with an untimed prepare() before every iteration
+     */
+    template <typename Prepare, typename Op>
+    JsonObject measure(JsonArray results, const char* name, uint8_t iterations,
+                       Prepare prepare, Op op);
+
+    /**
+     * @brief Append {name, skipped: reason}
+     */
+    void skip(JsonArray results, const char* name, const char* reason);
+
+    // ============================================
+    // SCENARIOS
+    // ============================================
+
+    void benchSrixRead(JsonArray results, const Options& options);
+    void benchSrixWrite(JsonArray results, const Options& options, bool selective);
+    void benchMifareRead(JsonArray results, const Options& options, bool use_cache);
+    void benchMifareKeys(JsonArray results, const Options& options);
+    void benchMifareWrite(JsonArray results, const Options& options, bool selective);
+
+    /**
+     * @brief Time writes that each change `blocks` on the tag
+     * @param blocks Blocks inverted every iteration (current tag = tag just read)
+     * @param block_size Protocol block size
+     * @param write Callable bool(): writes the current tag
+     *
+     * An untimed prepare() toggles the pattern and makes it the current
+     * tag, so iterations alternate inverted/original. The original is
+     * written back (untimed) afterwards. Result gets "blocks" and "restored".
+     */
+    template <typename Write>
+    void measureWrites(JsonArray results, const char* name, uint8_t iterations,
+                       const std::vector<uint8_t>& blocks, uint8_t block_size, Write write);
+    void benchDump(JsonArray results, const Options& options, NFCManager::Protocol protocol);
+    void benchBackup(JsonArray results, const Options& options);
+
+    /**
+     * @brief Fill the synthetic image with a plausible SRIX or Mifare 1K dump
+     * @return TagInfo pointing at the image
+     */
+    NFCManager::TagInfo makeImage(NFCManager::Protocol protocol);
+
+    // ============================================
+    // STATE
+    // ============================================
+
+    NFCManager& _nfc;
+    Series _series;
+
+    // Shared by every instance (one run at a time)
+    static std::atomic<bool> _running;
+    static NFCManager::TagInfo _saved_tag;                          // Loaded dump before the run
+    static uint8_t _saved_dump[NFCManager::MIFARE_4K_DUMP_SIZE];
+    static uint8_t _image[NFCManager::MIFARE_1K_DUMP_SIZE];         // Synthetic dump for storage runs
+    static uint8_t _pattern[NFCManager::MIFARE_4K_DUMP_SIZE];       // Write runs: tag content, toggled
+    static uint8_t _chunk[BACKUP_CHUNK_SIZE];                       // Backup output (discarded)
+};
@@ -0,0 +1,114 @@
+#include "boot_profile.h"
+
+// ============================================
+// STORAGE
+// ============================================
+
+BootProfile::Entry BootProfile::_entries[STAGE_COUNT] = {};
+std::atomic<uint8_t> BootProfile::_paths_left(BOOT_PATHS);
+
+static const char* const STAGE_NAMES[BootProfile::STAGE_COUNT] = {
+    "logger", "filesystem", "web_routes", "i2c", "nfc", "commands", "keys", "wifi", "web_listen"
+};
+
+// ============================================
+// PUBLIC METHODS
+// ============================================
+
+void BootProfile::begin(Stage stage) {
+    if (stage >= STAGE_COUNT) {
+        return;
+    }
+
+    Entry& e = _entries[stage];
+    e.start_ms = millis();
+    e.end_ms = e.start_ms;
+    e.core = xPortGetCoreID();
+    e.started = true;
+    e.done = false;
+}
+
+void BootProfile::end(Stage stage) {
+    if (stage >= STAGE_COUNT || !_entries[stage].started) {
+        return;
+    }
+
+    Entry& e = _entries[stage];
+    e.end_ms = millis();
+    e.done = true;
+    LOG_DEBUG("BOOT", "%s: %lu ms (core %u)", stageName(stage),
+              (unsigned long)(e.end_ms - e.start_ms), e.core);
+}
+
+bool BootProfile::complete() {
+    if (_paths_left.load() == 0) {
+        return false;
+    }
+    if (_paths_left.fetch_sub(1) != 1) {
+        return false;
+    }
+
+    report();
+    return true;
+}
+
+bool BootProfile::get(Stage stage, Entry& out) {
+    if (stage >= STAGE_COUNT || !_entries[stage].started) {
+        return false;
+    }
+    out = _entries[stage];
+    return true;
+}
+
+const char* BootProfile::stageName(Stage stage) {
+    return stage < STAGE_COUNT ? STAGE_NAMES[stage] : "unknown";
+}
+
+void BootProfile::report() {
+    LOG_INFO("BOOT", "Stage          Start    Time  Core");
+    for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+        const Entry& e = _entries[i];
+        if (!e.started) {
+            continue;
+        }
+        if (e.done) {
+            LOG_INFO("BOOT", "%-12s %7lu %7lu  %u", STAGE_NAMES[i],
+                     (unsigned long)e.start_ms, (unsigned long)(e.end_ms - e.start_ms), e.core);
+        } else {
+            LOG_INFO("BOOT", "%-12s %7lu    open  %u", STAGE_NAMES[i], (unsigned long)e.start_ms, e.core);
+        }
+    }
+
+    LOG_INFO("BOOT", "Serial commands ready at %lu ms, network at %lu ms (since power-on)",
+             (unsigned long)readyAt(STAGE_COMMANDS), (unsigned long)readyAt(STAGE_WEB_LISTEN));
+}
+
+void BootProfile::toJson(JsonObject obj) {
+    obj["finished"] = finished();
+    obj["commands_ready_ms"] = readyAt(STAGE_COMMANDS);
+    obj["network_ready_ms"] = readyAt(STAGE_WEB_LISTEN);
+
+    JsonArray stages = obj["stages"].to<JsonArray>();
+    for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+        const Entry& e = _entries[i];
+        if (!e.started) {
+            continue;
+        }
+
+        JsonObject stage = stages.add<JsonObject>();
+        stage["name"] = STAGE_NAMES[i];
+        stage["start_ms"] = e.start_ms;
+        stage["duration_ms"] = e.done ? e.end_ms - e.start_ms : 0;
+        stage["core"] = e.core;
+        stage["done"] = e.done;
+    }
+}
+
+// ============================================
+// INTERNAL
+// ============================================
+
+uint32_t BootProfile::readyAt(Stage stage) {
+    const Entry& e = _entries[stage];
+    return e.done ? e.end_ms : 0;
+}
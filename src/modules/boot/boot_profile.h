@@ -0,0 +1,132 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+#include "logger.h"
+
+/**
+ * @brief Boot stage timings
+ *
+ * Features:
+ * - Start/end time (millis() since power-on) and core of every boot stage
+ * - Time-to-ready markers: serial commands accepted, network up
+ * - One report logged once every boot path has finished
+ * - Kept for "sys boot" and /api/metrics
+ *
+ * Architecture:
+ * - Static singleton pattern (no instance needed)
+ * - Boot runs on two paths: setup() (storage, NFC, commands, keys) and
+ *   the network task (WiFi association, web server); each stage is
+ *   written by exactly one of them
+ * - Each path calls complete() when done, the last one logs the report
+ *
+ * Usage:
+ * @code
+ * BootProfile::begin(BootProfile::STAGE_NFC);
+ * nfcMgr.begin();
+ * BootProfile::end(BootProfile::STAGE_NFC);
+ * ...
+ * if (BootProfile::complete()) { ... }   // From each boot path, true for the last
+ * @endcode
+ */
+class BootProfile {
+public:
+    // ============================================
+    // TYPES
+    // ============================================
+
+    /**
+     * @brief Boot stages, in report order
+     */
+    enum Stage : uint8_t {
+        STAGE_LOGGER = 0,           ///< Serial port and logger
+        STAGE_FILESYSTEM,           ///< LittleFS mount
+        STAGE_WEB_ROUTES,           ///< Routes and NFC job engines (no listening yet)
+        STAGE_I2C,                  ///< I2C bus
+        STAGE_NFC,                  ///< PN532 reader(s)
+        STAGE_COMMANDS,             ///< Serial commander task
+        STAGE_KEYS,                 ///< Mifare key database
+        STAGE_WIFI,                 ///< Saved network, serial prompt or AP fallback
+        STAGE_WEB_LISTEN,           ///< AsyncWebServer listening
+        STAGE_COUNT
+    };
+
+    /**
+     * @brief One stage's timing
+     */
+    struct Entry {
+        uint32_t start_ms;          ///< millis() at begin()
+        uint32_t end_ms;            ///< millis() at end()
+        uint8_t core;               ///< Core the stage ran on
+        bool started;               ///< begin() called
+        bool done;                  ///< end() called
+    };
+
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr uint8_t BOOT_PATHS = 2;                    // setup() + network task
+
+    // ============================================
+    // PUBLIC METHODS
+    // ============================================
+
+    /**
+     * @brief Mark a stage started
+     */
+    static void begin(Stage stage);
+
+    /**
+     * @brief Mark a stage finished and log its duration
+     */
+    static void end(Stage stage);
+
+    /**
+     * @brief Mark one boot path finished
+     * @return true for the last of BOOT_PATHS calls (report logged)
+     */
+    static bool complete();
+
+    /**
+     * @brief Check if every boot path has finished
+     */
+    static bool finished() { return _paths_left.load() == 0; }
+
+    /**
+     * @brief Check if a stage has finished (e.g. STAGE_WIFI before "wifi" commands)
+     */
+    static bool isDone(Stage stage) { return readyAt(stage) != 0; }
+
+    /**
+     * @brief Get a stage's timing
+     * @return false if the stage never started
+     */
+    static bool get(Stage stage, Entry& out);
+
+    /**
+     * @brief Short stage name ("nfc", "wifi", ...)
+     */
+    static const char* stageName(Stage stage);
+
+    /**
+     * @brief Log the stage table and time-to-ready markers
+     */
+    static void report();
+
+    /**
+     * @brief Add stages and markers to a JSON object
+     * @param obj Target ("boot" object of /api/metrics)
+     */
+    static void toJson(JsonObject obj);
+
+private:
+    static Entry _entries[STAGE_COUNT];
+    static std::atomic<uint8_t> _paths_left;
+
+    /**
+     * @brief End time of a finished stage, 0 otherwise
+     */
+    static uint32_t readyAt(Stage stage);
+};
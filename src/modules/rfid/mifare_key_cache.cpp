@@ -0,0 +1,214 @@
+#include "mifare_key_cache.h"
+#include "nfc_reader.h"
+
+// ============================================
+// PUBLIC METHODS
+// ============================================
+
+bool MifareKeyCache::lookup(IdKind kind, const uint8_t* id, uint8_t id_len, Entry& out) {
+    NFCSharedLock lock;
+
+    memset(&out, 0, sizeof(out));
+    
+    if (id_len == 0 || id_len > MAX_ID_SIZE || !LittleFS.exists(CACHE_PATH)) {
+        return false;
+    }
+    
+    File file = LittleFS.open(CACHE_PATH, FILE_READ);
+    if (!file) {
+        LOG_ERROR("MFC-CACHE", "Failed to open cache: %s", CACHE_PATH);
+        return false;
+    }
+    
+    int match, victim;
+    uint32_t next_stamp;
+    scan(file, kind, id, id_len, match, victim, next_stamp);
+    
+    bool found = false;
+    if (match >= 0) {
+        file.seek((size_t)match * sizeof(Record) + HEADER_SIZE);
+        found = (file.read((uint8_t*)&out, sizeof(Entry)) == sizeof(Entry));
+    }
+    
+    file.close();
+    
+    LOG_DEBUG("MFC-CACHE", "Lookup kind %d: %s", kind, found ? "hit" : "miss");
+    return found;
+}
+
+bool MifareKeyCache::store(IdKind kind, const uint8_t* id, uint8_t id_len, const Entry& keys) {
+    NFCSharedLock lock;
+
+    if (id_len == 0 || id_len > MAX_ID_SIZE) {
+        return false;
+    }
+    
+    // "r+" needs an existing file
+    if (!LittleFS.exists(CACHE_PATH)) {
+        File create = LittleFS.open(CACHE_PATH, FILE_WRITE);
+        if (!create) {
+            LOG_ERROR("MFC-CACHE", "Failed to create cache: %s", CACHE_PATH);
+            return false;
+        }
+        create.close();
+    }
+    
+    File file = LittleFS.open(CACHE_PATH, "r+");
+    if (!file) {
+        LOG_ERROR("MFC-CACHE", "Failed to open cache: %s", CACHE_PATH);
+        return false;
+    }
+    
+    int match, victim;
+    uint32_t next_stamp;
+    scan(file, kind, id, id_len, match, victim, next_stamp);
+    
+    Record record;
+    memset(&record, 0, sizeof(record));
+    int index = victim;
+    
+    if (match >= 0) {
+        index = match;
+        file.seek((size_t)match * sizeof(Record));
+        if (file.read((uint8_t*)&record, sizeof(Record)) != sizeof(Record)) {
+            memset(&record, 0, sizeof(record));
+        }
+    }
+    
+    // Merge: learned keys overwrite, unknown sectors keep cached keys
+    bool changed = (match < 0);
+    for (uint8_t s = 0; s < MAX_SECTORS; s++) {
+        if ((keys.flags[s] & FLAG_KEY_A) &&
+            (!(record.keys.flags[s] & FLAG_KEY_A) || memcmp(record.keys.key_a[s], keys.key_a[s], KEY_SIZE) != 0)) {
+            memcpy(record.keys.key_a[s], keys.key_a[s], KEY_SIZE);
+            record.keys.flags[s] |= FLAG_KEY_A;
+            changed = true;
+        }
+        if ((keys.flags[s] & FLAG_KEY_B) &&
+            (!(record.keys.flags[s] & FLAG_KEY_B) || memcmp(record.keys.key_b[s], keys.key_b[s], KEY_SIZE) != 0)) {
+            memcpy(record.keys.key_b[s], keys.key_b[s], KEY_SIZE);
+            record.keys.flags[s] |= FLAG_KEY_B;
+            changed = true;
+        }
+    }
+    
+    if (!changed) {
+        file.close();
+        LOG_DEBUG("MFC-CACHE", "Store kind %d: already up to date", kind);
+        return false;
+    }
+    
+    record.kind = kind;
+    record.id_len = id_len;
+    memset(record.id, 0, MAX_ID_SIZE);
+    memcpy(record.id, id, id_len);
+    record.stamp = next_stamp;
+    
+    file.seek((size_t)index * sizeof(Record));
+    bool ok = (file.write((const uint8_t*)&record, sizeof(Record)) == sizeof(Record));
+    file.close();
+    
+    if (!ok) {
+        LOG_ERROR("MFC-CACHE", "Write failed (record %d)", index);
+        return false;
+    }
+    
+    LOG_INFO("MFC-CACHE", "Stored keys (kind %d, record %d%s)",
+             kind, index, match >= 0 ? ", merged" : "");
+    return true;
+}
+
+uint32_t MifareKeyCache::fingerprint(const uint8_t* block0, uint8_t uid_len) {
+    // 4-byte UID: UID + BCC occupy bytes 0-4; 7-byte UID: bytes 0-6
+    uint8_t first = (uid_len == 4) ? 5 : uid_len;
+    
+    uint32_t hash = 2166136261UL;           // FNV-1a offset basis
+    for (uint8_t i = first; i < 16; i++) {
+        hash ^= block0[i];
+        hash *= 16777619UL;                 // FNV-1a prime
+    }
+    return hash;
+}
+
+size_t MifareKeyCache::count() {
+    NFCSharedLock lock;
+
+    if (!LittleFS.exists(CACHE_PATH)) {
+        return 0;
+    }
+    
+    File file = LittleFS.open(CACHE_PATH, FILE_READ);
+    if (!file) {
+        return 0;
+    }
+    
+    size_t used = 0;
+    size_t records = file.size() / sizeof(Record);
+    for (size_t i = 0; i < records; i++) {
+        file.seek(i * sizeof(Record));
+        if (file.read() != ID_FREE) used++;
+    }
+    
+    file.close();
+    return used;
+}
+
+void MifareKeyCache::clear() {
+    NFCSharedLock lock;
+
+    if (LittleFS.exists(CACHE_PATH) && LittleFS.remove(CACHE_PATH)) {
+        LOG_INFO("MFC-CACHE", "Key cache cleared");
+    }
+}
+
+// ============================================
+// PRIVATE METHODS
+// ============================================
+
+int MifareKeyCache::scan(File& file, IdKind kind, const uint8_t* id, uint8_t id_len,
+                         int& match, int& victim, uint32_t& next_stamp) {
+    int records = file.size() / sizeof(Record);
+    uint32_t oldest_stamp = UINT32_MAX;
+    uint32_t newest_stamp = 0;
+    int free_slot = -1;
+    int oldest = -1;
+    
+    match = -1;
+    
+    Record header;
+    for (int i = 0; i < records; i++) {
+        file.seek((size_t)i * sizeof(Record));
+        if (file.read((uint8_t*)&header, HEADER_SIZE) != HEADER_SIZE) {
+            records = i;
+            break;
+        }
+        
+        if (header.kind == ID_FREE) {
+            if (free_slot < 0) free_slot = i;
+            continue;
+        }
+        
+        if (header.stamp > newest_stamp) newest_stamp = header.stamp;
+        if (header.stamp < oldest_stamp) {
+            oldest_stamp = header.stamp;
+            oldest = i;
+        }
+        
+        if (match < 0 && header.kind == kind && header.id_len == id_len &&
+            memcmp(header.id, id, id_len) == 0) {
+            match = i;
+        }
+    }
+    
+    // Free slot, then append, then recycle least recently stored
+    if (free_slot >= 0) {
+        victim = free_slot;
+    } else if (records < MAX_RECORDS) {
+        victim = records;
+    } else {
+        victim = (oldest >= 0) ? oldest : 0;
+    }
+    
+    next_stamp = newest_stamp + 1;
+    return records;
+}
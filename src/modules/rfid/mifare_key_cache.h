@@ -0,0 +1,148 @@
+#ifndef __MIFARE_KEY_CACHE_H__
+#define __MIFARE_KEY_CACHE_H__
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "logger.h"
+
+/**
+ * @brief Persistent per-card Mifare sector key cache
+ * 
+ * Features:
+ * - Remembers which Key A / Key B opened each sector of a card
+ * - Keyed by UID, plus a manufacturer-block fingerprint so cards from
+ *   the same batch/site can reuse keys learned on a sibling card
+ * - Fixed-size binary records in a single LittleFS file (no per-card
+ *   files: LittleFS spends a 4KB block per file)
+ * - Least-recently-learned record is recycled when the file is full
+ * 
+ * Architecture:
+ * - Static singleton pattern (no instance needed)
+ * - Shared by every reader: public calls hold NFCSharedLock
+ * - Records stored in /mfc_keycache.bin (MAX_RECORDS x sizeof(Record))
+ * - Lookups scan record headers only; store() merges into the match
+ * 
+ * Usage:
+ * @code
+ * MifareKeyCache::Entry entry;
+ * if (MifareKeyCache::lookup(MifareKeyCache::ID_UID, uid, uid_len, entry)) {
+ *     if (entry.flags[sector] & MifareKeyCache::FLAG_KEY_A) { ... entry.key_a[sector] ... }
+ * }
+ * MifareKeyCache::store(MifareKeyCache::ID_UID, uid, uid_len, entry);
+ * @endcode
+ */
+class MifareKeyCache {
+public:
+    // ============================================
+    // CONSTANTS
+    // ============================================
+    
+    static constexpr const char* CACHE_PATH = "/mfc_keycache.bin";
+    static constexpr uint8_t MAX_SECTORS = 40;          // Mifare Classic 4K
+    static constexpr uint8_t KEY_SIZE = 6;              // Bytes per key
+    static constexpr uint8_t MAX_ID_SIZE = 10;          // Longest UID
+    static constexpr uint8_t MAX_RECORDS = 64;          // ~34KB file at most
+    
+    // Per-sector flags
+    static constexpr uint8_t FLAG_KEY_A = 0x01;         // key_a[sector] opens the sector
+    static constexpr uint8_t FLAG_KEY_B = 0x02;         // key_b[sector] opens the sector
+    
+    // ============================================
+    // TYPES
+    // ============================================
+    
+    /**
+     * @brief What a record is keyed by
+     */
+    enum IdKind : uint8_t {
+        ID_FREE = 0,            ///< Unused record
+        ID_UID,                 ///< Card UID (4/7/10 bytes)
+        ID_FINGERPRINT          ///< Manufacturer block fingerprint (4 bytes)
+    };
+    
+    /**
+     * @brief Known keys for one card
+     */
+    struct Entry {
+        uint8_t flags[MAX_SECTORS];                 ///< FLAG_KEY_A / FLAG_KEY_B per sector
+        uint8_t key_a[MAX_SECTORS][KEY_SIZE];       ///< Key A per sector
+        uint8_t key_b[MAX_SECTORS][KEY_SIZE];       ///< Key B per sector
+    };
+    
+    // ============================================
+    // PUBLIC METHODS
+    // ============================================
+    
+    /**
+     * @brief Find cached keys for a card
+     * @param kind ID_UID or ID_FINGERPRINT
+     * @param id Identifier bytes
+     * @param id_len Identifier length (max MAX_ID_SIZE)
+     * @param out Entry to fill (cleared when not found)
+     * @return true if a record exists
+     */
+    static bool lookup(IdKind kind, const uint8_t* id, uint8_t id_len, Entry& out);
+    
+    /**
+     * @brief Merge learned keys into the cache
+     * @param kind ID_UID or ID_FINGERPRINT
+     * @param id Identifier bytes
+     * @param id_len Identifier length (max MAX_ID_SIZE)
+     * @param keys Keys to merge (only flagged sectors are written)
+     * @return true if written (false if nothing new or on FS error)
+     */
+    static bool store(IdKind kind, const uint8_t* id, uint8_t id_len, const Entry& keys);
+    
+    /**
+     * @brief Fingerprint of the manufacturer part of block 0
+     * @param block0 16-byte block 0
+     * @param uid_len UID length (4 or 7)
+     * @return FNV-1a hash of the bytes after UID/BCC (SAK, ATQA, manufacturer data)
+     */
+    static uint32_t fingerprint(const uint8_t* block0, uint8_t uid_len);
+    
+    /**
+     * @brief Count used records
+     */
+    static size_t count();
+    
+    /**
+     * @brief Delete the cache file
+     */
+    static void clear();
+
+private:
+    // ============================================
+    // RECORD LAYOUT
+    // ============================================
+    
+    struct __attribute__((packed)) Record {
+        uint8_t kind;               // IdKind
+        uint8_t id_len;             // Valid bytes in id
+        uint8_t id[MAX_ID_SIZE];    // UID or fingerprint
+        uint32_t stamp;             // Store sequence (LRU)
+        Entry keys;                 // Known keys
+    };
+    
+    static constexpr size_t HEADER_SIZE = offsetof(Record, keys);  // Bytes scanned per lookup
+    
+    // ============================================
+    // PRIVATE METHODS
+    // ============================================
+    
+    /**
+     * @brief Scan file for a record and LRU bookkeeping
+     * @param file Open cache file
+     * @param kind Identifier kind
+     * @param id Identifier bytes
+     * @param id_len Identifier length
+     * @param match Output: matching record index or -1
+     * @param victim Output: free or least-recently-stored record index
+     * @param next_stamp Output: stamp to use for the next store
+     * @return Number of records in file
+     */
+    static int scan(File& file, IdKind kind, const uint8_t* id, uint8_t id_len,
+                    int& match, int& victim, uint32_t& next_stamp);
+};
+
+#endif // __MIFARE_KEY_CACHE_H__
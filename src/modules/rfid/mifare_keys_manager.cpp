@@ -1,11 +1,16 @@
 #include "mifare_keys_manager.h"
+#include "nfc_reader.h"
+#include <algorithm>
 
 // ============================================
 // STATIC MEMBER INITIALIZATION
 // ============================================
 
-std::set<String> MifareKeysManager::_keys;
+std::vector<MifareKeysManager::KeyEntry> MifareKeysManager::_keys;
 bool MifareKeysManager::_loaded = false;
+bool MifareKeysManager::_stats_dirty = false;
+uint16_t MifareKeysManager::_pending_hits = 0;
+uint32_t MifareKeysManager::_dirty_since_ms = 0;
 
 // ============================================
 // PUBLIC METHODS
@@ -31,6 +36,8 @@ bool MifareKeysManager::begin() {
 }
 
 void MifareKeysManager::ensureLoaded() {
+    NFCSharedLock lock;
+
     if (_loaded) {
         return;
     }
@@ -43,10 +50,20 @@ void MifareKeysManager::ensureLoaded() {
         createDefaultFile();
     }
 
+    loadStats();
     _loaded = true;
 }
 
+void MifareKeysManager::snapshot(std::vector<KeyEntry>& out) {
+    NFCSharedLock lock;
+
+    ensureLoaded();
+    out.assign(_keys.begin(), _keys.end());
+}
+
 bool MifareKeysManager::addKey(const String& key) {
+    NFCSharedLock lock;
+
     // Clean and normalize key
     String cleanKey = key;
     cleanKey.toUpperCase();
@@ -60,14 +77,11 @@ bool MifareKeysManager::addKey(const String& key) {
 
     ensureLoaded();
 
-    // Check for duplicates (std::set handles this automatically)
-    if (_keys.find(cleanKey) != _keys.end()) {
+    // Add to in-memory array (rejects duplicates)
+    if (!insertKey(cleanKey)) {
         LOG_DEBUG("MFC-KEYS", "Key already exists: %s", cleanKey.c_str());
         return false;
     }
-
-    // Add to in-memory set
-    _keys.insert(cleanKey);
     
     // Append to file
     appendToFile(cleanKey);
@@ -77,19 +91,24 @@ bool MifareKeysManager::addKey(const String& key) {
 }
 
 bool MifareKeysManager::removeKey(const String& key) {
+    NFCSharedLock lock;
+
     ensureLoaded();
 
-    auto it = _keys.find(key);
-    if (it == _keys.end()) {
+    uint8_t bytes[KEY_BYTE_LENGTH];
+    int index = isValidHexKey(key) && keyToBytes(key, bytes) ? indexOf(bytes) : -1;
+    if (index < 0) {
         LOG_WARN("MFC-KEYS", "Key not found: %s", key.c_str());
         return false;
     }
 
-    // Remove from in-memory set
-    _keys.erase(it);
+    // Remove from in-memory array (order of the rest is preserved)
+    _keys.erase(_keys.begin() + index);
     
     // Rewrite entire file (necessary for removal)
     saveToFile();
+    _stats_dirty = true;
+    flushStats();
     
     LOG_INFO("MFC-KEYS", "Key removed: %s", key.c_str());
     return true;
@@ -97,12 +116,95 @@ bool MifareKeysManager::removeKey(const String& key) {
 
 bool MifareKeysManager::hasKey(const String& key) {
     ensureLoaded();
-    return _keys.find(key) != _keys.end();
+    
+    uint8_t bytes[KEY_BYTE_LENGTH];
+    if (!isValidHexKey(key) || !keyToBytes(key, bytes)) {
+        return false;
+    }
+    return indexOf(bytes) >= 0;
+}
+
+void MifareKeysManager::recordHit(const uint8_t* key) {
+    NFCSharedLock lock;
+
+    int index = indexOf(key);
+    if (index < 0) {
+        return;
+    }
+    
+    if (_keys[index].hits < MAX_HITS) {
+        _keys[index].hits++;
+        if (!_stats_dirty) {
+            _stats_dirty = true;
+            _dirty_since_ms = millis();
+        }
+        if (_pending_hits < STATS_FLUSH_HITS) {
+            _pending_hits++;
+        }
+    }
+    
+    // Bubble up: array stays sorted by hits (descending), ties keep file order
+    while (index > 0 && _keys[index - 1].hits < _keys[index].hits) {
+        KeyEntry tmp = _keys[index - 1];
+        _keys[index - 1] = _keys[index];
+        _keys[index] = tmp;
+        index--;
+    }
+}
+
+void MifareKeysManager::saveStats() {
+    // Unlocked peek: loop() calls this every tick, readers may hold the lock
+    if (!_stats_dirty) {
+        return;
+    }
+
+    NFCSharedLock lock;
+
+    if (_pending_hits < STATS_FLUSH_HITS && millis() - _dirty_since_ms < STATS_FLUSH_INTERVAL_MS) {
+        return;
+    }
+    flushStats();
+}
+
+void MifareKeysManager::flushStats() {
+    NFCSharedLock lock;
+
+    if (!_stats_dirty) {
+        return;
+    }
+    
+    File file = LittleFS.open(HITS_PATH, FILE_WRITE);
+    if (!file) {
+        LOG_ERROR("MFC-KEYS", "Failed to save hit counters: %s", HITS_PATH);
+        return;
+    }
+    
+    // Record: 6 key bytes + uint16 hits (little endian); zero-hit keys are implicit
+    int saved = 0;
+    for (const auto& entry : _keys) {
+        if (entry.hits == 0) continue;
+        uint8_t record[KEY_BYTE_LENGTH + 2];
+        memcpy(record, entry.key, KEY_BYTE_LENGTH);
+        record[KEY_BYTE_LENGTH] = entry.hits & 0xFF;
+        record[KEY_BYTE_LENGTH + 1] = entry.hits >> 8;
+        file.write(record, sizeof(record));
+        saved++;
+    }
+    
+    file.close();
+    _stats_dirty = false;
+    _pending_hits = 0;
+    
+    LOG_DEBUG("MFC-KEYS", "Saved hit counters for %d keys", saved);
 }
 
 void MifareKeysManager::clear() {
-    // Clear in-memory set
+    NFCSharedLock lock;
+
+    // Clear in-memory array
     _keys.clear();
+    _stats_dirty = false;
+    _pending_hits = 0;
 
     // Delete file if exists
     if (LittleFS.exists(KEYS_PATH)) {
@@ -112,6 +214,10 @@ void MifareKeysManager::clear() {
             LOG_ERROR("MFC-KEYS", "Failed to delete keys file");
         }
     }
+    
+    if (LittleFS.exists(HITS_PATH)) {
+        LittleFS.remove(HITS_PATH);
+    }
 
     // Reset loaded flag
     _loaded = false;
@@ -201,10 +307,9 @@ void MifareKeysManager::loadFromFile() {
         line.toUpperCase();
         line.replace(" ", "");
 
-        // Validate and add
+        // Validate and add (duplicates are dropped)
         if (isValidHexKey(line)) {
-            _keys.insert(line); // std::set prevents duplicates automatically
-            loaded++;
+            if (insertKey(line)) loaded++;
         } else {
             LOG_WARN("MFC-KEYS", "Invalid key skipped: %s", line.c_str());
             skipped++;
@@ -234,8 +339,8 @@ void MifareKeysManager::saveToFile() {
     file.println("# STANDARD KEYS");
 
     // Write all keys
-    for (const auto& key : _keys) {
-        file.println(key);
+    for (const auto& entry : _keys) {
+        file.println(bytesToKey(entry.key));
     }
 
     // Write footer
@@ -272,15 +377,65 @@ void MifareKeysManager::appendToFile(const String& key) {
 void MifareKeysManager::createDefaultFile() {
     LOG_INFO("MFC-KEYS", "Creating default keys database");
 
-    // Most common standard keys
-    _keys.insert("FFFFFFFFFFFF"); // Factory default (NXP)
-    _keys.insert("A0A1A2A3A4A5"); // MAD (Mifare Application Directory) key
-    _keys.insert("D3F7D3F7D3F7"); // NDEF (NFC Data Exchange Format) key
-    _keys.insert("000000000000"); // Common blank key
-    _keys.insert("B0B1B2B3B4B5"); // Alternative default
+    // Most common standard keys (most likely first)
+    insertKey("FFFFFFFFFFFF"); // Factory default (NXP)
+    insertKey("A0A1A2A3A4A5"); // MAD (Mifare Application Directory) key
+    insertKey("D3F7D3F7D3F7"); // NDEF (NFC Data Exchange Format) key
+    insertKey("000000000000"); // Common blank key
+    insertKey("B0B1B2B3B4B5"); // Alternative default
 
     // Write to file
     saveToFile();
     
     LOG_INFO("MFC-KEYS", "Default database created with %d keys", _keys.size());
 }
+
+void MifareKeysManager::loadStats() {
+    if (!LittleFS.exists(HITS_PATH)) {
+        return;
+    }
+    
+    File file = LittleFS.open(HITS_PATH, FILE_READ);
+    if (!file) {
+        LOG_WARN("MFC-KEYS", "Failed to open hit counters: %s", HITS_PATH);
+        return;
+    }
+    
+    uint8_t record[KEY_BYTE_LENGTH + 2];
+    int applied = 0;
+    while (file.read(record, sizeof(record)) == sizeof(record)) {
+        int index = indexOf(record);
+        if (index >= 0) {
+            _keys[index].hits = record[KEY_BYTE_LENGTH] | (record[KEY_BYTE_LENGTH + 1] << 8);
+            applied++;
+        }
+    }
+    file.close();
+    
+    // Most successful first; stable keeps file order among equals
+    std::stable_sort(_keys.begin(), _keys.end(), [](const KeyEntry& a, const KeyEntry& b) {
+        return a.hits > b.hits;
+    });
+    
+    LOG_DEBUG("MFC-KEYS", "Applied hit counters for %d keys", applied);
+}
+
+int MifareKeysManager::indexOf(const uint8_t* key) {
+    for (size_t i = 0; i < _keys.size(); i++) {
+        if (memcmp(_keys[i].key, key, KEY_BYTE_LENGTH) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool MifareKeysManager::insertKey(const String& key) {
+    KeyEntry entry;
+    if (!keyToBytes(key, entry.key) || indexOf(entry.key) >= 0) {
+        return false;
+    }
+    
+    entry.hits = 0;
+    _keys.push_back(entry);
+    return true;
+}
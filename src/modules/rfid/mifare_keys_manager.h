@@ -3,8 +3,7 @@
 
 #include <Arduino.h>
 #include <LittleFS.h>
-#include <set>
-#include <string>
+#include <vector>
 #include "logger.h"
 
 /**
@@ -12,7 +11,10 @@
  * 
  * Features:
  * - Optimized for LittleFS with lazy loading
- * - Automatic duplicate prevention using std::set
+ * - Keys held pre-decoded (6 bytes) in one contiguous array
+ * - Per-key hit counters, persisted, used to order candidates
+ *   (most successful keys are tried first)
+ * - Automatic duplicate prevention
  * - Default keys database creation
  * - Hex key validation
  * - Byte array conversion utilities
@@ -20,8 +22,11 @@
  * Architecture:
  * - Static singleton pattern (no instance needed)
  * - Keys stored in /mifare_keys.txt (one per line)
+ * - Hit counters stored in /mifare_keys.hits (binary, 8 bytes per key),
+ *   written at most every STATS_FLUSH_INTERVAL_MS or STATS_FLUSH_HITS hits
  * - Supports comments (lines starting with # or //)
- * - Thread-safe for single-core access
+ * - Loading, edits and hit counters hold NFCSharedLock (shared by
+ *   every reader's worker)
  * 
  * Key Format:
  * - 12 hexadecimal characters (case-insensitive)
@@ -32,9 +37,12 @@
  * @code
  * MifareKeysManager::begin();  // Initialize in setup()
  * MifareKeysManager::addKey("A0A1A2A3A4A5");
- * if (MifareKeysManager::hasKey("FFFFFFFFFFFF")) {
- *     // Key exists in database
+ * std::vector<MifareKeysManager::KeyEntry> keys;
+ * MifareKeysManager::snapshot(keys);
+ * for (const auto& entry : keys) {
+ *     if (tryAuth(entry.key)) { MifareKeysManager::recordHit(entry.key); break; }
  * }
+ * MifareKeysManager::saveStats();  // After the operation (writes when due)
  * @endcode
  */
 class MifareKeysManager {
@@ -46,12 +54,30 @@ public:
     // File paths
     static constexpr const char* KEYS_PATH = "/mifare_keys.txt";
     static constexpr const char* KEYS_DIR = "/";
+    static constexpr const char* HITS_PATH = "/mifare_keys.hits";
     
     // Key format constants
     static constexpr size_t KEY_HEX_LENGTH = 12;     // 12 hex chars = 6 bytes
     static constexpr size_t KEY_BYTE_LENGTH = 6;     // 6 bytes = 48 bits
     static constexpr size_t CHARS_PER_BYTE = 2;      // 2 hex chars per byte
     static constexpr uint8_t HEX_PADDING_THRESHOLD = 0x10; // Values < 0x10 need leading zero
+    static constexpr uint16_t MAX_HITS = 0xFFFF;     // Hit counter saturation
+    
+    // Hit counter persistence (one file rewrite per flush)
+    static constexpr uint16_t STATS_FLUSH_HITS = 32;             // Pending hits that force a write
+    static constexpr uint32_t STATS_FLUSH_INTERVAL_MS = 60000;   // Max age of unsaved hits
+    
+    // ============================================
+    // TYPES
+    // ============================================
+    
+    /**
+     * @brief Decoded key with usage statistics
+     */
+    struct KeyEntry {
+        uint8_t key[KEY_BYTE_LENGTH];   ///< Key bytes (ready for PN532)
+        uint16_t hits;                  ///< Successful authentications
+    };
     
     // ============================================
     // PUBLIC METHODS
@@ -80,7 +106,7 @@ public:
      * @return true if added successfully, false if invalid or duplicate
      * 
      * Automatically converts to uppercase and removes spaces.
-     * Prevents duplicates using std::set.
+     * Prevents duplicates (linear scan of decoded keys).
      * Appends to file immediately.
      */
     static bool addKey(const String& key);
@@ -104,22 +130,57 @@ public:
     /**
      * @brief Clear all keys from database
      * 
-     * Removes file and clears in-memory set.
+     * Removes keys and hit files, clears in-memory array.
      * Marks as not loaded for future lazy loading.
      */
     static void clear();
     
     /**
-     * @brief Get reference to all keys
-     * @return Const reference to std::set of keys
+     * @brief Get ordered candidate list
+     * @return Const reference to keys, highest hit count first
      * 
-     * Ensures keys are loaded before returning.
+     * Ensures keys are loaded before returning. Order changes on
+     * recordHit() and addKey()/removeKey() may reallocate: only for
+     * single-task use, key searches iterate a snapshot().
      */
-    static const std::set<String>& getKeys() { 
+    static const std::vector<KeyEntry>& getKeys() { 
         ensureLoaded(); 
         return _keys; 
     }
     
+    /**
+     * @brief Copy the ordered candidate list (held under NFCSharedLock)
+     * @param out Receives the keys, highest hit count first
+     * 
+     * Safe to iterate while another reader's worker records hits or
+     * the web API edits the database. Reuse the same vector across
+     * calls: its capacity is kept, so refreshing does not allocate.
+     */
+    static void snapshot(std::vector<KeyEntry>& out);
+    
+    /**
+     * @brief Count a successful authentication and reorder candidates
+     * @param key 6-byte key that authenticated
+     * 
+     * No-op if the key is not in the database. Counters are kept in
+     * RAM until saveStats().
+     */
+    static void recordHit(const uint8_t* key);
+    
+    /**
+     * @brief Persist hit counters if they changed and a flush is due
+     * 
+     * Due after STATS_FLUSH_HITS unsaved hits, or once the oldest unsaved
+     * hit is STATS_FLUSH_INTERVAL_MS old. Cheap when nothing changed:
+     * called after every Mifare operation and from loop().
+     */
+    static void saveStats();
+    
+    /**
+     * @brief Persist hit counters now if they changed
+     */
+    static void flushStats();
+    
     /**
      * @brief Get number of keys in database
      * @return Key count
@@ -158,8 +219,11 @@ private:
     // PRIVATE MEMBERS
     // ============================================
     
-    static std::set<String> _keys;    // In-memory key database (sorted, unique)
-    static bool _loaded;              // Lazy loading flag
+    static std::vector<KeyEntry> _keys;   // In-memory key database (unique, hits descending)
+    static bool _loaded;                  // Lazy loading flag
+    static bool _stats_dirty;             // Hit counters changed since the last write
+    static uint16_t _pending_hits;        // Hits since the last write
+    static uint32_t _dirty_since_ms;      // millis() of the first unsaved hit
     
     // ============================================
     // PRIVATE METHODS
@@ -170,15 +234,32 @@ private:
      * 
      * Parses file line by line.
      * Skips comments (# or //) and empty lines.
-     * Validates each key before adding to set.
+     * Validates each key before adding to the array.
      */
     static void loadFromFile();
     
+    /**
+     * @brief Apply persisted hit counters and sort candidates
+     */
+    static void loadStats();
+    
+    /**
+     * @brief Find key in array
+     * @return Index or -1
+     */
+    static int indexOf(const uint8_t* key);
+    
+    /**
+     * @brief Decode and append key if not present (no file I/O)
+     * @return true if added
+     */
+    static bool insertKey(const String& key);
+    
     /**
      * @brief Save all keys to file (overwrites)
      * 
      * Creates file with header comments.
-     * Writes all keys from in-memory set.
+     * Writes all keys from in-memory array.
      */
     static void saveToFile();
     
@@ -0,0 +1,263 @@
+#include "mifare_sector_scheduler.h"
+#include "nfc_reader.h"
+#include <freertos/task.h>
+
+// ============================================
+// STORAGE
+// ============================================
+
+MifareSectorScheduler::Plan MifareSectorScheduler::_plans[MAX_PLANS];
+uint32_t MifareSectorScheduler::_generation = 0;
+
+// ============================================
+// PUBLIC METHODS
+// ============================================
+
+MifareSectorScheduler::Ticket MifareSectorScheduler::join(const uint8_t* uid, uint8_t uid_len,
+                                                          uint8_t sector_count, uint8_t* dump) {
+    NFCSharedLock lock;
+
+    Ticket ticket = {-1, 0, 0};
+    if (uid_len == 0 || uid_len > MAX_UID_SIZE || sector_count == 0 || sector_count > MAX_SECTORS) {
+        return ticket;
+    }
+
+    // Another reader is working on the same card: take a free seat
+    for (uint8_t p = 0; p < MAX_PLANS; p++) {
+        Plan& plan = _plans[p];
+        if (!plan.open || plan.uid_len != uid_len || plan.sector_count != sector_count ||
+            memcmp(plan.uid, uid, uid_len) != 0 || plan.finished >= plan.sector_count) {
+            continue;
+        }
+
+        for (uint8_t w = 1; w < MAX_WORKERS; w++) {
+            if (plan.joined & (1 << w)) {
+                continue;
+            }
+
+            plan.joined |= (1 << w);
+            plan.active |= (1 << w);
+
+            // Sectors the others gave up on get a try in this reader's field
+            for (uint8_t s = 0; s < sector_count; s++) {
+                if (plan.state[s] == SECTOR_FAILED) {
+                    plan.state[s] = SECTOR_PENDING;
+                    plan.finished--;
+                }
+            }
+
+            LOG_INFO("MFC-SCHED", "Reader joined plan %u as worker %u (%u/%u sectors finished)",
+                     p, w, plan.finished, sector_count);
+            ticket = {(int8_t)p, w, plan.generation};
+            return ticket;
+        }
+    }
+
+    // New plan, this reader owns it
+    for (uint8_t p = 0; p < MAX_PLANS; p++) {
+        Plan& plan = _plans[p];
+        if (plan.open) {
+            continue;
+        }
+
+        memset(&plan, 0, sizeof(plan));
+        plan.open = true;
+        plan.generation = ++_generation;
+        memcpy(plan.uid, uid, uid_len);
+        plan.uid_len = uid_len;
+        plan.sector_count = sector_count;
+        plan.dump = dump;
+        plan.joined = 1;
+        plan.active = 1;
+        plan.started_ms = millis();
+        plan.progress_ms = plan.started_ms;
+
+        ticket = {(int8_t)p, 0, plan.generation};
+        return ticket;
+    }
+
+    LOG_ERROR("MFC-SCHED", "No free sector plan");
+    return ticket;
+}
+
+bool MifareSectorScheduler::claim(const Ticket& ticket, uint8_t& sector, Hints& hints) {
+    NFCSharedLock lock;
+
+    Plan* plan = planOf(ticket);
+    if (!plan) {
+        return false;
+    }
+
+    // Owner walks up from sector 0, joiners down from the last sector
+    uint8_t bit = 1 << ticket.worker;
+    for (uint8_t i = 0; i < plan->sector_count; i++) {
+        uint8_t s = ticket.owner() ? i : plan->sector_count - 1 - i;
+        if (plan->state[s] != SECTOR_PENDING || (plan->tried[s] & bit)) {
+            continue;
+        }
+
+        plan->state[s] = SECTOR_CLAIMED;
+        plan->tried[s] |= bit;
+        sector = s;
+        hints = plan->hints;
+        return true;
+    }
+
+    return false;
+}
+
+uint8_t MifareSectorScheduler::complete(const Ticket& ticket, uint8_t sector, bool ok,
+                                        const SectorResult& result, const uint8_t* dump,
+                                        size_t offset, size_t len, uint16_t attempts) {
+    NFCSharedLock lock;
+
+    Plan* plan = planOf(ticket);
+    if (!plan || sector >= plan->sector_count || plan->state[sector] != SECTOR_CLAIMED) {
+        return 0;
+    }
+
+    plan->keys_tried += attempts;
+    plan->progress_ms = millis();
+
+    if (ok) {
+        plan->state[sector] = SECTOR_DONE;
+        plan->reader_of[sector] = ticket.worker;
+        plan->results[sector] = result;
+        plan->finished++;
+
+        if (dump != plan->dump) {
+            memcpy(plan->dump + offset, dump + offset, len);
+        }
+
+        // Next sector on any reader starts with this key
+        if (result.key_a) {
+            memcpy(plan->hints.key_a, result.key, KEY_SIZE);
+            plan->hints.has_a = true;
+        } else {
+            memcpy(plan->hints.key_b, result.key, KEY_SIZE);
+            plan->hints.has_b = true;
+        }
+    } else {
+        // Another reader may still open it (other field, other key order)
+        plan->state[sector] = SECTOR_PENDING;
+        settle(*plan);
+    }
+
+    return plan->finished;
+}
+
+void MifareSectorScheduler::finish(const Ticket& ticket, Summary& out) {
+    memset(&out, 0, sizeof(out));
+
+    while (true) {
+        {
+            NFCSharedLock lock;
+
+            Plan* plan = planOf(ticket);
+            if (!plan) {
+                return;
+            }
+
+            settle(*plan);
+            bool stalled = (millis() - plan->progress_ms) > STALL_TIMEOUT_MS;
+            if (plan->finished >= plan->sector_count || stalled) {
+                if (stalled) {
+                    LOG_WARN("MFC-SCHED", "Plan %d stalled, %u/%u sectors finished",
+                             ticket.plan, plan->finished, plan->sector_count);
+                }
+
+                out.keys_tried = plan->keys_tried;
+                out.elapsed_ms = millis() - plan->started_ms;
+                out.readers = __builtin_popcount(plan->joined);
+                for (uint8_t s = 0; s < plan->sector_count; s++) {
+                    if (plan->state[s] == SECTOR_DONE) out.sectors_ok++;
+                }
+                return;
+            }
+        }
+
+        // Other reader still on a sector
+        vTaskDelay(pdMS_TO_TICKS(POLL_INTERVAL_MS));
+    }
+}
+
+bool MifareSectorScheduler::remoteResult(const Ticket& ticket, uint8_t sector, SectorResult& out) {
+    NFCSharedLock lock;
+
+    Plan* plan = planOf(ticket);
+    if (!plan || sector >= plan->sector_count || plan->state[sector] != SECTOR_DONE ||
+        plan->reader_of[sector] == ticket.worker) {
+        return false;
+    }
+
+    out = plan->results[sector];
+    return true;
+}
+
+void MifareSectorScheduler::leave(Ticket& ticket, uint8_t* dump, size_t size) {
+    {
+        NFCSharedLock lock;
+
+        Plan* plan = planOf(ticket);
+        if (!plan) {
+            ticket.plan = -1;
+            return;
+        }
+
+        plan->active &= ~(1 << ticket.worker);
+        settle(*plan);
+
+        if (!ticket.owner()) {
+            if (dump != plan->dump) {
+                memcpy(dump, plan->dump, size);
+            }
+            ticket.plan = -1;
+            return;
+        }
+    }
+
+    // Owner: the merged image is in our buffer, let joiners copy it first
+    uint32_t start = millis();
+    while (millis() - start < LEAVE_TIMEOUT_MS) {
+        {
+            NFCSharedLock lock;
+            Plan* plan = planOf(ticket);
+            if (!plan || plan->active == 0) {
+                break;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(POLL_INTERVAL_MS));
+    }
+
+    NFCSharedLock lock;
+    Plan* plan = planOf(ticket);
+    if (plan) {
+        plan->open = false;
+    }
+    ticket.plan = -1;
+}
+
+// ============================================
+// INTERNAL
+// ============================================
+
+MifareSectorScheduler::Plan* MifareSectorScheduler::planOf(const Ticket& ticket) {
+    if (ticket.plan < 0 || ticket.plan >= MAX_PLANS) {
+        return nullptr;
+    }
+
+    Plan& plan = _plans[ticket.plan];
+    if (!plan.open || plan.generation != ticket.generation) {
+        return nullptr;
+    }
+    return &plan;
+}
+
+void MifareSectorScheduler::settle(Plan& plan) {
+    for (uint8_t s = 0; s < plan.sector_count; s++) {
+        if (plan.state[s] == SECTOR_PENDING && (plan.active & ~plan.tried[s]) == 0) {
+            plan.state[s] = SECTOR_FAILED;
+            plan.finished++;
+        }
+    }
+}
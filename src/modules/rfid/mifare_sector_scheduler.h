@@ -0,0 +1,218 @@
+#ifndef __MIFARE_SECTOR_SCHEDULER_H__
+#define __MIFARE_SECTOR_SCHEDULER_H__
+
+#include <Arduino.h>
+#include "config.h"
+#include "logger.h"
+
+/**
+ * @brief Sector work plan for Mifare Classic full reads
+ *
+ * Features:
+ * - Hands out the sectors of a card one at a time (claim / complete)
+ * - Readers holding the same card (same UID) share one plan: the first
+ *   takes sectors from the front, the others from the back, so the key
+ *   search is split without fixed partitions
+ * - A sector one reader failed goes back to the queue for readers that
+ *   have not tried it yet
+ * - Latest working Key A / Key B shared as first candidates for the
+ *   next sector on every reader
+ * - Keys tried across all readers and the plan's wall time (keys/sec)
+ *
+ * Architecture:
+ * - Static singleton pattern (no instance needed)
+ * - Shared by every reader: public calls hold NFCSharedLock
+ * - At most one plan per reader (MAX_PLANS = NFC_MAX_READERS)
+ * - Blocks are merged into the dump buffer of the plan's owner; joiners
+ *   copy the merged image back in leave()
+ * - A single reader runs the plan alone, in sector order
+ *
+ * Usage:
+ * @code
+ * MifareSectorScheduler::Ticket ticket = MifareSectorScheduler::join(uid, uid_len, 16, dump);
+ * uint8_t sector;
+ * MifareSectorScheduler::Hints hints;
+ * while (MifareSectorScheduler::claim(ticket, sector, hints)) {
+ *     ... authenticate and read the sector ...
+ *     MifareSectorScheduler::complete(ticket, sector, ok, result, dump, offset, len, attempts);
+ * }
+ * MifareSectorScheduler::Summary summary;
+ * MifareSectorScheduler::finish(ticket, summary);
+ * ... import sectors other readers opened (remoteResult) ...
+ * MifareSectorScheduler::leave(ticket, dump, dump_size);
+ * @endcode
+ */
+class MifareSectorScheduler {
+public:
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr uint8_t MAX_PLANS = NFC_MAX_READERS;      // One plan per reader at most
+    static constexpr uint8_t MAX_WORKERS = NFC_MAX_READERS;    // Readers per plan
+    static constexpr uint8_t MAX_SECTORS = 40;                 // Mifare Classic 4K
+    static constexpr uint8_t KEY_SIZE = 6;                     // Bytes per key
+    static constexpr uint8_t MAX_UID_SIZE = 10;                // Longest UID
+    static constexpr uint32_t POLL_INTERVAL_MS = 5;            // finish()/leave() wait step
+    static constexpr uint32_t STALL_TIMEOUT_MS = 30000;        // No sector finished: give up waiting
+    static constexpr uint32_t LEAVE_TIMEOUT_MS = 500;          // Owner waits for joiners to copy
+
+    // ============================================
+    // TYPES
+    // ============================================
+
+    /**
+     * @brief A reader's seat in a plan
+     */
+    struct Ticket {
+        int8_t plan;                ///< Plan slot (-1 = none)
+        uint8_t worker;             ///< Worker index in the plan (0 = owner)
+        uint32_t generation;        ///< Plan generation (stale tickets are ignored)
+
+        bool valid() const { return plan >= 0; }
+        bool owner() const { return worker == 0; }
+    };
+
+    /**
+     * @brief Latest keys that opened a sector of the card (any reader)
+     */
+    struct Hints {
+        uint8_t key_a[KEY_SIZE];
+        uint8_t key_b[KEY_SIZE];
+        bool has_a;
+        bool has_b;
+    };
+
+    /**
+     * @brief Key that opened a sector
+     */
+    struct SectorResult {
+        uint8_t key[KEY_SIZE];
+        bool key_a;                 ///< true: Key A, false: Key B
+    };
+
+    /**
+     * @brief Plan totals (filled by finish())
+     */
+    struct Summary {
+        uint32_t keys_tried;        ///< Authentication attempts, all readers
+        uint32_t elapsed_ms;        ///< From join() of the owner to finish()
+        uint8_t readers;            ///< Readers that joined the plan
+        uint8_t sectors_ok;         ///< Sectors opened by any reader
+    };
+
+    // ============================================
+    // PUBLIC METHODS
+    // ============================================
+
+    /**
+     * @brief Join the open plan for this card, or start one
+     * @param uid Card UID
+     * @param uid_len UID length
+     * @param sector_count Sectors of the card (16 or 40)
+     * @param dump Caller's dump buffer (becomes the merge target if owner)
+     * @return Ticket (invalid if every plan slot is taken)
+     */
+    static Ticket join(const uint8_t* uid, uint8_t uid_len, uint8_t sector_count, uint8_t* dump);
+
+    /**
+     * @brief Take the next sector this reader has not tried yet
+     * @param ticket Seat from join()
+     * @param sector Output: sector to read
+     * @param hints Output: latest working keys of the card
+     * @return false when nothing is left for this reader
+     */
+    static bool claim(const Ticket& ticket, uint8_t& sector, Hints& hints);
+
+    /**
+     * @brief Report a claimed sector
+     * @param ticket Seat from join()
+     * @param sector Sector from claim()
+     * @param ok true if the sector was opened and read
+     * @param result Key that opened it (ignored if !ok)
+     * @param dump Caller's dump buffer holding the sector (trailer keys reconstructed)
+     * @param offset Byte offset of the sector's first block
+     * @param len Sector size in bytes
+     * @param attempts Authentication attempts spent on the sector
+     * @return Sectors finished so far, all readers (for progress)
+     */
+    static uint8_t complete(const Ticket& ticket, uint8_t sector, bool ok, const SectorResult& result,
+                            const uint8_t* dump, size_t offset, size_t len, uint16_t attempts);
+
+    /**
+     * @brief Wait until no sector of the plan is left or in flight
+     * @param ticket Seat from join()
+     * @param out Plan totals
+     *
+     * Returns at once for a single reader. Gives up after
+     * STALL_TIMEOUT_MS without a finished sector.
+     */
+    static void finish(const Ticket& ticket, Summary& out);
+
+    /**
+     * @brief Sector opened by another reader of the plan
+     * @param ticket Seat from join()
+     * @param sector Sector number
+     * @param out Key that opened it
+     * @return false if the sector failed or this reader read it itself
+     */
+    static bool remoteResult(const Ticket& ticket, uint8_t sector, SectorResult& out);
+
+    /**
+     * @brief Leave the plan
+     * @param ticket Seat from join() (invalid afterwards)
+     * @param dump Joiners: receives the merged image
+     * @param size Bytes to copy (card size)
+     *
+     * The owner waits up to LEAVE_TIMEOUT_MS for joiners to copy the
+     * merged image, then closes the plan.
+     */
+    static void leave(Ticket& ticket, uint8_t* dump, size_t size);
+
+private:
+    // ============================================
+    // PLAN STORAGE
+    // ============================================
+
+    enum SectorState : uint8_t {
+        SECTOR_PENDING = 0,         // Waiting for a reader
+        SECTOR_CLAIMED,             // A reader is on it
+        SECTOR_DONE,                // Opened and read
+        SECTOR_FAILED               // Every reader tried, none opened it
+    };
+
+    struct Plan {
+        bool open;                  // Slot in use
+        uint32_t generation;        // Bumped on every start
+        uint8_t uid[MAX_UID_SIZE];
+        uint8_t uid_len;
+        uint8_t sector_count;
+        uint8_t* dump;              // Owner's buffer (merge target)
+        uint8_t joined;             // Worker bitmask (joined)
+        uint8_t active;             // Worker bitmask (not left yet)
+        uint8_t finished;           // Sectors DONE or FAILED
+        uint8_t state[MAX_SECTORS];           // SectorState
+        uint8_t tried[MAX_SECTORS];           // Worker bitmask
+        uint8_t reader_of[MAX_SECTORS];       // Worker that opened the sector
+        SectorResult results[MAX_SECTORS];
+        Hints hints;
+        uint32_t keys_tried;
+        uint32_t started_ms;
+        uint32_t progress_ms;       // Last complete()
+    };
+
+    static Plan _plans[MAX_PLANS];
+    static uint32_t _generation;
+
+    /**
+     * @brief Plan of a ticket, nullptr if closed or recycled (lock held)
+     */
+    static Plan* planOf(const Ticket& ticket);
+
+    /**
+     * @brief Fail pending sectors no remaining reader can still try (lock held)
+     */
+    static void settle(Plan& plan);
+};
+
+#endif // __MIFARE_SECTOR_SCHEDULER_H__
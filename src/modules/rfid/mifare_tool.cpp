@@ -4,14 +4,20 @@
  */
 
 #include "mifare_tool.h"
+#include "nfc_progress.h"
+#include <stage_metrics.h>
 
 // ============================================
 // CONSTRUCTOR & INITIALIZATION
 // ============================================
 
-MifareTool::MifareTool(bool headless)
-    : _nfc(PN532_IRQ, PN532_RF_REST),
+MifareTool::MifareTool(bool headless, const NFCReaderConfig& reader, NFCIrq* irq)
+    : _nfc(reader.irq_pin, reader.reset_pin, reader.wire),
+      _raw(reader.irq_pin, 255, reader.wire),
+      _irq(irq),
+      _sector_write_count(0),
       _headless(headless),
+      _key_cache_enabled(true),
       _uid_length(0),
       _sak(0),
       _card_type(CARD_UNKNOWN),
@@ -24,6 +30,11 @@ MifareTool::MifareTool(bool headless)
     memset(_atqa, 0, sizeof(_atqa));
     memset(_dump, 0, sizeof(_dump));
     memset(_sector_auth_success, false, sizeof(_sector_auth_success));
+    memset(&_known_keys, 0, sizeof(_known_keys));
+    memset(&_learned_keys, 0, sizeof(_learned_keys));
+    memset(&_recovery, 0, sizeof(_recovery));
+    memset(&_key_stats, 0, sizeof(_key_stats));
+    memset(_sector_writes, 0, sizeof(_sector_writes));
     
     // Initialize key storage
     for (int i = 0; i < MIFARE_4K_SECTORS; i++) {
@@ -43,9 +54,17 @@ MifareTool::~MifareTool() {
 bool MifareTool::begin() {
     LOG_INFO("MIFARE", "Initializing PN532...");
     
-    _nfc.begin();
+    uint32_t versiondata;
+    {
+        // Adafruit_PN532 frames go through a library-global buffer
+        NFCSharedLock lock;
+        _nfc.begin();
+        versiondata = _nfc.getFirmwareVersion();
+        if (versiondata) {
+            _nfc.SAMConfig();
+        }
+    }
     
-    uint32_t versiondata = _nfc.getFirmwareVersion();
     if (!versiondata) {
         LOG_ERROR("MIFARE", "PN532 not found (check wiring and power)");
         return false;
@@ -55,7 +74,11 @@ bool MifareTool::begin() {
              (versiondata >> 16) & 0xFF, 
              (versiondata >> 8) & 0xFF);
     
-    _nfc.SAMConfig();
+    // Raw transport only sends frames (no init/reset: Adafruit owns the chip)
+    _raw.setFastMode(true);
+    if (_irq && _irq->isEnabled()) {
+        _raw.setWaitHook(NFCIrq::waitHook, _irq);
+    }
     
     LOG_INFO("MIFARE", "PN532 ready");
     return true;
@@ -65,18 +88,15 @@ bool MifareTool::begin() {
 // HEADLESS OPERATIONS - READ
 // ============================================
 
-String MifareTool::read_tag_headless(uint32_t timeout_ms) {
+int MifareTool::read_tag_binary(uint32_t timeout_ms) {
     LOG_INFO("MIFARE", "Starting tag read (timeout: %lu ms)", timeout_ms);
     
     unsigned long start = millis();
     
     // Wait for card detection
-    while (!detectCard(CARD_DETECT_SHORT_TIMEOUT_MS)) {
-        if (millis() - start > timeout_ms) {
-            LOG_WARN("MIFARE", "Tag detection timeout");
-            return "";
-        }
-        delay(CARD_DETECT_INTERVAL_MS);
+    if (!waitForCard(timeout_ms)) {
+        LOG_WARN("MIFARE", "Tag detection timeout");
+        return ERROR_NO_TAG;
     }
     
     LOG_DEBUG("MIFARE", "Card detected, starting full read...");
@@ -84,6 +104,34 @@ String MifareTool::read_tag_headless(uint32_t timeout_ms) {
     _blocks_read = 0;
     int read_result = readAllBlocks();
     
+    _dump_valid = (read_result == SUCCESS);
+    
+    LOG_INFO("MIFARE", "Read complete: %d/%d blocks in %lu ms (success: %d)", 
+             _blocks_read, _total_blocks, millis() - start, read_result == SUCCESS);
+    
+    return read_result;
+}
+
+int MifareTool::read_uid_binary(uint32_t timeout_ms) {
+    LOG_INFO("MIFARE", "Starting UID-only read (timeout: %lu ms)", timeout_ms);
+    
+    // Wait for card detection
+    if (!waitForCard(timeout_ms)) {
+        LOG_WARN("MIFARE", "UID read timeout");
+        return ERROR_NO_TAG;
+    }
+    
+    LOG_INFO("MIFARE", "UID read successful: %s", uidToString().c_str());
+    return SUCCESS;
+}
+
+String MifareTool::read_tag_headless(uint32_t timeout_ms) {
+    int read_result = read_tag_binary(timeout_ms);
+    
+    if (read_result == ERROR_NO_TAG) {
+        return "";
+    }
+    
     // Build JSON response
     String json = "{";
     json += "\"uid\":\"" + uidToString() + "\",";
@@ -102,26 +150,12 @@ String MifareTool::read_tag_headless(uint32_t timeout_ms) {
     
     json += "}";
     
-    _dump_valid = (read_result == SUCCESS);
-    
-    LOG_INFO("MIFARE", "Read complete: %d/%d blocks (success: %d)", 
-             _blocks_read, _total_blocks, read_result == SUCCESS);
-    
     return json;
 }
 
 String MifareTool::read_uid_headless(uint32_t timeout_ms) {
-    LOG_INFO("MIFARE", "Starting UID-only read (timeout: %lu ms)", timeout_ms);
-    
-    unsigned long start = millis();
-    
-    // Wait for card detection
-    while (!detectCard(CARD_DETECT_SHORT_TIMEOUT_MS)) {
-        if (millis() - start > timeout_ms) {
-            LOG_WARN("MIFARE", "UID read timeout");
-            return "";
-        }
-        delay(CARD_DETECT_INTERVAL_MS);
+    if (read_uid_binary(timeout_ms) != SUCCESS) {
+        return "";
     }
     
     // Build JSON response (UID only)
@@ -132,8 +166,6 @@ String MifareTool::read_uid_headless(uint32_t timeout_ms) {
     json += "\"card_type\":\"" + cardTypeToString(_card_type) + "\"";
     json += "}";
     
-    LOG_INFO("MIFARE", "UID read successful: %s", uidToString().c_str());
-    
     return json;
 }
 
@@ -142,6 +174,8 @@ String MifareTool::read_uid_headless(uint32_t timeout_ms) {
 // ============================================
 
 int MifareTool::write_tag_headless(int timeout_sec) {
+    _sector_write_count = 0;
+    
     if (!_dump_valid) {
         LOG_ERROR("MIFARE", "Write failed: No valid dump loaded");
         return ERROR_INVALID_DATA;
@@ -151,21 +185,21 @@ int MifareTool::write_tag_headless(int timeout_sec) {
     
     unsigned long start = millis();
     uint32_t timeout_ms = timeout_sec * 1000UL;
+    CardType dump_type = _card_type;    // Detection overwrites it with the card's type
     
     // Wait for card
-    while (!detectCard(CARD_DETECT_SHORT_TIMEOUT_MS)) {
-        if (millis() - start > timeout_ms) {
-            LOG_ERROR("MIFARE", "Write failed: Tag detection timeout");
-            return ERROR_NO_TAG;
-        }
-        delay(CARD_DETECT_INTERVAL_MS);
+    if (!waitForCard(timeout_ms)) {
+        LOG_ERROR("MIFARE", "Write failed: Tag detection timeout");
+        return ERROR_NO_TAG;
     }
     
-    // Verify card type matches dump
-    if (identifyCardType() != _card_type) {
+    // Verify card type matches dump (detection typed the card from SAK/ATQA)
+    if (_card_type != dump_type) {
         LOG_ERROR("MIFARE", "Write failed: Card type mismatch (expected %s, got %s)",
-                 cardTypeToString(_card_type).c_str(),
-                 cardTypeToString(identifyCardType()).c_str());
+                 cardTypeToString(dump_type).c_str(),
+                 cardTypeToString(_card_type).c_str());
+        _card_type = dump_type;
+        _total_blocks = (_card_type == CARD_MIFARE_1K) ? MIFARE_1K_BLOCKS : MIFARE_4K_BLOCKS;
         return ERROR_INVALID_DATA;
     }
     
@@ -173,10 +207,13 @@ int MifareTool::write_tag_headless(int timeout_sec) {
     
     // Write all sectors
     int sector_count = getSectorCount(_card_type);
+    memset(&_recovery, 0, sizeof(_recovery));
     for (int sector = 0; sector < sector_count; sector++) {
-        int result = writeSector(sector);
+        int result = writeSectorBlocks(sector, dataBlockMask(sector));
+        NFCProgress::sector(NFCProgress::OP_WRITE, sector + 1, sector_count, result == SUCCESS);
         if (result != SUCCESS) {
             LOG_ERROR("MIFARE", "Write failed at sector %d (error: %d)", sector, result);
+            MifareKeysManager::saveStats();
             return result;
         }
         
@@ -187,11 +224,16 @@ int MifareTool::write_tag_headless(int timeout_sec) {
         }
     }
     
+    MifareKeysManager::saveStats();
+    logRecoveryStats("Write");
+    
     LOG_INFO("MIFARE", "Write complete: %d sectors written successfully", sector_count);
     return SUCCESS;
 }
 
 int MifareTool::write_single_block_headless(int block) {
+    _sector_write_count = 0;
+    
     if (!_dump_valid) {
         LOG_ERROR("MIFARE", "Single block write failed: No valid dump loaded");
         return ERROR_INVALID_DATA;
@@ -210,9 +252,7 @@ int MifareTool::write_single_block_headless(int block) {
     }
     
     // Determine sector and check if it's a trailer
-    int sector = (block < LARGE_SECTOR_BOUNDARY) ? 
-                 (block / BLOCKS_PER_SMALL_SECTOR) : 
-                 (SMALL_SECTOR_COUNT + (block - LARGE_SECTOR_BOUNDARY) / BLOCKS_PER_LARGE_SECTOR);
+    int sector = getSectorOfBlock(block);
     
     int first_block = getFirstBlockOfSector(sector);
     int block_count = getBlockCountInSector(sector);
@@ -227,17 +267,14 @@ int MifareTool::write_single_block_headless(int block) {
     LOG_INFO("MIFARE", "Writing single block %d (sector %d)...", block, sector);
     
     // Wait for tag
-    unsigned long start = millis();
-    while (!detectCard(CARD_DETECT_SHORT_TIMEOUT_MS)) {
-        if (millis() - start > SINGLE_BLOCK_TIMEOUT_MS) {
-            LOG_ERROR("MIFARE", "Single block write timeout");
-            return ERROR_NO_TAG;
-        }
-        delay(CARD_DETECT_INTERVAL_MS);
+    if (!waitForCard(SINGLE_BLOCK_TIMEOUT_MS)) {
+        LOG_ERROR("MIFARE", "Single block write timeout");
+        return ERROR_NO_TAG;
     }
     
     // Write the block
-    int result = writeSingleBlock(block);
+    int result = writeSectorBlocks(sector, 1U << (block - first_block));
+    MifareKeysManager::saveStats();
     
     if (result == SUCCESS) {
         LOG_INFO("MIFARE", "Block %d written successfully", block);
@@ -248,6 +285,72 @@ int MifareTool::write_single_block_headless(int block) {
     return result;
 }
 
+int MifareTool::write_blocks_headless(const std::vector<uint8_t>& blocks, uint32_t timeout_ms) {
+    _sector_write_count = 0;
+    
+    if (!_dump_valid) {
+        LOG_ERROR("MIFARE", "Block write failed: No valid dump loaded");
+        return ERROR_INVALID_DATA;
+    }
+    
+    // Group by sector: bit n of masks[s] = block first_block(s) + n
+    uint16_t masks[MIFARE_4K_SECTORS] = {0};
+    int total = 0;
+    
+    for (uint8_t block : blocks) {
+        if (block >= _total_blocks) {
+            LOG_WARN("MIFARE", "Skipping invalid block %d", block);
+            continue;
+        }
+        
+        int sector = getSectorOfBlock(block);
+        uint16_t bit = 1U << (block - getFirstBlockOfSector(sector));
+        
+        if (!(dataBlockMask(sector) & bit)) {
+            LOG_WARN("MIFARE", "Cannot write block %d (UID or sector trailer)", block);
+            return ERROR_INVALID_DATA;
+        }
+        
+        if (!(masks[sector] & bit)) {
+            masks[sector] |= bit;
+            total++;
+        }
+    }
+    
+    if (total == 0) {
+        LOG_ERROR("MIFARE", "Block write failed: No valid blocks");
+        return ERROR_INVALID_DATA;
+    }
+    
+    LOG_INFO("MIFARE", "Writing %d blocks...", total);
+    
+    if (!waitForCard(timeout_ms)) {
+        LOG_ERROR("MIFARE", "Block write timeout");
+        return ERROR_NO_TAG;
+    }
+    
+    memset(&_recovery, 0, sizeof(_recovery));
+    int done = 0;
+    int result = SUCCESS;
+    
+    for (int sector = 0; sector < MIFARE_4K_SECTORS && result == SUCCESS; sector++) {
+        if (!masks[sector]) continue;
+        
+        result = writeSectorBlocks(sector, masks[sector]);
+        done += __builtin_popcount(masks[sector]);
+        NFCProgress::block(NFCProgress::OP_WRITE, done, total, result == SUCCESS);
+    }
+    
+    MifareKeysManager::saveStats();
+    logRecoveryStats("Block write");
+    
+    if (result != SUCCESS) {
+        LOG_ERROR("MIFARE", "Block write failed in sector %d (error: %d)",
+                  _sector_writes[_sector_write_count - 1].sector, result);
+    }
+    return result;
+}
+
 int MifareTool::clone_uid_headless(int timeout_sec) {
     if (!_dump_valid || _uid_length == 0) {
         LOG_ERROR("MIFARE", "Clone UID failed: No valid UID loaded");
@@ -256,16 +359,12 @@ int MifareTool::clone_uid_headless(int timeout_sec) {
     
     LOG_INFO("MIFARE", "Starting UID clone (timeout: %d seconds)", timeout_sec);
     
-    unsigned long start = millis();
     uint32_t timeout_ms = timeout_sec * 1000UL;
     
     // Wait for card
-    while (!detectCard(CARD_DETECT_SHORT_TIMEOUT_MS)) {
-        if (millis() - start > timeout_ms) {
-            LOG_ERROR("MIFARE", "Clone UID timeout: No tag detected");
-            return ERROR_NO_TAG;
-        }
-        delay(CARD_DETECT_INTERVAL_MS);
+    if (!waitForCard(timeout_ms)) {
+        LOG_ERROR("MIFARE", "Clone UID timeout: No tag detected");
+        return ERROR_NO_TAG;
     }
     
     // Build block 0 data
@@ -293,7 +392,10 @@ int MifareTool::clone_uid_headless(int timeout_sec) {
              uidToString().c_str(), bcc, _sak, _atqa[1], _atqa[0]);
     
     // Write block 0
-    if (writeBlock0(block0)) {
+    bool cloned = writeBlock0(block0);
+    MifareKeysManager::saveStats();
+    
+    if (cloned) {
         LOG_INFO("MIFARE", "UID cloned successfully");
         return SUCCESS;
     }
@@ -302,11 +404,57 @@ int MifareTool::clone_uid_headless(int timeout_sec) {
     return ERROR_WRITE_FAILED;
 }
 
+// ============================================
+// KEY SEARCH
+// ============================================
+
+bool MifareTool::getSectorKey(int sector, bool& keyA, uint8_t* key) const {
+    if (sector < 0 || sector >= MifareKeyCache::MAX_SECTORS) {
+        return false;
+    }
+    
+    uint8_t flags = _learned_keys.flags[sector];
+    if (flags & MifareKeyCache::FLAG_KEY_A) {
+        keyA = true;
+        memcpy(key, _learned_keys.key_a[sector], MIFARE_KEY_SIZE);
+        return true;
+    }
+    if (flags & MifareKeyCache::FLAG_KEY_B) {
+        keyA = false;
+        memcpy(key, _learned_keys.key_b[sector], MIFARE_KEY_SIZE);
+        return true;
+    }
+    return false;
+}
+
+int MifareTool::probeKeys(int sector, bool keyA, const uint8_t* keys, uint16_t count, int& found) {
+    found = -1;
+    
+    // Fresh selection: the card may still be authenticated from the last command
+    if (!reselectCard() && !reactivateCard()) {
+        LOG_WARN("MIFARE", "Key probe: card not in field");
+        return ERROR_NO_TAG;
+    }
+    
+    int first_block = getFirstBlockOfSector(sector);
+    for (uint16_t i = 0; i < count; i++) {
+        if (authenticateBlock(first_block, keyA, keys + i * MIFARE_KEY_SIZE) == SUCCESS) {
+            found = i;
+            return SUCCESS;
+        }
+        recoverAfterFailedAuth();
+    }
+    
+    return SUCCESS;
+}
+
 // ============================================
 // FILE OPERATIONS
 // ============================================
 
 String MifareTool::save_file_headless(const String& filename) {
+    METRIC_SCOPE(METRIC_FS_SAVE);
+
     if (!_dump_valid) {
         LOG_ERROR("MIFARE", "Save failed: No valid dump to save");
         return "";
@@ -316,15 +464,21 @@ String MifareTool::save_file_headless(const String& filename) {
     
     String filepath = buildFilePath(filename);
     
-    File file = LittleFS.open(filepath, FILE_WRITE);
-    if (!file) {
-        LOG_ERROR("MIFARE", "Failed to open file for writing: %s", filepath.c_str());
-        return "";
+    if (NFCDumpFile::isBinaryName(filepath)) {
+        if (!writeBinaryFormat(filepath)) {
+            return "";
+        }
+    } else {
+        File file = LittleFS.open(filepath, FILE_WRITE);
+        if (!file) {
+            LOG_ERROR("MIFARE", "Failed to open file for writing: %s", filepath.c_str());
+            return "";
+        }
+        
+        writeFileFormat(file);
+        file.close();
     }
     
-    writeFileFormat(file);
-    file.close();
-    
     LOG_INFO("MIFARE", "File saved successfully: %s (%d blocks)", 
              filepath.c_str(), _blocks_read);
     
@@ -332,6 +486,8 @@ String MifareTool::save_file_headless(const String& filename) {
 }
 
 int MifareTool::load_file_headless(const String& filename) {
+    METRIC_SCOPE(METRIC_FS_LOAD);
+
     LOG_INFO("MIFARE", "Loading dump from file: %s", filename.c_str());
     
     String filepath = buildFilePath(filename);
@@ -341,14 +497,20 @@ int MifareTool::load_file_headless(const String& filename) {
         return ERROR_FILE_ERROR;
     }
     
-    File file = LittleFS.open(filepath, FILE_READ);
-    if (!file) {
-        LOG_ERROR("MIFARE", "Failed to open file: %s", filepath.c_str());
-        return ERROR_FILE_ERROR;
-    }
+    bool success;
     
-    bool success = parseFileFormat(file);
-    file.close();
+    if (NFCDumpFile::isBinaryName(filepath)) {
+        success = parseBinaryFormat(filepath);
+    } else {
+        File file = LittleFS.open(filepath, FILE_READ);
+        if (!file) {
+            LOG_ERROR("MIFARE", "Failed to open file: %s", filepath.c_str());
+            return ERROR_FILE_ERROR;
+        }
+        
+        success = parseFileFormat(file);
+        file.close();
+    }
     
     if (success) {
         _dump_valid = true;
@@ -367,24 +529,48 @@ int MifareTool::load_file_headless(const String& filename) {
 // INTERNAL: CARD DETECTION
 // ============================================
 
+bool MifareTool::waitForCard(uint32_t timeout_ms) {
+    unsigned long start = millis();
+    
+    while (true) {
+        uint32_t elapsed = millis() - start;
+        if (elapsed > timeout_ms) {
+            return false;
+        }
+        
+        // IRQ mode: one attempt sleeps for the whole remaining time
+        uint32_t attempt_ms = useIrqDetection() ? (timeout_ms - elapsed) : CARD_DETECT_SHORT_TIMEOUT_MS;
+        if (detectCard(attempt_ms ? attempt_ms : 1)) {
+            return true;
+        }
+        
+        delay(CARD_DETECT_INTERVAL_MS);
+    }
+}
+
 bool MifareTool::detectCard(uint32_t timeout_ms) {
-    uint8_t uid_buffer[7];
+    uint8_t uid_buffer[MIFARE_UID_MAX_SIZE];
     uint8_t uid_len;
     
-    bool detected = _nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid_buffer, &uid_len, timeout_ms);
+    // Clamp to the 16-bit transport timeout (waitForCard() loops for longer waits)
+    uint16_t attempt_ms = timeout_ms > 0xFFFF ? 0xFFFF : (timeout_ms ? timeout_ms : 1);
+    
+    if (!listTarget(attempt_ms, uid_buffer, uid_len)) {
+        return false;
+    }
+    
+    _uid_length = uid_len;
+    memcpy(_uid, uid_buffer, uid_len);
+    _card_type = cardTypeFromSAK(_sak, _atqa);
     
-    if (detected) {
-        _uid_length = uid_len;
-        memcpy(_uid, uid_buffer, uid_len);
+    if (_card_type == CARD_UNKNOWN) {
+        LOG_DEBUG("MIFARE", "Ambiguous SAK 0x%02X / ATQA %02X%02X, probing block 64...",
+                  _sak, _atqa[1], _atqa[0]);
         _card_type = identifyCardType();
         
-        LOG_DEBUG("MIFARE", "Card detected, identifying type...");
-        
-        // Re-select card after type detection (workaround for PN532 bug)
+        // Re-select card after type probe (failed auth halts the card)
         delay(CARD_REACTIVATE_DELAY_MS);
-        detected = _nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid_buffer, &uid_len, CARD_RESELECT_TIMEOUT_MS);
-        
-        if (!detected) {
+        if (!listTarget(CARD_RESELECT_TIMEOUT_MS, uid_buffer, uid_len)) {
             LOG_WARN("MIFARE", "Card lost after re-selection");
             return false;
         }
@@ -395,35 +581,101 @@ bool MifareTool::detectCard(uint32_t timeout_ms) {
             _uid_length = uid_len;
             memcpy(_uid, uid_buffer, uid_len);
         }
-        
-        // Set SAK/ATQA based on card type
-        switch (_card_type) {
-            case CARD_MIFARE_1K:
-                _sak = 0x08;
-                _atqa[0] = 0x04;
-                _atqa[1] = 0x00;
-                break;
-            case CARD_MIFARE_4K:
-                _sak = 0x18;
-                _atqa[0] = 0x02;
-                _atqa[1] = 0x00;
-                break;
-            default:
-                _sak = 0x00;
-                _atqa[0] = 0x00;
-                _atqa[1] = 0x00;
-                break;
-        }
-        
-        _total_blocks = (_card_type == CARD_MIFARE_1K) ? MIFARE_1K_BLOCKS : MIFARE_4K_BLOCKS;
-        
-        LOG_INFO("MIFARE", "Card detected: UID=%d bytes, Type=%s, Blocks=%d",
-                 _uid_length, cardTypeToString(_card_type).c_str(), _total_blocks);
-        
+    }
+    
+    _total_blocks = (_card_type == CARD_MIFARE_1K) ? MIFARE_1K_BLOCKS : MIFARE_4K_BLOCKS;
+    
+    LOG_INFO("MIFARE", "Card detected: UID=%d bytes, SAK=0x%02X, ATQA=%02X%02X, Type=%s, Blocks=%d",
+             _uid_length, _sak, _atqa[1], _atqa[0], cardTypeToString(_card_type).c_str(), _total_blocks);
+    
+    return true;
+}
+
+bool MifareTool::pollCardHeadless(uint16_t timeout_ms) {
+    uint8_t uid_buffer[MIFARE_UID_MAX_SIZE];
+    uint8_t uid_len;
+    
+    // listTarget() stores SAK/ATQA: keep those of the last read card
+    uint8_t sak = _sak;
+    uint8_t atqa[MIFARE_ATQA_SIZE] = {_atqa[0], _atqa[1]};
+    
+    bool found = listTarget(timeout_ms ? timeout_ms : 1, uid_buffer, uid_len);
+    
+    _sak = sak;
+    memcpy(_atqa, atqa, MIFARE_ATQA_SIZE);
+    return found;
+}
+
+bool MifareTool::isCardPresentHeadless(const uint8_t* uid, uint8_t uid_len) {
+    if (!uid || uid_len == 0 || uid_len > MIFARE_UID_MAX_SIZE) {
+        return false;
+    }
+    
+    // Re-select addresses the last read UID
+    bool last_card = (uid_len == _uid_length && memcmp(uid, _uid, uid_len) == 0);
+    if (last_card && reselectCard()) {
         return true;
     }
     
-    return false;
+    uint8_t uid_buffer[MIFARE_UID_MAX_SIZE];
+    uint8_t found_len;
+    uint8_t sak = _sak;
+    uint8_t atqa[MIFARE_ATQA_SIZE] = {_atqa[0], _atqa[1]};
+    
+    bool same = listTarget(CARD_DETECT_SHORT_TIMEOUT_MS, uid_buffer, found_len) &&
+                found_len == uid_len && memcmp(uid_buffer, uid, uid_len) == 0;
+    
+    _sak = sak;
+    memcpy(_atqa, atqa, MIFARE_ATQA_SIZE);
+    return same;
+}
+
+bool MifareTool::listTarget(uint16_t timeout_ms, uint8_t* uid, uint8_t& uid_len) {
+    // InListPassiveTarget, 1 target, 106 kbps type A
+    uint8_t cmd[3] = {PN532_COMMAND_INLISTPASSIVETARGET, 1, PN532_MIFARE_ISO14443A};
+    
+    // Response: NbTg Tg ATQA(2) SAK NFCIDLength NFCID...
+    // IRQ mode: the transport wait hook sleeps on the IRQ line until the PN532 answers
+    uint8_t response[6 + MIFARE_UID_MAX_SIZE];
+    int16_t len = _raw.exchange(cmd, sizeof(cmd), response, sizeof(response), timeout_ms);
+    
+    if (len < 6 || response[0] != 1) {
+        return false;
+    }
+    
+    if (response[5] == 0 || response[5] > MIFARE_UID_MAX_SIZE || len < 6 + response[5]) {
+        LOG_WARN("MIFARE", "Invalid target data (UID length %d)", response[5]);
+        return false;
+    }
+    
+    _atqa[1] = response[2];     // ATQA is sent MSB first
+    _atqa[0] = response[3];
+    _sak = response[4];
+    uid_len = response[5];
+    memcpy(uid, &response[6], uid_len);
+    
+    return true;
+}
+
+MifareTool::CardType MifareTool::cardTypeFromSAK(uint8_t sak, const uint8_t* atqa) {
+    // NXP AN10833 SAK values; ATQA bit 1 (4K) / bit 2 (1K) cross-checks the SAK
+    switch (sak) {
+        case 0x08:  // Classic 1K
+        case 0x88:  // Classic 1K (Infineon)
+        case 0x28:  // SmartMX with Classic 1K emulation
+            if (atqa[0] & 0x04) return CARD_MIFARE_1K;
+            break;
+        case 0x18:  // Classic 4K
+        case 0x98:  // Classic 4K (Pro emulation)
+        case 0x38:  // SmartMX with Classic 4K emulation
+            if (atqa[0] & 0x02) return CARD_MIFARE_4K;
+            break;
+        default:
+            break;
+    }
+    
+    // Clones, Mini/2K and non-standard answers: let the block 64 probe decide
+    return CARD_UNKNOWN;
 }
 
 // ============================================
@@ -435,7 +687,7 @@ MifareTool::CardType MifareTool::identifyCardType() {
     
     // Try to authenticate block 64 (first block of sector 16)
     // If successful, it's a 4K card; otherwise, it's a 1K card
-    if (_nfc.mifareclassic_AuthenticateBlock(_uid, _uid_length, 64, 0, default_key)) {
+    if (rawAuthenticate(64, MIFARE_CMD_AUTH_A, default_key)) {
         LOG_DEBUG("MIFARE", "Detected: Mifare Classic 4K");
         return CARD_MIFARE_4K;
     }
@@ -452,46 +704,166 @@ int MifareTool::readAllBlocks() {
     
     _blocks_read = 0;
     int sector_count = getSectorCount(_card_type);
+    memset(&_recovery, 0, sizeof(_recovery));
+    memset(&_key_stats, 0, sizeof(_key_stats));
+    memset(_sector_auth_success, false, sizeof(_sector_auth_success));
     
     // Key caching for optimization
     String working_key_a = "";
     String working_key_b = "";
     
-    for (int sector = 0; sector < sector_count; sector++) {
-        int result = readSectorWithCache(sector, working_key_a, working_key_b);
+    // Persistent per-UID cache (falls back to block 0 fingerprint after sector 0)
+    bool uid_cached = false;
+    if (_key_cache_enabled) {
+        uid_cached = MifareKeyCache::lookup(MifareKeyCache::ID_UID, _uid, _uid_length, _known_keys);
+    } else {
+        memset(&_known_keys, 0, sizeof(_known_keys));
+    }
+    memset(&_learned_keys, 0, sizeof(_learned_keys));
+    uint32_t fp = 0;
+    
+    if (uid_cached) {
+        LOG_INFO("MIFARE", "Key cache hit for UID %s", uidToString().c_str());
+    }
+    
+    // Sector plan: shared with another reader that holds the same card
+    MifareSectorScheduler::Ticket ticket =
+        MifareSectorScheduler::join(_uid, _uid_length, sector_count, _dump);
+    if (!ticket.valid()) {
+        LOG_ERROR("MIFARE", "No sector plan available");
+        return ERROR_READ_FAILED;
+    }
+    if (!ticket.owner()) {
+        LOG_INFO("MIFARE", "Sharing sectors of UID %s with another reader", uidToString().c_str());
+    }
+    
+    uint8_t sector;
+    MifareSectorScheduler::Hints hints;
+    while (MifareSectorScheduler::claim(ticket, sector, hints)) {
+        // Latest working keys of this card, whichever reader found them
+        if (hints.has_a) working_key_a = MifareKeysManager::bytesToKey(hints.key_a);
+        if (hints.has_b) working_key_b = MifareKeysManager::bytesToKey(hints.key_b);
         
-        if (result != SUCCESS) {
-            _sector_auth_success[sector] = false;
+        uint16_t attempts = 0;
+        int result = readSectorWithCache(sector, working_key_a, working_key_b, attempts);
+        bool ok = (result == SUCCESS);
+        _key_stats.keys_tried += attempts;
+        
+        MifareSectorScheduler::SectorResult opened;
+        memset(&opened, 0, sizeof(opened));
+        if (ok) {
+            opened.key_a = (_learned_keys.flags[sector] & MifareKeyCache::FLAG_KEY_A) != 0;
+            memcpy(opened.key, opened.key_a ? _learned_keys.key_a[sector] : _learned_keys.key_b[sector],
+                   MIFARE_KEY_SIZE);
+        }
+        
+        size_t offset = (size_t)getFirstBlockOfSector(sector) * MIFARE_BLOCK_SIZE;
+        size_t len = (size_t)getBlockCountInSector(sector) * MIFARE_BLOCK_SIZE;
+        uint8_t finished = MifareSectorScheduler::complete(ticket, sector, ok, opened,
+                                                           _dump, offset, len, attempts);
+        NFCProgress::sector(NFCProgress::OP_READ, finished, sector_count, ok);
+        
+        if (!ok) {
             LOG_WARN("MIFARE", "Sector %d read failed", sector);
             continue;
         }
         
         _sector_auth_success[sector] = true;
+        _key_stats.sectors_local++;
+        
+        // Unknown card: borrow keys learned on cards with the same manufacturer block
+        if (sector == 0) {
+            fp = MifareKeyCache::fingerprint(_dump, _uid_length);
+            if (!uid_cached && _key_cache_enabled &&
+                MifareKeyCache::lookup(MifareKeyCache::ID_FINGERPRINT, (const uint8_t*)&fp, sizeof(fp), _known_keys)) {
+                LOG_INFO("MIFARE", "Key cache hit for block 0 fingerprint %08lX", (unsigned long)fp);
+            }
+        }
+    }
+    
+    MifareSectorScheduler::Summary summary;
+    MifareSectorScheduler::finish(ticket, summary);
+    
+    // Sectors the other reader opened (blocks are copied by leave())
+    for (int s = 0; s < sector_count; s++) {
+        MifareSectorScheduler::SectorResult remote;
+        if (!_sector_auth_success[s] && MifareSectorScheduler::remoteResult(ticket, s, remote)) {
+            importRemoteSector(s, remote);
+        }
     }
+    MifareSectorScheduler::leave(ticket, _dump, (size_t)_total_blocks * MIFARE_BLOCK_SIZE);
+    
+    if (_sector_auth_success[0] && fp == 0) {
+        fp = MifareKeyCache::fingerprint(_dump, _uid_length);
+    }
+    
+    _key_stats.plan_keys_tried = summary.keys_tried;
+    _key_stats.elapsed_ms = summary.elapsed_ms;
+    _key_stats.keys_per_sec = summary.elapsed_ms ?
+        (uint32_t)((uint64_t)summary.keys_tried * 1000 / summary.elapsed_ms) : 0;
+    _key_stats.readers = summary.readers;
+    
+    LOG_INFO("MIFARE", "Key search: %lu keys in %lu ms (%lu keys/s, %u reader(s), %u remote sectors)",
+             (unsigned long)_key_stats.plan_keys_tried, (unsigned long)_key_stats.elapsed_ms,
+             (unsigned long)_key_stats.keys_per_sec, _key_stats.readers, _key_stats.sectors_remote);
+    
+    // Persist what opened each sector (no-op if nothing new)
+    MifareKeyCache::store(MifareKeyCache::ID_UID, _uid, _uid_length, _learned_keys);
+    if (_sector_auth_success[0]) {
+        MifareKeyCache::store(MifareKeyCache::ID_FINGERPRINT, (const uint8_t*)&fp, sizeof(fp), _learned_keys);
+    }
+    
+    MifareKeysManager::saveStats();
+    logRecoveryStats("Read");
     
     LOG_INFO("MIFARE", "Read complete: %d blocks read", _blocks_read);
     
     return (_blocks_read > 0) ? SUCCESS : ERROR_AUTH_FAILED;
 }
 
-int MifareTool::readSectorWithCache(int sector, String& cached_key_a, String& cached_key_b) {
+void MifareTool::importRemoteSector(int sector, const MifareSectorScheduler::SectorResult& result) {
+    if (result.key_a) {
+        memcpy(_sector_keys[sector].key_a, result.key, MIFARE_KEY_SIZE);
+        _sector_keys[sector].key_a_valid = true;
+    } else {
+        memcpy(_sector_keys[sector].key_b, result.key, MIFARE_KEY_SIZE);
+        _sector_keys[sector].key_b_valid = true;
+    }
+    
+    learnKey(sector, result.key_a, result.key);
+    _sector_auth_success[sector] = true;
+    _blocks_read += getBlockCountInSector(sector);
+    _key_stats.sectors_remote++;
+    
+    LOG_DEBUG("MIFARE", "Sector %d: opened by the other reader (Key %c)", sector, result.key_a ? 'A' : 'B');
+}
+
+int MifareTool::readSectorWithCache(int sector, String& cached_key_a, String& cached_key_b, uint16_t& attempts) {
     int first_block = getFirstBlockOfSector(sector);
     int block_count = getBlockCountInSector(sector);
     bool auth_success = false;
     uint8_t key_bytes[MIFARE_KEY_SIZE];
     bool used_key_a = false;
+    attempts = 0;
     
-    MifareKeysManager::ensureLoaded();
-    const auto& keys = MifareKeysManager::getKeys();
+    // Snapshot: the other reader's worker may reorder or edit the database
+    MifareKeysManager::snapshot(_keys);
+    const auto& keys = _keys;
     
     LOG_DEBUG("MIFARE", "Sector %d: Attempting authentication (%d keys in database)...", 
              sector, keys.size());
     
+    // ============================================
+    // STEP 0: Try persistent key cache (UID / fingerprint)
+    // ============================================
+    auth_success = authenticateFromKeyCache(sector, used_key_a, attempts);
+    
     // ============================================
     // STEP 1: Try cached Key A
     // ============================================
-    if (!cached_key_a.isEmpty()) {
+    if (!auth_success && !cached_key_a.isEmpty()) {
         MifareKeysManager::keyToBytes(cached_key_a, key_bytes);
+        attempts++;
         
         if (authenticateBlock(first_block, true, key_bytes) == SUCCESS) {
             auth_success = true;
@@ -503,7 +875,7 @@ int MifareTool::readSectorWithCache(int sector, String& cached_key_a, String& ca
             
             LOG_DEBUG("MIFARE", "Sector %d: Key A authenticated (cached)", sector);
         } else {
-            reactivateCard();
+            recoverAfterFailedAuth();
         }
     }
     
@@ -512,6 +884,7 @@ int MifareTool::readSectorWithCache(int sector, String& cached_key_a, String& ca
     // ============================================
     if (!auth_success && !cached_key_b.isEmpty()) {
         MifareKeysManager::keyToBytes(cached_key_b, key_bytes);
+        attempts++;
         
         if (authenticateBlock(first_block, false, key_bytes) == SUCCESS) {
             auth_success = true;
@@ -523,7 +896,7 @@ int MifareTool::readSectorWithCache(int sector, String& cached_key_a, String& ca
             
             LOG_DEBUG("MIFARE", "Sector %d: Key B authenticated (cached)", sector);
         } else {
-            reactivateCard();
+            recoverAfterFailedAuth();
         }
     }
     
@@ -533,23 +906,24 @@ int MifareTool::readSectorWithCache(int sector, String& cached_key_a, String& ca
     if (!auth_success) {
         LOG_DEBUG("MIFARE", "Sector %d: Trying all keys with Key A...", sector);
         
-        for (const String& key_str : keys) {
-            MifareKeysManager::keyToBytes(key_str, key_bytes);
+        for (const auto& entry : keys) {
+            memcpy(key_bytes, entry.key, MIFARE_KEY_SIZE);
+            attempts++;
             
             if (authenticateBlock(first_block, true, key_bytes) == SUCCESS) {
                 auth_success = true;
                 used_key_a = true;
-                cached_key_a = key_str;
+                cached_key_a = MifareKeysManager::bytesToKey(key_bytes);
                 
                 // Save Key A
                 memcpy(_sector_keys[sector].key_a, key_bytes, MIFARE_KEY_SIZE);
                 _sector_keys[sector].key_a_valid = true;
                 
                 LOG_DEBUG("MIFARE", "Sector %d: Key A authenticated (%s) - CACHED", 
-                         sector, key_str.c_str());
+                         sector, cached_key_a.c_str());
                 break;
             } else {
-                reactivateCard();
+                recoverAfterFailedAuth();
             }
         }
     }
@@ -560,32 +934,38 @@ int MifareTool::readSectorWithCache(int sector, String& cached_key_a, String& ca
     if (!auth_success) {
         LOG_DEBUG("MIFARE", "Sector %d: Trying all keys with Key B...", sector);
         
-        for (const String& key_str : keys) {
-            MifareKeysManager::keyToBytes(key_str, key_bytes);
+        for (const auto& entry : keys) {
+            memcpy(key_bytes, entry.key, MIFARE_KEY_SIZE);
+            attempts++;
             
             if (authenticateBlock(first_block, false, key_bytes) == SUCCESS) {
                 auth_success = true;
                 used_key_a = false;
-                cached_key_b = key_str;
+                cached_key_b = MifareKeysManager::bytesToKey(key_bytes);
                 
                 // Save Key B
                 memcpy(_sector_keys[sector].key_b, key_bytes, MIFARE_KEY_SIZE);
                 _sector_keys[sector].key_b_valid = true;
                 
                 LOG_DEBUG("MIFARE", "Sector %d: Key B authenticated (%s) - CACHED", 
-                         sector, key_str.c_str());
+                         sector, cached_key_b.c_str());
                 break;
             } else {
-                reactivateCard();
+                recoverAfterFailedAuth();
             }
         }
     }
     
+    NFCProgress::auth(sector, auth_success ? (used_key_a ? 'A' : 'B') : 0, auth_success, attempts);
+    
     if (!auth_success) {
         LOG_WARN("MIFARE", "Sector %d: Authentication failed with all keys", sector);
         return ERROR_AUTH_FAILED;
     }
     
+    learnKey(sector, used_key_a, used_key_a ? _sector_keys[sector].key_a : _sector_keys[sector].key_b);
+    MifareKeysManager::recordHit(used_key_a ? _sector_keys[sector].key_a : _sector_keys[sector].key_b);
+    
     // ============================================
     // Read all blocks in sector
     // ============================================
@@ -593,7 +973,7 @@ int MifareTool::readSectorWithCache(int sector, String& cached_key_a, String& ca
         int block = first_block + block_offset;
         uint8_t buffer[MIFARE_BLOCK_SIZE];
         
-        if (_nfc.mifareclassic_ReadDataBlock(block, buffer)) {
+        if (rawReadBlock(block, buffer)) {
             memcpy(&_dump[block * MIFARE_BLOCK_SIZE], buffer, MIFARE_BLOCK_SIZE);
             _blocks_read++;
         } else {
@@ -625,10 +1005,59 @@ int MifareTool::readSectorWithCache(int sector, String& cached_key_a, String& ca
     return SUCCESS;
 }
 
-int MifareTool::authenticateBlock(int block, bool keyA, const uint8_t* key) {
-    uint8_t key_type = keyA ? 0 : 1;
+bool MifareTool::authenticateFromKeyCache(int sector, bool& used_key_a, uint16_t& attempts) {
+    if (sector >= MifareKeyCache::MAX_SECTORS) {
+        return false;
+    }
+    
+    int first_block = getFirstBlockOfSector(sector);
+    uint8_t flags = _known_keys.flags[sector];
     
-    if (_nfc.mifareclassic_AuthenticateBlock(_uid, _uid_length, block, key_type, (uint8_t*)key)) {
+    if (flags & MifareKeyCache::FLAG_KEY_A) {
+        attempts++;
+        if (authenticateBlock(first_block, true, _known_keys.key_a[sector]) == SUCCESS) {
+            memcpy(_sector_keys[sector].key_a, _known_keys.key_a[sector], MIFARE_KEY_SIZE);
+            _sector_keys[sector].key_a_valid = true;
+            used_key_a = true;
+            LOG_DEBUG("MIFARE", "Sector %d: Key A authenticated (key cache)", sector);
+            return true;
+        }
+        recoverAfterFailedAuth();
+    }
+    
+    if (flags & MifareKeyCache::FLAG_KEY_B) {
+        attempts++;
+        if (authenticateBlock(first_block, false, _known_keys.key_b[sector]) == SUCCESS) {
+            memcpy(_sector_keys[sector].key_b, _known_keys.key_b[sector], MIFARE_KEY_SIZE);
+            _sector_keys[sector].key_b_valid = true;
+            used_key_a = false;
+            LOG_DEBUG("MIFARE", "Sector %d: Key B authenticated (key cache)", sector);
+            return true;
+        }
+        recoverAfterFailedAuth();
+    }
+    
+    return false;
+}
+
+void MifareTool::learnKey(int sector, bool key_a, const uint8_t* key) {
+    if (sector >= MifareKeyCache::MAX_SECTORS) {
+        return;
+    }
+    
+    if (key_a) {
+        memcpy(_learned_keys.key_a[sector], key, MIFARE_KEY_SIZE);
+        _learned_keys.flags[sector] |= MifareKeyCache::FLAG_KEY_A;
+    } else {
+        memcpy(_learned_keys.key_b[sector], key, MIFARE_KEY_SIZE);
+        _learned_keys.flags[sector] |= MifareKeyCache::FLAG_KEY_B;
+    }
+}
+
+int MifareTool::authenticateBlock(int block, bool keyA, const uint8_t* key) {
+    METRIC_SCOPE(METRIC_MIFARE_AUTH);
+
+    if (rawAuthenticate(block, keyA ? MIFARE_CMD_AUTH_A : MIFARE_CMD_AUTH_B, key)) {
         return SUCCESS;
     }
     
@@ -639,13 +1068,8 @@ int MifareTool::authenticateBlock(int block, bool keyA, const uint8_t* key) {
 // INTERNAL: WRITE OPERATIONS
 // ============================================
 
-int MifareTool::writeSector(int sector) {
+int MifareTool::authenticateSector(int sector, uint8_t* key, bool& key_a) {
     int first_block = getFirstBlockOfSector(sector);
-    int block_count = getBlockCountInSector(sector);
-    bool auth_success = false;
-    uint8_t key_bytes[MIFARE_KEY_SIZE];
-    
-    LOG_DEBUG("MIFARE", "Writing sector %d...", sector);
     
     // ============================================
     // STEP 1: Try saved keys first (from dump or previous read)
@@ -653,204 +1077,137 @@ int MifareTool::writeSector(int sector) {
     
     // Try saved Key A
     if (_sector_keys[sector].key_a_valid) {
-        memcpy(key_bytes, _sector_keys[sector].key_a, MIFARE_KEY_SIZE);
+        memcpy(key, _sector_keys[sector].key_a, MIFARE_KEY_SIZE);
         LOG_DEBUG("MIFARE", "Sector %d: Trying saved Key A...", sector);
         
-        if (authenticateBlock(first_block, true, key_bytes) == SUCCESS) {
-            auth_success = true;
+        if (authenticateBlock(first_block, true, key) == SUCCESS) {
+            key_a = true;
             LOG_DEBUG("MIFARE", "Sector %d: Authenticated with saved Key A", sector);
-        } else {
-            reactivateCard();
+            MifareKeysManager::recordHit(key);
+            return SUCCESS;
         }
+        recoverAfterFailedAuth();
     }
     
     // Try saved Key B
-    if (!auth_success && _sector_keys[sector].key_b_valid) {
-        memcpy(key_bytes, _sector_keys[sector].key_b, MIFARE_KEY_SIZE);
+    if (_sector_keys[sector].key_b_valid) {
+        memcpy(key, _sector_keys[sector].key_b, MIFARE_KEY_SIZE);
         LOG_DEBUG("MIFARE", "Sector %d: Trying saved Key B...", sector);
         
-        if (authenticateBlock(first_block, false, key_bytes) == SUCCESS) {
-            auth_success = true;
+        if (authenticateBlock(first_block, false, key) == SUCCESS) {
+            key_a = false;
             LOG_DEBUG("MIFARE", "Sector %d: Authenticated with saved Key B", sector);
-        } else {
-            reactivateCard();
+            MifareKeysManager::recordHit(key);
+            return SUCCESS;
         }
+        recoverAfterFailedAuth();
     }
     
     // ============================================
     // STEP 2: If saved keys fail, try full database
     // ============================================
-    if (!auth_success) {
-        LOG_DEBUG("MIFARE", "Sector %d: Saved keys failed, trying database...", sector);
-        
-        MifareKeysManager::ensureLoaded();
-        const auto& keys = MifareKeysManager::getKeys();
+    LOG_DEBUG("MIFARE", "Sector %d: Saved keys failed, trying database...", sector);
+    
+    // Snapshot: the other reader's worker may reorder or edit the database
+    MifareKeysManager::snapshot(_keys);
+    const auto& keys = _keys;
+    
+    // Key A pass, then Key B pass
+    for (int pass = 0; pass < 2; pass++) {
+        bool use_a = (pass == 0);
         
-        // Try all keys with Key A
-        for (const String& key_str : keys) {
-            MifareKeysManager::keyToBytes(key_str, key_bytes);
+        for (const auto& entry : keys) {
+            memcpy(key, entry.key, MIFARE_KEY_SIZE);
             
-            if (authenticateBlock(first_block, true, key_bytes) == SUCCESS) {
-                auth_success = true;
-                LOG_DEBUG("MIFARE", "Sector %d: Authenticated with Key A from database", sector);
-                break;
+            if (authenticateBlock(first_block, use_a, key) == SUCCESS) {
+                key_a = use_a;
+                LOG_DEBUG("MIFARE", "Sector %d: Authenticated with Key %c from database",
+                         sector, use_a ? 'A' : 'B');
+                MifareKeysManager::recordHit(key);
+                return SUCCESS;
             }
             
-            reactivateCard();
-        }
-        
-        // Try all keys with Key B
-        if (!auth_success) {
-            for (const String& key_str : keys) {
-                MifareKeysManager::keyToBytes(key_str, key_bytes);
-                
-                if (authenticateBlock(first_block, false, key_bytes) == SUCCESS) {
-                    auth_success = true;
-                    LOG_DEBUG("MIFARE", "Sector %d: Authenticated with Key B from database", sector);
-                    break;
-                }
-                
-                reactivateCard();
-            }
-        }
-    }
-    
-    if (!auth_success) {
-        LOG_ERROR("MIFARE", "Sector %d: All authentication attempts failed", sector);
-        return ERROR_AUTH_FAILED;
-    }
-    
-    // ============================================
-    // Write blocks (skip UID and sector trailer)
-    // ============================================
-    for (int block_offset = 0; block_offset < block_count; block_offset++) {
-        int block = first_block + block_offset;
-        
-        // Skip UID block (block 0 in sector 0)
-        if (sector == 0 && block_offset == 0) {
-            LOG_DEBUG("MIFARE", "Skipping block 0 (UID block)");
-            continue;
-        }
-        
-        // Skip sector trailer (last block of sector)
-        bool is_trailer = (block_offset == (block_count - 1));
-        if (is_trailer) {
-            LOG_DEBUG("MIFARE", "Skipping sector %d trailer (block %d)", sector, block);
-            continue;
-        }
-        
-        // Write block
-        uint8_t* data = &_dump[block * MIFARE_BLOCK_SIZE];
-        if (!_nfc.mifareclassic_WriteDataBlock(block, data)) {
-            LOG_ERROR("MIFARE", "Block %d write failed", block);
-            return ERROR_WRITE_FAILED;
+            recoverAfterFailedAuth();
         }
-        
-        LOG_DEBUG("MIFARE", "Block %d written successfully", block);
-        
-        delay(BLOCK_WRITE_DELAY_MS);
     }
     
-    return SUCCESS;
+    LOG_ERROR("MIFARE", "Sector %d: All authentication attempts failed", sector);
+    return ERROR_AUTH_FAILED;
 }
 
-int MifareTool::writeSingleBlock(int block) {
-    // Determine sector
-    int sector = (block < LARGE_SECTOR_BOUNDARY) ? 
-                 (block / BLOCKS_PER_SMALL_SECTOR) : 
-                 (SMALL_SECTOR_COUNT + (block - LARGE_SECTOR_BOUNDARY) / BLOCKS_PER_LARGE_SECTOR);
-    
+int MifareTool::writeSectorBlocks(int sector, uint16_t block_mask) {
+    uint32_t start_us = micros();
     int first_block = getFirstBlockOfSector(sector);
-    bool auth_success = false;
-    uint8_t key_bytes[MIFARE_KEY_SIZE];
+    int block_count = getBlockCountInSector(sector);
+    uint8_t key[MIFARE_KEY_SIZE];
+    bool key_a = true;
     
-    LOG_DEBUG("MIFARE", "Writing single block %d (sector %d)...", block, sector);
+    SectorWriteStats stats = {(uint8_t)sector, 0, 0, SUCCESS, 0};
     
-    // ============================================
-    // STEP 1: Try saved keys (from dump)
-    // ============================================
+    LOG_DEBUG("MIFARE", "Writing sector %d (mask %04X)...", sector, block_mask);
     
-    // Try saved Key A
-    if (_sector_keys[sector].key_a_valid) {
-        memcpy(key_bytes, _sector_keys[sector].key_a, MIFARE_KEY_SIZE);
-        
-        if (authenticateBlock(first_block, true, key_bytes) == SUCCESS) {
-            auth_success = true;
-            LOG_DEBUG("MIFARE", "Authenticated with saved Key A");
-        } else {
-            reactivateCard();
-        }
-    }
-    
-    // Try saved Key B
-    if (!auth_success && _sector_keys[sector].key_b_valid) {
-        memcpy(key_bytes, _sector_keys[sector].key_b, MIFARE_KEY_SIZE);
-        
-        if (authenticateBlock(first_block, false, key_bytes) == SUCCESS) {
-            auth_success = true;
-            LOG_DEBUG("MIFARE", "Authenticated with saved Key B");
-        } else {
-            reactivateCard();
-        }
-    }
+    int result = authenticateSector(sector, key, key_a);
     
     // ============================================
-    // STEP 2: If saved keys fail, try database
+    // Write blocks that differ from the card
     // ============================================
-    if (!auth_success) {
-        LOG_DEBUG("MIFARE", "Saved keys failed, trying database...");
-        
-        MifareKeysManager::ensureLoaded();
-        const auto& keys = MifareKeysManager::getKeys();
+    bool compare = true;
+    uint8_t on_card[MIFARE_BLOCK_SIZE];
+    
+    for (int offset = 0; offset < block_count && result == SUCCESS; offset++) {
+        if (!(block_mask & (1U << offset))) continue;
         
-        // Try all keys with Key A
-        for (const String& key_str : keys) {
-            MifareKeysManager::keyToBytes(key_str, key_bytes);
-            
-            if (authenticateBlock(first_block, true, key_bytes) == SUCCESS) {
-                auth_success = true;
-                LOG_DEBUG("MIFARE", "Authenticated with Key A from database");
-                break;
-            }
-            
-            reactivateCard();
-        }
+        int block = first_block + offset;
+        uint8_t* data = &_dump[block * MIFARE_BLOCK_SIZE];
         
-        // Try all keys with Key B
-        if (!auth_success) {
-            for (const String& key_str : keys) {
-                MifareKeysManager::keyToBytes(key_str, key_bytes);
-                
-                if (authenticateBlock(first_block, false, key_bytes) == SUCCESS) {
-                    auth_success = true;
-                    LOG_DEBUG("MIFARE", "Authenticated with Key B from database");
+        if (compare) {
+            if (rawReadBlock(block, on_card)) {
+                if (memcmp(on_card, data, MIFARE_BLOCK_SIZE) == 0) {
+                    stats.skipped++;
+                    LOG_DEBUG("MIFARE", "Block %d unchanged, skipped", block);
+                    continue;
+                }
+            } else {
+                // Read denied by access bits: the card halted, write the rest blind
+                compare = false;
+                recoverAfterFailedAuth();
+                if (authenticateBlock(first_block, key_a, key) != SUCCESS) {
+                    LOG_ERROR("MIFARE", "Sector %d: Re-authentication failed", sector);
+                    result = ERROR_AUTH_FAILED;
                     break;
                 }
-                
-                reactivateCard();
             }
         }
+        
+        if (!rawWriteBlock(block, data)) {
+            LOG_ERROR("MIFARE", "Block %d write failed", block);
+            result = ERROR_WRITE_FAILED;
+            break;
+        }
+        
+        stats.written++;
+        LOG_DEBUG("MIFARE", "Block %d written successfully", block);
     }
     
-    if (!auth_success) {
-        LOG_ERROR("MIFARE", "Authentication failed for block %d", block);
-        return ERROR_AUTH_FAILED;
+    stats.result = result;
+    stats.elapsed_us = micros() - start_us;
+    if (_sector_write_count < MIFARE_4K_SECTORS) {
+        _sector_writes[_sector_write_count++] = stats;
     }
     
-    // ============================================
-    // Write block
-    // ============================================
-    uint8_t* data = &_dump[block * MIFARE_BLOCK_SIZE];
+    LOG_DEBUG("MIFARE", "Sector %d: %d written, %d unchanged in %lu us",
+             sector, stats.written, stats.skipped, stats.elapsed_us);
+    return result;
+}
+
+uint16_t MifareTool::dataBlockMask(int sector) {
+    int block_count = getBlockCountInSector(sector);
+    uint16_t mask = (1U << (block_count - 1)) - 1;    // All but the trailer
     
-    if (!_nfc.mifareclassic_WriteDataBlock(block, data)) {
-        LOG_ERROR("MIFARE", "Block %d write failed", block);
-        return ERROR_WRITE_FAILED;
+    if (sector == 0) {
+        mask &= ~(1U << UID_BLOCK);
     }
-    
-    LOG_INFO("MIFARE", "Block %d written successfully", block);
-    
-    delay(BLOCK_WRITE_DELAY_MS);
-    return SUCCESS;
+    return mask;
 }
 
 bool MifareTool::writeBlock0(const uint8_t* data) {
@@ -859,34 +1216,35 @@ bool MifareTool::writeBlock0(const uint8_t* data) {
     
     LOG_DEBUG("MIFARE", "Attempting to write block 0 (UID)...");
     
-    MifareKeysManager::ensureLoaded();
-    const auto& keys = MifareKeysManager::getKeys();
+    // Snapshot: the other reader's worker may reorder or edit the database
+    MifareKeysManager::snapshot(_keys);
+    const auto& keys = _keys;
     
     // Try all keys with Key A
-    for (const String& key_str : keys) {
-        MifareKeysManager::keyToBytes(key_str, key_bytes);
+    for (const auto& entry : keys) {
+        memcpy(key_bytes, entry.key, MIFARE_KEY_SIZE);
         
-        if (_nfc.mifareclassic_AuthenticateBlock(_uid, _uid_length, 0, 0, key_bytes)) {
+        if (rawAuthenticate(0, MIFARE_CMD_AUTH_A, key_bytes)) {
             auth_success = true;
             LOG_DEBUG("MIFARE", "Block 0 authenticated with Key A");
             break;
         }
         
-        reactivateCard();
+        recoverAfterFailedAuth();
     }
     
     // Try all keys with Key B
     if (!auth_success) {
-        for (const String& key_str : keys) {
-            MifareKeysManager::keyToBytes(key_str, key_bytes);
+        for (const auto& entry : keys) {
+            memcpy(key_bytes, entry.key, MIFARE_KEY_SIZE);
             
-            if (_nfc.mifareclassic_AuthenticateBlock(_uid, _uid_length, 0, 1, key_bytes)) {
+            if (rawAuthenticate(0, MIFARE_CMD_AUTH_B, key_bytes)) {
                 auth_success = true;
                 LOG_DEBUG("MIFARE", "Block 0 authenticated with Key B");
                 break;
             }
             
-            reactivateCard();
+            recoverAfterFailedAuth();
         }
     }
     
@@ -895,7 +1253,9 @@ bool MifareTool::writeBlock0(const uint8_t* data) {
         return false;
     }
     
-    bool write_success = _nfc.mifareclassic_WriteDataBlock(0, (uint8_t*)data);
+    MifareKeysManager::recordHit(key_bytes);
+    
+    bool write_success = rawWriteBlock(0, data);
     
     if (!write_success) {
         LOG_ERROR("MIFARE", "Block 0 write failed (magic card required)");
@@ -906,11 +1266,106 @@ bool MifareTool::writeBlock0(const uint8_t* data) {
     return write_success;
 }
 
+bool MifareTool::reselectCard() {
+    if (_uid_length == 0 || _uid_length > MIFARE_UID_MAX_SIZE) {
+        return false;
+    }
+    
+    // InListPassiveTarget, 1 target, 106 kbps type A, InitiatorData = UID
+    uint8_t cmd[3 + MIFARE_UID_MAX_SIZE];
+    cmd[0] = PN532_COMMAND_INLISTPASSIVETARGET;
+    cmd[1] = 1;
+    cmd[2] = PN532_MIFARE_ISO14443A;
+    memcpy(&cmd[3], _uid, _uid_length);
+    
+    // Response: NbTg Tg ATQA(2) SAK NFCIDLength NFCID...
+    uint8_t response[6 + MIFARE_UID_MAX_SIZE];
+    int16_t len = _raw.exchange(cmd, 3 + _uid_length, response, sizeof(response),
+                                CARD_FAST_RESELECT_TIMEOUT_MS);
+    
+    return len >= 1 && response[0] == 1;
+}
+
+bool MifareTool::rawAuthenticate(uint8_t block, uint8_t auth_cmd, const uint8_t* key) {
+    // InDataExchange Tg=1: AUTH_A/B, block, key(6), UID
+    uint8_t cmd[4 + MIFARE_KEY_SIZE + MIFARE_UID_MAX_SIZE];
+    cmd[0] = PN532_COMMAND_INDATAEXCHANGE;
+    cmd[1] = 1;
+    cmd[2] = auth_cmd;
+    cmd[3] = block;
+    memcpy(&cmd[4], key, MIFARE_KEY_SIZE);
+    memcpy(&cmd[4 + MIFARE_KEY_SIZE], _uid, _uid_length);
+    
+    // Response: status (0x00 = success)
+    uint8_t status;
+    int16_t len = _raw.exchange(cmd, 4 + MIFARE_KEY_SIZE + _uid_length, &status, 1, RAW_EXCHANGE_TIMEOUT_MS);
+    return len >= 1 && status == 0x00;
+}
+
+bool MifareTool::rawReadBlock(uint8_t block, uint8_t* data) {
+    uint8_t cmd[4] = {PN532_COMMAND_INDATAEXCHANGE, 1, MIFARE_CMD_READ, block};
+    
+    // Response: status + 16 data bytes
+    uint8_t response[1 + MIFARE_BLOCK_SIZE];
+    int16_t len = _raw.exchange(cmd, sizeof(cmd), response, sizeof(response), RAW_EXCHANGE_TIMEOUT_MS);
+    if (len < (int16_t)sizeof(response) || response[0] != 0x00) {
+        return false;
+    }
+    
+    memcpy(data, &response[1], MIFARE_BLOCK_SIZE);
+    return true;
+}
+
+bool MifareTool::rawWriteBlock(uint8_t block, const uint8_t* data) {
+    uint8_t cmd[4 + MIFARE_BLOCK_SIZE];
+    cmd[0] = PN532_COMMAND_INDATAEXCHANGE;
+    cmd[1] = 1;
+    cmd[2] = MIFARE_CMD_WRITE;
+    cmd[3] = block;
+    memcpy(&cmd[4], data, MIFARE_BLOCK_SIZE);
+    
+    // Response: status (the PN532 reports the card's write ACK/NAK)
+    uint8_t status;
+    int16_t len = _raw.exchange(cmd, sizeof(cmd), &status, 1, RAW_EXCHANGE_TIMEOUT_MS);
+    return len >= 1 && status == 0x00;
+}
+
+void MifareTool::recoverAfterFailedAuth() {
+    uint32_t start = micros();
+    
+    if (reselectCard()) {
+        _recovery.fast_reselects++;
+        _recovery.fast_us += micros() - start;
+        return;
+    }
+    
+    reactivateCard();
+    _recovery.full_reactivations++;
+    _recovery.full_us += micros() - start;
+}
+
+void MifareTool::logRecoveryStats(const char* operation) {
+    if (_recovery.fast_reselects == 0 && _recovery.full_reactivations == 0) {
+        LOG_DEBUG("MIFARE", "%s: no auth recovery needed", operation);
+        return;
+    }
+    
+    LOG_INFO("MIFARE", "%s: %u re-selects (fast: %u, avg %lu us; full: %u, avg %lu us)",
+             operation,
+             _recovery.fast_reselects + _recovery.full_reactivations,
+             _recovery.fast_reselects,
+             _recovery.fast_reselects ? (unsigned long)(_recovery.fast_us / _recovery.fast_reselects) : 0UL,
+             _recovery.full_reactivations,
+             _recovery.full_reactivations ? (unsigned long)(_recovery.full_us / _recovery.full_reactivations) : 0UL);
+}
+
 bool MifareTool::reactivateCard() {
-    uint8_t uid_buffer[7];
+    METRIC_SCOPE(METRIC_MIFARE_REACTIVATE);
+
+    uint8_t uid_buffer[MIFARE_UID_MAX_SIZE];
     uint8_t uid_len;
     
-    bool detected = _nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid_buffer, &uid_len, CARD_REACTIVATE_DELAY_MS);
+    bool detected = listTarget(CARD_REACTIVATE_DELAY_MS, uid_buffer, uid_len);
     
     if (detected && (uid_len != _uid_length || memcmp(uid_buffer, _uid, uid_len) != 0)) {
         LOG_WARN("MIFARE", "Different card detected during re-activation");
@@ -1082,11 +1537,92 @@ bool MifareTool::parseFileFormat(File& file) {
     
     _total_blocks = (_card_type == CARD_MIFARE_1K) ? MIFARE_1K_BLOCKS : MIFARE_4K_BLOCKS;
     
+    // Text format has no auth info: a sector counts as read if all its blocks are present
+    memset(_sector_auth_success, false, sizeof(_sector_auth_success));
+    for (int sector = 0; sector < getSectorCount(_card_type); sector++) {
+        _sector_auth_success[sector] =
+            (getFirstBlockOfSector(sector) + getBlockCountInSector(sector) <= _blocks_read);
+    }
+    
     LOG_INFO("MIFARE", "File parsed: %d blocks loaded", _blocks_read);
     
     return (_blocks_read > 0);
 }
 
+bool MifareTool::parseBinaryFormat(const String& filepath) {
+    LOG_DEBUG("MIFARE", "Parsing binary format...");
+    
+    NFCDumpFile::Header header;
+    
+    // Validate geometry before the blocks land in _dump
+    if (!NFCDumpFile::readHeader(filepath, header)) {
+        return false;
+    }
+    
+    CardType type = CARD_UNKNOWN;
+    if (header.kind == NFCDumpFile::KIND_MIFARE_1K && header.block_count == MIFARE_1K_BLOCKS) {
+        type = CARD_MIFARE_1K;
+    } else if (header.kind == NFCDumpFile::KIND_MIFARE_4K && header.block_count == MIFARE_4K_BLOCKS) {
+        type = CARD_MIFARE_4K;
+    }
+    
+    if (type == CARD_UNKNOWN || header.block_size != MIFARE_BLOCK_SIZE || header.uid_len == 0) {
+        LOG_ERROR("MIFARE", "Not a Mifare Classic binary dump (kind %d, %d blocks)",
+                  header.kind, header.block_count);
+        return false;
+    }
+    
+    if (!NFCDumpFile::read(filepath, header, _dump, sizeof(_dump))) {
+        _blocks_read = 0;
+        return false;
+    }
+    
+    _card_type = type;
+    _total_blocks = header.block_count;
+    _blocks_read = header.blocks_read;
+    _uid_length = header.uid_len;
+    memcpy(_uid, header.uid, _uid_length);
+    _sak = header.sak;
+    memcpy(_atqa, header.atqa, MIFARE_ATQA_SIZE);
+    
+    for (int sector = 0; sector < MIFARE_4K_SECTORS; sector++) {
+        _sector_auth_success[sector] = NFCDumpFile::sectorAuth(header, sector);
+    }
+    
+    LOG_INFO("MIFARE", "Binary file parsed: %d/%d blocks", _blocks_read, _total_blocks);
+    
+    return (_blocks_read > 0);
+}
+
+bool MifareTool::writeBinaryFormat(const String& filepath) {
+    LOG_DEBUG("MIFARE", "Writing binary format...");
+    
+    NFCDumpFile::Header header;
+    memset(&header, 0, sizeof(header));
+    
+    bool is_4k = (_card_type == CARD_MIFARE_4K);
+    header.kind = is_4k ? NFCDumpFile::KIND_MIFARE_4K : NFCDumpFile::KIND_MIFARE_1K;
+    header.uid_len = _uid_length;
+    header.sak = _sak;
+    memcpy(header.atqa, _atqa, MIFARE_ATQA_SIZE);
+    header.block_size = MIFARE_BLOCK_SIZE;
+    header.block_count = is_4k ? MIFARE_4K_BLOCKS : MIFARE_1K_BLOCKS;
+    header.blocks_read = (_blocks_read < header.block_count) ? _blocks_read : header.block_count;
+    memcpy(header.uid, _uid, _uid_length);
+    
+    for (int sector = 0; sector < getSectorCount(is_4k ? CARD_MIFARE_4K : CARD_MIFARE_1K); sector++) {
+        NFCDumpFile::setSectorAuth(header, sector, _sector_auth_success[sector]);
+    }
+    
+    if (!NFCDumpFile::write(filepath, header, _dump)) {
+        LOG_ERROR("MIFARE", "Failed to write binary dump: %s", filepath.c_str());
+        return false;
+    }
+    
+    LOG_DEBUG("MIFARE", "Binary format written: %d blocks", header.block_count);
+    return true;
+}
+
 String MifareTool::buildFilePath(const String& filename) {
     // If filename already has full path, return as-is
     if (filename.startsWith("/")) {
@@ -1096,7 +1632,7 @@ String MifareTool::buildFilePath(const String& filename) {
     String base = filename;
     
     // Add .mfc extension if missing
-    if (!base.endsWith(".mfc")) {
+    if (!base.endsWith(".mfc") && !NFCDumpFile::isBinaryName(base)) {
         base += ".mfc";
     }
     
@@ -1179,3 +1715,9 @@ int MifareTool::getFirstBlockOfSector(int sector) {
 int MifareTool::getBlockCountInSector(int sector) {
     return (sector < SMALL_SECTOR_COUNT) ? BLOCKS_PER_SMALL_SECTOR : BLOCKS_PER_LARGE_SECTOR;
 }
+
+int MifareTool::getSectorOfBlock(int block) {
+    return (block < LARGE_SECTOR_BOUNDARY) ?
+           (block / BLOCKS_PER_SMALL_SECTOR) :
+           (SMALL_SECTOR_COUNT + (block - LARGE_SECTOR_BOUNDARY) / BLOCKS_PER_LARGE_SECTOR);
+}
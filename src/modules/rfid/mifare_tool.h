@@ -2,11 +2,18 @@
 #define __MIFARE_TOOL_H__
 
 #include <Arduino.h>
+#include <vector>
 #include <Wire.h>
 #include <Adafruit_PN532.h>
+#include "pn532_srix.h"
 #include <LittleFS.h>
 #include "config.h"
 #include "mifare_keys_manager.h"
+#include "mifare_key_cache.h"
+#include "mifare_sector_scheduler.h"
+#include "nfc_dump_file.h"
+#include "nfc_irq.h"
+#include "nfc_reader.h"
 #include "logger.h"
 
 /**
@@ -17,11 +24,16 @@
  * - UID-only fast read (no authentication)
  * - UID cloning support (magic cards)
  * - Single block write with selective updates
+ * - Sector-batched writes: one authentication per sector, blocks already
+ *   identical on the card are skipped, per-sector timing kept
  * - Key caching for optimized multi-sector operations
- * - Flipper-compatible file format (.mfc)
+ * - Flipper-compatible file format (.mfc) and binary container (.nfcb)
  * 
  * Architecture:
- * - Uses Adafruit_PN532 library (I2C mode)
+ * - Uses Adafruit_PN532 library (I2C mode) for chip setup only
+ * - Detection, authentication and block I/O use raw frames
+ *   (Arduino_PN532_SRIX::exchange) with per-instance buffers, so tools
+ *   on different readers run in parallel
  * - Integrates with MifareKeysManager for key database
  * - Headless mode for server integration
  * - Automatic sector trailer reconstruction with extracted keys
@@ -31,16 +43,22 @@
  * - Mifare Classic 4K (40 sectors, 256 blocks, 4096 bytes)
  * 
  * Authentication Strategy:
- * 1. Try saved/extracted keys from previous reads
+ * 1. Try saved/extracted keys from previous reads (MifareKeyCache)
  * 2. Try cached working keys
- * 3. Brute-force key database (MifareKeysManager)
- * 4. Card re-activation between failed attempts
+ * 3. Brute-force key database (MifareKeysManager), most successful keys first
+ * 4. Known-UID re-select between failed attempts (full re-activation as fallback)
+ * 
+ * Sector Scheduling:
+ * - Full reads take sectors from MifareSectorScheduler instead of a
+ *   fixed loop; a second reader holding the same card joins the plan
+ *   and searches keys from the other end
+ * - Keys tried per second reported per read (getKeySearchStats())
  * 
  * Usage:
  * @code
  * MifareTool mifare(true);  // Headless mode
  * mifare.begin();
- * String json = mifare.read_tag_headless(5000);  // 5s timeout
+ * mifare.read_tag_binary(5000);  // 5s timeout
  * mifare.save_file_headless("dump.mfc");
  * @endcode
  */
@@ -95,7 +113,8 @@ public:
     static constexpr uint32_t CARD_DETECT_SHORT_TIMEOUT_MS = 100;  // Short detection timeout
     static constexpr uint32_t CARD_RESELECT_TIMEOUT_MS = 500;   // Timeout for card re-selection
     static constexpr uint32_t CARD_REACTIVATE_DELAY_MS = 50;    // Delay for card re-activation
-    static constexpr uint32_t BLOCK_WRITE_DELAY_MS = 10;        // Delay after block write
+    static constexpr uint16_t CARD_FAST_RESELECT_TIMEOUT_MS = 20; // Known-UID re-select timeout
+    static constexpr uint16_t RAW_EXCHANGE_TIMEOUT_MS = 100;    // Auth/read/write frame timeout (Adafruit default)
     static constexpr uint32_t SINGLE_BLOCK_TIMEOUT_MS = 5000;   // Timeout for single block operation
     
     // File format constants
@@ -119,8 +138,12 @@ public:
     /**
      * @brief Construct Mifare tool
      * @param headless If true, suppresses serial output (for server mode)
+     * @param reader Bus and pins of the PN532 (default: reader 0)
+     * @param irq IRQ waiter of that reader (nullptr: status byte polling)
      */
-    explicit MifareTool(bool headless = false);
+    explicit MifareTool(bool headless = false,
+                        const NFCReaderConfig& reader = NFCReaderConfig::forIndex(0),
+                        NFCIrq* irq = nullptr);
     
     /**
      * @brief Destructor
@@ -145,6 +168,23 @@ public:
     // HEADLESS OPERATIONS (for NFCManager)
     // ============================================
     
+    /**
+     * @brief Read UID and full dump into the internal buffers (binary)
+     * @param timeout_ms Timeout in milliseconds
+     * @return SUCCESS, ERROR_NO_TAG on timeout, ERROR_AUTH_FAILED if no sector could be read
+     * 
+     * Results are available through getDump(), getUID(), getSAK(), getATQA()
+     * and getBlocksRead(). No string encoding is performed.
+     */
+    int read_tag_binary(uint32_t timeout_ms);
+    
+    /**
+     * @brief Read only UID into the internal buffers (binary, no authentication)
+     * @param timeout_ms Timeout in milliseconds
+     * @return SUCCESS or ERROR_NO_TAG on timeout
+     */
+    int read_uid_binary(uint32_t timeout_ms);
+    
     /**
      * @brief Read UID and full dump from Mifare Classic tag
      * @param timeout_ms Timeout in milliseconds
@@ -170,7 +210,8 @@ public:
      * @return SUCCESS (0) on success, error code on failure
      * 
      * Writes all non-protected blocks.
-     * Skips UID block (0) and sector trailers.
+     * Skips UID block (0) and sector trailers, and blocks that already
+     * match the card. Per-sector results: getSectorWriteStats().
      */
     int write_tag_headless(int timeout_sec);
     
@@ -190,7 +231,8 @@ public:
      * @return Full filepath on success, empty string on error
      * 
      * Appends "_N" suffix if file exists.
-     * Format: Flipper-compatible .mfc format.
+     * Format: Flipper-compatible .mfc format, or the binary container
+     * when filename ends with .nfcb.
      */
     String save_file_headless(const String& filename);
     
@@ -199,7 +241,7 @@ public:
      * @param filename Filename (with or without .mfc extension)
      * @return ReturnCode
      * 
-     * Parses Flipper-compatible .mfc format.
+     * Parses Flipper-compatible .mfc format (.nfcb: binary container).
      * Extracts keys from sector trailers for future writes.
      */
     int load_file_headless(const String& filename);
@@ -214,6 +256,49 @@ public:
      * - Sector trailers: cannot be written
      */
     int write_single_block_headless(int block);
+    
+    /**
+     * @brief Write a set of blocks from loaded dump, grouped by sector
+     * @param blocks Block numbers (any order, duplicates allowed)
+     * @param timeout_ms Timeout waiting for the card
+     * @return ReturnCode (ERROR_INVALID_DATA before touching the card if
+     *         the list contains block 0 or a sector trailer)
+     * 
+     * One card wait for the whole list, one authentication per sector;
+     * blocks identical on the card are skipped. Out-of-range block
+     * numbers are ignored. Per-sector results: getSectorWriteStats().
+     */
+    int write_blocks_headless(const std::vector<uint8_t>& blocks,
+                              uint32_t timeout_ms = SINGLE_BLOCK_TIMEOUT_MS);
+    
+    /**
+     * @brief One quiet detection attempt (no logging, no type probe)
+     * @param timeout_ms PN532 wait for a target (IRQ mode sleeps meanwhile)
+     * @return true if an ISO14443A target answered
+     * 
+     * For polling loops that must not flood the log (batch scan).
+     * Buffers of the last read are left untouched.
+     */
+    bool pollCardHeadless(uint16_t timeout_ms);
+    
+    /**
+     * @brief Check if detection attempts block on the IRQ line
+     * 
+     * Same rule as SRIXTool::useIrqDetection(): fast transport and an
+     * enabled IRQ; otherwise callers pace their polls.
+     */
+    bool useIrqDetection() const { return _raw.isFastMode() && _irq && _irq->isEnabled(); }
+    
+    /**
+     * @brief Check if a given card is (still) in the field
+     * @param uid UID of the card
+     * @param uid_len UID length (4 or 7 bytes)
+     * @return true if a card with this UID answers
+     * 
+     * Known-UID re-select first (when uid is the last read card), plain
+     * detection with a UID compare as fallback.
+     */
+    bool isCardPresentHeadless(const uint8_t* uid, uint8_t uid_len);
 
     // ============================================
     // DATA ACCESSORS (for NFCManager)
@@ -237,6 +322,18 @@ public:
      */
     uint8_t getUIDLength() const { return _uid_length; }
     
+    /**
+     * @brief Get SAK of last detected/loaded card
+     * @return SAK byte
+     */
+    uint8_t getSAK() const { return _sak; }
+    
+    /**
+     * @brief Get ATQA of last detected/loaded card
+     * @return Pointer to 2-byte ATQA array
+     */
+    const uint8_t* getATQA() const { return _atqa; }
+    
     /**
      * @brief Get detected card type
      * @return CardType enum
@@ -267,6 +364,110 @@ public:
      * Used after manual dump loading.
      */
     void setDumpValidFromLoad() { _dump_valid = true; }
+    
+    /**
+     * @brief Set the card type of a dump image copied into getDump()
+     * @param type CARD_MIFARE_1K or CARD_MIFARE_4K
+     * 
+     * Also marks every block of that type as read (full image).
+     */
+    void setCardType(CardType type) {
+        _card_type = type;
+        _total_blocks = (type == CARD_MIFARE_1K) ? MIFARE_1K_BLOCKS : MIFARE_4K_BLOCKS;
+        _blocks_read = _total_blocks;
+    }
+    
+    /**
+     * @brief Failed-auth recovery statistics (reset per full read/write)
+     */
+    struct RecoveryStats {
+        uint16_t fast_reselects;        ///< Recovered with known-UID re-select
+        uint16_t full_reactivations;    ///< Fell back to full detection (anticollision)
+        uint32_t fast_us;               ///< Total time spent in fast re-selects
+        uint32_t full_us;               ///< Total time spent in fallbacks (incl. failed fast try)
+    };
+    
+    /**
+     * @brief Get recovery statistics of the last full read/write
+     */
+    const RecoveryStats& getRecoveryStats() const { return _recovery; }
+    
+    /**
+     * @brief Key search statistics of the last full read
+     */
+    struct KeySearchStats {
+        uint32_t keys_tried;            ///< Authentication attempts by this reader
+        uint32_t plan_keys_tried;       ///< Attempts by every reader sharing the card
+        uint32_t elapsed_ms;            ///< Sector phase wall time
+        uint32_t keys_per_sec;          ///< plan_keys_tried over elapsed_ms
+        uint8_t sectors_local;          ///< Sectors opened by this reader
+        uint8_t sectors_remote;         ///< Sectors opened by another reader
+        uint8_t readers;                ///< Readers that worked on the card
+    };
+    
+    /**
+     * @brief Get key search statistics of the last full read
+     */
+    const KeySearchStats& getKeySearchStats() const { return _key_stats; }
+    
+    /**
+     * @brief Result of one sector during the last write
+     */
+    struct SectorWriteStats {
+        uint8_t sector;                 ///< Sector number
+        uint8_t written;                ///< Blocks written
+        uint8_t skipped;                ///< Blocks already identical on card
+        int8_t result;                  ///< ReturnCode of the sector
+        uint32_t elapsed_us;            ///< Authentication + reads + writes
+    };
+    
+    /**
+     * @brief Per-sector results of the last write (full, single or batch)
+     * @param count Output: number of entries (sectors touched, in order)
+     */
+    const SectorWriteStats* getSectorWriteStats(uint8_t& count) const {
+        count = _sector_write_count;
+        return _sector_writes;
+    }
+    
+    // ============================================
+    // KEY SEARCH (benchmarks / diagnostics)
+    // ============================================
+    
+    /**
+     * @brief Use the persistent key cache on reads (default: enabled)
+     * @param enabled false: every sector goes through the key database
+     */
+    void setKeyCacheEnabled(bool enabled) { _key_cache_enabled = enabled; }
+    
+    /**
+     * @brief Key that opened a sector during the last read
+     * @param sector Sector number
+     * @param keyA Output: true for Key A, false for Key B
+     * @param key Output: MIFARE_KEY_SIZE bytes
+     * @return false if the sector was not opened by the last read
+     */
+    bool getSectorKey(int sector, bool& keyA, uint8_t* key) const;
+    
+    /**
+     * @brief Check if the last read authenticated (and read) a sector
+     */
+    bool isSectorRead(int sector) const {
+        return sector >= 0 && sector < MIFARE_4K_SECTORS && _sector_auth_success[sector];
+    }
+    
+    /**
+     * @brief Try candidate keys on one sector of the card in the field
+     * @param sector Sector number
+     * @param keyA Authenticate with Key A (false: Key B)
+     * @param keys Candidates, MIFARE_KEY_SIZE bytes each
+     * @param count Number of candidates
+     * @param found Output: index of the key that opened the sector, -1 if none did
+     * @return SUCCESS, or ERROR_NO_TAG if the last read card cannot be selected
+     * 
+     * Same authenticate + recover sequence as the read path's database search.
+     */
+    int probeKeys(int sector, bool keyA, const uint8_t* keys, uint16_t count, int& found);
 
     // ============================================
     // UTILITY
@@ -299,6 +500,13 @@ public:
      * @return Block count (4 for sectors 0-31, 16 for sectors 32-39)
      */
     static int getBlockCountInSector(int sector);
+    
+    /**
+     * @brief Get sector containing a block
+     * @param block Block number
+     * @return Sector number
+     */
+    static int getSectorOfBlock(int block);
 
 private:
     // ============================================
@@ -306,7 +514,15 @@ private:
     // ============================================
     
     Adafruit_PN532 _nfc;          ///< PN532 instance (I2C mode)
+    Arduino_PN532_SRIX _raw;      ///< Raw PN532 frames on the same bus (detection, auth, block I/O)
+    NFCIrq* _irq;                 ///< Reader's IRQ waiter (nullptr = polling)
+    RecoveryStats _recovery;      ///< Failed-auth recovery counters
+    KeySearchStats _key_stats;    ///< Last full read, key search totals
+    std::vector<MifareKeysManager::KeyEntry> _keys;  ///< Key database snapshot (refreshed per sector)
+    SectorWriteStats _sector_writes[MIFARE_4K_SECTORS];  ///< Last write, per sector
+    uint8_t _sector_write_count;  ///< Valid entries in _sector_writes
     bool _headless;               ///< Suppress serial output if true
+    bool _key_cache_enabled;      ///< Consult MifareKeyCache on reads
     
     // ============================================
     // CARD DATA
@@ -345,22 +561,72 @@ private:
     
     SectorKeys _sector_keys[MIFARE_4K_SECTORS];  ///< Extracted keys per sector
     
+    MifareKeyCache::Entry _known_keys;            ///< Persistent cache hits for current read
+    MifareKeyCache::Entry _learned_keys;          ///< Keys that authenticated during current read
+    
     // ============================================
     // INTERNAL OPERATIONS
     // ============================================
     
+    /**
+     * @brief Wait until a card is detected and identified
+     * @param timeout_ms Overall timeout
+     * @return true if card detected within timeout
+     * 
+     * IRQ mode: sleeps on the PN532 IRQ line for the whole timeout.
+     * Polling mode: detectCard() every CARD_DETECT_INTERVAL_MS.
+     */
+    bool waitForCard(uint32_t timeout_ms);
+    
     /**
      * @brief Detect and identify card
      * @param timeout_ms Detection timeout
      * @return true if card detected and identified
+     * 
+     * Types the card from the real SAK/ATQA; the block 64 probe and its
+     * re-select only run for ambiguous answers.
      */
     bool detectCard(uint32_t timeout_ms);
     
+    /**
+     * @brief Run InListPassiveTarget on the raw transport
+     * @param timeout_ms Response timeout
+     * @param uid Output UID buffer (MIFARE_UID_MAX_SIZE bytes)
+     * @param uid_len Output UID length
+     * @return true if one target answered
+     * 
+     * Stores the anticollision SAK/ATQA in _sak/_atqa.
+     */
+    bool listTarget(uint16_t timeout_ms, uint8_t* uid, uint8_t& uid_len);
+    
+    /**
+     * @brief Map SAK/ATQA to a card type
+     * @param sak Select acknowledge
+     * @param atqa ATQA (LSB first, as stored in _atqa)
+     * @return CARD_MIFARE_1K/4K, or CARD_UNKNOWN if ambiguous
+     */
+    static CardType cardTypeFromSAK(uint8_t sak, const uint8_t* atqa);
+    
+    /**
+     * @brief Try keys from the persistent cache for a sector
+     * @param sector Sector number
+     * @param used_key_a Output: true if Key A authenticated
+     * @param attempts Incremented per authentication attempt
+     * @return true if a cached key authenticated
+     */
+    bool authenticateFromKeyCache(int sector, bool& used_key_a, uint16_t& attempts);
+    
+    /**
+     * @brief Record a key that opened a sector (for the persistent cache)
+     */
+    void learnKey(int sector, bool key_a, const uint8_t* key);
+    
     /**
      * @brief Identify card type (1K vs 4K)
      * @return CardType enum
      * 
      * Attempts authentication on block 64 to distinguish 1K from 4K.
+     * Fallback only: used when cardTypeFromSAK() is ambiguous.
      */
     CardType identifyCardType();
     
@@ -368,10 +634,21 @@ private:
      * @brief Read all blocks from card
      * @return ReturnCode
      * 
-     * Uses optimized key caching for multi-sector reads.
+     * Uses optimized key caching for multi-sector reads. Sectors come
+     * from a MifareSectorScheduler plan shared with any other reader
+     * reading the same card; their sectors are imported at the end.
      */
     int readAllBlocks();
     
+    /**
+     * @brief Take a sector opened by another reader into this read
+     * @param sector Sector number
+     * @param result Key that opened it
+     * 
+     * Blocks arrive with MifareSectorScheduler::leave().
+     */
+    void importRemoteSector(int sector, const MifareSectorScheduler::SectorResult& result);
+    
     /**
      * @brief Read single sector
      * @param sector Sector number
@@ -384,11 +661,12 @@ private:
      * @param sector Sector number
      * @param cached_key_a Reference to cached Key A (updated on success)
      * @param cached_key_b Reference to cached Key B (updated on success)
+     * @param attempts Output: authentication attempts spent on the sector
      * @return ReturnCode
      * 
      * Optimization: tries cached keys first before database brute-force.
      */
-    int readSectorWithCache(int sector, String& cached_key_a, String& cached_key_b);
+    int readSectorWithCache(int sector, String& cached_key_a, String& cached_key_b, uint16_t& attempts);
     
     /**
      * @brief Authenticate block with key
@@ -400,13 +678,36 @@ private:
     int authenticateBlock(int block, bool keyA, const uint8_t* key);
     
     /**
-     * @brief Write all blocks in sector
+     * @brief Authenticate a sector for writing
+     * @param sector Sector number
+     * @param key Output: 6-byte key that authenticated
+     * @param key_a Output: true if it is Key A
+     * @return ReturnCode
+     * 
+     * Keys extracted from the dump first, then the key database.
+     */
+    int authenticateSector(int sector, uint8_t* key, bool& key_a);
+    
+    /**
+     * @brief Write selected blocks of one sector (single authentication)
      * @param sector Sector number
+     * @param block_mask Bit n = block first_block + n (caller excludes
+     *        UID block and trailer)
      * @return ReturnCode
      * 
-     * Skips UID block and sector trailers.
+     * Each block is read first and only written if it differs. If the
+     * access bits deny the read, the sector is re-authenticated and the
+     * remaining blocks are written unconditionally. No fixed delay: the
+     * PN532 returns once the card has acknowledged the write. Appends
+     * one entry to _sector_writes.
      */
-    int writeSector(int sector);
+    int writeSectorBlocks(int sector, uint16_t block_mask);
+    
+    /**
+     * @brief Mask of writable data blocks in a sector
+     * @return All blocks except the trailer (and block 0 in sector 0)
+     */
+    static uint16_t dataBlockMask(int sector);
     
     /**
      * @brief Write block 0 (UID cloning)
@@ -424,13 +725,6 @@ private:
      */
     void extractKeysFromDump();
     
-    /**
-     * @brief Write single block
-     * @param block Block number
-     * @return ReturnCode
-     */
-    int writeSingleBlock(int block);
-    
     // ============================================
     // FILE OPERATIONS
     // ============================================
@@ -439,6 +733,7 @@ private:
      * @brief Build full file path
      * @param filename Input filename (with or without path/extension)
      * @return Full path with /DUMPS/MIFARE/ prefix and .mfc extension
+     *         (.nfcb names are kept as-is)
      */
     String buildFilePath(const String& filename);
     
@@ -455,6 +750,20 @@ private:
      */
     void writeFileFormat(File& file);
     
+    /**
+     * @brief Load .nfcb container (header, auth bitmap, raw blocks)
+     * @param filepath Full path
+     * @return true on success, false if invalid or not a Mifare dump
+     */
+    bool parseBinaryFormat(const String& filepath);
+    
+    /**
+     * @brief Write current dump as .nfcb container
+     * @param filepath Full path
+     * @return true on success
+     */
+    bool writeBinaryFormat(const String& filepath);
+    
     // ============================================
     // HELPERS
     // ============================================
@@ -488,6 +797,55 @@ private:
      * Required between failed authentication attempts.
      */
     bool reactivateCard();
+    
+    /**
+     * @brief Re-select the known card with InListPassiveTarget + UID
+     * @return true if the card answered
+     * 
+     * The PN532 runs WUPA and cascade SELECT for the given UID only,
+     * skipping anticollision, and the host skips the full detection
+     * path (reactivateCard()).
+     */
+    bool reselectCard();
+    
+    /**
+     * @brief Authenticate a block (InDataExchange AUTH_A/AUTH_B)
+     * @param block Block number
+     * @param auth_cmd MIFARE_CMD_AUTH_A or MIFARE_CMD_AUTH_B
+     * @param key 6-byte key
+     * @return true if the card accepted the key
+     * 
+     * Same frame as Adafruit_PN532::mifareclassic_AuthenticateBlock, but
+     * through _raw: Adafruit keeps its frame buffer in a library global
+     * shared by every instance.
+     */
+    bool rawAuthenticate(uint8_t block, uint8_t auth_cmd, const uint8_t* key);
+    
+    /**
+     * @brief Read one 16-byte block of an authenticated sector
+     * @return false on timeout or card error status
+     */
+    bool rawReadBlock(uint8_t block, uint8_t* data);
+    
+    /**
+     * @brief Write one 16-byte block of an authenticated sector
+     * @return false on timeout or when the card NAKs the write
+     */
+    bool rawWriteBlock(uint8_t block, const uint8_t* data);
+    
+    /**
+     * @brief Bring card back after a failed authentication
+     * 
+     * Tries reselectCard() first, falls back to reactivateCard().
+     * Updates RecoveryStats.
+     */
+    void recoverAfterFailedAuth();
+    
+    /**
+     * @brief Log and keep RecoveryStats of the finished operation
+     * @param operation Label for the log line
+     */
+    void logRecoveryStats(const char* operation);
 };
 
 #endif // __MIFARE_TOOL_H__
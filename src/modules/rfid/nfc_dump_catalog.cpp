@@ -0,0 +1,460 @@
+#include "nfc_dump_catalog.h"
+#include "nfc_dump_file.h"
+#include "nfc_reader.h"
+#include <esp_rom_crc.h>
+
+// ============================================
+// PUBLIC METHODS
+// ============================================
+
+bool NFCDumpCatalog::update(const String& path, uint8_t protocol, const uint8_t* uid, uint8_t uid_len) {
+    NFCSharedLock lock;
+
+    if (path.length() >= PATH_SIZE) {
+        markStale("Path too long", path);
+        return false;
+    }
+
+    Entry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.used = 1;
+    entry.protocol = protocol;
+    strncpy(entry.path, path.c_str(), PATH_SIZE - 1);
+
+    if (!stat(path, entry)) {
+        return false;
+    }
+
+    if (uid && uid_len > 0 && uid_len <= MAX_UID_SIZE) {
+        entry.uid_len = uid_len;
+        memcpy(entry.uid, uid, uid_len);
+    } else {
+        entry.uid_len = readUid(path, entry.uid);
+    }
+
+    File file = openForUpdate();
+    if (!file) {
+        markStale("Catalog not writable", path);
+        return false;
+    }
+
+    // Free slot reused, file grows otherwise
+    int match, free_slot;
+    int records = find(file, entry.path, match, free_slot);
+    int index = (match >= 0) ? match : (free_slot >= 0 ? free_slot : records);
+
+    if (index == LARGE_RECORDS) {
+        LOG_WARN("CATALOG", "Catalog past %d records: listings slow down, consider archiving dumps",
+                 LARGE_RECORDS);
+    }
+
+    file.seek((size_t)index * sizeof(Entry));
+    bool ok = (file.write((const uint8_t*)&entry, sizeof(Entry)) == sizeof(Entry));
+    file.close();
+
+    if (!ok) {
+        markStale("Write failed", path);
+        return false;
+    }
+
+    LOG_DEBUG("CATALOG", "Indexed %s at %d (%lu bytes, CRC %08lX)", entry.path, index,
+              (unsigned long)entry.size, (unsigned long)entry.crc);
+    return ok;
+}
+
+size_t NFCDumpCatalog::remove(const String& path) {
+    NFCSharedLock lock;
+
+    if (!exists()) {
+        return 0;
+    }
+
+    File file = LittleFS.open(NFC_CATALOG_FILE, "r+");
+    if (!file) {
+        LOG_ERROR("CATALOG", "Failed to open catalog: %s", NFC_CATALOG_FILE);
+        return 0;
+    }
+
+    // Folder removal drops every record below it
+    String folder = path.endsWith("/") ? path : path + "/";
+    size_t removed = 0;
+    int records = file.size() / sizeof(Entry);
+    Entry entry;
+
+    for (int i = 0; i < records; i++) {
+        file.seek((size_t)i * sizeof(Entry));
+        if (file.read((uint8_t*)&entry, sizeof(Entry)) != sizeof(Entry)) break;
+        if (!entry.used) continue;
+
+        if (path == entry.path || strncmp(entry.path, folder.c_str(), folder.length()) == 0) {
+            uint8_t free_mark = 0;
+            file.seek((size_t)i * sizeof(Entry) + offsetof(Entry, used));
+            file.write(&free_mark, 1);
+            removed++;
+        }
+    }
+
+    file.close();
+
+    LOG_DEBUG("CATALOG", "Removed %u record(s) for %s", (unsigned)removed, path.c_str());
+    return removed;
+}
+
+bool NFCDumpCatalog::rename(const String& from, const String& to) {
+    NFCSharedLock lock;
+
+    if (!exists() || to.length() >= PATH_SIZE) {
+        return false;
+    }
+
+    File file = LittleFS.open(NFC_CATALOG_FILE, "r+");
+    if (!file) {
+        LOG_ERROR("CATALOG", "Failed to open catalog: %s", NFC_CATALOG_FILE);
+        return false;
+    }
+
+    int match, free_slot;
+    find(file, from.c_str(), match, free_slot);
+
+    bool ok = false;
+    if (match >= 0) {
+        char path[PATH_SIZE];
+        memset(path, 0, sizeof(path));
+        strncpy(path, to.c_str(), PATH_SIZE - 1);
+
+        file.seek((size_t)match * sizeof(Entry) + offsetof(Entry, path));
+        ok = (file.write((const uint8_t*)path, PATH_SIZE) == PATH_SIZE);
+    }
+
+    file.close();
+    return ok;
+}
+
+size_t NFCDumpCatalog::query(const Filter& filter, size_t offset, size_t limit, std::vector<Item>& out) {
+    NFCSharedLock lock;
+
+    out.clear();
+
+    if (!exists()) {
+        return 0;
+    }
+
+    File file = LittleFS.open(NFC_CATALOG_FILE, FILE_READ);
+    if (!file) {
+        LOG_ERROR("CATALOG", "Failed to open catalog: %s", NFC_CATALOG_FILE);
+        return 0;
+    }
+
+    size_t total = 0;
+    Entry batch[SCAN_BATCH];
+
+    while (true) {
+        size_t got = file.read((uint8_t*)batch, sizeof(batch)) / sizeof(Entry);
+        if (got == 0) break;
+
+        for (size_t i = 0; i < got; i++) {
+            const Entry& entry = batch[i];
+            if (!entry.used) continue;
+            if (filter.protocol && entry.protocol != filter.protocol) continue;
+            if (filter.uid_len &&
+                (entry.uid_len != filter.uid_len || memcmp(entry.uid, filter.uid, filter.uid_len) != 0)) {
+                continue;
+            }
+
+            if (total >= offset && (limit == 0 || out.size() < limit)) {
+                out.emplace_back();
+                toItem(entry, out.back());
+            }
+            total++;
+        }
+    }
+
+    file.close();
+    return total;
+}
+
+size_t NFCDumpCatalog::scan(const Source* sources, size_t source_count, const Filter& filter,
+                            size_t offset, size_t limit, std::vector<Item>& out) {
+    NFCSharedLock lock;
+
+    out.clear();
+    size_t total = 0;
+
+    for (size_t s = 0; s < source_count; s++) {
+        const Source& source = sources[s];
+        if (filter.protocol && source.protocol != filter.protocol) continue;
+
+        File dir = LittleFS.open(source.folder);
+        if (!dir || !dir.isDirectory()) continue;
+
+        File file = dir.openNextFile();
+        while (file) {
+            bool is_dir = file.isDirectory();
+            String name = String(file.name());
+            file.close();
+
+            int last_slash = name.lastIndexOf('/');
+            if (last_slash >= 0) {
+                name = name.substring(last_slash + 1);
+            }
+
+            bool accepted = false;
+            for (const char* const* ext = source.extensions; *ext && !is_dir; ext++) {
+                if (name.endsWith(*ext)) {
+                    accepted = true;
+                    break;
+                }
+            }
+
+            if (accepted) {
+                String path = String(source.folder) + name;
+                uint8_t uid[MAX_UID_SIZE];
+                uint8_t uid_len = (filter.uid_len || total >= offset) ? readUid(path, uid) : 0;
+
+                if (!filter.uid_len ||
+                    (uid_len == filter.uid_len && memcmp(uid, filter.uid, uid_len) == 0)) {
+                    if (total >= offset && (limit == 0 || out.size() < limit)) {
+                        Entry entry;
+                        memset(&entry, 0, sizeof(entry));
+                        if (stat(path, entry)) {
+                            out.emplace_back();
+                            Item& item = out.back();
+                            item.path = path;
+                            item.protocol = source.protocol;
+                            item.uid_len = uid_len;
+                            memcpy(item.uid, uid, uid_len);
+                            item.size = entry.size;
+                            item.mtime = entry.mtime;
+                            item.crc = entry.crc;
+                        }
+                    }
+                    total++;
+                }
+            }
+
+            file = dir.openNextFile();
+        }
+
+        dir.close();
+    }
+
+    return total;
+}
+
+bool NFCDumpCatalog::complete() {
+    NFCSharedLock lock;
+    return exists() && !LittleFS.exists(STALE_PATH);
+}
+
+size_t NFCDumpCatalog::scanFolder(const char* folder, uint8_t protocol, const char* const* extensions) {
+    NFCSharedLock lock;
+
+    File dir = LittleFS.open(folder);
+    if (!dir || !dir.isDirectory()) {
+        LOG_WARN("CATALOG", "Folder not found: %s", folder);
+        return 0;
+    }
+
+    size_t indexed = 0;
+    File file = dir.openNextFile();
+
+    while (file) {
+        if (!file.isDirectory()) {
+            String name = String(file.name());
+            int last_slash = name.lastIndexOf('/');
+            if (last_slash >= 0) {
+                name = name.substring(last_slash + 1);
+            }
+            file.close();
+
+            for (const char* const* ext = extensions; *ext; ext++) {
+                if (name.endsWith(*ext)) {
+                    if (update(String(folder) + name, protocol, nullptr, 0)) {
+                        indexed++;
+                    }
+                    break;
+                }
+            }
+        }
+        file = dir.openNextFile();
+    }
+
+    dir.close();
+
+    LOG_INFO("CATALOG", "Indexed %u file(s) in %s", (unsigned)indexed, folder);
+    return indexed;
+}
+
+size_t NFCDumpCatalog::count() {
+    NFCSharedLock lock;
+
+    if (!exists()) {
+        return 0;
+    }
+
+    File file = LittleFS.open(NFC_CATALOG_FILE, FILE_READ);
+    if (!file) {
+        return 0;
+    }
+
+    size_t used = 0;
+    int records = file.size() / sizeof(Entry);
+    for (int i = 0; i < records; i++) {
+        uint8_t flag = 0;
+        file.seek((size_t)i * sizeof(Entry) + offsetof(Entry, used));
+        if (file.read(&flag, 1) == 1 && flag) used++;
+    }
+
+    file.close();
+    return used;
+}
+
+void NFCDumpCatalog::clear() {
+    NFCSharedLock lock;
+
+    if (exists()) {
+        LittleFS.remove(NFC_CATALOG_FILE);
+    }
+    if (LittleFS.exists(STALE_PATH)) {
+        LittleFS.remove(STALE_PATH);
+    }
+    LOG_INFO("CATALOG", "Catalog cleared");
+}
+
+uint8_t NFCDumpCatalog::parseUid(const String& str, uint8_t* uid) {
+    String clean = str;
+    clean.replace(":", "");
+    clean.replace(" ", "");
+    clean.trim();
+
+    uint8_t len = clean.length() / 2;
+    if (len == 0 || len > MAX_UID_SIZE || clean.length() % 2 != 0) {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < len; i++) {
+        char byte_str[3] = {clean[i * 2], clean[i * 2 + 1], 0};
+        char* end;
+        uid[i] = strtoul(byte_str, &end, 16);
+        if (*end != 0) return 0;
+    }
+
+    return len;
+}
+
+uint8_t NFCDumpCatalog::readUid(const String& path, uint8_t* uid) {
+    if (NFCDumpFile::isBinaryName(path)) {
+        NFCDumpFile::Header header;
+        if (!NFCDumpFile::readHeader(path, header)) return 0;
+        memcpy(uid, header.uid, header.uid_len);
+        return header.uid_len;
+    }
+
+    // Flipper-style text: "UID: ..." within the first header lines
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file) return 0;
+
+    uint8_t len = 0;
+    for (uint8_t line_no = 0; line_no < UID_SCAN_LINES && file.available(); line_no++) {
+        String line = file.readStringUntil('\n');
+        line.trim();
+        if (line.startsWith("UID:")) {
+            len = parseUid(line.substring(4), uid);
+            break;
+        }
+    }
+
+    file.close();
+    return len;
+}
+
+// ============================================
+// PRIVATE METHODS
+// ============================================
+
+File NFCDumpCatalog::openForUpdate() {
+    // "r+" needs an existing file
+    if (!exists()) {
+        File create = LittleFS.open(NFC_CATALOG_FILE, FILE_WRITE);
+        if (!create) {
+            LOG_ERROR("CATALOG", "Failed to create catalog: %s", NFC_CATALOG_FILE);
+            return File();
+        }
+        create.close();
+    }
+
+    File file = LittleFS.open(NFC_CATALOG_FILE, "r+");
+    if (!file) {
+        LOG_ERROR("CATALOG", "Failed to open catalog: %s", NFC_CATALOG_FILE);
+    }
+    return file;
+}
+
+int NFCDumpCatalog::find(File& file, const char* path, int& match, int& free_slot) {
+    match = -1;
+    free_slot = -1;
+
+    file.seek(0);
+    int index = 0;
+    Entry batch[SCAN_BATCH];
+
+    while (true) {
+        size_t got = file.read((uint8_t*)batch, sizeof(batch)) / sizeof(Entry);
+        if (got == 0) break;
+
+        for (size_t i = 0; i < got; i++, index++) {
+            if (!batch[i].used) {
+                if (free_slot < 0) free_slot = index;
+            } else if (path && match < 0 && strncmp(batch[i].path, path, PATH_SIZE) == 0) {
+                match = index;
+            }
+        }
+    }
+
+    return index;
+}
+
+void NFCDumpCatalog::markStale(const char* reason, const String& path) {
+    LOG_WARN("CATALOG", "%s, not indexed: %s (listings fall back to folder scans)", reason, path.c_str());
+
+    if (LittleFS.exists(STALE_PATH)) {
+        return;
+    }
+    File marker = LittleFS.open(STALE_PATH, FILE_WRITE);
+    if (marker) {
+        marker.print(path);
+        marker.close();
+    }
+}
+
+void NFCDumpCatalog::toItem(const Entry& entry, Item& item) {
+    item.path = entry.path;
+    item.protocol = entry.protocol;
+    item.uid_len = entry.uid_len <= MAX_UID_SIZE ? entry.uid_len : 0;
+    memcpy(item.uid, entry.uid, MAX_UID_SIZE);
+    item.size = entry.size;
+    item.mtime = entry.mtime;
+    item.crc = entry.crc;
+}
+
+bool NFCDumpCatalog::stat(const String& path, Entry& entry) {
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file || file.isDirectory()) {
+        LOG_WARN("CATALOG", "Cannot index %s: not a file", path.c_str());
+        return false;
+    }
+
+    entry.size = file.size();
+    entry.mtime = (uint32_t)file.getLastWrite();
+
+    uint8_t chunk[CRC_CHUNK_SIZE];
+    uint32_t crc = 0;
+    size_t got;
+    while ((got = file.read(chunk, sizeof(chunk))) > 0) {
+        crc = esp_rom_crc32_le(crc, chunk, got);
+    }
+    entry.crc = crc;
+
+    file.close();
+    return true;
+}
@@ -0,0 +1,237 @@
+#ifndef __NFC_DUMP_CATALOG_H__
+#define __NFC_DUMP_CATALOG_H__
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <vector>
+#include "config.h"
+#include "logger.h"
+
+/**
+ * @brief Persistent index of the dump files under /DUMPS
+ *
+ * Features:
+ * - One fixed-size record per dump: path, protocol, UID, size,
+ *   mtime and CRC32 of the file contents
+ * - Updated incrementally on save, delete and rename; file listings
+ *   and UID searches read the index instead of opening every dump
+ * - Paginated queries with protocol and UID filters
+ * - Rebuilt from a folder scan when the index is missing
+ * - A file that cannot be indexed (path too long, write error) marks the
+ *   catalog stale: queries then go through scan() until a rebuild
+ *
+ * Architecture:
+ * - Static singleton pattern (no instance needed)
+ * - Shared by every reader: public calls hold NFCSharedLock
+ * - Records stored in NFC_CATALOG_FILE (sizeof(Entry) each, grows as needed)
+ * - Stale marker in STALE_PATH (survives reboots)
+ * - Deleted records are marked free and reused by the next insert
+ * - Protocol is an opaque byte (NFCManager::Protocol), set by the caller
+ *
+ * Usage:
+ * @code
+ * NFCDumpCatalog::update("/DUMPS/SRIX/tag.srix", protocol, uid, 8);
+ * NFCDumpCatalog::Filter filter = {protocol, 8, {...}};
+ * std::vector<NFCDumpCatalog::Item> page;
+ * size_t total = NFCDumpCatalog::complete() ?
+ *                NFCDumpCatalog::query(filter, 0, 20, page) :
+ *                NFCDumpCatalog::scan(sources, 2, filter, 0, 20, page);
+ * @endcode
+ */
+class NFCDumpCatalog {
+public:
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr uint8_t MAX_UID_SIZE = 10;         // Longest ISO14443A UID
+    static constexpr size_t PATH_SIZE = 64;             // Path incl. terminator
+    static constexpr uint16_t LARGE_RECORDS = 512;      // Warn past this many records (~46KB)
+    static constexpr const char* STALE_PATH = "/nfc_catalog.stale";  // Marker: some dump not indexed
+    static constexpr uint8_t SCAN_BATCH = 8;            // Records per file read
+    static constexpr uint8_t UID_SCAN_LINES = 8;        // Text header lines searched for "UID:"
+    static constexpr size_t CRC_CHUNK_SIZE = 256;       // Bytes per CRC read
+
+    // ============================================
+    // TYPES
+    // ============================================
+
+    /**
+     * @brief One catalog record (on-flash layout)
+     */
+    struct __attribute__((packed)) Entry {
+        uint8_t used;                   ///< 0 = free slot
+        uint8_t protocol;               ///< NFCManager::Protocol
+        uint8_t uid_len;                ///< Valid bytes in uid (0 = unknown)
+        uint8_t uid[MAX_UID_SIZE];      ///< Tag UID
+        uint8_t reserved;               ///< Zero
+        uint32_t size;                  ///< File size in bytes
+        uint32_t mtime;                 ///< File::getLastWrite() (epoch seconds)
+        uint32_t crc;                   ///< CRC32 of the file contents
+        char path[PATH_SIZE];           ///< Full LittleFS path
+    };
+
+    /**
+     * @brief Query result (copy of a record, or of a scanned file)
+     */
+    struct Item {
+        String path;                    ///< Full LittleFS path
+        uint8_t protocol;               ///< NFCManager::Protocol
+        uint8_t uid_len;                ///< Valid bytes in uid (0 = unknown)
+        uint8_t uid[MAX_UID_SIZE];      ///< Tag UID
+        uint32_t size;                  ///< File size in bytes
+        uint32_t mtime;                 ///< File::getLastWrite() (epoch seconds)
+        uint32_t crc;                   ///< CRC32 of the file contents
+    };
+
+    /**
+     * @brief Dump folder for scan()
+     */
+    struct Source {
+        const char* folder;             ///< Folder path (with trailing '/')
+        uint8_t protocol;               ///< Protocol byte of its files
+        const char* const* extensions;  ///< Accepted extensions (nullptr-terminated)
+    };
+
+    /**
+     * @brief Query filter (zero fields match everything)
+     */
+    struct Filter {
+        uint8_t protocol;               ///< 0 = any protocol
+        uint8_t uid_len;                ///< 0 = any UID
+        uint8_t uid[MAX_UID_SIZE];      ///< UID to match
+    };
+
+    // ============================================
+    // PUBLIC METHODS
+    // ============================================
+
+    /**
+     * @brief Insert or refresh the record for a dump file
+     * @param path Full LittleFS path
+     * @param protocol Protocol byte stored in the record
+     * @param uid Tag UID (nullptr: read it from the file header)
+     * @param uid_len UID length
+     * @return true if written
+     */
+    static bool update(const String& path, uint8_t protocol, const uint8_t* uid, uint8_t uid_len);
+
+    /**
+     * @brief Drop the record of a file, or of every file below a folder
+     * @param path Full file or folder path
+     * @return Number of records removed
+     */
+    static size_t remove(const String& path);
+
+    /**
+     * @brief Move a record to a new path
+     * @param from Old full path
+     * @param to New full path
+     * @return true if a record was moved
+     */
+    static bool rename(const String& from, const String& to);
+
+    /**
+     * @brief Paginated query
+     * @param filter Protocol/UID filter
+     * @param offset Matching records to skip
+     * @param limit Max records returned (0 = no limit)
+     * @param out Matching records (cleared first)
+     * @return Total number of matching records
+     */
+    static size_t query(const Filter& filter, size_t offset, size_t limit, std::vector<Item>& out);
+
+    /**
+     * @brief Same as query(), from a directory scan (stale catalog)
+     * @param sources Folders to list
+     * @param source_count Number of sources
+     * @param filter Protocol/UID filter
+     * @param offset Matching files to skip
+     * @param limit Max files returned (0 = no limit)
+     * @param out Matching files (cleared first)
+     * @return Total number of matching files
+     *
+     * Opens a file only for a UID filter and for the returned page
+     * (size, mtime, CRC).
+     */
+    static size_t scan(const Source* sources, size_t source_count, const Filter& filter,
+                       size_t offset, size_t limit, std::vector<Item>& out);
+
+    /**
+     * @brief Check if every dump is indexed (index exists, not stale)
+     */
+    static bool complete();
+
+    /**
+     * @brief Add every file below a folder (no duplicates)
+     * @param folder Folder path (with trailing '/')
+     * @param protocol Protocol byte for the records
+     * @param extensions Accepted extensions (nullptr-terminated)
+     * @return Number of files indexed
+     */
+    static size_t scanFolder(const char* folder, uint8_t protocol, const char* const* extensions);
+
+    /**
+     * @brief Count used records
+     */
+    static size_t count();
+
+    /**
+     * @brief Check if the index file exists
+     */
+    static bool exists() { return LittleFS.exists(NFC_CATALOG_FILE); }
+
+    /**
+     * @brief Delete the index file and the stale marker
+     */
+    static void clear();
+
+    /**
+     * @brief Parse a UID string ("04:A1:B2", "04 A1 B2" or "04A1B2")
+     * @param str Input string
+     * @param uid Output buffer (MAX_UID_SIZE bytes)
+     * @return UID length (0 if invalid)
+     */
+    static uint8_t parseUid(const String& str, uint8_t* uid);
+
+    /**
+     * @brief Read the UID stored in a dump file (.nfcb header or text "UID:" line)
+     * @param path Full LittleFS path
+     * @param uid Output buffer (MAX_UID_SIZE bytes)
+     * @return UID length (0 if not found)
+     */
+    static uint8_t readUid(const String& path, uint8_t* uid);
+
+private:
+    /**
+     * @brief Open the index for update, creating it if missing
+     */
+    static File openForUpdate();
+
+    /**
+     * @brief Find a record by path and the first free slot
+     * @param file Open index
+     * @param path Path to match (nullptr: free slot only)
+     * @param match Output: matching record index or -1
+     * @param free_slot Output: first free record index or -1
+     * @return Number of records in file
+     */
+    static int find(File& file, const char* path, int& match, int& free_slot);
+
+    /**
+     * @brief Flag the catalog incomplete (a dump is not indexed)
+     */
+    static void markStale(const char* reason, const String& path);
+
+    /**
+     * @brief Copy a record into a query result
+     */
+    static void toItem(const Entry& entry, Item& item);
+
+    /**
+     * @brief Fill size, mtime and CRC32 from the file itself
+     */
+    static bool stat(const String& path, Entry& entry);
+};
+
+#endif // __NFC_DUMP_CATALOG_H__
@@ -0,0 +1,168 @@
+#include "nfc_dump_diff.h"
+#include "mifare_tool.h"
+#include "logger.h"
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+NFCDumpDiff::NFCDumpDiff() {
+    reset();
+}
+
+void NFCDumpDiff::reset() {
+    memset(_dirty, 0, sizeof(_dirty));
+    memset(_protected, 0, sizeof(_protected));
+    memset(_unknown, 0, sizeof(_unknown));
+    memset(_uid, 0, sizeof(_uid));
+    _uid_length = 0;
+    _blocks = 0;
+    _block_size = 0;
+    _valid = false;
+    _stamp = 0;
+}
+
+// ============================================
+// COMPARE
+// ============================================
+
+bool NFCDumpDiff::compare(const uint8_t* expected, const uint8_t* actual,
+                          size_t size, uint8_t block_size, uint32_t stamp) {
+    reset();
+
+    if (!expected || !actual || block_size == 0 || (block_size & 3) ||
+        size % block_size || size / block_size > MAX_BLOCKS) {
+        LOG_ERROR("DIFF", "Unsupported geometry: %u bytes, %u-byte blocks",
+                  (unsigned)size, block_size);
+        return false;
+    }
+
+    _blocks = size / block_size;
+    _block_size = block_size;
+    const uint8_t words_per_block = block_size / 4;
+
+    if (((uintptr_t)expected & 3) == 0 && ((uintptr_t)actual & 3) == 0) {
+        // Aligned: one 32-bit XOR per word, OR-reduced per block
+        const uint32_t* a = (const uint32_t*)expected;
+        const uint32_t* b = (const uint32_t*)actual;
+
+        for (uint16_t block = 0; block < _blocks; block++) {
+            uint32_t acc = 0;
+            for (uint8_t w = 0; w < words_per_block; w++) {
+                acc |= a[w] ^ b[w];
+            }
+            if (acc) setBit(_dirty, block);
+            a += words_per_block;
+            b += words_per_block;
+        }
+    } else {
+        for (uint16_t block = 0; block < _blocks; block++) {
+            if (memcmp(expected + block * block_size, actual + block * block_size, block_size) != 0) {
+                setBit(_dirty, block);
+            }
+        }
+    }
+
+    _stamp = stamp;
+    _valid = true;
+
+    LOG_DEBUG("DIFF", "%u/%u blocks differ", dirtyCount(), _blocks);
+    return true;
+}
+
+void NFCDumpDiff::protect(uint16_t block) {
+    if (block < MAX_BLOCKS) setBit(_protected, block);
+}
+
+void NFCDumpDiff::protectMifareSystemBlocks() {
+    protect(MifareTool::UID_BLOCK);
+    for (uint16_t block = 0; block < _blocks; block++) {
+        if (isMifareTrailer(block)) protect(block);
+    }
+}
+
+void NFCDumpDiff::markUnknown(uint16_t block) {
+    if (block >= MAX_BLOCKS) return;
+    setBit(_unknown, block);
+    setBit(_protected, block);
+    clearBit(_dirty, block);
+}
+
+void NFCDumpDiff::setTagUid(const uint8_t* uid, uint8_t length) {
+    _uid_length = (length <= MAX_UID_LENGTH) ? length : MAX_UID_LENGTH;
+    memcpy(_uid, uid, _uid_length);
+}
+
+bool NFCDumpDiff::isMifareTrailer(uint16_t block) {
+    if (block < MifareTool::LARGE_SECTOR_BOUNDARY) {
+        return (block % MifareTool::BLOCKS_PER_SMALL_SECTOR) == MifareTool::BLOCKS_PER_SMALL_SECTOR - 1;
+    }
+    return ((block - MifareTool::LARGE_SECTOR_BOUNDARY) % MifareTool::BLOCKS_PER_LARGE_SECTOR) ==
+           MifareTool::BLOCKS_PER_LARGE_SECTOR - 1;
+}
+
+// ============================================
+// QUERIES
+// ============================================
+
+uint16_t NFCDumpDiff::dirtyCount() const {
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < BITMAP_WORDS; i++) {
+        count += __builtin_popcount(_dirty[i]);
+    }
+    return count;
+}
+
+uint16_t NFCDumpDiff::writableCount() const {
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < BITMAP_WORDS; i++) {
+        count += __builtin_popcount(_dirty[i] & ~_protected[i]);
+    }
+    return count;
+}
+
+uint16_t NFCDumpDiff::unknownCount() const {
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < BITMAP_WORDS; i++) {
+        count += __builtin_popcount(_unknown[i]);
+    }
+    return count;
+}
+
+int16_t NFCDumpDiff::nextDirty(uint16_t from) const {
+    while (from < _blocks) {
+        uint32_t word = _dirty[from / WORD_BITS] >> (from % WORD_BITS);
+        if (word) {
+            uint16_t block = from + __builtin_ctz(word);
+            return block < _blocks ? block : -1;
+        }
+        from = (from / WORD_BITS + 1) * WORD_BITS;    // Skip to next word
+    }
+    return -1;
+}
+
+size_t NFCDumpDiff::writableBlocks(std::vector<uint8_t>& out) const {
+    out.clear();
+    out.reserve(writableCount());
+
+    for (int16_t block = nextDirty(0); block >= 0; block = nextDirty(block + 1)) {
+        if (!isProtected(block)) {
+            out.push_back((uint8_t)block);
+        }
+    }
+    return out.size();
+}
+
+String NFCDumpDiff::bitmapToHex() const {
+    String hex;
+    size_t bytes = (_blocks + 7) / 8;
+    hex.reserve(bytes * 2);
+
+    for (size_t i = 0; i < bytes; i++) {
+        uint8_t value = (_dirty[i / 4] >> ((i % 4) * 8)) & 0xFF;
+        char buf[3];
+        snprintf(buf, sizeof(buf), "%02X", value);
+        hex += buf;
+    }
+    return hex;
+}
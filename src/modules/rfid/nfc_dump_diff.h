@@ -0,0 +1,157 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+/**
+ * @brief NFCDumpDiff - Block-level difference between two tag dumps
+ *
+ * Features:
+ * - Word-wide compare (32-bit loads when both buffers are aligned)
+ * - Compact dirty-block bitmap (1 bit per block, up to 256 blocks)
+ * - Protected-block mask (Mifare block 0 and sector trailers) so the
+ *   write list never contains blocks the write path would refuse
+ * - Bound to the dump it was computed against (TagInfo timestamp),
+ *   so a stale diff is never used after reading/loading another dump
+ * - Remembers the UID of the compared tag, so the write can refuse a
+ *   card swapped in after the compare (any UID may be compared)
+ * - Unknown-block mask: blocks the read could not see (Mifare sectors
+ *   that failed auth) are neither dirty nor writable, compare is partial
+ *
+ * Architecture:
+ * - One instance lives on NFCManager, filled by compareWithTag()
+ * - Compare jobs report from it, write-selective jobs without a block
+ *   list (and write-changes jobs) write its writable dirty blocks
+ *
+ * Usage:
+ * @code
+ * NFCDumpDiff diff;
+ * diff.compare(loaded, physical, 1024, 16, tag.timestamp);
+ * diff.protectMifareSystemBlocks();
+ * std::vector<uint8_t> blocks;
+ * diff.writableBlocks(blocks);
+ * @endcode
+ */
+class NFCDumpDiff {
+public:
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr uint16_t MAX_BLOCKS = 256;               // Mifare 4K: 256 blocks × 16 bytes
+    static constexpr uint8_t WORD_BITS = 32;
+    static constexpr uint16_t BITMAP_WORDS = MAX_BLOCKS / WORD_BITS;
+
+    NFCDumpDiff();
+
+    /**
+     * @brief Diff two dumps block by block
+     * @param expected Reference dump (the loaded file)
+     * @param actual Dump read from the tag
+     * @param size Dump size in bytes (both buffers)
+     * @param block_size Block size in bytes (multiple of 4)
+     * @param stamp Timestamp of the reference dump (TagInfo::timestamp)
+     * @return false on unsupported geometry (diff left invalid)
+     *
+     * Clears the protected mask.
+     */
+    bool compare(const uint8_t* expected, const uint8_t* actual,
+                 size_t size, uint8_t block_size, uint32_t stamp);
+
+    /**
+     * @brief Exclude a block from writableBlocks()
+     */
+    void protect(uint16_t block);
+
+    /**
+     * @brief Protect Mifare block 0 (UID) and every sector trailer
+     */
+    void protectMifareSystemBlocks();
+
+    /**
+     * @brief Mark a block as not read from the tag (protected, never dirty)
+     */
+    void markUnknown(uint16_t block);
+
+    /**
+     * @brief Record the UID of the tag the diff was read from
+     */
+    void setTagUid(const uint8_t* uid, uint8_t length);
+
+    /**
+     * @brief Check a UID against the compared tag
+     */
+    bool tagMatches(const uint8_t* uid, uint8_t length) const {
+        return _valid && length == _uid_length && memcmp(uid, _uid, length) == 0;
+    }
+
+    const uint8_t* tagUid() const { return _uid; }
+    uint8_t tagUidLength() const { return _uid_length; }
+
+    /**
+     * @brief Forget the diff (after a successful write, or a new dump)
+     */
+    void reset();
+
+    /**
+     * @brief Collect dirty, unprotected block numbers in ascending order
+     * @param out Output list (cleared first)
+     * @return Number of blocks
+     */
+    size_t writableBlocks(std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Next dirty block at or after from
+     * @return Block number, or -1 when none is left
+     */
+    int16_t nextDirty(uint16_t from) const;
+
+    /**
+     * @brief Hex string of the dirty bitmap (block 0 = LSB of first byte)
+     */
+    String bitmapToHex() const;
+
+    /**
+     * @brief Check that the diff belongs to the given reference dump
+     */
+    bool matches(uint32_t stamp) const { return _valid && _stamp == stamp; }
+
+    bool valid() const { return _valid; }
+    uint16_t blockCount() const { return _blocks; }
+    uint8_t blockSize() const { return _block_size; }
+    uint16_t dirtyCount() const;
+    uint16_t writableCount() const;
+    uint16_t unknownCount() const;
+    bool partial() const { return unknownCount() > 0; }
+    bool isUnknown(uint16_t block) const { return testBit(_unknown, block); }
+    bool isDirty(uint16_t block) const { return testBit(_dirty, block); }
+    bool isProtected(uint16_t block) const { return testBit(_protected, block); }
+
+    /**
+     * @brief Mifare Classic sector trailer test (1K/4K layout)
+     */
+    static bool isMifareTrailer(uint16_t block);
+
+private:
+    static bool testBit(const uint32_t* map, uint16_t block) {
+        return block < MAX_BLOCKS && (map[block / WORD_BITS] >> (block % WORD_BITS)) & 1;
+    }
+    static void setBit(uint32_t* map, uint16_t block) {
+        map[block / WORD_BITS] |= (1UL << (block % WORD_BITS));
+    }
+    static void clearBit(uint32_t* map, uint16_t block) {
+        map[block / WORD_BITS] &= ~(1UL << (block % WORD_BITS));
+    }
+
+    static constexpr uint8_t MAX_UID_LENGTH = 10;             // TagInfo::uid
+
+    uint32_t _dirty[BITMAP_WORDS];        // Block differs
+    uint32_t _protected[BITMAP_WORDS];    // Block must not be written
+    uint32_t _unknown[BITMAP_WORDS];      // Block not read from the tag
+    uint8_t _uid[MAX_UID_LENGTH];         // Compared tag
+    uint8_t _uid_length;
+    uint16_t _blocks;
+    uint8_t _block_size;
+    bool _valid;
+    uint32_t _stamp;                      // Reference dump timestamp
+};
@@ -0,0 +1,134 @@
+#include "nfc_dump_file.h"
+#include <esp_rom_crc.h>
+
+// ============================================
+// PUBLIC METHODS
+// ============================================
+
+bool NFCDumpFile::write(const String& path, Header& header, const uint8_t* data) {
+    size_t size = dataSize(header);
+
+    if (size == 0 || size > MAX_DATA_SIZE || header.uid_len > MAX_UID_SIZE) {
+        LOG_ERROR("NFCB", "Invalid dump geometry: %u x %u bytes, UID %u bytes",
+                  header.block_count, header.block_size, header.uid_len);
+        return false;
+    }
+
+    header.magic = MAGIC;
+    header.version = FORMAT_VERSION;
+    header.data_crc = esp_rom_crc32_le(0, data, size);
+
+    File file = LittleFS.open(path, FILE_WRITE);
+    if (!file) {
+        LOG_ERROR("NFCB", "Failed to open file for writing: %s", path.c_str());
+        return false;
+    }
+
+    bool ok = file.write((const uint8_t*)&header, sizeof(Header)) == sizeof(Header) &&
+              file.write(data, size) == size;
+    file.close();
+
+    if (!ok) {
+        LOG_ERROR("NFCB", "Short write: %s", path.c_str());
+        LittleFS.remove(path);
+        return false;
+    }
+
+    LOG_DEBUG("NFCB", "Written %s (%u bytes)", path.c_str(), (unsigned)(sizeof(Header) + size));
+    return true;
+}
+
+bool NFCDumpFile::readHeader(const String& path, Header& out) {
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file) {
+        LOG_ERROR("NFCB", "Failed to open file: %s", path.c_str());
+        return false;
+    }
+
+    bool ok = validate(file, out);
+    file.close();
+    return ok;
+}
+
+bool NFCDumpFile::read(const String& path, Header& out, uint8_t* data, size_t capacity) {
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file) {
+        LOG_ERROR("NFCB", "Failed to open file: %s", path.c_str());
+        return false;
+    }
+
+    if (!validate(file, out)) {
+        file.close();
+        return false;
+    }
+
+    size_t size = dataSize(out);
+    if (size > capacity) {
+        LOG_ERROR("NFCB", "Dump too large: %u bytes (buffer %u)", (unsigned)size, (unsigned)capacity);
+        file.close();
+        return false;
+    }
+
+    bool ok = (file.read(data, size) == size);
+    file.close();
+
+    if (!ok) {
+        LOG_ERROR("NFCB", "Short read: %s", path.c_str());
+        return false;
+    }
+
+    if (esp_rom_crc32_le(0, data, size) != out.data_crc) {
+        LOG_ERROR("NFCB", "CRC mismatch: %s", path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void NFCDumpFile::setSectorAuth(Header& header, uint8_t sector, bool ok) {
+    if (sector >= MAX_SECTORS) return;
+
+    if (ok) {
+        header.auth_bitmap[sector / 8] |= (1 << (sector % 8));
+    } else {
+        header.auth_bitmap[sector / 8] &= ~(1 << (sector % 8));
+    }
+}
+
+bool NFCDumpFile::sectorAuth(const Header& header, uint8_t sector) {
+    if (sector >= MAX_SECTORS) return false;
+    return header.auth_bitmap[sector / 8] & (1 << (sector % 8));
+}
+
+// ============================================
+// PRIVATE METHODS
+// ============================================
+
+bool NFCDumpFile::validate(File& file, Header& out) {
+    if (file.read((uint8_t*)&out, sizeof(Header)) != sizeof(Header)) {
+        LOG_ERROR("NFCB", "File too short for header");
+        return false;
+    }
+
+    if (out.magic != MAGIC || out.version != FORMAT_VERSION) {
+        LOG_ERROR("NFCB", "Not an NFCB v%d file (magic %08lX, version %d)",
+                  FORMAT_VERSION, (unsigned long)out.magic, out.version);
+        return false;
+    }
+
+    size_t size = dataSize(out);
+    if (out.uid_len > MAX_UID_SIZE || size == 0 || size > MAX_DATA_SIZE ||
+        out.blocks_read > out.block_count) {
+        LOG_ERROR("NFCB", "Corrupt header (UID %u bytes, %u x %u blocks)",
+                  out.uid_len, out.block_count, out.block_size);
+        return false;
+    }
+
+    if (file.size() != sizeof(Header) + size) {
+        LOG_ERROR("NFCB", "Size mismatch: %u bytes, expected %u",
+                  (unsigned)file.size(), (unsigned)(sizeof(Header) + size));
+        return false;
+    }
+
+    return true;
+}
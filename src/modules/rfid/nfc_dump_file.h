@@ -0,0 +1,151 @@
+#ifndef __NFC_DUMP_FILE_H__
+#define __NFC_DUMP_FILE_H__
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "logger.h"
+
+/**
+ * @brief Compact binary dump container (.nfcb)
+ *
+ * Features:
+ * - Fixed 36-byte header: tag kind, UID, SAK/ATQA, block geometry,
+ *   per-sector auth bitmap and a CRC32 of the block data
+ * - Raw blocks follow the header (no hex encoding, no line parsing)
+ * - Header doubles as an index: readHeader() touches 36 bytes only
+ * - Lives next to the Flipper-style text dumps (.srix / .mfc); the
+ *   protocol tools import/export between the two formats
+ *
+ * File Layout:
+ *   [Header (36 bytes)] [block_count × block_size bytes]
+ *   SRIX4K: 36 + 512 bytes, Mifare 1K: 36 + 1024, Mifare 4K: 36 + 4096
+ *
+ * Architecture:
+ * - Static singleton pattern (no instance needed)
+ * - Protocol-neutral: callers fill the header from their own state
+ *
+ * Usage:
+ * @code
+ * NFCDumpFile::Header header = {};
+ * header.kind = NFCDumpFile::KIND_SRIX;
+ * header.block_size = 4;
+ * header.block_count = header.blocks_read = 128;
+ * NFCDumpFile::write("/DUMPS/SRIX/tag.nfcb", header, dump);
+ * NFCDumpFile::read("/DUMPS/SRIX/tag.nfcb", header, dump, sizeof(dump));
+ * @endcode
+ */
+class NFCDumpFile {
+public:
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr const char* EXTENSION = ".nfcb";
+    static constexpr size_t EXTENSION_LEN = 5;          // Length of ".nfcb"
+    static constexpr uint32_t MAGIC = 0x42434E46;       // "NFCB" (little-endian)
+    static constexpr uint8_t FORMAT_VERSION = 1;
+    static constexpr uint8_t MAX_UID_SIZE = 10;         // Longest ISO14443A UID
+    static constexpr uint8_t MAX_SECTORS = 40;          // Mifare Classic 4K
+    static constexpr uint8_t AUTH_BITMAP_SIZE = 5;      // MAX_SECTORS bits
+    static constexpr size_t MAX_DATA_SIZE = 4096;       // Mifare Classic 4K
+
+    // ============================================
+    // TYPES
+    // ============================================
+
+    /**
+     * @brief Tag kind stored in the header
+     */
+    enum TagKind : uint8_t {
+        KIND_UNKNOWN = 0,
+        KIND_SRIX,              ///< SRIX4K: 128 × 4-byte blocks
+        KIND_MIFARE_1K,         ///< Mifare Classic 1K: 64 × 16-byte blocks
+        KIND_MIFARE_4K          ///< Mifare Classic 4K: 256 × 16-byte blocks
+    };
+
+    /**
+     * @brief On-flash header (little-endian, packed)
+     */
+    struct __attribute__((packed)) Header {
+        uint32_t magic;                             ///< MAGIC
+        uint8_t version;                            ///< FORMAT_VERSION
+        uint8_t kind;                               ///< TagKind
+        uint8_t uid_len;                            ///< Valid bytes in uid
+        uint8_t sak;                                ///< SAK (0 for SRIX)
+        uint8_t atqa[2];                            ///< ATQA, LSB first (0 for SRIX)
+        uint8_t block_size;                         ///< Bytes per block
+        uint8_t reserved;                           ///< Zero
+        uint16_t block_count;                       ///< Blocks stored after the header
+        uint16_t blocks_read;                       ///< Blocks read from the tag
+        uint8_t uid[MAX_UID_SIZE];                  ///< Tag UID
+        uint8_t auth_bitmap[AUTH_BITMAP_SIZE];      ///< Bit n = sector n authenticated
+        uint8_t pad;                                ///< Zero
+        uint32_t data_crc;                          ///< CRC32 of the block data
+    };
+
+    static_assert(sizeof(Header) == 36, "NFCDumpFile::Header layout changed");
+
+    // ============================================
+    // PUBLIC METHODS
+    // ============================================
+
+    /**
+     * @brief Write header and blocks to a file (replaces existing file)
+     * @param path Full LittleFS path
+     * @param header Header to write (magic, version and data_crc are filled in)
+     * @param data Block data (block_count × block_size bytes)
+     * @return true on success (partial files are removed)
+     */
+    static bool write(const String& path, Header& header, const uint8_t* data);
+
+    /**
+     * @brief Read and validate the header only
+     * @param path Full LittleFS path
+     * @param out Header to fill
+     * @return true if the file is a valid .nfcb container
+     */
+    static bool readHeader(const String& path, Header& out);
+
+    /**
+     * @brief Read header and blocks, verifying the CRC
+     * @param path Full LittleFS path
+     * @param out Header to fill
+     * @param data Output buffer for the block data
+     * @param capacity Size of data buffer
+     * @return true if valid and the data fits in capacity
+     */
+    static bool read(const String& path, Header& out, uint8_t* data, size_t capacity);
+
+    /**
+     * @brief Check if a filename uses the binary extension
+     */
+    static bool isBinaryName(const String& filename) { return filename.endsWith(EXTENSION); }
+
+    /**
+     * @brief Block data size described by a header
+     */
+    static size_t dataSize(const Header& header) {
+        return (size_t)header.block_count * header.block_size;
+    }
+
+    /**
+     * @brief Set sector auth bit
+     */
+    static void setSectorAuth(Header& header, uint8_t sector, bool ok);
+
+    /**
+     * @brief Get sector auth bit
+     */
+    static bool sectorAuth(const Header& header, uint8_t sector);
+
+private:
+    /**
+     * @brief Read and validate header from an open file
+     * @param file Open file positioned at 0
+     * @param out Header to fill
+     * @return true if magic, version, geometry and file size match
+     */
+    static bool validate(File& file, Header& out);
+};
+
+#endif // __NFC_DUMP_FILE_H__
@@ -0,0 +1,64 @@
+#include "nfc_irq.h"
+#include "logger.h"
+
+// ============================================
+// PUBLIC METHODS
+// ============================================
+
+bool NFCIrq::begin(uint8_t pin) {
+    if (pin == INVALID_PIN) {
+        LOG_WARN("NFC-IRQ", "No IRQ pin configured, falling back to polling");
+        return false;
+    }
+    
+    if (_pin != INVALID_PIN) {
+        return true; // Already attached
+    }
+    
+    pinMode(pin, INPUT);
+    attachInterruptArg(digitalPinToInterrupt(pin), isr, this, FALLING);
+    _pin = pin;
+    
+    LOG_INFO("NFC-IRQ", "IRQ detection enabled on GPIO %d", pin);
+    return true;
+}
+
+bool NFCIrq::wait(uint32_t timeout_ms) {
+    if (!isEnabled()) {
+        return false;
+    }
+    
+    // Arm first, then check level: an edge between the two still notifies
+    ulTaskNotifyTake(pdTRUE, 0);    // Drop stale notification
+    _waiter = xTaskGetCurrentTaskHandle();
+    
+    if (digitalRead(_pin) == LOW) {
+        _waiter = nullptr;
+        return true;
+    }
+    
+    TickType_t ticks = (timeout_ms == 0) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    if (ticks == 0) ticks = 1;
+    
+    ulTaskNotifyTake(pdTRUE, ticks);
+    _waiter = nullptr;
+    
+    return digitalRead(_pin) == LOW;
+}
+
+// ============================================
+// PRIVATE METHODS
+// ============================================
+
+void IRAM_ATTR NFCIrq::isr(void* arg) {
+    TaskHandle_t waiter = static_cast<NFCIrq*>(arg)->_waiter;
+    if (!waiter) {
+        return;
+    }
+    
+    BaseType_t higher_priority_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(waiter, &higher_priority_woken);
+    if (higher_priority_woken) {
+        portYIELD_FROM_ISR();
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef __NFC_IRQ_H__
+#define __NFC_IRQ_H__
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * @brief PN532 IRQ line wait helper
+ * 
+ * Features:
+ * - GPIO interrupt on the PN532 IRQ pin (active LOW = response ready)
+ * - Calling task sleeps on a FreeRTOS task notification until the
+ *   PN532 signals, instead of polling I2C at fixed intervals
+ * - Race-free: pin level is checked after arming the waiter
+ * 
+ * Architecture:
+ * - One instance per PN532 (owned by its NFCManager), each with its own
+ *   GPIO interrupt, so readers on separate buses wait independently
+ * - One waiting task per instance (operations on a reader are serialized
+ *   by its NFCManager / NFCJobEngine worker)
+ * 
+ * Usage:
+ * @code
+ * NFCIrq irq;
+ * irq.begin(PN532_IRQ_PIN);
+ * raw.setWaitHook(NFCIrq::waitHook, &irq);
+ * if (irq.wait(5000)) {
+ *     nfc.readDetectedPassiveTargetID(uid, &uid_len);
+ * }
+ * @endcode
+ */
+class NFCIrq {
+public:
+    // ============================================
+    // CONSTANTS
+    // ============================================
+    
+    static constexpr uint8_t INVALID_PIN = 255;     // No IRQ pin configured
+    
+    // ============================================
+    // PUBLIC METHODS
+    // ============================================
+    
+    /**
+     * @brief Attach the GPIO interrupt
+     * @param pin IRQ GPIO connected to PN532 P70_IRQ
+     * @return true if interrupt attached
+     */
+    bool begin(uint8_t pin);
+    
+    /**
+     * @brief Check if IRQ waiting is available
+     */
+    bool isEnabled() const { return _pin != INVALID_PIN; }
+    
+    /**
+     * @brief Sleep until PN532 IRQ goes LOW (response ready)
+     * @param timeout_ms Max wait (0 = forever)
+     * @return true if PN532 is ready, false on timeout or when disabled
+     * 
+     * Must be called from a task, never from an ISR.
+     */
+    bool wait(uint32_t timeout_ms);
+    
+    /**
+     * @brief Check IRQ line level without waiting
+     * @return true if PN532 is signalling ready
+     */
+    bool isAsserted() const { return isEnabled() && digitalRead(_pin) == LOW; }
+    
+    /**
+     * @brief PN532_SRIX_WaitHook adapter (context = NFCIrq*)
+     */
+    static bool waitHook(uint32_t timeout_ms, void* context) {
+        return static_cast<NFCIrq*>(context)->wait(timeout_ms);
+    }
+
+private:
+    // ============================================
+    // PRIVATE MEMBERS
+    // ============================================
+    
+    uint8_t _pin = INVALID_PIN;                 // IRQ GPIO (INVALID_PIN = disabled)
+    volatile TaskHandle_t _waiter = nullptr;    // Task sleeping in wait() (nullptr = none)
+    
+    static void IRAM_ATTR isr(void* arg);
+};
+
+#endif // __NFC_IRQ_H__
@@ -4,17 +4,58 @@
  */
 
 #include "nfc_manager.h"
+#include "nfc_progress.h"
+#include "nfc_irq.h"
+#include <time.h>
+
+// ============================================
+// TAG TYPE TABLE
+// ============================================
+
+namespace {
+
+// Indexed by NFCManager::TagType
+constexpr NFCManager::TagTypeInfo TAG_TYPES[NFCManager::TAG_TYPE_COUNT] = {
+    {"Unknown",           NFCManager::PROTOCOL_UNKNOWN,        0,                               0,  0},
+    {"SRIX4K",            NFCManager::PROTOCOL_SRIX,           NFCManager::SRIX_DUMP_SIZE,      4,  0},
+    {"Mifare Classic 1K", NFCManager::PROTOCOL_MIFARE_CLASSIC, NFCManager::MIFARE_1K_DUMP_SIZE, 16, 16},
+    {"Mifare Classic 4K", NFCManager::PROTOCOL_MIFARE_CLASSIC, NFCManager::MIFARE_4K_DUMP_SIZE, 16, 40},
+};
+
+// Prefix of the save result message, followed by the full path
+constexpr const char SAVED_PREFIX[] = "Saved to ";
+constexpr size_t SAVED_PREFIX_LEN = sizeof(SAVED_PREFIX) - 1;
+
+// Indexed by NFCManager::BatchStatus
+const char* const BATCH_STATUS_NAMES[] = {
+    "saved",
+    "duplicate",
+    "read_failed",
+    "save_failed",
+    "removed"
+};
+
+} // namespace
+
+const NFCManager::TagTypeInfo& NFCManager::tagTypeInfo(TagType type) {
+    return TAG_TYPES[type < TAG_TYPE_COUNT ? type : TAG_UNKNOWN];
+}
 
 // ============================================
 // CONSTRUCTOR & INITIALIZATION
 // ============================================
 
-NFCManager::NFCManager()
-    : _srix_handler(nullptr),
+NFCManager::NFCManager(const NFCReaderConfig& reader)
+    : _reader(reader),
+      _srix_handler(nullptr),
       _mifare_handler(nullptr),
       _initialized(false),
-      _current_protocol(PROTOCOL_UNKNOWN) {
-    _current_tag.valid = false;
+      _current_protocol(PROTOCOL_UNKNOWN),
+      _batch_stop(false),
+      _batch_running(false) {
+    memset(&_current_tag, 0, sizeof(_current_tag));
+    memset(&_batch_stats, 0, sizeof(_batch_stats));
+    memset(_dump, 0, sizeof(_dump));
     
     LOG_DEBUG("NFC", "NFCManager constructor initialized");
 }
@@ -54,9 +95,28 @@ bool NFCManager::begin() {
         }
     }
     
+    // Dump catalog: one folder scan the first time, incremental afterwards
+    if (!NFCDumpCatalog::exists()) {
+        rebuildCatalog();
+    } else if (!NFCDumpCatalog::complete()) {
+        LOG_WARN("NFC", "Dump catalog stale: listings scan the folders ('nfc catalog rebuild' to reindex)");
+    }
+    
+    // Reader bus (reader 0's Wire is also started in setup(), begin() is idempotent)
+    _reader.wire->begin(_reader.sda, _reader.scl);
+    _reader.wire->setClock(_reader.frequency);
+    
+    // IRQ-driven detection (must be attached before handlers copy the setting)
+    #if NFC_IRQ_DETECTION
+        _irq.begin(_reader.irq_pin);
+    #endif
+    
+    // Write list for changed blocks: sized once, reused by every write
+    _block_list.reserve(NFCDumpDiff::MAX_BLOCKS);
+    
     _initialized = true;
     
-    LOG_INFO("NFC", "NFCManager ready (handlers will be lazy-loaded)");
+    LOG_INFO("NFC", "NFCManager ready on reader %d (handlers will be lazy-loaded)", _reader.id);
     LOG_INFO("NFC", "Type 'nfc help' for commands");
     
     return true;
@@ -79,7 +139,7 @@ bool NFCManager::beginSRIX() {
     
     // Create SRIX handler (headless mode)
     LOG_DEBUG("SRIX", "Creating handler...");
-    _srix_handler = new SRIXTool(true);
+    _srix_handler = new SRIXTool(true, _reader, &_irq);
     
     if (!_srix_handler) {
         LOG_ERROR("SRIX", "Failed to allocate SRIX handler");
@@ -115,7 +175,7 @@ bool NFCManager::beginMifare() {
     
     // Create Mifare handler (non-headless for debugging)
     LOG_DEBUG("MIFARE", "Creating handler...");
-    _mifare_handler = new MifareTool(false);
+    _mifare_handler = new MifareTool(false, _reader, &_irq);
     
     if (!_mifare_handler) {
         LOG_ERROR("MIFARE", "Failed to allocate Mifare handler");
@@ -138,7 +198,7 @@ bool NFCManager::beginMifare() {
 // SRIX OPERATIONS
 // ============================================
 
-NFCManager::Result NFCManager::readSRIX(TagInfo& info, int timeout_sec) {
+NFCManager::Result NFCManager::readSRIX(TagInfo& info, int timeout_sec, bool make_current) {
     Result result = {false, "", -1};
     
     if (!_initialized) {
@@ -154,47 +214,33 @@ NFCManager::Result NFCManager::readSRIX(TagInfo& info, int timeout_sec) {
         return result;
     }
     
-    int timeout_ms = timeout_sec * 1000;
+    uint32_t timeout_ms = (uint32_t)timeout_sec * 1000UL;
     LOG_INFO("SRIX", "Reading tag (timeout: %d seconds)...", timeout_sec);
     
-    String json = _srix_handler->read_tag_headless(timeout_ms);
+    // Binary read into the handler buffer, UID straight into TagInfo
+    // (batched SRIX_read_blocks() fast path, per-block loop as fallback)
+    int read_result = _srix_handler->read_tag_binary(timeout_ms, nullptr, info.uid);
     
-    if (json.isEmpty()) {
-        result.message = "Timeout: No SRIX tag found";
-        result.code = -1;
+    if (read_result != SRIXTool::SUCCESS) {
+        result.message = (read_result == SRIXTool::ERROR_TIMEOUT) ? 
+                         "Timeout: No SRIX tag found" : "NFC hardware error";
+        result.code = read_result;
         LOG_WARN("SRIX", "%s", result.message.c_str());
         return result;
     }
     
-    // Parse JSON response
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, json);
-    
-    if (error) {
-        result.message = "Failed to parse tag data";
-        result.code = -2;
-        LOG_ERROR("SRIX", "JSON parse error: %s", error.c_str());
-        return result;
-    }
-    
     // Fill TagInfo
-    info.protocol = PROTOCOL_SRIX;
-    info.protocol_name = "SRIX4K";
-    info.valid = true;
-    info.timestamp = millis();
-    
-    // Parse UID (8 bytes)
-    String uid_str = doc["uid"].as<String>();
-    uid_str.replace(" ", "");
-    stringToUid(uid_str, info.uid, info.uid_length);
-    
-    // Parse dump (512 bytes)
-    String dump_hex = doc["data"].as<String>();
-    hexToDump(dump_hex, info.data.srix.dump, SRIX_DUMP_SIZE);
-    
-    // Save as current
-    _current_tag = info;
-    _current_protocol = PROTOCOL_SRIX;
+    info.uid_length = SRIXTool::SRIX_UID_SIZE;
+    
+    // Save as current (compare reads stay in the handler buffer)
+    if (make_current) {
+        memcpy(_dump, _srix_handler->getDump(), SRIX_DUMP_SIZE);
+        fillTagInfo(info, TAG_SRIX4K, _dump);
+        _current_tag = info;
+        _current_protocol = PROTOCOL_SRIX;
+    } else {
+        fillTagInfo(info, TAG_SRIX4K, _srix_handler->getDump());
+    }
     
     result.success = true;
     result.message = "SRIX tag read successfully";
@@ -221,7 +267,7 @@ NFCManager::Result NFCManager::writeSRIX(const TagInfo& info, int timeout_sec) {
         return result;
     }
     
-    if (!info.valid || info.protocol != PROTOCOL_SRIX) {
+    if (!info.valid || info.protocol != PROTOCOL_SRIX || info.size != SRIX_DUMP_SIZE) {
         result.message = "Invalid SRIX data";
         result.code = -2;
         LOG_ERROR("SRIX", "%s", result.message.c_str());
@@ -229,7 +275,9 @@ NFCManager::Result NFCManager::writeSRIX(const TagInfo& info, int timeout_sec) {
     }
     
     // Copy data to SRIX handler
-    memcpy(_srix_handler->getDump(), info.data.srix.dump, SRIX_DUMP_SIZE);
+    if (info.dump != _srix_handler->getDump()) {
+        memcpy(_srix_handler->getDump(), info.dump, SRIX_DUMP_SIZE);
+    }
     memcpy(_srix_handler->getUID(), info.uid, 8);
     _srix_handler->setDumpValidFromLoad();
     
@@ -238,8 +286,14 @@ NFCManager::Result NFCManager::writeSRIX(const TagInfo& info, int timeout_sec) {
     int write_result = _srix_handler->write_tag_headless(timeout_sec);
     
     if (write_result == 0) {
+        const SRIXTool::WriteStats& stats = _srix_handler->getLastWriteStats();
         result.success = true;
-        result.message = "SRIX tag written and verified";
+        result.message = "SRIX tag written and verified (" + String(stats.written) + " written, " +
+                         String(stats.skipped) + " unchanged";
+        if (stats.verify_failed > 0) {
+            result.message += ", " + String(stats.verify_failed) + " verify mismatch";
+        }
+        result.message += ", " + String(stats.elapsed_ms) + " ms)";
         result.code = 0;
         LOG_INFO("SRIX", "Write complete and verified");
     } else if (write_result > 0) {
@@ -277,7 +331,7 @@ NFCManager::Result NFCManager::saveSRIX(const TagInfo& info, String filename) {
     // saveSRIX doesn't need hardware, works only on memory
     // But if we never initialized, create handler just for file ops
     if (!_srix_handler) {
-        _srix_handler = new SRIXTool(true);
+        _srix_handler = new SRIXTool(true, _reader, &_irq);
         if (!_srix_handler) {
             result.message = "Failed to create SRIX handler";
             LOG_ERROR("SRIX", "%s", result.message.c_str());
@@ -285,14 +339,16 @@ NFCManager::Result NFCManager::saveSRIX(const TagInfo& info, String filename) {
         }
     }
     
-    if (!info.valid || info.protocol != PROTOCOL_SRIX) {
+    if (!info.valid || info.protocol != PROTOCOL_SRIX || info.size != SRIX_DUMP_SIZE) {
         result.message = "Invalid SRIX data to save";
         LOG_ERROR("SRIX", "%s", result.message.c_str());
         return result;
     }
     
     // Copy data to SRIX handler
-    memcpy(_srix_handler->getDump(), info.data.srix.dump, SRIX_DUMP_SIZE);
+    if (info.dump != _srix_handler->getDump()) {
+        memcpy(_srix_handler->getDump(), info.dump, SRIX_DUMP_SIZE);
+    }
     memcpy(_srix_handler->getUID(), info.uid, 8);
     _srix_handler->setDumpValidFromLoad();
     
@@ -306,8 +362,10 @@ NFCManager::Result NFCManager::saveSRIX(const TagInfo& info, String filename) {
         return result;
     }
     
+    NFCDumpCatalog::update(filepath, PROTOCOL_SRIX, info.uid, 8);
+    
     result.success = true;
-    result.message = "Saved to " + filepath;
+    result.message = SAVED_PREFIX + filepath;
     result.code = 0;
     
     LOG_INFO("SRIX", "File saved: %s", filepath.c_str());
@@ -326,7 +384,7 @@ NFCManager::Result NFCManager::loadSRIX(TagInfo& info, String filename) {
     
     // loadSRIX doesn't need hardware, works only on file
     if (!_srix_handler) {
-        _srix_handler = new SRIXTool(true);
+        _srix_handler = new SRIXTool(true, _reader, &_irq);
         if (!_srix_handler) {
             result.message = "Failed to create SRIX handler";
             LOG_ERROR("SRIX", "%s", result.message.c_str());
@@ -351,13 +409,10 @@ NFCManager::Result NFCManager::loadSRIX(TagInfo& info, String filename) {
     }
     
     // Fill TagInfo from loaded data
-    info.protocol = PROTOCOL_SRIX;
-    info.protocol_name = "SRIX4K";
-    info.valid = true;
-    info.timestamp = millis();
     info.uid_length = 8;
     memcpy(info.uid, _srix_handler->getUID(), 8);
-    memcpy(info.data.srix.dump, _srix_handler->getDump(), SRIX_DUMP_SIZE);
+    memcpy(_dump, _srix_handler->getDump(), SRIX_DUMP_SIZE);
+    fillTagInfo(info, TAG_SRIX4K, _dump);
     
     // Save as current
     _current_tag = info;
@@ -454,15 +509,17 @@ NFCManager::Result NFCManager::writeSRIXBlocksSelective(const std::vector<uint8_
         }
         
         // Get data from current tag
-        const uint8_t* block_data = _current_tag.data.srix.dump + (block_num * 4);
+        const uint8_t* block_data = _dump + (block_num * SRIX_BLOCK_SIZE);
         
         LOG_DEBUG("SRIX", "[%d/%d] Writing block #%d...", 
                  i + 1, block_numbers.size(), block_num);
         
         // Write block
         Result block_result = writeSRIXBlock(block_num, block_data);
+        bool block_ok = block_result.success || (block_result.code >= 0 && block_result.code <= 2);
+        NFCProgress::block(NFCProgress::OP_WRITE, i + 1, block_numbers.size(), block_ok);
         
-        if (block_result.success || (block_result.code >= 0 && block_result.code <= 2)) {
+        if (block_ok) {
             blocks_written++;
             
             if (block_result.code == 0) {
@@ -521,7 +578,7 @@ bool NFCManager::waitForSRIXTag(uint32_t timeout_ms) {
 // MIFARE OPERATIONS
 // ============================================
 
-NFCManager::Result NFCManager::readMifare(TagInfo& info, int timeout_sec) {
+NFCManager::Result NFCManager::readMifare(TagInfo& info, int timeout_sec, bool make_current) {
     Result result = {false, "", -1};
     
     if (!_initialized) {
@@ -537,58 +594,42 @@ NFCManager::Result NFCManager::readMifare(TagInfo& info, int timeout_sec) {
         return result;
     }
     
-    int timeout_ms = timeout_sec * 1000;
+    uint32_t timeout_ms = (uint32_t)timeout_sec * 1000UL;
     LOG_INFO("MIFARE", "Reading tag (timeout: %d seconds)...", timeout_sec);
     
-    String json = _mifare_handler->read_tag_headless(timeout_ms);
+    int read_result = _mifare_handler->read_tag_binary(timeout_ms);
     
-    if (json.isEmpty()) {
+    if (read_result == MifareTool::ERROR_NO_TAG) {
         result.message = "Timeout: No Mifare tag found";
         result.code = -1;
         LOG_WARN("MIFARE", "%s", result.message.c_str());
         return result;
     }
     
-    // Parse JSON response
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, json);
-    
-    if (error) {
-        result.message = "Failed to parse tag data";
-        result.code = -2;
-        LOG_ERROR("MIFARE", "JSON parse error: %s", error.c_str());
-        return result;
+    if (read_result != MifareTool::SUCCESS) {
+        LOG_WARN("MIFARE", "Partial read (code: %d), keeping readable sectors", read_result);
     }
     
-    // Fill TagInfo
-    info.protocol = PROTOCOL_MIFARE_CLASSIC;
-    info.protocol_name = doc["card_type"].as<String>();
-    info.valid = true;
-    info.timestamp = millis();
-    
-    // Parse UID
-    String uid_str = doc["uid"].as<String>();
-    uid_str.replace(" ", "");
-    stringToUid(uid_str, info.uid, info.uid_length);
+    // Fill TagInfo straight from handler buffers
+    info.uid_length = _mifare_handler->getUIDLength();
+    memcpy(info.uid, _mifare_handler->getUID(), info.uid_length);
     
-    // Copy dump from handler
     int total_blocks = _mifare_handler->getTotalBlocks();
     int blocks_read = _mifare_handler->getBlocksRead();
-    
-    if (_mifare_handler->getCardType() == MifareTool::CARD_MIFARE_1K) {
-        memcpy(info.data.mifare_classic.dump, _mifare_handler->getDump(), MIFARE_1K_DUMP_SIZE);
-        info.data.mifare_classic.sectors = 16;
+    TagType type = (_mifare_handler->getCardType() == MifareTool::CARD_MIFARE_1K) ?
+                   TAG_MIFARE_1K : TAG_MIFARE_4K;
+    
+    // Save as current (compare reads stay in the handler buffer; write
+    // paths put the loaded dump back with syncMifareHandler())
+    if (make_current) {
+        memcpy(_dump, _mifare_handler->getDump(), tagTypeInfo(type).dump_size);
+        fillTagInfo(info, type, _dump);
+        _current_tag = info;
+        _current_protocol = PROTOCOL_MIFARE_CLASSIC;
     } else {
-        // 4K card - TagInfo supports only 1K, truncate or expand structure if needed
-        memcpy(info.data.mifare_classic.dump, _mifare_handler->getDump(), MIFARE_1K_DUMP_SIZE);
-        info.data.mifare_classic.sectors = 16; // Limit to 16 sectors for now
-        LOG_WARN("MIFARE", "4K card detected but TagInfo limited to 1K");
+        fillTagInfo(info, type, _mifare_handler->getDump());
     }
     
-    // Save as current
-    _current_tag = info;
-    _current_protocol = PROTOCOL_MIFARE_CLASSIC;
-    
     result.success = true;
     result.message = "Mifare tag read successfully";
     result.code = 0;
@@ -616,40 +657,21 @@ NFCManager::Result NFCManager::readMifareUID(TagInfo& info, int timeout_sec) {
         return result;
     }
     
-    int timeout_ms = timeout_sec * 1000;
+    uint32_t timeout_ms = (uint32_t)timeout_sec * 1000UL;
     LOG_INFO("MIFARE", "Reading UID only (timeout: %d seconds)...", timeout_sec);
     
-    String json = _mifare_handler->read_uid_headless(timeout_ms);
-    
-    if (json.isEmpty()) {
+    if (_mifare_handler->read_uid_binary(timeout_ms) != MifareTool::SUCCESS) {
         result.message = "Timeout: No Mifare tag found";
         result.code = -1;
         LOG_WARN("MIFARE", "%s", result.message.c_str());
         return result;
     }
     
-    // Parse JSON
-    JsonDocument doc;
-    if (deserializeJson(doc, json)) {
-        result.message = "Failed to parse UID data";
-        result.code = -2;
-        LOG_ERROR("MIFARE", "JSON parse error");
-        return result;
-    }
-    
     // Fill TagInfo (UID only, no dump)
-    info.protocol = PROTOCOL_MIFARE_CLASSIC;
-    info.protocol_name = doc["card_type"].as<String>();
-    info.valid = true;
-    info.timestamp = millis();
-    
-    String uid_str = doc["uid"].as<String>();
-    uid_str.replace(" ", "");
-    stringToUid(uid_str, info.uid, info.uid_length);
-    
-    // No dump data
-    memset(info.data.mifare_classic.dump, 0, sizeof(info.data.mifare_classic.dump));
-    info.data.mifare_classic.sectors = 0;
+    info.uid_length = _mifare_handler->getUIDLength();
+    memcpy(info.uid, _mifare_handler->getUID(), info.uid_length);
+    fillTagInfo(info, (_mifare_handler->getCardType() == MifareTool::CARD_MIFARE_1K) ?
+                TAG_MIFARE_1K : TAG_MIFARE_4K, nullptr);
     
     result.success = true;
     result.message = "UID read successfully";
@@ -676,7 +698,7 @@ NFCManager::Result NFCManager::writeMifare(const TagInfo& info, int timeout_sec)
         return result;
     }
     
-    if (!info.valid || info.protocol != PROTOCOL_MIFARE_CLASSIC) {
+    if (!info.valid || info.protocol != PROTOCOL_MIFARE_CLASSIC || !info.dump) {
         result.message = "Invalid Mifare data";
         result.code = -2;
         LOG_ERROR("MIFARE", "%s", result.message.c_str());
@@ -684,17 +706,25 @@ NFCManager::Result NFCManager::writeMifare(const TagInfo& info, int timeout_sec)
     }
     
     // Copy data to handler
-    memcpy(_mifare_handler->getDump(), info.data.mifare_classic.dump, MIFARE_1K_DUMP_SIZE);
-    memcpy(_mifare_handler->getUID(), info.uid, info.uid_length);
-    _mifare_handler->setDumpValidFromLoad();
+    syncMifareHandler(info);
     
     LOG_INFO("MIFARE", "Writing tag (timeout: %d seconds)...", timeout_sec);
     
     int write_result = _mifare_handler->write_tag_headless(timeout_sec);
     
     if (write_result == MifareTool::SUCCESS) {
+        uint8_t sectors = 0;
+        const MifareTool::SectorWriteStats* stats = _mifare_handler->getSectorWriteStats(sectors);
+        int written = 0;
+        int skipped = 0;
+        for (uint8_t i = 0; i < sectors; i++) {
+            written += stats[i].written;
+            skipped += stats[i].skipped;
+        }
+        
         result.success = true;
-        result.message = "Mifare tag written successfully";
+        result.message = "Mifare tag written successfully (" + String(written) + " blocks written, " +
+                         String(skipped) + " unchanged)";
         result.code = 0;
         LOG_INFO("MIFARE", "Write complete");
     } else {
@@ -798,7 +828,7 @@ NFCManager::Result NFCManager::saveMifare(const TagInfo& info, String filename)
     
     // saveMifare doesn't need active hardware
     if (!_mifare_handler) {
-        _mifare_handler = new MifareTool(true);
+        _mifare_handler = new MifareTool(true, _reader, &_irq);
         if (!_mifare_handler || !_mifare_handler->begin()) {
             result.message = "Failed to create Mifare handler";
             LOG_ERROR("MIFARE", "%s", result.message.c_str());
@@ -806,16 +836,14 @@ NFCManager::Result NFCManager::saveMifare(const TagInfo& info, String filename)
         }
     }
     
-    if (!info.valid || info.protocol != PROTOCOL_MIFARE_CLASSIC) {
+    if (!info.valid || info.protocol != PROTOCOL_MIFARE_CLASSIC || !info.dump) {
         result.message = "Invalid Mifare data to save";
         LOG_ERROR("MIFARE", "%s", result.message.c_str());
         return result;
     }
     
     // Copy data to handler
-    memcpy(_mifare_handler->getDump(), info.data.mifare_classic.dump, MIFARE_1K_DUMP_SIZE);
-    memcpy(_mifare_handler->getUID(), info.uid, info.uid_length);
-    _mifare_handler->setDumpValidFromLoad();
+    syncMifareHandler(info);
     
     LOG_DEBUG("MIFARE", "Saving to file: %s", filename.c_str());
     
@@ -827,8 +855,10 @@ NFCManager::Result NFCManager::saveMifare(const TagInfo& info, String filename)
         return result;
     }
     
+    NFCDumpCatalog::update(filepath, PROTOCOL_MIFARE_CLASSIC, info.uid, info.uid_length);
+    
     result.success = true;
-    result.message = "Saved to " + filepath;
+    result.message = SAVED_PREFIX + filepath;
     result.code = 0;
     
     LOG_INFO("MIFARE", "File saved: %s", filepath.c_str());
@@ -847,7 +877,7 @@ NFCManager::Result NFCManager::loadMifare(TagInfo& info, String filename) {
     
     // loadMifare doesn't need active hardware
     if (!_mifare_handler) {
-        _mifare_handler = new MifareTool(true);
+        _mifare_handler = new MifareTool(true, _reader, &_irq);
         if (!_mifare_handler || !_mifare_handler->begin()) {
             result.message = "Failed to create Mifare handler";
             LOG_ERROR("MIFARE", "%s", result.message.c_str());
@@ -877,21 +907,13 @@ NFCManager::Result NFCManager::loadMifare(TagInfo& info, String filename) {
     }
     
     // Fill TagInfo from loaded data
-    info.protocol = PROTOCOL_MIFARE_CLASSIC;
-    info.valid = true;
-    info.timestamp = millis();
     info.uid_length = _mifare_handler->getUIDLength();
     memcpy(info.uid, _mifare_handler->getUID(), info.uid_length);
-    memcpy(info.data.mifare_classic.dump, _mifare_handler->getDump(), MIFARE_1K_DUMP_SIZE);
     
-    if (_mifare_handler->getCardType() == MifareTool::CARD_MIFARE_1K) {
-        info.protocol_name = "Mifare Classic 1K";
-        info.data.mifare_classic.sectors = 16;
-    } else {
-        info.protocol_name = "Mifare Classic 4K";
-        info.data.mifare_classic.sectors = 40; // Note: TagInfo limited to 1K
-        LOG_WARN("MIFARE", "4K card loaded but TagInfo limited to 1K");
-    }
+    TagType type = (_mifare_handler->getCardType() == MifareTool::CARD_MIFARE_1K) ?
+                   TAG_MIFARE_1K : TAG_MIFARE_4K;
+    memcpy(_dump, _mifare_handler->getDump(), tagTypeInfo(type).dump_size);
+    fillTagInfo(info, type, _dump);
     
     // Save as current
     _current_tag = info;
@@ -934,70 +956,414 @@ NFCManager::Result NFCManager::writeMifareBlocksSelective(const std::vector<uint
     
     LOG_INFO("MIFARE", "SELECTIVE WRITE: %d blocks", block_numbers.size());
     
+    // A compare read may have left the physical tag in the handler buffer
+    syncMifareHandler(_current_tag);
+    
+    // One card wait, one authentication per sector
+    int write_result = _mifare_handler->write_blocks_headless(block_numbers);
+    
+    uint8_t sectors = 0;
+    const MifareTool::SectorWriteStats* stats = _mifare_handler->getSectorWriteStats(sectors);
     int blocks_written = 0;
+    int blocks_skipped = 0;
+    uint32_t elapsed_us = 0;
+    for (uint8_t i = 0; i < sectors; i++) {
+        blocks_written += stats[i].written;
+        blocks_skipped += stats[i].skipped;
+        elapsed_us += stats[i].elapsed_us;
+    }
     
-    for (size_t i = 0; i < block_numbers.size(); i++) {
-        uint8_t block_num = block_numbers[i];
+    if (write_result != MifareTool::SUCCESS) {
+        // Real error - stop everything
+        result.success = false;
+        result.message = sectors > 0 ?
+            "Failed in sector " + String(stats[sectors - 1].sector) + " (code=" + String(write_result) + ")" :
+            "Write failed (code=" + String(write_result) + ")";
+        result.code = write_result;
+        LOG_ERROR("MIFARE", "%s", result.message.c_str());
+        return result;
+    }
+    
+    LOG_INFO("MIFARE", "COMPLETE: %d written, %d unchanged, %d sectors in %lu ms",
+             blocks_written, blocks_skipped, sectors, elapsed_us / 1000);
+    
+    result.success = true;
+    result.message = "Successfully wrote " + String(blocks_written) + " blocks (" +
+                     String(blocks_skipped) + " unchanged)";
+    result.code = 0;
+    
+    return result;
+}
+// ============================================
+// COMPARE / WRITE CHANGES
+// ============================================
+
+NFCManager::Result NFCManager::compareWithTag(TagInfo& physical, int timeout_sec) {
+    Result result = {false, "", -1};
+    _diff.reset();
+    
+    if (!hasValidData()) {
+        result.message = "No loaded dump to compare";
+        result.code = -2;
+        LOG_ERROR("NFC", "%s", result.message.c_str());
+        return result;
+    }
+    
+    Protocol proto = _current_tag.protocol;
+    if (proto == PROTOCOL_SRIX) {
+        result = readSRIX(physical, timeout_sec, false);
+    } else if (proto == PROTOCOL_MIFARE_CLASSIC) {
+        result = readMifare(physical, timeout_sec, false);
+    } else {
+        result.message = "Compare not supported for " + protocolToString(proto);
+        LOG_ERROR("NFC", "%s", result.message.c_str());
+        return result;
+    }
+    
+    if (!result.success) {
+        return result;
+    }
+    
+    size_t size = getTagDataSize(_current_tag);
+    if (physical.type != _current_tag.type || getTagDataSize(physical) != size) {
+        result.success = false;
+        result.message = "Size mismatch between loaded dump and physical tag";
+        result.code = -4;
+        LOG_WARN("NFC", "%s", result.message.c_str());
+        return result;
+    }
+    
+    uint8_t block_size = tagTypeInfo(_current_tag.type).block_size;
+    if (!_diff.compare(getTagDataPointer(_current_tag), getTagDataPointer(physical),
+                       size, block_size, _current_tag.timestamp)) {
+        result.success = false;
+        result.message = "Unsupported dump size";
+        result.code = -4;
+        return result;
+    }
+    
+    // Any UID may be compared (blank/clone target); the write checks it is still this tag
+    _diff.setTagUid(physical.uid, physical.uid_length);
+    
+    if (proto == PROTOCOL_MIFARE_CLASSIC) {
+        _diff.protectMifareSystemBlocks();
         
-        if (block_num >= 64) {
-            LOG_WARN("MIFARE", "Skipping invalid block %d", block_num);
+        // Sectors the read could not open hold no tag data: not compared, never written
+        int sectors = MifareTool::getSectorCount(_mifare_handler->getCardType());
+        for (int sector = 0; sector < sectors; sector++) {
+            if (_mifare_handler->isSectorRead(sector)) continue;
+            int first = MifareTool::getFirstBlockOfSector(sector);
+            int count = MifareTool::getBlockCountInSector(sector);
+            for (int block = first; block < first + count; block++) {
+                _diff.markUnknown(block);
+            }
+        }
+    }
+    
+    result.success = true;
+    result.code = _diff.partial() ? 1 : 0;
+    result.message = (_diff.dirtyCount() == 0) ? String("Tag matches loaded dump") :
+                     String(_diff.dirtyCount()) + " blocks differ";
+    if (_diff.partial()) {
+        result.message += " (partial: " + String(_diff.unknownCount()) + " blocks in unread sectors)";
+    }
+    LOG_INFO("NFC", "Compare: %d/%d blocks differ, %d writable, %d unread",
+             _diff.dirtyCount(), _diff.blockCount(), _diff.writableCount(), _diff.unknownCount());
+    return result;
+}
+
+NFCManager::Result NFCManager::writeChangedBlocks() {
+    Result result = {false, "", -1};
+    
+    if (!hasValidData()) {
+        result.message = "No loaded data to write from";
+        result.code = -2;
+        LOG_ERROR("NFC", "%s", result.message.c_str());
+        return result;
+    }
+    
+    if (!_diff.matches(_current_tag.timestamp)) {
+        result.message = "No compare result for the loaded dump (compare first)";
+        result.code = -5;
+        LOG_ERROR("NFC", "%s", result.message.c_str());
+        return result;
+    }
+    
+    if (_diff.writableBlocks(_block_list) == 0) {
+        result.success = true;
+        result.message = "Nothing to write";
+        result.code = 0;
+        LOG_INFO("NFC", "%s", result.message.c_str());
+        return result;
+    }
+    
+    // The bitmap says what differs on the compared tag only
+    if (!waitForTagUid(_current_tag.protocol, _diff.tagUid(), _diff.tagUidLength(),
+                       WRITE_TARGET_TIMEOUT_MS)) {
+        result.message = "Compared tag (UID " + uidToString(_diff.tagUid(), _diff.tagUidLength()) +
+                         ") not in the field, compare again";
+        result.code = -6;
+        LOG_ERROR("NFC", "%s", result.message.c_str());
+        return result;
+    }
+    
+    if (_current_tag.protocol == PROTOCOL_SRIX) {
+        result = writeSRIXBlocksSelective(_block_list);
+    } else {
+        result = writeMifareBlocksSelective(_block_list);
+    }
+    
+    // Tag now matches: the bitmap is stale
+    if (result.success) {
+        _diff.reset();
+    }
+    return result;
+}
+
+// ============================================
+// BATCH SCAN
+// ============================================
+
+NFCManager::Result NFCManager::runBatch(const BatchOptions& options, BatchListener listener, void* context) {
+    Result result = {false, "", -1};
+    
+    if (!_initialized) {
+        result.message = "NFCManager not initialized";
+        LOG_ERROR("BATCH", "%s", result.message.c_str());
+        return result;
+    }
+    
+    if (options.protocol != PROTOCOL_SRIX && options.protocol != PROTOCOL_MIFARE_CLASSIC) {
+        result.message = "Batch scan supports SRIX and Mifare Classic only";
+        LOG_ERROR("BATCH", "%s", result.message.c_str());
+        return result;
+    }
+    
+    bool ready = (options.protocol == PROTOCOL_SRIX) ? beginSRIX() : beginMifare();
+    if (!ready) {
+        result.message = "Failed to initialize " + protocolToString(options.protocol) + " handler";
+        LOG_ERROR("BATCH", "%s", result.message.c_str());
+        return result;
+    }
+    
+    if (_batch_running) {
+        result.message = "Batch scan already running";
+        result.code = -2;
+        LOG_WARN("BATCH", "%s", result.message.c_str());
+        return result;
+    }
+    
+    memset(&_batch_stats, 0, sizeof(_batch_stats));
+    _batch_stop = false;
+    _batch_running = true;
+    
+    LOG_INFO("BATCH", "Batch scan started: %s (dedupe: %s, format: %s, max: %u, idle: %lu ms)",
+             protocolToString(options.protocol).c_str(), options.dedupe ? "on" : "off",
+             options.binary ? "nfcb" : "text", options.max_tags, options.idle_timeout_ms);
+    
+    uint32_t start = millis();
+    uint32_t cycle_start = start;          // Last removal (or start)
+    std::vector<NFCDumpCatalog::Item> match;
+    
+    while (!_batch_stop && (options.max_tags == 0 || _batch_stats.tags < options.max_tags)) {
+        _batch_stats.elapsed_ms = millis() - start;
+        
+        if (!batchDetect(options.protocol)) {
+            if (options.idle_timeout_ms && (millis() - cycle_start) >= options.idle_timeout_ms) {
+                LOG_INFO("BATCH", "No tag for %lu ms, stopping", options.idle_timeout_ms);
+                break;
+            }
             continue;
         }
         
-        LOG_DEBUG("MIFARE", "[%d/%d] Writing block %d...",
-                 i + 1, block_numbers.size(), block_num);
+        // Full read: the tag becomes the current tag, like a manual read
+        TagInfo tag;
+        uint32_t read_start = millis();
+        Result read = (options.protocol == PROTOCOL_SRIX) ?
+                      readSRIX(tag, BATCH_READ_TIMEOUT_SEC) :
+                      readMifare(tag, BATCH_READ_TIMEOUT_SEC);
         
-        // Write block using handler's write_single_block_headless
-        int write_result = _mifare_handler->write_single_block_headless(block_num);
+        BatchEvent event = {BATCH_SAVED, ++_batch_stats.tags, &tag, "",
+                            millis() - read_start, 0};
+        String path;
         
-        if (write_result == MifareTool::SUCCESS) {
-            blocks_written++;
-            LOG_INFO("MIFARE", "Block %d written [%d/%d]",
-                    block_num, blocks_written, block_numbers.size());
+        if (!read.success) {
+            event.status = BATCH_READ_FAILED;
+            event.tag = nullptr;
+            _batch_stats.failed++;
         } else {
-            // Real error - stop everything
-            LOG_ERROR("MIFARE", "Block %d FAILED (code=%d)", block_num, write_result);
+            // Dedupe: one catalog lookup by UID (folder scan while stale)
+            NFCDumpCatalog::Filter filter = {};
+            filter.protocol = options.protocol;
+            filter.uid_len = tag.uid_length;
+            memcpy(filter.uid, tag.uid, tag.uid_length);
             
-            result.success = false;
-            result.message = "Failed at block " + String(block_num) + 
-                           " (code=" + String(write_result) + ")";
-            result.code = write_result;
-            return result;
+            if (options.dedupe && queryDumps(filter, 0, 1, match) > 0) {
+                event.status = BATCH_DUPLICATE;
+                path = match[0].path;
+                _batch_stats.duplicates++;
+            } else {
+                String filename = batchFilename(tag, options.binary);
+                Result saved = (options.protocol == PROTOCOL_SRIX) ?
+                               saveSRIX(tag, filename) : saveMifare(tag, filename);
+                if (saved.success) {
+                    path = saved.message.substring(SAVED_PREFIX_LEN);
+                    _batch_stats.saved++;
+                } else {
+                    event.status = BATCH_SAVE_FAILED;
+                    _batch_stats.failed++;
+                }
+            }
         }
+        
+        event.path = path.c_str();
+        event.cycle_ms = millis() - cycle_start;
+        
+        LOG_INFO("BATCH", "#%u %s %s (read %lu ms, cycle %lu ms) %s",
+                 event.index,
+                 event.tag ? uidToString(tag.uid, tag.uid_length).c_str() : "-",
+                 batchStatusToString(event.status), event.read_ms, event.cycle_ms, event.path);
+        if (listener) listener(event, context);
+        
+        // Same tag stays on the reader: read it once
+        if (!batchWaitRemoval(options.protocol, event.tag)) {
+            break;
+        }
+        
+        cycle_start = millis();
+        event.status = BATCH_REMOVED;
+        event.path = "";
+        event.read_ms = 0;
+        event.cycle_ms = 0;
+        if (listener) listener(event, context);
     }
     
-    LOG_INFO("MIFARE", "COMPLETE: %d/%d blocks written", blocks_written, block_numbers.size());
+    _batch_stats.elapsed_ms = millis() - start;
+    _batch_running = false;
+    _batch_stop = false;
     
     result.success = true;
-    result.message = "Successfully wrote " + String(blocks_written) + " blocks";
-    result.code = 0;
+    result.message = "Batch scan: " + String(_batch_stats.tags) + " tags, " +
+                     String(_batch_stats.saved) + " saved, " +
+                     String(_batch_stats.duplicates) + " duplicates, " +
+                     String(_batch_stats.failed) + " failed";
+    result.code = _batch_stats.saved;
     
+    LOG_INFO("BATCH", "%s in %lu ms", result.message.c_str(), _batch_stats.elapsed_ms);
     return result;
 }
+
+const char* NFCManager::batchStatusToString(BatchStatus status) {
+    return status <= BATCH_REMOVED ? BATCH_STATUS_NAMES[status] : "unknown";
+}
+
+bool NFCManager::batchDetect(Protocol protocol) {
+    // IRQ detection sleeps on the line for the RF timeout; polling paces the bus.
+    // Same predicate as the handlers' own loops (fast transport and IRQ)
+    if (protocol == PROTOCOL_SRIX) {
+        if (_srix_handler->pollTagHeadless()) return true;
+        if (!_srix_handler->useIrqDetection()) delay(SRIXTool::TAG_DETECT_DELAY_MS);
+        return false;
+    }
+    
+    if (_mifare_handler->pollCardHeadless(BATCH_DETECT_SLICE_MS)) return true;
+    if (!_mifare_handler->useIrqDetection()) delay(MifareTool::CARD_DETECT_INTERVAL_MS);
+    return false;
+}
+
+bool NFCManager::waitForTagUid(Protocol protocol, const uint8_t* uid, uint8_t length, uint32_t timeout_ms) {
+    if (protocol == PROTOCOL_SRIX ? !beginSRIX() : !beginMifare()) {
+        return false;
+    }
+    
+    uint32_t start = millis();
+    while (true) {
+        bool present = (protocol == PROTOCOL_SRIX) ? _srix_handler->isTagPresentHeadless(uid) :
+                                                     _mifare_handler->isCardPresentHeadless(uid, length);
+        if (present) {
+            return true;
+        }
+        if (millis() - start >= timeout_ms) {
+            return false;
+        }
+        delay(WRITE_TARGET_POLL_MS);
+    }
+}
+
+bool NFCManager::batchWaitRemoval(Protocol protocol, const TagInfo* tag) {
+    uint8_t misses = 0;
+    
+    while (!_batch_stop) {
+        bool present;
+        if (!tag) {
+            present = batchDetect(protocol);
+        } else if (protocol == PROTOCOL_SRIX) {
+            present = _srix_handler->isTagPresentHeadless(tag->uid);
+        } else {
+            present = _mifare_handler->isCardPresentHeadless(tag->uid, tag->uid_length);
+        }
+        
+        if (present) {
+            misses = 0;
+        } else if (++misses >= BATCH_REMOVAL_MISSES) {
+            return true;
+        }
+        delay(BATCH_REMOVAL_POLL_MS);
+    }
+    
+    return false;
+}
+
+String NFCManager::batchFilename(const TagInfo& tag, bool binary) {
+    char name[48];
+    size_t len = 0;
+    
+    for (uint8_t i = 0; i < tag.uid_length && i < MAX_UID_LENGTH; i++) {
+        len += snprintf(name + len, sizeof(name) - len, "%02X", tag.uid[i]);
+    }
+    
+    // Wall clock only if something (SNTP) has set it
+    time_t now = time(nullptr);
+    if (now >= (time_t)BATCH_CLOCK_VALID_EPOCH) {
+        struct tm local;
+        localtime_r(&now, &local);
+        len += strftime(name + len, sizeof(name) - len, "_%Y%m%d-%H%M%S", &local);
+    } else {
+        len += snprintf(name + len, sizeof(name) - len, "_up%lu", (unsigned long)(millis() / 1000));
+    }
+    
+    String filename(name);
+    if (binary) {
+        filename += NFCDumpFile::EXTENSION;
+    }
+    return filename;
+}
+
 // ============================================
 // MEMORY MANAGEMENT
 // ============================================
 
 void NFCManager::clearCurrentTag() {
     memset(&_current_tag, 0, sizeof(TagInfo));
-    _current_tag.valid = false;
     _current_protocol = PROTOCOL_UNKNOWN;
     
     LOG_INFO("NFC", "Memory cleared");
 }
 
 void NFCManager::restoreCurrentTag(const TagInfo& info) {
+    if (info.dump && info.dump != _dump && info.size <= sizeof(_dump)) {
+        memcpy(_dump, info.dump, info.size);
+    }
     _current_tag = info;
+    _current_tag.dump = info.dump ? _dump : nullptr;
     _current_protocol = info.protocol;
     
     // Critical: Restore dump to handler as well
-    if (info.protocol == PROTOCOL_MIFARE_CLASSIC && _mifare_handler) {
-        memcpy(_mifare_handler->getDump(), info.data.mifare_classic.dump, MIFARE_1K_DUMP_SIZE);
-        memcpy(_mifare_handler->getUID(), info.uid, info.uid_length);
-        _mifare_handler->setDumpValidFromLoad();
+    if (info.protocol == PROTOCOL_MIFARE_CLASSIC && _mifare_handler && info.dump) {
+        syncMifareHandler(_current_tag);
         LOG_INFO("NFC", "Restored Mifare dump to handler");
-    } else if (info.protocol == PROTOCOL_SRIX && _srix_handler) {
-        memcpy(_srix_handler->getDump(), info.data.srix.dump, SRIX_DUMP_SIZE);
+    } else if (info.protocol == PROTOCOL_SRIX && _srix_handler && info.dump) {
+        memcpy(_srix_handler->getDump(), _dump, SRIX_DUMP_SIZE);
         memcpy(_srix_handler->getUID(), info.uid, 8);
         _srix_handler->setDumpValidFromLoad();
         LOG_INFO("NFC", "Restored SRIX dump to handler");
@@ -1061,13 +1427,10 @@ NFCManager::Result NFCManager::load(String filename, Protocol protocol) {
         return result;
     }
     
-    // If protocol not specified, try to deduce from extension
+    // If protocol not specified, try to deduce from extension (or .nfcb header)
     if (protocol == PROTOCOL_UNKNOWN) {
-        if (filename.endsWith(".srix")) {
-            protocol = PROTOCOL_SRIX;
-        } else if (filename.endsWith(".mfc")) {
-            protocol = PROTOCOL_MIFARE_CLASSIC;
-        } else {
+        protocol = detectFileProtocol(filename);
+        if (protocol == PROTOCOL_UNKNOWN) {
             result.message = "Cannot detect protocol (specify or use correct extension)";
             LOG_ERROR("NFC", "%s", result.message.c_str());
             return result;
@@ -1117,7 +1480,6 @@ NFCManager::Result NFCManager::listFiles(Protocol protocol) {
     Result result = {false, "", -1};
     
     String folder = getProtocolFolder(protocol);
-    String extension = getFileExtension(protocol);
     
     if (!LittleFS.exists(folder)) {
         result.message = "Dump folder not found";
@@ -1125,29 +1487,22 @@ NFCManager::Result NFCManager::listFiles(Protocol protocol) {
         return result;
     }
     
-    File dir = LittleFS.open(folder);
-    if (!dir || !dir.isDirectory()) {
-        result.message = "Failed to open directory";
-        LOG_ERROR("NFC", "Cannot open directory: %s", folder.c_str());
-        return result;
-    }
+    // Served from the catalog: no directory scan, no file opens (unless stale)
+    NFCDumpCatalog::Filter filter;
+    memset(&filter, 0, sizeof(filter));
+    filter.protocol = protocol;
+    
+    std::vector<NFCDumpCatalog::Item> entries;
+    int count = queryDumps(filter, 0, 0, entries);
     
     LOG_INFO("NFC", "╔═══════════════════════════════════════╗");
     LOG_INFO("NFC", "║ %s FILES", protocolToString(protocol).c_str());
     LOG_INFO("NFC", "╠═══════════════════════════════════════╣");
     
-    int count = 0;
-    File file = dir.openNextFile();
-    
-    while (file) {
-        if (!file.isDirectory()) {
-            String name = String(file.name());
-            if (extension.isEmpty() || name.endsWith(extension)) {
-                LOG_INFO("NFC", " %s (%d bytes)", name.c_str(), file.size());
-                count++;
-            }
-        }
-        file = dir.openNextFile();
+    for (const auto& entry : entries) {
+        LOG_INFO("NFC", " %s (%lu bytes, UID %s)",
+                 entry.path.c_str() + folder.length(), (unsigned long)entry.size,
+                 uidToString(entry.uid, entry.uid_len).c_str());
     }
     
     if (count == 0) {
@@ -1163,6 +1518,197 @@ NFCManager::Result NFCManager::listFiles(Protocol protocol) {
     return result;
 }
 
+// Dump folders and the files they hold (catalog rebuild and fallback scans)
+static const char* const SRIX_DUMP_EXT[] = {".srix", NFCDumpFile::EXTENSION, nullptr};
+static const char* const MIFARE_DUMP_EXT[] = {".mfc", NFCDumpFile::EXTENSION, nullptr};
+static const NFCDumpCatalog::Source DUMP_SOURCES[] = {
+    {NFC_SRIX_DUMP_FOLDER, NFCManager::PROTOCOL_SRIX, SRIX_DUMP_EXT},
+    {NFC_MIFARE_DUMP_FOLDER, NFCManager::PROTOCOL_MIFARE_CLASSIC, MIFARE_DUMP_EXT},
+};
+static constexpr size_t DUMP_SOURCE_COUNT = sizeof(DUMP_SOURCES) / sizeof(DUMP_SOURCES[0]);
+
+size_t NFCManager::queryDumps(const NFCDumpCatalog::Filter& filter, size_t offset, size_t limit,
+                              std::vector<NFCDumpCatalog::Item>& out) {
+    if (NFCDumpCatalog::complete()) {
+        return NFCDumpCatalog::query(filter, offset, limit, out);
+    }
+    
+    LOG_DEBUG("NFC", "Dump catalog stale, scanning folders");
+    return NFCDumpCatalog::scan(DUMP_SOURCES, DUMP_SOURCE_COUNT, filter, offset, limit, out);
+}
+
+size_t NFCManager::rebuildCatalog() {
+    LOG_INFO("NFC", "Rebuilding dump catalog...");
+    unsigned long start = millis();
+    
+    NFCDumpCatalog::clear();
+    size_t indexed = 0;
+    for (size_t i = 0; i < DUMP_SOURCE_COUNT; i++) {
+        indexed += NFCDumpCatalog::scanFolder(DUMP_SOURCES[i].folder, DUMP_SOURCES[i].protocol,
+                                              DUMP_SOURCES[i].extensions);
+    }
+    
+    LOG_INFO("NFC", "Dump catalog rebuilt: %u file(s) in %lu ms", (unsigned)indexed, millis() - start);
+    return indexed;
+}
+
+void NFCManager::onFileChanged(const String& path) {
+    Protocol protocol = protocolFromPath(path);
+    if (protocol != PROTOCOL_UNKNOWN) {
+        NFCDumpCatalog::update(path, protocol, nullptr, 0);
+    }
+}
+
+void NFCManager::onFileRemoved(const String& path) {
+    if (path.startsWith(NFC_DUMP_ROOT_FOLDER)) {
+        NFCDumpCatalog::remove(path);
+    }
+}
+
+void NFCManager::onFileRenamed(const String& from, const String& to) {
+    Protocol old_protocol = protocolFromPath(from);
+    Protocol new_protocol = protocolFromPath(to);
+    
+    // Same folder and kind: keep the record (UID, CRC), only the path moves
+    if (old_protocol != PROTOCOL_UNKNOWN && old_protocol == new_protocol &&
+        NFCDumpCatalog::rename(from, to)) {
+        return;
+    }
+    
+    onFileRemoved(from);
+    onFileChanged(to);
+}
+
+NFCManager::Result NFCManager::convertFile(String filename, Protocol protocol) {
+    Result result = {false, "", -1};
+    
+    if (!_initialized) {
+        result.message = "NFCManager not initialized";
+        LOG_ERROR("NFC", "%s", result.message.c_str());
+        return result;
+    }
+    
+    if (protocol == PROTOCOL_UNKNOWN) {
+        protocol = detectFileProtocol(filename);
+    }
+    
+    if (protocol != PROTOCOL_SRIX && protocol != PROTOCOL_MIFARE_CLASSIC) {
+        result.message = "Cannot detect protocol (specify or use correct extension)";
+        result.code = -3;
+        LOG_ERROR("NFC", "%s", result.message.c_str());
+        return result;
+    }
+    
+    // Text -> binary (import) or binary -> text (export), same folder and base name
+    bool to_binary = !NFCDumpFile::isBinaryName(filename);
+    String text_ext = getFileExtension(protocol);
+    String base = filename;
+    if (base.endsWith(text_ext)) {
+        base = base.substring(0, base.length() - text_ext.length());
+    } else if (!to_binary) {
+        base = base.substring(0, base.length() - NFCDumpFile::EXTENSION_LEN);
+    }
+    String source = to_binary ? base + text_ext : filename;
+    String target = base + (to_binary ? String(NFCDumpFile::EXTENSION) : text_ext);
+    
+    LOG_INFO("NFC", "Converting %s -> %s", source.c_str(), target.c_str());
+    
+    // Conversion runs in the protocol handler only: current tag is untouched
+    String filepath;
+    int load_result;
+    
+    if (protocol == PROTOCOL_SRIX) {
+        if (!_srix_handler) {
+            _srix_handler = new SRIXTool(true, _reader, &_irq);
+        }
+        if (!_srix_handler) {
+            result.message = "Failed to create SRIX handler";
+            LOG_ERROR("SRIX", "%s", result.message.c_str());
+            return result;
+        }
+        load_result = _srix_handler->load_file_headless(source);
+        if (load_result == 0) {
+            filepath = _srix_handler->save_file_headless(target);
+        }
+    } else {
+        if (!_mifare_handler) {
+            _mifare_handler = new MifareTool(true, _reader, &_irq);
+            if (!_mifare_handler || !_mifare_handler->begin()) {
+                result.message = "Failed to create Mifare handler";
+                LOG_ERROR("MIFARE", "%s", result.message.c_str());
+                return result;
+            }
+        }
+        load_result = _mifare_handler->load_file_headless(source);
+        if (load_result == MifareTool::SUCCESS) {
+            filepath = _mifare_handler->save_file_headless(target);
+        }
+    }
+    
+    if (load_result != 0) {
+        result.message = "Failed to load " + source;
+        result.code = load_result;
+        LOG_ERROR("NFC", "Convert failed: %s (code: %d)", result.message.c_str(), load_result);
+        return result;
+    }
+    
+    if (filepath.isEmpty()) {
+        result.message = "Failed to save " + target;
+        LOG_ERROR("NFC", "Convert failed: %s", result.message.c_str());
+        return result;
+    }
+    
+    NFCDumpCatalog::update(filepath, protocol, nullptr, 0);
+    
+    result.success = true;
+    result.message = "Converted to " + filepath;
+    result.code = 0;
+    
+    LOG_INFO("NFC", "%s", result.message.c_str());
+    
+    return result;
+}
+
+NFCManager::Protocol NFCManager::detectFileProtocol(const String& filename) {
+    if (filename.endsWith(".srix")) {
+        return PROTOCOL_SRIX;
+    }
+    if (filename.endsWith(".mfc")) {
+        return PROTOCOL_MIFARE_CLASSIC;
+    }
+    if (!NFCDumpFile::isBinaryName(filename)) {
+        return PROTOCOL_UNKNOWN;
+    }
+    
+    // Binary container: the 36-byte header says what is inside,
+    // the folder decides for corrupt files (so they can still be deleted)
+    const Protocol protocols[] = {PROTOCOL_SRIX, PROTOCOL_MIFARE_CLASSIC};
+    for (Protocol folder_protocol : protocols) {
+        String path = filename.startsWith("/") ? filename : getProtocolFolder(folder_protocol) + filename;
+        if (!LittleFS.exists(path)) {
+            continue;
+        }
+        
+        NFCDumpFile::Header header;
+        if (!NFCDumpFile::readHeader(path, header)) {
+            return folder_protocol;
+        }
+        
+        switch (header.kind) {
+            case NFCDumpFile::KIND_SRIX:
+                return PROTOCOL_SRIX;
+            case NFCDumpFile::KIND_MIFARE_1K:
+            case NFCDumpFile::KIND_MIFARE_4K:
+                return PROTOCOL_MIFARE_CLASSIC;
+            default:
+                return folder_protocol;
+        }
+    }
+    
+    LOG_DEBUG("NFC", "Binary dump not found: %s", filename.c_str());
+    return PROTOCOL_UNKNOWN;
+}
+
 NFCManager::Result NFCManager::deleteFile(String filename, Protocol protocol) {
     // Filename is already complete (e.g., "example.srix")
     String filepath = getProtocolFolder(protocol) + filename;
@@ -1175,6 +1721,7 @@ NFCManager::Result NFCManager::deleteFile(String filename, Protocol protocol) {
     }
     
     if (LittleFS.remove(filepath)) {
+        NFCDumpCatalog::remove(filepath);
         LOG_INFO("NFC", "File deleted: %s", filepath.c_str());
         return {true, "File deleted", 0};
     }
@@ -1238,26 +1785,29 @@ String NFCManager::dumpToHex(const uint8_t* data, size_t length) {
     return result;
 }
 
-size_t NFCManager::getTagDataSize(const TagInfo& info) const {
-    switch (info.protocol) {
-        case PROTOCOL_SRIX:
-            return SRIX_DUMP_SIZE;
-        case PROTOCOL_MIFARE_CLASSIC:
-            return MIFARE_1K_DUMP_SIZE;
-        default:
-            return 0;
-    }
+void NFCManager::fillTagInfo(TagInfo& info, TagType type, const uint8_t* dump) {
+    const TagTypeInfo& model = tagTypeInfo(type);
+    
+    info.protocol = model.protocol;
+    info.type = type;
+    info.valid = true;
+    info.timestamp = millis();
+    info.dump = dump;
+    info.size = dump ? model.dump_size : 0;
 }
 
-const uint8_t* NFCManager::getTagDataPointer(const TagInfo& info) const {
-    switch (info.protocol) {
-        case PROTOCOL_SRIX:
-            return info.data.srix.dump;
-        case PROTOCOL_MIFARE_CLASSIC:
-            return info.data.mifare_classic.dump;
-        default:
-            return nullptr;
+void NFCManager::syncMifareHandler(const TagInfo& info) {
+    if (!_mifare_handler || !info.dump) {
+        return;
     }
+    
+    if (info.dump != _mifare_handler->getDump()) {
+        memcpy(_mifare_handler->getDump(), info.dump, info.size);
+    }
+    memcpy(_mifare_handler->getUID(), info.uid, info.uid_length);
+    _mifare_handler->setCardType(info.type == TAG_MIFARE_4K ? MifareTool::CARD_MIFARE_4K :
+                                                              MifareTool::CARD_MIFARE_1K);
+    _mifare_handler->setDumpValidFromLoad();
 }
 
 String NFCManager::getProtocolFolder(Protocol proto) {
@@ -1272,6 +1822,19 @@ String NFCManager::getProtocolFolder(Protocol proto) {
     }
 }
 
+NFCManager::Protocol NFCManager::protocolFromPath(const String& path) {
+    bool binary = NFCDumpFile::isBinaryName(path);
+    
+    if (path.startsWith(NFC_SRIX_DUMP_FOLDER) && (binary || path.endsWith(".srix"))) {
+        return PROTOCOL_SRIX;
+    }
+    if (path.startsWith(NFC_MIFARE_DUMP_FOLDER) && (binary || path.endsWith(".mfc"))) {
+        return PROTOCOL_MIFARE_CLASSIC;
+    }
+    
+    return PROTOCOL_UNKNOWN;
+}
+
 String NFCManager::getFileExtension(Protocol proto) {
     switch (proto) {
         case PROTOCOL_SRIX:
@@ -1302,10 +1865,3 @@ void NFCManager::stringToUid(const String& str, uint8_t* uid, uint8_t& length) {
         uid[i] = strtoul(byte_str.c_str(), NULL, 16);
     }
 }
-
-void NFCManager::hexToDump(const String& hex, uint8_t* data, size_t length) {
-    for (size_t i = 0; i < length && i * 2 < hex.length(); i++) {
-        String byte_str = hex.substring(i * 2, i * 2 + 2);
-        data[i] = strtoul(byte_str.c_str(), NULL, 16);
-    }
-}
@@ -7,6 +7,11 @@
 #include "logger.h"
 #include "srix_tool.h"
 #include "mifare_tool.h"
+#include "nfc_dump_file.h"
+#include "nfc_dump_catalog.h"
+#include "nfc_dump_diff.h"
+#include "nfc_irq.h"
+#include "nfc_reader.h"
 
 /**
  * @file nfc_manager.h
@@ -20,14 +25,26 @@
  * Features:
  * - Protocol abstraction with unified TagInfo structure
  * - Lazy initialization (handlers created on demand)
- * - File management (save/load/list/delete)
+ * - File management (save/load/list/delete, text <-> .nfcb conversion)
+ * - Persistent dump catalog (NFCDumpCatalog) kept in sync on every file change
  * - Memory management (current tag state)
  * - Selective block write operations
+ * - Compare against the physical tag with a dirty-block bitmap (NFCDumpDiff),
+ *   so changed blocks are written without the client sending a block list
+ * - Batch scan: detect, read, auto-name, save and wait for removal in a
+ *   loop, for high-volume tag intake
+ * - One instance per PN532 reader (NFCReaderConfig: bus, pins, worker
+ *   core), so two readers can run jobs in parallel
  * 
  * Architecture:
- * - NFCManager acts as coordinator
+ * - NFCManager acts as coordinator for one reader
+ * - Each instance owns its handlers, IRQ waiter, current tag and dump;
+ *   dump files, catalog and key database are shared (NFCSharedLock)
  * - Protocol-specific handlers (SRIXTool, MifareTool) handle hardware
- * - TagInfo struct provides protocol-agnostic data storage
+ * - TagInfo is metadata only (~32 bytes, cheap to pass around); the dump
+ *   bytes live once in NFCManager (sized for the largest tag, Mifare 4K)
+ *   and TagInfo::dump points at them
+ * - Tag names and dump geometry come from a constexpr TagType table
  * - File operations use protocol-specific folders and extensions
  * 
  * Usage:
@@ -58,39 +75,54 @@ public:
         PROTOCOL_DESFIRE             ///< DESFire (ISO 14443A) - Future
     };
     
+    /**
+     * @brief Tag models (index into the tag type table)
+     */
+    enum TagType : uint8_t {
+        TAG_UNKNOWN = 0,             ///< No tag / UID-only read of an unknown model
+        TAG_SRIX4K,                  ///< SRIX4K: 128 blocks × 4 bytes
+        TAG_MIFARE_1K,               ///< Mifare Classic 1K: 64 blocks × 16 bytes
+        TAG_MIFARE_4K,               ///< Mifare Classic 4K: 256 blocks × 16 bytes
+        TAG_TYPE_COUNT
+    };
+    
+    /**
+     * @brief Static description of a tag model
+     */
+    struct TagTypeInfo {
+        const char* name;            ///< Human-readable name
+        Protocol protocol;           ///< Protocol family
+        uint16_t dump_size;          ///< Full dump size in bytes
+        uint8_t block_size;          ///< Block size in bytes
+        uint8_t sectors;             ///< Sector count (0: no sectors)
+    };
+    
     // ============================================
     // TAG INFO STRUCTURE
     // ============================================
     
     /**
-     * @brief Universal tag information container
+     * @brief Universal tag information (metadata + dump handle)
      * 
-     * Protocol-agnostic structure that holds tag data.
-     * Uses union to optimize memory for protocol-specific data.
+     * Small and copyable: the dump itself is not part of the struct.
+     * dump points at NFCManager's own buffer for the current tag, or at
+     * the protocol handler's buffer for a tag read without making it
+     * current (compare); the latter is valid until the next tag operation.
      */
     struct TagInfo {
-        Protocol protocol;           ///< Detected protocol
-        String protocol_name;        ///< Human-readable protocol name
-        uint8_t uid[10];            ///< Universal UID buffer (max 10 bytes)
-        uint8_t uid_length;         ///< Actual UID length
-        bool valid;                 ///< Data validity flag
-        uint32_t timestamp;         ///< Timestamp of read/load (millis())
+        Protocol protocol = PROTOCOL_UNKNOWN;  ///< Detected protocol
+        TagType type = TAG_UNKNOWN;  ///< Tag model (name, geometry)
+        uint8_t uid[10] = {};        ///< Universal UID buffer (max 10 bytes)
+        uint8_t uid_length = 0;      ///< Actual UID length
+        bool valid = false;          ///< Data validity flag
+        uint16_t size = 0;           ///< Dump size in bytes (0: UID only)
+        uint32_t timestamp = 0;      ///< Timestamp of read/load (millis())
+        const uint8_t* dump = nullptr;  ///< Dump bytes (not owned), nullptr if size is 0
         
         /**
-         * @brief Protocol-specific data storage (union saves RAM)
+         * @brief Human-readable tag name (from the tag type table)
          */
-        union {
-            struct {
-                uint8_t dump[512];   ///< SRIX: 128 blocks × 4 bytes
-            } srix;
-            
-            struct {
-                uint8_t dump[1024];  ///< Mifare Classic 1K: 64 blocks × 16 bytes
-                uint8_t sectors;     ///< Number of sectors (16 for 1K, 40 for 4K)
-            } mifare_classic;
-            
-            // Future: NTAG, DESFire, etc.
-        } data;
+        const char* name() const { return tagTypeInfo(type).name; }
     };
     
     // ============================================
@@ -111,9 +143,25 @@ public:
     static constexpr size_t SRIX_DUMP_SIZE = 512;           ///< SRIX dump size in bytes
     static constexpr size_t MIFARE_1K_DUMP_SIZE = 1024;     ///< Mifare 1K dump size in bytes
     static constexpr size_t MIFARE_4K_DUMP_SIZE = 4096;     ///< Mifare 4K dump size in bytes
+    static constexpr uint8_t SRIX_BLOCK_SIZE = 4;           ///< SRIX block size in bytes
+    static constexpr uint8_t MIFARE_BLOCK_SIZE = 16;        ///< Mifare Classic block size in bytes
     static constexpr int DEFAULT_READ_TIMEOUT_SEC = 10;     ///< Default read timeout
     static constexpr int DEFAULT_WRITE_TIMEOUT_SEC = 20;    ///< Default write timeout
     static constexpr int DEFAULT_UID_READ_TIMEOUT_SEC = 5;  ///< Default UID-only read timeout
+    static constexpr uint32_t WRITE_TARGET_TIMEOUT_MS = 5000; ///< Write-changes wait for the compared tag
+    static constexpr uint32_t WRITE_TARGET_POLL_MS = 50;    ///< Interval of compared-tag checks
+    static constexpr uint16_t BATCH_DETECT_SLICE_MS = 100;  ///< Detection attempt between stop checks
+    static constexpr uint32_t BATCH_REMOVAL_POLL_MS = 50;   ///< Interval of tag-still-present checks
+    static constexpr uint8_t BATCH_REMOVAL_MISSES = 3;      ///< Missed checks that count as removal
+    static constexpr int BATCH_READ_TIMEOUT_SEC = 2;        ///< Full read once a tag is detected
+    static constexpr uint32_t BATCH_CLOCK_VALID_EPOCH = 1700000000UL; ///< time() below this: clock not set
+    
+    /**
+     * @brief Look up a tag model
+     * @param type TagType (out of range: TAG_UNKNOWN entry)
+     * @return Constant table entry
+     */
+    static const TagTypeInfo& tagTypeInfo(TagType type);
     
     // ============================================
     // CONSTRUCTOR & INITIALIZATION
@@ -121,8 +169,9 @@ public:
     
     /**
      * @brief Constructor
+     * @param reader PN532 this manager drives (default: reader 0)
      */
-    NFCManager();
+    explicit NFCManager(const NFCReaderConfig& reader = NFCReaderConfig::forIndex(0));
     
     /**
      * @brief Destructor
@@ -135,11 +184,16 @@ public:
      * @brief Initialize NFC Manager
      * @return true if initialization successful
      * 
-     * Creates dump directories on LittleFS.
-     * Does not initialize protocol handlers (lazy init).
+     * Creates dump directories on LittleFS, starts the reader's bus and
+     * IRQ line. Does not initialize protocol handlers (lazy init).
      */
     bool begin();
     
+    /**
+     * @brief Reader this manager drives (id, bus, pins, worker core)
+     */
+    const NFCReaderConfig& reader() const { return _reader; }
+    
     /**
      * @brief Initialize SRIX handler (lazy init)
      * @return true if handler ready
@@ -188,9 +242,10 @@ public:
      * @brief Read SRIX tag (UID + full dump)
      * @param info TagInfo structure to fill
      * @param timeout_sec Timeout in seconds
+     * @param make_current Also make it the current tag (false: compare reads)
      * @return Result with success/message/code
      */
-    Result readSRIX(TagInfo& info, int timeout_sec = DEFAULT_READ_TIMEOUT_SEC);
+    Result readSRIX(TagInfo& info, int timeout_sec = DEFAULT_READ_TIMEOUT_SEC, bool make_current = true);
     
     /**
      * @brief Write SRIX tag from loaded dump
@@ -246,9 +301,11 @@ public:
      * @brief Read Mifare tag (UID + full dump)
      * @param info TagInfo structure to fill
      * @param timeout_sec Timeout in seconds
+     * @param make_current Also make it the current tag (false: compare reads,
+     *                     handler buffer is put back to the loaded dump)
      * @return Result with success/message/code
      */
-    Result readMifare(TagInfo& info, int timeout_sec = DEFAULT_READ_TIMEOUT_SEC);
+    Result readMifare(TagInfo& info, int timeout_sec = DEFAULT_READ_TIMEOUT_SEC, bool make_current = true);
     
     /**
      * @brief Read Mifare UID only (fast, no authentication)
@@ -297,15 +354,184 @@ public:
      */
     Result writeMifareBlocksSelective(const std::vector<uint8_t>& block_numbers);
     
+    /**
+     * @brief Per-sector results of the last Mifare write
+     * @param count Output: number of sectors (0 if the handler is not initialized)
+     * @return Sector stats array, or nullptr
+     */
+    const MifareTool::SectorWriteStats* getMifareWriteStats(uint8_t& count) const {
+        count = 0;
+        return _mifare_handler ? _mifare_handler->getSectorWriteStats(count) : nullptr;
+    }
+    
+    /**
+     * @brief Key search totals of the last full Mifare read (keys/sec, readers)
+     * @return Stats, or nullptr if the handler is not initialized
+     */
+    const MifareTool::KeySearchStats* getMifareKeyStats() const {
+        return _mifare_handler ? &_mifare_handler->getKeySearchStats() : nullptr;
+    }
+    
+    /**
+     * @brief Enable/disable the persistent Mifare key cache for reads
+     * @param enabled false: reads search the key database for every sector
+     */
+    void setMifareKeyCacheEnabled(bool enabled) {
+        if (_mifare_handler) _mifare_handler->setKeyCacheEnabled(enabled);
+    }
+    
+    /**
+     * @brief Key that opened a sector during the last Mifare read
+     * @return false if unknown (see MifareTool::getSectorKey())
+     */
+    bool getMifareSectorKey(int sector, bool& keyA, uint8_t* key) const {
+        return _mifare_handler && _mifare_handler->getSectorKey(sector, keyA, key);
+    }
+    
+    /**
+     * @brief Try candidate keys on a sector of the last read Mifare card
+     * @return MifareTool ReturnCode (see MifareTool::probeKeys())
+     */
+    int probeMifareKeys(int sector, bool keyA, const uint8_t* keys, uint16_t count, int& found) {
+        found = -1;
+        return _mifare_handler ? _mifare_handler->probeKeys(sector, keyA, keys, count, found) :
+                                 MifareTool::ERROR_NO_TAG;
+    }
+    
+    // ============================================
+    // COMPARE / WRITE CHANGES
+    // ============================================
+    
+    /**
+     * @brief Read the physical tag and diff it against the loaded dump
+     * @param physical TagInfo filled with the tag just read
+     * @param timeout_sec Timeout in seconds
+     * @return Result with success/message/code (code 1: partial Mifare
+     *         read, -4: size mismatch)
+     * 
+     * The loaded dump stays current (no TagInfo backup/restore). The diff
+     * is kept for writeChangedBlocks() until another dump is read/loaded.
+     * The tag's UID may differ from the dump's (clone/patch target); the
+     * diff records it. Sectors a partial Mifare read could not open are
+     * marked unknown: not dirty, never written.
+     */
+    Result compareWithTag(TagInfo& physical, int timeout_sec = DEFAULT_READ_TIMEOUT_SEC);
+    
+    /**
+     * @brief Write the writable dirty blocks of the last compare
+     * @return Result with success/message/code (code -5: no compare for this
+     *         dump, -6: the compared tag is not in the field)
+     * 
+     * Mifare block 0 and sector trailers are never in the list. Waits up
+     * to WRITE_TARGET_TIMEOUT_MS for the UID the compare read, so a card
+     * swapped in after the compare is refused.
+     */
+    Result writeChangedBlocks();
+    
+    /**
+     * @brief Last compare result (check matches(currentTag().timestamp))
+     */
+    const NFCDumpDiff& getLastDiff() const { return _diff; }
+    
+    // ============================================
+    // BATCH SCAN
+    // ============================================
+    
+    /**
+     * @brief Batch scan parameters
+     */
+    struct BatchOptions {
+        Protocol protocol;           ///< PROTOCOL_SRIX or PROTOCOL_MIFARE_CLASSIC
+        bool dedupe;                 ///< Skip saving UIDs already in the dump catalog
+        bool binary;                 ///< Save as .nfcb instead of the text format
+        uint16_t max_tags;           ///< Stop after this many tags (0 = no limit)
+        uint32_t idle_timeout_ms;    ///< Stop after this long without a tag (0 = never)
+    };
+    
+    /**
+     * @brief Outcome of one batch step
+     */
+    enum BatchStatus : uint8_t {
+        BATCH_SAVED = 0,             ///< Read and saved (path set)
+        BATCH_DUPLICATE,             ///< Read, UID already catalogued (path of the existing dump)
+        BATCH_READ_FAILED,           ///< Detected but the full read failed
+        BATCH_SAVE_FAILED,           ///< Read but the file could not be written
+        BATCH_REMOVED                ///< Tag left the field, ready for the next one
+    };
+    
+    /**
+     * @brief Per-tag batch event
+     */
+    struct BatchEvent {
+        BatchStatus status;          ///< What happened
+        uint16_t index;              ///< Tag number in this run (1-based)
+        const TagInfo* tag;          ///< Tag read (nullptr for BATCH_READ_FAILED)
+        const char* path;            ///< Dump path (saved/duplicate), "" otherwise
+        uint32_t read_ms;            ///< Full read time
+        uint32_t cycle_ms;           ///< Previous tag removed -> this event
+    };
+    
+    /**
+     * @brief Counters of the current/last batch run
+     */
+    struct BatchStats {
+        uint16_t tags;               ///< Tags detected
+        uint16_t saved;              ///< Dumps written
+        uint16_t duplicates;         ///< Already catalogued, not written
+        uint16_t failed;             ///< Read or save failures
+        uint32_t elapsed_ms;         ///< Run time so far
+    };
+    
+    /**
+     * @brief Batch event listener (runs on the scanning task, keep it short)
+     */
+    typedef void (*BatchListener)(const BatchEvent& event, void* context);
+    
+    /**
+     * @brief Scan tags in a loop until stopped
+     * @param options Protocol, dedupe, file format, stop conditions
+     * @param listener Per-tag callback (may be nullptr)
+     * @param context Opaque pointer passed back to listener
+     * @return Result (code = tags saved); stats in batchStats()
+     * 
+     * Loop: detect -> full read -> name "<UID>_<time>" -> dedupe against
+     * the catalog -> save -> wait for removal. A tag is read once while
+     * it stays in the field. Each read tag becomes the current tag.
+     * Blocks the calling task: run it on the NFC worker.
+     */
+    Result runBatch(const BatchOptions& options, BatchListener listener, void* context);
+    
+    /**
+     * @brief Ask a running batch to stop (any task)
+     * 
+     * Takes effect at the next detection slice or removal check.
+     */
+    void stopBatch() { _batch_stop = true; }
+    
+    /**
+     * @brief Check if a batch scan is running
+     */
+    bool isBatchRunning() const { return _batch_running; }
+    
+    /**
+     * @brief Counters of the running or last batch
+     */
+    BatchStats batchStats() const { return _batch_stats; }
+    
+    /**
+     * @brief Batch status as API string (e.g. "duplicate")
+     */
+    static const char* batchStatusToString(BatchStatus status);
+    
     // ============================================
     // MEMORY MANAGEMENT
     // ============================================
     
     /**
-     * @brief Get current tag data
-     * @return TagInfo structure (copy)
+     * @brief Get current tag data without copying it
+     * @return Reference to the live TagInfo (changes when a job reads/loads)
      */
-    TagInfo getCurrentTag() const { return _current_tag; }
+    const TagInfo& currentTag() const { return _current_tag; }
     
     /**
      * @brief Check if valid data is loaded
@@ -320,7 +546,8 @@ public:
     
     /**
      * @brief Restore current tag from backup
-     * @param info TagInfo to restore
+     * @param info TagInfo to restore (its dump is copied into the
+     *             manager's buffer if it points elsewhere)
      * 
      * Useful after selective block writes to maintain state.
      */
@@ -349,9 +576,68 @@ public:
      * @brief List files for protocol
      * @param protocol Protocol type
      * @return Result with success/message/code (code = file count)
+     * 
+     * Reads the dump catalog (folder scan while it is stale).
      */
     Result listFiles(Protocol protocol = PROTOCOL_SRIX);
     
+    /**
+     * @brief Paginated dump listing, catalog or folder scan
+     * @param filter Protocol/UID filter
+     * @param offset Matching files to skip
+     * @param limit Max files returned (0 = no limit)
+     * @param out Matching files
+     * @return Total number of matching files
+     * 
+     * Falls back to NFCDumpCatalog::scan() while the catalog is
+     * missing or stale, so unindexed dumps still show up.
+     */
+    size_t queryDumps(const NFCDumpCatalog::Filter& filter, size_t offset, size_t limit,
+                      std::vector<NFCDumpCatalog::Item>& out);
+    
+    /**
+     * @brief Rebuild the dump catalog from a scan of the dump folders
+     * @return Number of files indexed
+     */
+    size_t rebuildCatalog();
+    
+    /**
+     * @brief Catalog hook: file written outside NFCManager (upload, editor)
+     * @param path Full path (ignored unless it is a dump file)
+     */
+    void onFileChanged(const String& path);
+    
+    /**
+     * @brief Catalog hook: file or folder removed outside NFCManager
+     * @param path Full path
+     */
+    void onFileRemoved(const String& path);
+    
+    /**
+     * @brief Catalog hook: file renamed or moved outside NFCManager
+     * @param from Old full path
+     * @param to New full path
+     */
+    void onFileRenamed(const String& from, const String& to);
+    
+    /**
+     * @brief Convert a dump between text and binary (.nfcb) format
+     * @param filename Source file (.srix/.mfc imports, .nfcb exports)
+     * @param protocol Protocol type (auto-detect if PROTOCOL_UNKNOWN)
+     * @return Result with success/message/code (message holds new path)
+     * 
+     * Writes the converted file next to the source with the same base
+     * name. The current tag in memory is not changed.
+     */
+    Result convertFile(String filename, Protocol protocol = PROTOCOL_UNKNOWN);
+    
+    /**
+     * @brief Detect dump protocol from a filename
+     * @param filename Filename or full path
+     * @return Protocol from the extension, or from the header for .nfcb
+     */
+    Protocol detectFileProtocol(const String& filename);
+    
     /**
      * @brief Delete file
      * @param filename Filename (without path)
@@ -388,20 +674,27 @@ public:
     String dumpToHex(const uint8_t* data, size_t length);
     
     /**
-     * @brief Get data size for tag protocol
+     * @brief Get data size of a tag
      * @param info TagInfo structure
-     * @return Data size in bytes
+     * @return Data size in bytes (0 for UID-only reads)
      */
-    size_t getTagDataSize(const TagInfo& info) const;
+    size_t getTagDataSize(const TagInfo& info) const { return info.dump ? info.size : 0; }
     
     /**
      * @brief Get pointer to tag data
      * @param info TagInfo structure
-     * @return Pointer to data buffer
+     * @return Pointer to data buffer (nullptr for UID-only reads)
      */
-    const uint8_t* getTagDataPointer(const TagInfo& info) const;
+    const uint8_t* getTagDataPointer(const TagInfo& info) const { return info.dump; }
 
 private:
+    // ============================================
+    // HARDWARE
+    // ============================================
+    
+    NFCReaderConfig _reader;        ///< Bus, pins and worker core of this reader
+    NFCIrq _irq;                    ///< IRQ waiter of this reader's PN532
+    
     // ============================================
     // PROTOCOL HANDLERS
     // ============================================
@@ -416,12 +709,70 @@ private:
     
     bool _initialized;              ///< Manager initialization flag
     Protocol _current_protocol;     ///< Currently active protocol
-    TagInfo _current_tag;           ///< Current loaded tag data
+    TagInfo _current_tag;           ///< Current loaded tag data (dump -> _dump)
+    alignas(4) uint8_t _dump[MIFARE_4K_DUMP_SIZE];  ///< Current tag dump (the only copy)
+    NFCDumpDiff _diff;              ///< Last compare against _current_tag
+    std::vector<uint8_t> _block_list; ///< writeChangedBlocks() list (reserved in begin())
+    volatile bool _batch_stop;      ///< stopBatch() request
+    volatile bool _batch_running;   ///< runBatch() active
+    BatchStats _batch_stats;        ///< Current/last batch counters
     
     // ============================================
     // HELPER FUNCTIONS
     // ============================================
     
+    /**
+     * @brief Fill tag metadata for a model
+     * @param info TagInfo to fill (uid must already be set)
+     * @param type Tag model
+     * @param dump Dump bytes (nullptr: UID only)
+     */
+    void fillTagInfo(TagInfo& info, TagType type, const uint8_t* dump);
+    
+    /**
+     * @brief Put a tag image into the Mifare handler before it writes/saves
+     * @param info Tag to copy (dump, UID, card type)
+     * 
+     * The handler buffer is also the read buffer of compare reads, so
+     * every handler write path loads the image it needs first.
+     */
+    void syncMifareHandler(const TagInfo& info);
+    
+    /**
+     * @brief Wait for a tag with a given UID
+     * @param protocol PROTOCOL_SRIX or PROTOCOL_MIFARE_CLASSIC
+     * @param uid UID to look for
+     * @param length UID length
+     * @param timeout_ms Give up after this long (another UID in the field keeps waiting)
+     * @return true once that tag answers
+     */
+    bool waitForTagUid(Protocol protocol, const uint8_t* uid, uint8_t length, uint32_t timeout_ms);
+    
+    /**
+     * @brief One quiet detection attempt for a batch scan
+     * @return true if a tag of the protocol answered
+     */
+    bool batchDetect(Protocol protocol);
+    
+    /**
+     * @brief Wait until the tag just handled leaves the field
+     * @param protocol Batch protocol
+     * @param tag Tag read (nullptr after a failed read: any tag counts)
+     * @return false if the batch was stopped while waiting
+     * 
+     * Removal is BATCH_REMOVAL_MISSES checks in a row without an answer
+     * from that UID (a different tag placed on the reader counts).
+     */
+    bool batchWaitRemoval(Protocol protocol, const TagInfo* tag);
+    
+    /**
+     * @brief Build the auto-generated batch filename
+     * @param tag Tag read
+     * @param binary Append .nfcb
+     * @return "<UID hex>_<YYYYMMDD-HHMMSS>", or "_up<seconds>" without a set clock
+     */
+    String batchFilename(const TagInfo& tag, bool binary);
+    
     /**
      * @brief Convert hex string to UID bytes
      * @param str Input hex string (with or without separators)
@@ -430,14 +781,6 @@ private:
      */
     void stringToUid(const String& str, uint8_t* uid, uint8_t& length);
     
-    /**
-     * @brief Convert hex string to dump bytes
-     * @param hex Input hex string
-     * @param data Output data buffer
-     * @param length Maximum bytes to write
-     */
-    void hexToDump(const String& hex, uint8_t* data, size_t length);
-    
     /**
      * @brief Get protocol dump folder path
      * @param proto Protocol type
@@ -445,6 +788,13 @@ private:
      */
     String getProtocolFolder(Protocol proto);
     
+    /**
+     * @brief Map a full path to its dump protocol
+     * @param path Full LittleFS path
+     * @return Protocol if path is a dump file in a protocol folder, else PROTOCOL_UNKNOWN
+     */
+    Protocol protocolFromPath(const String& path);
+    
     /**
      * @brief Get protocol file extension
      * @param proto Protocol type
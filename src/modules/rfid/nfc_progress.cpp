@@ -0,0 +1,38 @@
+#include "nfc_progress.h"
+
+// ============================================
+// STATIC MEMBERS
+// ============================================
+
+NFCProgress::Listener NFCProgress::_listeners[NFCProgress::MAX_LISTENERS] = {};
+void* NFCProgress::_contexts[NFCProgress::MAX_LISTENERS] = {};
+volatile uint8_t NFCProgress::_count = 0;
+
+// ============================================
+// PUBLIC METHODS
+// ============================================
+
+bool NFCProgress::addListener(Listener listener, void* context) {
+    if (!listener || _count >= MAX_LISTENERS) {
+        return false;
+    }
+    
+    // Fill the slot before publishing it through _count
+    _listeners[_count] = listener;
+    _contexts[_count] = context;
+    _count = _count + 1;
+    return true;
+}
+
+// ============================================
+// PRIVATE METHODS
+// ============================================
+
+void NFCProgress::emit(EventType type, Operation op, uint16_t index, uint16_t total,
+                       bool ok, char key_type, uint16_t attempts) {
+    Event event = {type, op, index, total, ok, key_type, attempts};
+    uint8_t count = _count;
+    for (uint8_t i = 0; i < count; i++) {
+        _listeners[i](event, _contexts[i]);
+    }
+}
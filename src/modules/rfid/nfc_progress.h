@@ -0,0 +1,141 @@
+#ifndef __NFC_PROGRESS_H__
+#define __NFC_PROGRESS_H__
+
+#include <Arduino.h>
+
+/**
+ * @brief Progress reporting hook for NFC tools
+ * 
+ * Features:
+ * - Per-block and per-sector progress for reads and writes
+ * - Mifare sector authentication results (key type, attempts)
+ * - Up to MAX_LISTENERS listeners (one per NFC worker), zero cost when
+ *   nobody listens
+ * 
+ * Architecture:
+ * - Static singleton pattern (no instance needed)
+ * - SRIXTool, MifareTool and NFCManager report from their loops
+ * - Listener runs synchronously on the reporting task (keep it short)
+ * - Every listener sees every event: listeners of parallel workers
+ *   filter on xTaskGetCurrentTaskHandle()
+ * 
+ * Usage:
+ * @code
+ * void onProgress(const NFCProgress::Event& ev, void* ctx) { ... }
+ * NFCProgress::addListener(onProgress, this);
+ * NFCProgress::block(NFCProgress::OP_READ, 10, 128);
+ * @endcode
+ */
+class NFCProgress {
+public:
+    // ============================================
+    // TYPES
+    // ============================================
+    
+    /**
+     * @brief Event kinds
+     */
+    enum EventType : uint8_t {
+        EVENT_BLOCK = 0,    ///< Block processed (index/total)
+        EVENT_SECTOR,       ///< Mifare sector processed (index/total)
+        EVENT_AUTH          ///< Mifare sector authentication result
+    };
+    
+    /**
+     * @brief Operation being reported
+     */
+    enum Operation : uint8_t {
+        OP_READ = 0,
+        OP_WRITE
+    };
+    
+    /**
+     * @brief Progress event payload
+     */
+    struct Event {
+        EventType type;     ///< Event kind
+        Operation op;       ///< Read or write
+        uint16_t index;     ///< Items completed (1-based) or sector number (auth)
+        uint16_t total;     ///< Items expected (0 for auth)
+        bool ok;            ///< Item succeeded
+        char key_type;      ///< 'A' / 'B' for auth events, 0 otherwise
+        uint16_t attempts;  ///< Keys tried (auth events)
+    };
+    
+    /**
+     * @brief Listener signature
+     */
+    typedef void (*Listener)(const Event& event, void* context);
+    
+    // ============================================
+    // CONSTANTS
+    // ============================================
+    
+    static constexpr uint8_t MAX_LISTENERS = 2;     // One per NFC worker (NFC_MAX_READERS)
+    
+    // ============================================
+    // PUBLIC METHODS
+    // ============================================
+    
+    /**
+     * @brief Install a progress listener
+     * @param listener Callback invoked for every event
+     * @param context Opaque pointer passed back to listener
+     * @return false if all MAX_LISTENERS slots are taken
+     * 
+     * Install at startup, before reports start: slots are not locked.
+     */
+    static bool addListener(Listener listener, void* context);
+    
+    /**
+     * @brief Report block progress
+     * @param op Read or write
+     * @param done Blocks completed (1-based)
+     * @param total Blocks in this operation
+     * @param ok Block succeeded
+     */
+    static void block(Operation op, uint16_t done, uint16_t total, bool ok = true) {
+        if (_count) emit(EVENT_BLOCK, op, done, total, ok, 0, 0);
+    }
+    
+    /**
+     * @brief Report Mifare sector progress
+     * @param op Read or write
+     * @param done Sectors completed (1-based)
+     * @param total Sectors in this operation
+     * @param ok Sector succeeded
+     */
+    static void sector(Operation op, uint16_t done, uint16_t total, bool ok = true) {
+        if (_count) emit(EVENT_SECTOR, op, done, total, ok, 0, 0);
+    }
+    
+    /**
+     * @brief Report Mifare sector authentication result
+     * @param sector Sector number
+     * @param key_type 'A' or 'B' (0 if all keys failed)
+     * @param ok Authentication succeeded
+     * @param attempts Number of keys tried
+     */
+    static void auth(uint16_t sector, char key_type, bool ok, uint16_t attempts) {
+        if (_count) emit(EVENT_AUTH, OP_READ, sector, 0, ok, key_type, attempts);
+    }
+    
+    /**
+     * @brief Convert operation to string ("read" / "write")
+     */
+    static const char* opToString(Operation op) { return op == OP_WRITE ? "write" : "read"; }
+
+private:
+    // ============================================
+    // PRIVATE MEMBERS
+    // ============================================
+    
+    static Listener _listeners[MAX_LISTENERS];  // Installed listeners
+    static void* _contexts[MAX_LISTENERS];      // Listener contexts
+    static volatile uint8_t _count;             // Slots in use
+    
+    static void emit(EventType type, Operation op, uint16_t index, uint16_t total,
+                     bool ok, char key_type, uint16_t attempts);
+};
+
+#endif // __NFC_PROGRESS_H__
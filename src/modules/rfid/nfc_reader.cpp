@@ -0,0 +1,12 @@
+#include "nfc_reader.h"
+
+// ============================================
+// SHARED LOCK
+// ============================================
+
+SemaphoreHandle_t NFCSharedLock::handle() {
+    // Function-local statics: constructed once, thread-safe on first use
+    static StaticSemaphore_t buffer;
+    static SemaphoreHandle_t lock = xSemaphoreCreateRecursiveMutexStatic(&buffer);
+    return lock;
+}
@@ -0,0 +1,85 @@
+#ifndef __NFC_READER_H__
+#define __NFC_READER_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "config.h"
+
+/**
+ * @brief Hardware description of one PN532 reader
+ * 
+ * Features:
+ * - Bus (TwoWire), pins and clock of one PN532
+ * - Core of the reader's NFC worker task
+ * 
+ * Architecture:
+ * - One NFCManager per reader; the reader's SRIXTool/MifareTool talk
+ *   only to this bus and wait only on this IRQ line
+ * - The PN532 I2C address is fixed (0x24): one reader per I2C controller
+ * 
+ * Usage:
+ * @code
+ * NFCManager primary(NFCReaderConfig::forIndex(0));
+ * NFCManager secondary(NFCReaderConfig::forIndex(1));
+ * @endcode
+ */
+struct NFCReaderConfig {
+    uint8_t id;                 ///< Reader index (0 = primary)
+    TwoWire* wire;              ///< I2C controller (Wire, Wire1)
+    int8_t sda;                 ///< I2C Data pin
+    int8_t scl;                 ///< I2C Clock pin
+    uint32_t frequency;         ///< Bus clock (Hz)
+    uint8_t irq_pin;            ///< PN532 IRQ (255 = status byte polling)
+    uint8_t reset_pin;          ///< PN532 reset (255 = none)
+    uint8_t core;               ///< Core the reader's NFC worker is pinned to
+    
+    /**
+     * @brief Reader from the config.h pin map
+     * @param id 0 (PN532_* pins, Wire) or 1 (NFC_READER1_* pins, Wire1)
+     */
+    static NFCReaderConfig forIndex(uint8_t id) {
+        if (id == 1) {
+            return {1, &Wire1, NFC_READER1_SDA_PIN, NFC_READER1_SCL_PIN, I2C_FREQUENCY,
+                    NFC_READER1_IRQ_PIN, NFC_READER1_RESET_PIN, NFC_READER1_CORE};
+        }
+        return {0, &Wire, I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY,
+                PN532_IRQ_PIN, PN532_RESET_PIN, NFC_READER0_CORE};
+    }
+};
+
+/**
+ * @brief Lock for state shared by every reader
+ * 
+ * Guards the file-backed singletons that parallel NFC workers would
+ * otherwise corrupt with interleaved read-modify-write cycles (dump
+ * catalog, Mifare key cache, key database counters) and the
+ * Adafruit_PN532 frame buffer, which the library keeps in a global.
+ * 
+ * Features:
+ * - RAII: held for the scope of the guard object
+ * - Recursive: guarded functions may call each other
+ * - Static storage, created on first use
+ * 
+ * Usage:
+ * @code
+ * bool NFCDumpCatalog::update(...) {
+ *     NFCSharedLock lock;
+ *     ...
+ * }
+ * @endcode
+ */
+class NFCSharedLock {
+public:
+    NFCSharedLock() { xSemaphoreTakeRecursive(handle(), portMAX_DELAY); }
+    ~NFCSharedLock() { xSemaphoreGiveRecursive(handle()); }
+    
+    NFCSharedLock(const NFCSharedLock&) = delete;
+    NFCSharedLock& operator=(const NFCSharedLock&) = delete;
+
+private:
+    static SemaphoreHandle_t handle();
+};
+
+#endif // __NFC_READER_H__
@@ -7,14 +7,16 @@
  */
 
 #include "srix_tool.h"
+#include "nfc_progress.h"
 #include <LittleFS.h>
+#include <stage_metrics.h>
 
 // ============================================
 // CONSTRUCTOR
 // ============================================
 
-SRIXTool::SRIXTool(bool headless_mode) {
-    LOG_INFO("SRIX", "Initializing SRIX Tool (headless mode: %d)", headless_mode);
+SRIXTool::SRIXTool(bool headless_mode, const NFCReaderConfig& reader, NFCIrq* irq) : _irq(irq) {
+    LOG_INFO("SRIX", "Initializing SRIX Tool (reader %d, headless mode: %d)", reader.id, headless_mode);
     
     // Initialize state flags
     _dump_valid_from_read = false;
@@ -26,24 +28,31 @@ SRIXTool::SRIXTool(bool headless_mode) {
     memset(_uid, 0, sizeof(_uid));
     
     // Initialize I2C
-    LOG_DEBUG("SRIX", "I2C configuration: SDA=%d, SCL=%d, Clock=%dHz", 
-             sda_pin, scl_pin, I2C_CLOCK_SPEED);
-    Wire.begin(sda_pin, scl_pin);
-    Wire.setClock(I2C_CLOCK_SPEED);
+    LOG_DEBUG("SRIX", "I2C configuration: SDA=%d, SCL=%d, Clock=%luHz", 
+             reader.sda, reader.scl, (unsigned long)reader.frequency);
+    reader.wire->begin(reader.sda, reader.scl);
+    reader.wire->setClock(reader.frequency);
     
     // Create PN532 instance based on hardware configuration
-    #if defined(PN532_IRQ) && defined(PN532_RF_REST)
-        LOG_INFO("SRIX", "Using hardware IRQ mode: IRQ=%d, RST=%d", PN532_IRQ, PN532_RF_REST);
-        nfc = new Arduino_PN532_SRIX(PN532_IRQ, PN532_RF_REST);
-    #else
+    _has_hardware_pins = reader.irq_pin != PN532_INVALID_PIN && reader.reset_pin != PN532_INVALID_PIN;
+    if (_has_hardware_pins) {
+        LOG_INFO("SRIX", "Using hardware IRQ mode: IRQ=%d, RST=%d", reader.irq_pin, reader.reset_pin);
+        nfc = new Arduino_PN532_SRIX(reader.irq_pin, reader.reset_pin, reader.wire);
+    } else {
         LOG_INFO("SRIX", "Using polling mode (no IRQ pin defined)");
-        nfc = new Arduino_PN532_SRIX(PN532_INVALID_PIN, PN532_INVALID_PIN);
-    #endif
+        nfc = new Arduino_PN532_SRIX(PN532_INVALID_PIN, PN532_INVALID_PIN, reader.wire);
+    }
     
     // Initialize PN532
     if (nfc) {
         LOG_DEBUG("SRIX", "PN532 object created, initializing...");
         
+        nfc->setFastMode(SRIX_FAST_TRANSPORT);
+        if (_irq && _irq->isEnabled()) {
+            nfc->setWaitHook(NFCIrq::waitHook, _irq);
+        }
+        LOG_INFO("SRIX", "I2C transport: %s", nfc->isFastMode() ? "fast" : "legacy");
+        
         if (nfc->init()) {
             LOG_DEBUG("SRIX", "PN532 init successful, configuring...");
             
@@ -84,33 +93,54 @@ bool SRIXTool::waitForTagHeadless(uint32_t timeout_ms) {
             return true;
         }
         
-        // Delay between attempts to prevent I2C bus saturation
-        delay(TAG_DETECT_DELAY_MS);
+        // Each attempt already sleeps on the IRQ for the PN532 RF timeout
+        if (!useIrqDetection()) {
+            // Delay between attempts to prevent I2C bus saturation
+            delay(TAG_DETECT_DELAY_MS);
+        }
     }
     
     LOG_WARN("SRIX", "Tag detection timeout after %lu ms", timeout_ms);
     return false;
 }
 
+bool SRIXTool::pollTagHeadless(uint8_t *uid_out) {
+    if (!nfc || !nfc->SRIX_initiate_select()) {
+        return false;
+    }
+    return !uid_out || nfc->SRIX_get_uid(uid_out);
+}
+
+bool SRIXTool::isTagPresentHeadless(const uint8_t *uid) {
+    if (!nfc) {
+        return false;
+    }
+    
+    uint8_t current[SRIX_UID_SIZE];
+    if (nfc->SRIX_get_uid(current) && memcmp(current, uid, SRIX_UID_SIZE) == 0) {
+        return true;
+    }
+    return pollTagHeadless(current) && memcmp(current, uid, SRIX_UID_SIZE) == 0;
+}
+
 // ============================================
 // READ OPERATIONS
 // ============================================
 
-String SRIXTool::read_tag_headless(int timeout_seconds) {
+int SRIXTool::read_tag_binary(uint32_t timeout_ms, uint8_t *dump_out, uint8_t *uid_out) {
     if (!nfc) {
         LOG_ERROR("SRIX", "Cannot read: NFC object is NULL");
-        return "";
+        return ERROR_NULL_NFC;
     }
     
-    LOG_INFO("SRIX", "Starting tag read (timeout: %d seconds)", timeout_seconds);
+    LOG_INFO("SRIX", "Starting tag read (timeout: %lu ms)", timeout_ms);
     
     uint32_t startTime = millis();
-    uint32_t timeout_ms = timeout_seconds * 1000UL;
     
     while ((millis() - startTime) < timeout_ms) {
         // Try to detect tag
         if (!nfc->SRIX_initiate_select()) {
-            delay(TAG_DETECT_DELAY_MS);
+            if (!useIrqDetection()) delay(TAG_DETECT_DELAY_MS);
             continue;
         }
         
@@ -125,23 +155,38 @@ String SRIXTool::read_tag_headless(int timeout_seconds) {
         
         LOG_DEBUG("SRIX", "UID read successful, reading blocks...");
         
-        // Read all blocks
-        uint8_t block[SRIX_BLOCK_SIZE];
+        // Read all blocks straight into the dump buffer
         bool read_success = true;
+        uint32_t blocks_start = millis();
+        
+        uint8_t b = 0;
         
-        for (uint8_t b = 0; b < SRIX_BLOCK_COUNT; b++) {
-            if (!nfc->SRIX_read_block(b, block)) {
+        // Fast path: batched reads, progress reported per batch
+        #if SRIX_BATCH_READ
+        while (b < SRIX_BLOCK_COUNT) {
+            uint8_t want = SRIX_BLOCK_COUNT - b;
+            if (want > READ_BATCH_BLOCKS) want = READ_BATCH_BLOCKS;
+            
+            uint8_t got = nfc->SRIX_read_blocks(b, want, &_dump[(uint16_t)b * SRIX_BLOCK_SIZE]);
+            b += got;
+            if (got) NFCProgress::block(NFCProgress::OP_READ, b, SRIX_BLOCK_COUNT);
+            
+            if (got < want) {
+                LOG_DEBUG("SRIX", "Batch read stopped at block %d, falling back to per-block", b);
+                break;
+            }
+        }
+        #endif
+        
+        // Fallback: per-block loop for whatever the batch did not cover
+        for (; b < SRIX_BLOCK_COUNT; b++) {
+            if (!nfc->SRIX_read_block(b, &_dump[(uint16_t)b * SRIX_BLOCK_SIZE])) {
                 LOG_WARN("SRIX", "Failed to read block %d", b);
+                NFCProgress::block(NFCProgress::OP_READ, b + 1, SRIX_BLOCK_COUNT, false);
                 read_success = false;
                 break;
             }
-            
-            // Copy block to dump buffer
-            const uint16_t offset = (uint16_t)b * SRIX_BLOCK_SIZE;
-            _dump[offset + 0] = block[0];
-            _dump[offset + 1] = block[1];
-            _dump[offset + 2] = block[2];
-            _dump[offset + 3] = block[3];
+            NFCProgress::block(NFCProgress::OP_READ, b + 1, SRIX_BLOCK_COUNT);
         }
         
         if (!read_success) {
@@ -154,41 +199,56 @@ String SRIXTool::read_tag_headless(int timeout_seconds) {
         _dump_valid_from_read = true;
         _dump_valid_from_load = false;
         
-        LOG_INFO("SRIX", "Tag read successful: %d blocks", SRIX_BLOCK_COUNT);
-        
-        // Build UID string (8 bytes with spaces)
-        String uid_str = "";
-        for (uint8_t i = 0; i < SRIX_UID_SIZE; i++) {
-            if (_uid[i] < HEX_PADDING_THRESHOLD) uid_str += "0";
-            uid_str += String(_uid[i], HEX);
-            if (i < SRIX_UID_SIZE - 1) uid_str += " ";
-        }
-        uid_str.toUpperCase();
-        
-        // Build data hex string (1024 hex chars = 512 bytes)
-        String dump_str = "";
-        dump_str.reserve(SRIX_TOTAL_SIZE * HEX_CHARS_PER_BYTE); // Pre-allocate memory
-        
-        for (uint16_t i = 0; i < SRIX_TOTAL_SIZE; i++) {
-            if (_dump[i] < HEX_PADDING_THRESHOLD) dump_str += "0";
-            dump_str += String(_dump[i], HEX);
-        }
-        dump_str.toUpperCase();
+        // Hand the raw bytes to the caller (no string encoding)
+        if (dump_out) memcpy(dump_out, _dump, SRIX_TOTAL_SIZE);
+        if (uid_out) memcpy(uid_out, _uid, SRIX_UID_SIZE);
         
-        // Build JSON response
-        String result = "{";
-        result += "\"uid\":\"" + uid_str + "\",";
-        result += "\"blocks\":" + String(SRIX_BLOCK_COUNT) + ",";
-        result += "\"size\":" + String(SRIX_TOTAL_SIZE) + ",";
-        result += "\"data\":\"" + dump_str + "\"";
-        result += "}";
-        
-        LOG_DEBUG("SRIX", "JSON response size: %d bytes", result.length());
-        return result;
+        uint32_t blocks_ms = millis() - blocks_start;
+        LOG_INFO("SRIX", "Tag read successful: %d blocks in %lu ms (%lu blocks/s, %s transport)", 
+                 SRIX_BLOCK_COUNT, millis() - startTime,
+                 blocks_ms ? (SRIX_BLOCK_COUNT * 1000UL) / blocks_ms : 0UL,
+                 nfc->isFastMode() ? "fast" : "legacy");
+        return SUCCESS;
+    }
+    
+    LOG_ERROR("SRIX", "Read timeout after %lu ms", timeout_ms);
+    return ERROR_TIMEOUT;
+}
+
+String SRIXTool::read_tag_headless(int timeout_seconds) {
+    if (read_tag_binary((uint32_t)timeout_seconds * 1000UL) != SUCCESS) {
+        return ""; // Timeout or hardware error
+    }
+    
+    // Build UID string (8 bytes with spaces)
+    String uid_str = "";
+    for (uint8_t i = 0; i < SRIX_UID_SIZE; i++) {
+        if (_uid[i] < HEX_PADDING_THRESHOLD) uid_str += "0";
+        uid_str += String(_uid[i], HEX);
+        if (i < SRIX_UID_SIZE - 1) uid_str += " ";
     }
+    uid_str.toUpperCase();
+    
+    // Build data hex string (1024 hex chars = 512 bytes)
+    String dump_str = "";
+    dump_str.reserve(SRIX_TOTAL_SIZE * HEX_CHARS_PER_BYTE); // Pre-allocate memory
     
-    LOG_ERROR("SRIX", "Read timeout after %d seconds", timeout_seconds);
-    return ""; // Timeout
+    for (uint16_t i = 0; i < SRIX_TOTAL_SIZE; i++) {
+        if (_dump[i] < HEX_PADDING_THRESHOLD) dump_str += "0";
+        dump_str += String(_dump[i], HEX);
+    }
+    dump_str.toUpperCase();
+    
+    // Build JSON response
+    String result = "{";
+    result += "\"uid\":\"" + uid_str + "\",";
+    result += "\"blocks\":" + String(SRIX_BLOCK_COUNT) + ",";
+    result += "\"size\":" + String(SRIX_TOTAL_SIZE) + ",";
+    result += "\"data\":\"" + dump_str + "\"";
+    result += "}";
+    
+    LOG_DEBUG("SRIX", "JSON response size: %d bytes", result.length());
+    return result;
 }
 
 // ============================================
@@ -196,6 +256,9 @@ String SRIXTool::read_tag_headless(int timeout_seconds) {
 // ============================================
 
 int SRIXTool::write_tag_headless(int timeout_seconds) {
+    // Zeroed up front: no early return leaves the previous write's stats
+    _write_stats = {};
+    
     if (!nfc) {
         LOG_ERROR("SRIX", "Cannot write: NFC object is NULL");
         return ERROR_NULL_NFC;
@@ -217,6 +280,60 @@ int SRIXTool::write_tag_headless(int timeout_seconds) {
     
     LOG_INFO("SRIX", "Tag detected, starting write operation...");
     
+    uint32_t start_ms = millis();
+    
+    #if SRIX_ADAPTIVE_WRITE
+    // Pre-read: one batched pass tells which blocks already match
+    uint8_t on_tag[SRIX_TOTAL_SIZE];
+    bool have_tag_copy = (nfc->SRIX_read_blocks(0, SRIX_BLOCK_COUNT, on_tag) == SRIX_BLOCK_COUNT);
+    if (!have_tag_copy) {
+        LOG_WARN("SRIX", "Pre-read incomplete, writing every block");
+        waitForTagHeadless(TAG_REDETECT_TIMEOUT_MS);
+    }
+    
+    for (uint8_t b = 0; b < SRIX_BLOCK_COUNT; b++) {
+        const uint8_t *block = &_dump[(uint16_t)b * SRIX_BLOCK_SIZE];
+        
+        if (have_tag_copy && memcmp(block, &on_tag[(uint16_t)b * SRIX_BLOCK_SIZE], SRIX_BLOCK_SIZE) == 0) {
+            _write_stats.skipped++;
+            NFCProgress::block(NFCProgress::OP_WRITE, b + 1, SRIX_BLOCK_COUNT);
+            continue;
+        }
+        
+        int result = writeBlockAdaptive(b, block);
+        
+        if (result == ERROR_WRITE_FAILED) {
+            LOG_ERROR("SRIX", "Write failed at block %d (written: %d)", b, _write_stats.written);
+            NFCProgress::block(NFCProgress::OP_WRITE, b + 1, SRIX_BLOCK_COUNT, false);
+            _write_stats.elapsed_ms = millis() - start_ms;
+            _write_stats.cycle_us = _write_cycle_us;
+            return ERROR_WRITE_FAILED;
+        }
+        
+        _write_stats.written++;
+        NFCProgress::block(NFCProgress::OP_WRITE, b + 1, SRIX_BLOCK_COUNT);
+        
+        if (result == SUCCESS_VERIFY_FAIL) {
+            // Counters and OTP blocks legitimately refuse some values
+            _write_stats.verify_failed++;
+        } else if (result == SUCCESS_VERIFY_SKIP) {
+            // Tag stopped answering: selected again before the next block
+            _write_stats.verify_skipped++;
+            if (!waitForTagHeadless(TAG_REDETECT_TIMEOUT_MS)) {
+                LOG_WARN("SRIX", "Tag lost at block %d (may have completed successfully)", b);
+                _write_stats.elapsed_ms = millis() - start_ms;
+                _write_stats.cycle_us = _write_cycle_us;
+                return _write_stats.written;
+            }
+        }
+    }
+    
+    _write_stats.elapsed_ms = millis() - start_ms;
+    _write_stats.cycle_us = _write_cycle_us;
+    LOG_INFO("SRIX", "Write complete in %lu ms: %d written, %d unchanged, %d verify mismatch, cycle %lu us",
+             _write_stats.elapsed_ms, _write_stats.written, _write_stats.skipped,
+             _write_stats.verify_failed, _write_cycle_us);
+    #else
     uint8_t block[SRIX_BLOCK_SIZE];
     uint8_t blocks_written = 0;
     
@@ -234,10 +351,13 @@ int SRIXTool::write_tag_headless(int timeout_seconds) {
         if (!nfc->SRIX_write_block(b, block)) {
             LOG_ERROR("SRIX", "Write failed at block %d (written: %d/%d)", 
                      b, blocks_written, SRIX_BLOCK_COUNT);
+            _write_stats.written = blocks_written;
+            _write_stats.elapsed_ms = millis() - start_ms;
             return ERROR_WRITE_FAILED;
         }
         
         blocks_written++;
+        NFCProgress::block(NFCProgress::OP_WRITE, blocks_written, SRIX_BLOCK_COUNT);
         
         // Wait for EEPROM write cycle to complete
         delay(SRIX_EEPROM_WRITE_DELAY_MS);
@@ -250,16 +370,68 @@ int SRIXTool::write_tag_headless(int timeout_seconds) {
         // Wait for tag to be ready again (required by protocol)
         if (!waitForTagHeadless(TAG_REDETECT_TIMEOUT_MS)) {
             LOG_WARN("SRIX", "Tag lost at block %d (may have completed successfully)", b);
+            _write_stats.written = blocks_written;
+            _write_stats.elapsed_ms = millis() - start_ms;
             return blocks_written;
         }
     }
     
+    _write_stats.written = blocks_written;
+    _write_stats.elapsed_ms = millis() - start_ms;
     LOG_INFO("SRIX", "Write complete: %d/%d blocks written successfully", 
              blocks_written, SRIX_BLOCK_COUNT);
+    #endif
     
     return SUCCESS; // All blocks written
 }
 
+int SRIXTool::writeBlockAdaptive(uint8_t block_num, const uint8_t *block_data) {
+    if (!nfc->SRIX_write_block(block_num, (uint8_t *)block_data)) {
+        return ERROR_WRITE_FAILED;
+    }
+    
+    uint32_t written_us = micros();
+    uint32_t wait_us = _write_cycle_us;
+    bool answered = false;
+    uint8_t attempts = 0;
+    uint8_t readback[SRIX_BLOCK_SIZE];
+    
+    // The read-back both ends the EEPROM cycle wait and verifies the block
+    while (true) {
+        delayMicroseconds(wait_us);
+        attempts++;
+        
+        if (nfc->SRIX_read_block(block_num, readback)) {
+            answered = true;
+            if (memcmp(readback, block_data, SRIX_BLOCK_SIZE) == 0) {
+                break;
+            }
+        } else {
+            // Busy programming, or deselected: select again for the next poll
+            nfc->SRIX_initiate_select();
+        }
+        
+        if ((micros() - written_us) >= SRIX_EEPROM_WRITE_TIMEOUT_MS * 1000UL) {
+            LOG_DEBUG("SRIX", "Block %d read-back %s after %d polls", block_num,
+                     answered ? "mismatch" : "timeout", attempts);
+            return answered ? SUCCESS_VERIFY_FAIL : SUCCESS_VERIFY_SKIP;
+        }
+        wait_us = WRITE_POLL_INTERVAL_US;
+    }
+    
+    // Learn: probe lower after a first-try hit, jump to what it took otherwise
+    uint32_t took_us = micros() - written_us;
+    if (attempts == 1) {
+        _write_cycle_us -= _write_cycle_us / 8;
+        if (_write_cycle_us < WRITE_CYCLE_MIN_US) _write_cycle_us = WRITE_CYCLE_MIN_US;
+    } else {
+        _write_cycle_us = took_us;
+    }
+    
+    LOG_DEBUG("SRIX", "Block %d verified in %lu us (%d polls)", block_num, took_us, attempts);
+    return SUCCESS;
+}
+
 int SRIXTool::write_single_block_headless(uint8_t block_num, const uint8_t *block_data) {
     // Validate NFC object
     if (!nfc) {
@@ -291,6 +463,17 @@ int SRIXTool::write_single_block_headless(uint8_t block_num, const uint8_t *bloc
     
     LOG_DEBUG("SRIX", "Tag ready, sending write command...");
     
+    #if SRIX_ADAPTIVE_WRITE
+    int result = writeBlockAdaptive(block_num, block_data);
+    if (result == ERROR_WRITE_FAILED) {
+        LOG_ERROR("SRIX", "Write command failed");
+    } else if (result == SUCCESS) {
+        LOG_INFO("SRIX", "Write verified successfully");
+    } else {
+        LOG_WARN("SRIX", "Write sent, read-back %s", result == SUCCESS_VERIFY_FAIL ? "mismatch" : "unavailable");
+    }
+    return result;
+    #else
     // Write block
     if (nfc->SRIX_write_block(block_num, (uint8_t *)block_data)) {
         // Wait for hardware write to complete
@@ -336,6 +519,7 @@ int SRIXTool::write_single_block_headless(uint8_t block_num, const uint8_t *bloc
         LOG_ERROR("SRIX", "Write command failed");
         return ERROR_WRITE_FAILED;
     }
+    #endif
 }
 
 // ============================================
@@ -343,6 +527,8 @@ int SRIXTool::write_single_block_headless(uint8_t block_num, const uint8_t *bloc
 // ============================================
 
 String SRIXTool::save_file_headless(String filename) {
+    METRIC_SCOPE(METRIC_FS_SAVE);
+
     // Check if dump is valid
     if (!_dump_valid_from_read && !_dump_valid_from_load) {
         LOG_ERROR("SRIX", "Cannot save: No valid dump in memory");
@@ -370,25 +556,31 @@ String SRIXTool::save_file_headless(String filename) {
         }
     }
     
-    // Build filepath
+    // Build filepath (.nfcb selects the binary container)
+    bool binary = NFCDumpFile::isBinaryName(filename);
+    String ext = binary ? NFCDumpFile::EXTENSION : ".srix";
     String filepath = NFC_SRIX_DUMP_FOLDER + filename;
-    if (!filename.endsWith(".srix")) {
-        filepath += ".srix";
+    if (!filename.endsWith(ext)) {
+        filepath += ext;
     }
     
     // Handle existing file (append number suffix)
     if (LittleFS.exists(filepath)) {
         int i = 1;
-        String base = filepath.substring(0, filepath.length() - SRIX_FILE_EXTENSION_LEN);
+        String base = filepath.substring(0, filepath.length() - ext.length());
         
-        while (LittleFS.exists(base + "_" + String(i) + ".srix")) {
+        while (LittleFS.exists(base + "_" + String(i) + ext)) {
             i++;
         }
         
-        filepath = base + "_" + String(i) + ".srix";
+        filepath = base + "_" + String(i) + ext;
         LOG_INFO("SRIX", "File exists, using: %s", filepath.c_str());
     }
     
+    if (binary) {
+        return saveBinaryFile(filepath) ? filepath : "";
+    }
+    
     // Open file for writing
     File file = LittleFS.open(filepath, FILE_WRITE);
     if (!file) {
@@ -438,6 +630,8 @@ String SRIXTool::save_file_headless(String filename) {
 }
 
 int SRIXTool::load_file_headless(String filename) {
+    METRIC_SCOPE(METRIC_FS_LOAD);
+
     if (!nfc) {
         LOG_ERROR("SRIX", "Cannot load: NFC object is NULL");
         return ERROR_TIMEOUT;
@@ -447,7 +641,7 @@ int SRIXTool::load_file_headless(String filename) {
     
     // Build filepath
     String filepath = NFC_SRIX_DUMP_FOLDER + filename;
-    if (!filename.endsWith(".srix")) {
+    if (!filename.endsWith(".srix") && !NFCDumpFile::isBinaryName(filename)) {
         filepath += ".srix";
     }
     
@@ -457,6 +651,10 @@ int SRIXTool::load_file_headless(String filename) {
         return ERROR_FILE_NOT_FOUND;
     }
     
+    if (NFCDumpFile::isBinaryName(filepath)) {
+        return loadBinaryFile(filepath);
+    }
+    
     // Open file
     File file = LittleFS.open(filepath, FILE_READ);
     if (!file) {
@@ -552,3 +750,55 @@ int SRIXTool::load_file_headless(String filename) {
     LOG_INFO("SRIX", "File loaded successfully: %d blocks", blocks_loaded);
     return SUCCESS;
 }
+
+// ============================================
+// BINARY FILE FORMAT (.nfcb)
+// ============================================
+
+bool SRIXTool::saveBinaryFile(const String& filepath) {
+    NFCDumpFile::Header header;
+    memset(&header, 0, sizeof(header));
+    
+    header.kind = NFCDumpFile::KIND_SRIX;
+    header.uid_len = SRIX_UID_SIZE;
+    header.block_size = SRIX_BLOCK_SIZE;
+    header.block_count = SRIX_BLOCK_COUNT;
+    header.blocks_read = SRIX_BLOCK_COUNT;
+    memcpy(header.uid, _uid, SRIX_UID_SIZE);
+    
+    if (!NFCDumpFile::write(filepath, header, _dump)) {
+        LOG_ERROR("SRIX", "Failed to write binary dump: %s", filepath.c_str());
+        return false;
+    }
+    
+    LOG_INFO("SRIX", "File saved successfully: %s (%d blocks, binary)", filepath.c_str(), SRIX_BLOCK_COUNT);
+    return true;
+}
+
+int SRIXTool::loadBinaryFile(const String& filepath) {
+    NFCDumpFile::Header header;
+    
+    // Read straight into the dump buffer: reject before touching it
+    if (!NFCDumpFile::readHeader(filepath, header)) {
+        return ERROR_INCOMPLETE_DUMP;
+    }
+    
+    if (header.kind != NFCDumpFile::KIND_SRIX || header.block_size != SRIX_BLOCK_SIZE ||
+        header.block_count != SRIX_BLOCK_COUNT || header.uid_len != SRIX_UID_SIZE) {
+        LOG_ERROR("SRIX", "Not an SRIX4K binary dump: %s (kind %d)", filepath.c_str(), header.kind);
+        return ERROR_INCOMPLETE_DUMP;
+    }
+    
+    if (!NFCDumpFile::read(filepath, header, _dump, sizeof(_dump))) {
+        memset(_dump, 0, sizeof(_dump));
+        return ERROR_INCOMPLETE_DUMP;
+    }
+    
+    memcpy(_uid, header.uid, SRIX_UID_SIZE);
+    
+    _dump_valid_from_load = true;
+    _dump_valid_from_read = false;
+    
+    LOG_INFO("SRIX", "File loaded successfully: %d blocks (binary)", SRIX_BLOCK_COUNT);
+    return SUCCESS;
+}
@@ -14,6 +14,9 @@
 #include <Wire.h>
 #include "config.h"
 #include "logger.h"
+#include "nfc_irq.h"
+#include "nfc_reader.h"
+#include "nfc_dump_file.h"
 
 /**
  * @brief SRIX (ISO 15693) NFC Tag Reader/Writer Tool
@@ -29,20 +32,25 @@
  * - Uses Arduino_PN532_SRIX library for low-level operations
  * - RAM-based dump buffer (512 bytes)
  * - Validates dump origin (read vs. loaded)
- * - I2C communication at 100kHz
+ * - I2C communication at I2C_FREQUENCY (100kHz, 400kHz with I2C_FAST_PROFILE)
+ * - Fast transport (SRIX_FAST_TRANSPORT): bulk reads, IRQ-driven ready wait
+ * - Adaptive writes (SRIX_ADAPTIVE_WRITE): blocks already on the tag are
+ *   skipped, each write is completed by polling a read-back of the block
+ *   (which is also its verify), starting at a learned EEPROM cycle time
  * 
  * Supported Tags:
  * - SRIX4K (512 bytes, 128 blocks)
  * - SRIX512 (64 bytes, 16 blocks) - partial support
  * 
  * Hardware Support:
- * - IRQ mode (if PN532_IRQ and PN532_RF_REST defined)
+ * - IRQ mode (if the reader has IRQ and reset pins)
  * - Polling mode (fallback if no hardware pins)
+ * - Any bus/pin set (NFCReaderConfig), one tool per reader
  * 
  * Usage:
  * @code
  * SRIXTool srix(true);  // Headless mode
- * String json = srix.read_tag_headless(10);  // Read with 10s timeout
+ * srix.read_tag_binary(10000);  // Read with 10s timeout
  * srix.save_file_headless("dump.srix");
  * @endcode
  */
@@ -60,19 +68,23 @@ public:
     static constexpr uint8_t SRIX_MAX_BLOCK_NUM = 127;     // Maximum block number (0-127)
     
     // I2C configuration
-    static constexpr uint32_t I2C_CLOCK_SPEED = 100000;    // 100kHz
+    static constexpr uint32_t I2C_CLOCK_SPEED = I2C_FREQUENCY; // From config.h (100kHz, 400kHz fast profile)
     
     // PN532 configuration
     static constexpr uint8_t PN532_INVALID_PIN = 255;      // Invalid pin marker
     static constexpr uint8_t PN532_MAX_RETRIES = 0xFF;     // Passive activation retries
     
     // Timing constants
+    static constexpr uint8_t READ_BATCH_BLOCKS = 16;            // Blocks per SRIX_read_blocks() call
     static constexpr uint32_t TAG_DETECT_DELAY_MS = 50;         // Delay between detection attempts
     static constexpr uint32_t TAG_DETECT_RETRY_DELAY_MS = 100;  // Delay after failed UID read
     static constexpr uint32_t TAG_REDETECT_TIMEOUT_MS = 600;    // Tag re-detection timeout
     static constexpr uint32_t SINGLE_BLOCK_TIMEOUT_MS = 2500;   // Single block write timeout
     static constexpr uint32_t VERIFY_DELAY_MS = 10;             // Delay before verify
     static constexpr uint32_t VERIFY_READ_DELAY_MS = 5;         // Delay after verify read
+    static constexpr uint32_t WRITE_CYCLE_INITIAL_US = 5000;    // First read-back delay (datasheet typ. Tw)
+    static constexpr uint32_t WRITE_CYCLE_MIN_US = 1000;        // Floor for the learned cycle time
+    static constexpr uint32_t WRITE_POLL_INTERVAL_US = 1000;    // Read-back retry interval
     
     // File format constants
     static constexpr size_t SRIX_FILE_EXTENSION_LEN = 5;   // Length of ".srix"
@@ -101,11 +113,14 @@ public:
     /**
      * @brief Construct SRIX tool in headless mode
      * @param headless_mode If true, no UI/loop (for server integration)
+     * @param reader Bus and pins of the PN532 (default: reader 0)
+     * @param irq IRQ waiter of that reader (nullptr: status byte polling)
      * 
      * Initializes I2C, creates PN532 object, configures passive activation.
-     * Uses hardware IRQ/RST pins if defined, otherwise polling mode.
+     * Uses hardware IRQ/RST pins if the reader has them, otherwise polling mode.
      */
-    SRIXTool(bool headless_mode);
+    SRIXTool(bool headless_mode, const NFCReaderConfig& reader = NFCReaderConfig::forIndex(0),
+             NFCIrq* irq = nullptr);
     
     /**
      * @brief Get pointer to PN532 NFC object
@@ -123,6 +138,20 @@ public:
         _dump_valid_from_read = false;
     }
     
+    /**
+     * @brief Read tag into the internal dump buffer (binary, no encoding)
+     * @param timeout_ms Maximum time to wait for tag (milliseconds)
+     * @param dump_out Optional 512-byte buffer that receives a copy of the dump
+     * @param uid_out Optional 8-byte buffer that receives a copy of the UID
+     * @return SUCCESS (0), ERROR_TIMEOUT (-1) or ERROR_NULL_NFC (-6)
+     * 
+     * Preferred read path for NFCManager: avoids building and parsing
+     * a hex/JSON string for every read. Blocks are fetched in batches of
+     * READ_BATCH_BLOCKS via SRIX_read_blocks(); a short batch falls back
+     * to per-block reads from the failed block onward.
+     */
+    int read_tag_binary(uint32_t timeout_ms, uint8_t *dump_out = nullptr, uint8_t *uid_out = nullptr);
+    
     /**
      * @brief Read tag and return JSON with UID and data
      * @param timeout_seconds Maximum time to wait for tag (seconds)
@@ -130,9 +159,22 @@ public:
      * 
      * Blocks until tag detected or timeout.
      * Reads all 128 blocks and returns as hex string.
+     * Thin wrapper around read_tag_binary() kept for text interfaces.
      */
     String read_tag_headless(int timeout_seconds);
     
+    /**
+     * @brief Statistics of the last write_tag_headless() call
+     */
+    struct WriteStats {
+        uint8_t written;            ///< Blocks written
+        uint8_t skipped;            ///< Blocks already matching on tag
+        uint8_t verify_failed;      ///< Read-back never matched (e.g. counters)
+        uint8_t verify_skipped;     ///< No read-back answer, tag re-detected
+        uint32_t elapsed_ms;        ///< Whole write, pre-read included
+        uint32_t cycle_us;          ///< Learned EEPROM cycle time at the end
+    };
+    
     /**
      * @brief Write loaded dump to tag
      * @param timeout_seconds Maximum time to wait for tag (seconds)
@@ -145,10 +187,18 @@ public:
      * - ERROR_WRITE_FAILED (-5): Write operation failed
      * - Positive: Number of blocks written if tag lost mid-write
      * 
-     * NOTE: Verify is removed as it's unreliable on SRIX protocol.
+     * Adaptive mode: the tag is pre-read in one batch, only differing
+     * blocks are written and each one is verified by its completion
+     * read-back (see getLastWriteStats()). Legacy mode: every block,
+     * fixed SRIX_EEPROM_WRITE_DELAY_MS, no verify.
      */
     int write_tag_headless(int timeout_seconds);
     
+    /**
+     * @brief Stats of the last full write
+     */
+    const WriteStats& getLastWriteStats() const { return _write_stats; }
+    
     /**
      * @brief Save current dump to file
      * @param filename Output filename (without .srix extension)
@@ -156,7 +206,8 @@ public:
      * 
      * Creates directories if needed.
      * Appends "_N" suffix if file exists.
-     * Format: Flipper-compatible .srix dump format.
+     * Format: Flipper-compatible .srix dump format, or the binary
+     * container when filename ends with .nfcb.
      */
     String save_file_headless(String filename);
     
@@ -170,7 +221,7 @@ public:
      * - ERROR_FILE_NOT_FOUND (-2): File not found
      * - ERROR_INCOMPLETE_DUMP (-3): File has less than 128 blocks
      * 
-     * Parses Flipper-compatible .srix format.
+     * Parses Flipper-compatible .srix format (.nfcb: binary container).
      */
     int load_file_headless(String filename);
     
@@ -197,10 +248,38 @@ public:
      * @param timeout_ms Timeout in milliseconds
      * @return true if tag detected, false on timeout
      * 
-     * Polls tag at TAG_DETECT_DELAY_MS intervals.
+     * Polls tag at TAG_DETECT_DELAY_MS intervals. With IRQ detection
+     * (fast transport + NFCIrq) each attempt sleeps on the IRQ line for
+     * the PN532 RF timeout and the next attempt starts immediately.
      */
     bool waitForTagHeadless(uint32_t timeout_ms);
     
+    /**
+     * @brief One quiet detection attempt (no logging, no retry delay)
+     * @param uid_out Optional 8-byte buffer that receives the UID
+     * @return true if a tag was selected (and its UID read, if requested)
+     * 
+     * For polling loops that must not flood the log (batch scan).
+     */
+    bool pollTagHeadless(uint8_t *uid_out = nullptr);
+    
+    /**
+     * @brief Check if detection attempts block on the IRQ line
+     * 
+     * Fast transport and an enabled IRQ; otherwise callers pace their polls.
+     */
+    bool useIrqDetection() const { return nfc && nfc->isFastMode() && _irq && _irq->isEnabled(); }
+    
+    /**
+     * @brief Check if a given tag still answers
+     * @param uid 8-byte UID of the tag
+     * @return true if a tag with this UID is in the field
+     * 
+     * Asks the selected tag for its UID first, so a tag that stays
+     * selected after a read is still seen; falls back to a new select.
+     */
+    bool isTagPresentHeadless(const uint8_t *uid);
+    
     /**
      * @brief Get pointer to dump buffer
      * @return Pointer to 512-byte dump array
@@ -225,13 +304,9 @@ private:
     // ============================================
     
     // Hardware configuration
-    #if defined(PN532_IRQ) && defined(PN532_RF_REST)
-        Arduino_PN532_SRIX *nfc;      // PN532 instance (IRQ mode)
-        bool _has_hardware_pins = true;
-    #else
-        Arduino_PN532_SRIX *nfc;      // PN532 instance (polling mode)
-        bool _has_hardware_pins = false;
-    #endif
+    Arduino_PN532_SRIX *nfc;                // PN532 instance (on the reader's bus)
+    NFCIrq *_irq;                           // Reader's IRQ waiter (nullptr = polling)
+    bool _has_hardware_pins = false;        // IRQ and reset pins wired
     
     // State flags
     bool _tag_read = false;                 // Tag has been read successfully
@@ -241,6 +316,39 @@ private:
     // Data buffers
     uint8_t _dump[SRIX_TOTAL_SIZE];         // RAM storage for 128 blocks (512 bytes)
     uint8_t _uid[SRIX_UID_SIZE];            // Tag UID (8 bytes)
+    
+    // Adaptive write state
+    uint32_t _write_cycle_us = WRITE_CYCLE_INITIAL_US;  // Learned write-to-read-back time
+    WriteStats _write_stats = {};
+    
+    /**
+     * @brief Write one block and wait for it by polling its read-back
+     * @param block_num Block number
+     * @param block_data 4 bytes to write
+     * @return SUCCESS (read back matches), SUCCESS_VERIFY_FAIL (read back
+     *         differs until timeout), SUCCESS_VERIFY_SKIP (no read-back
+     *         answer) or ERROR_WRITE_FAILED (write not acknowledged)
+     * 
+     * First read-back after the learned cycle time, then every
+     * WRITE_POLL_INTERVAL_US up to SRIX_EEPROM_WRITE_TIMEOUT_MS. The
+     * estimate shrinks after first-try hits and grows to the observed
+     * time otherwise.
+     */
+    int writeBlockAdaptive(uint8_t block_num, const uint8_t *block_data);
+    
+    /**
+     * @brief Write current dump as .nfcb container
+     * @param filepath Full path (already de-duplicated)
+     * @return true on success
+     */
+    bool saveBinaryFile(const String& filepath);
+    
+    /**
+     * @brief Load .nfcb container into the dump buffer
+     * @param filepath Full path
+     * @return SUCCESS or ERROR_INCOMPLETE_DUMP
+     */
+    int loadBinaryFile(const String& filepath);
 };
 
 /**
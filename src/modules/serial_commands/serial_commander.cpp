@@ -1,8 +1,12 @@
 #include "serial_commander.h"
 #include <LittleFS.h>
+#include "modules/rfid/mifare_key_cache.h"
+#include "modules/webserver/nfc_job_engine.h"
+#include "modules/boot/boot_profile.h"
+#include <stage_metrics.h>
 
 SerialCommander::SerialCommander(WiFiManager& wifi, NFCManager& nfc)
-    : _wifi(wifi), _nfc(nfc), _enabled(true) 
+    : _wifi(wifi), _nfc(nfc), _enabled(true), _jobs(nullptr), _frames(nfc)
 {
     LOG_DEBUG("CMD", "SerialCommander initialized");
 }
@@ -12,8 +16,18 @@ SerialCommander::SerialCommander(WiFiManager& wifi, NFCManager& nfc)
 // ============================================
 
 void SerialCommander::handleCommands() {
-    // Early exit if disabled or no data available
-    if (!_enabled || !Serial.available()) {
+    if (!_enabled) {
+        return;
+    }
+
+    // Binary frame mode owns the port until CMD_TEXT
+    if (_frames.isActive()) {
+        _frames.poll();
+        return;
+    }
+
+    // Early exit if no data available
+    if (!Serial.available()) {
         return;
     }
 
@@ -62,8 +76,17 @@ void SerialCommander::handleCommands() {
 // ============================================
 
 void SerialCommander::handleWifiCommands(const String& subcmd) {
+    bool status = subcmd.isEmpty() || subcmd == "status";
+
+    // The network boot task owns the WiFiManager until its stage ends
+    if (!status && !BootProfile::isDone(BootProfile::STAGE_WIFI)) {
+        LOG_WARN("CMD", "WiFi still starting, try again when the network is up");
+        Serial.println("WiFi boot in progress ('sys boot' for stages)");
+        return;
+    }
+
     // Status command (default if no subcommand)
-    if (subcmd.isEmpty() || subcmd == "status") {
+    if (status) {
         bool connected = (WiFi.status() == WL_CONNECTED);
         
         LOG_INFO("CMD", "WiFi status: %s", connected ? "CONNECTED" : "NOT CONNECTED");
@@ -178,6 +201,10 @@ void SerialCommander::handleNfcCommands(const String& cmd) {
     NFCManager::TagInfo data;
     NFCManager::Result result;
 
+    if (refuseWhileJobRunning(cmd)) {
+        return;
+    }
+
     // ========== READ SRIX TAG ==========
     if (cmd == "srix_read") {
         LOG_INFO("CMD", "Reading SRIX tag (timeout: %d ms)", NFC_READ_TIMEOUT_MS);
@@ -188,7 +215,7 @@ void SerialCommander::handleNfcCommands(const String& cmd) {
         if (result.success) {
             LOG_INFO("CMD", "SRIX tag read successfully");
             Serial.println("✅ SRIX tag read successfully");
-            Serial.println("Protocol: " + data.protocol_name);
+            Serial.println("Protocol: " + String(data.name()));
             Serial.println("UID: " + _nfc.uidToString(data.uid, data.uid_length));
             
             size_t dumpSize = _nfc.getTagDataSize(data);
@@ -232,7 +259,7 @@ void SerialCommander::handleNfcCommands(const String& cmd) {
     // ========== WRITE MIFARE TAG ==========
     if (cmd == "mifare_write") {
         LOG_INFO("CMD", "Writing Mifare Classic tag");
-        result = _nfc.writeMifare(_nfc.getCurrentTag(), DEFAULT_MIFARE_WRITE_TIMEOUT_SEC);
+        result = _nfc.writeMifare(_nfc.currentTag(), DEFAULT_MIFARE_WRITE_TIMEOUT_SEC);
         
         LOG_INFO("CMD", "Mifare write result: %s", result.message.c_str());
         Serial.println(result.message);
@@ -260,7 +287,7 @@ void SerialCommander::handleNfcCommands(const String& cmd) {
         }
 
         // Get current tag data and protocol
-        NFCManager::TagInfo currentTag = _nfc.getCurrentTag();
+        const NFCManager::TagInfo& currentTag = _nfc.currentTag();
         NFCManager::Protocol currentProto = _nfc.getCurrentProtocol();
         
         LOG_INFO("CMD", "Saving %s dump to '%s'", 
@@ -317,7 +344,7 @@ void SerialCommander::handleNfcCommands(const String& cmd) {
         if (filename.isEmpty()) {
             LOG_WARN("CMD", "Load command missing filename");
             Serial.println("❌ Usage: nfc load <filename.ext>");
-            Serial.println("Extensions: .srix (SRIX4K) | .mfc (Mifare Classic)");
+            Serial.println("Extensions: .srix (SRIX4K) | .mfc (Mifare Classic) | .nfcb (binary)");
             return;
         }
 
@@ -331,6 +358,7 @@ void SerialCommander::handleNfcCommands(const String& cmd) {
             Serial.println("Supported extensions:");
             Serial.println("  .srix - SRIX4K/SRIX512");
             Serial.println("  .mfc  - Mifare Classic");
+            Serial.println("  .nfcb - Binary dump (any protocol)");
             Serial.println("Example: nfc load my_tag.srix");
             return;
         }
@@ -427,12 +455,162 @@ void SerialCommander::handleNfcCommands(const String& cmd) {
         return;
     }
 
+    // ========== TEXT <-> BINARY DUMP CONVERSION ==========
+    if (cmd.startsWith("convert ")) {
+        String filename = cmd.substring(CMD_OFFSET_CONVERT);
+        filename.trim();
+        
+        result = _nfc.convertFile(filename);
+        
+        if (result.success) {
+            LOG_INFO("CMD", "Convert successful: %s", result.message.c_str());
+            Serial.printf("✅ %s\n", result.message.c_str());
+        } else {
+            LOG_ERROR("CMD", "Convert failed: %s (code: %d)",
+                     result.message.c_str(), result.code);
+            Serial.printf("❌ %s (code: %d)\n", result.message.c_str(), result.code);
+        }
+        return;
+    }
+    
+    if (cmd == "convert") {
+        Serial.println("❌ Usage: nfc convert <file.ext>");
+        Serial.println("  .srix/.mfc -> .nfcb (import), .nfcb -> .srix/.mfc (export)");
+        return;
+    }
+
+    // ========== MIFARE KEY CACHE ==========
+    if (cmd == "keycache") {
+        Serial.printf("Mifare key cache: %u/%d records (%s)\n",
+                      (unsigned)MifareKeyCache::count(), MifareKeyCache::MAX_RECORDS,
+                      MifareKeyCache::CACHE_PATH);
+        return;
+    }
+    
+    if (cmd == "keycache clear") {
+        MifareKeyCache::clear();
+        Serial.println("✅ Mifare key cache cleared");
+        return;
+    }
+
+    // ========== DUMP CATALOG ==========
+    if (cmd == "catalog") {
+        Serial.printf("Dump catalog: %u records (%s)%s\n",
+                      (unsigned)NFCDumpCatalog::count(), NFC_CATALOG_FILE,
+                      NFCDumpCatalog::complete() ? "" : " - stale, listings scan folders");
+        return;
+    }
+    
+    if (cmd == "catalog rebuild") {
+        size_t indexed = _nfc.rebuildCatalog();
+        Serial.printf("✅ Dump catalog rebuilt: %u file(s)\n", (unsigned)indexed);
+        return;
+    }
+
+    // ========== BATCH SCAN ==========
+    if (cmd == "batch stop") {
+        if (!_nfc.isBatchRunning()) {
+            Serial.println("No batch scan running");
+            return;
+        }
+        _nfc.stopBatch();
+        Serial.println("Batch scan stopping...");
+        return;
+    }
+
+    if (cmd == "batch status") {
+        NFCManager::BatchStats stats = _nfc.batchStats();
+        Serial.printf("Batch scan: %s - %u tags, %u saved, %u duplicates, %u failed (%lu s)\n",
+                      _nfc.isBatchRunning() ? "running" : "idle",
+                      stats.tags, stats.saved, stats.duplicates, stats.failed,
+                      (unsigned long)(stats.elapsed_ms / 1000));
+        return;
+    }
+
+    if (cmd == "batch" || cmd.startsWith("batch ")) {
+        startBatch(cmd.substring(5));
+        return;
+    }
+
     // Unknown NFC command
     LOG_WARN("CMD", "Unknown NFC command: '%s'", cmd.c_str());
     Serial.println("❌ Unknown NFC command: " + cmd);
     Serial.println("Type 'help' for available commands");
 }
 
+bool SerialCommander::refuseWhileJobRunning(const String& cmd) {
+    // Status, key cache and batch control commands never touch the reader
+    bool direct = cmd == "srix_read" || cmd.startsWith("mifare_") ||
+                  cmd.startsWith("save ") || cmd.startsWith("load ") ||
+                  cmd.startsWith("wait") || cmd.startsWith("convert ") ||
+                  cmd == "catalog rebuild";
+    if (!direct || !_jobs || !_jobs->isBusy()) {
+        return false;
+    }
+
+    LOG_WARN("CMD", "NFC job running, refusing '%s'", cmd.c_str());
+    Serial.println("❌ NFC job running, retry later");
+    return true;
+}
+
+void SerialCommander::startBatch(const String& args) {
+    if (!_jobs) {
+        Serial.println("❌ Job engine not available");
+        return;
+    }
+    if (_nfc.isBatchRunning()) {
+        Serial.println("❌ Batch scan already running (nfc batch stop)");
+        return;
+    }
+
+    // Tokens: srix|mifare, "all" (no dedupe), "nfcb", a number = max tags
+    NFCJobEngine::JobRequest req;
+    req.type = NFCJobEngine::JOB_BATCH_SCAN;
+    req.timeout_sec = NFCManager::BATCH_READ_TIMEOUT_SEC;
+    req.batch.protocol = NFCManager::PROTOCOL_UNKNOWN;
+    req.batch.dedupe = true;
+    req.batch.binary = false;
+    req.batch.max_tags = 0;
+    req.batch.idle_timeout_ms = 0;
+
+    String rest = args;
+    rest.trim();
+    while (rest.length() > 0) {
+        int space = rest.indexOf(' ');
+        String token = space < 0 ? rest : rest.substring(0, space);
+        rest = space < 0 ? "" : rest.substring(space + 1);
+        rest.trim();
+
+        if (token == "srix") {
+            req.batch.protocol = NFCManager::PROTOCOL_SRIX;
+        } else if (token == "mifare") {
+            req.batch.protocol = NFCManager::PROTOCOL_MIFARE_CLASSIC;
+        } else if (token == "all") {
+            req.batch.dedupe = false;
+        } else if (token == "nfcb") {
+            req.batch.binary = true;
+        } else if (token.length() > 0 && isDigit(token[0])) {
+            req.batch.max_tags = token.toInt();
+        }
+    }
+
+    if (req.batch.protocol == NFCManager::PROTOCOL_UNKNOWN) {
+        Serial.println("❌ Usage: nfc batch <srix|mifare> [all] [nfcb] [max_tags]");
+        Serial.println("  all: save tags already in the catalog too, nfcb: binary dumps");
+        return;
+    }
+
+    uint32_t id = _jobs->submit(req);
+    if (id == NFCJobEngine::INVALID_JOB_ID) {
+        Serial.println("❌ Job queue full, try again later");
+        return;
+    }
+
+    LOG_INFO("CMD", "Batch scan job %u submitted", id);
+    Serial.printf("Batch scan running (job %u): present tags one after another\n", id);
+    Serial.println("Per-tag results are logged as [BATCH]; 'nfc batch stop' to finish");
+}
+
 // ============================================
 // SYSTEM COMMANDS
 // ============================================
@@ -449,6 +627,7 @@ void SerialCommander::handleSystemCommands(const String& subcmd) {
         Serial.printf("CPU Freq: %d MHz\n", ESP.getCpuFreqMHz());
         Serial.printf("Free Heap: %d bytes\n", ESP.getFreeHeap());
         Serial.printf("Flash Size: %d bytes\n", ESP.getFlashChipSize());
+        Serial.printf("Log Lines Dropped: %u\n", Logger::droppedCount());
         
         // LittleFS filesystem info
         Serial.println("\nLittleFS:");
@@ -496,6 +675,82 @@ void SerialCommander::handleSystemCommands(const String& subcmd) {
         uint32_t freeHeap = ESP.getFreeHeap();
         LOG_INFO("CMD", "Free heap: %d bytes", freeHeap);
         Serial.printf("Free Heap: %d bytes\n", freeHeap);
+        Serial.printf("Largest Block: %d bytes\n", ESP.getMaxAllocHeap());
+        Serial.printf("Minimum Free: %d bytes\n", ESP.getMinFreeHeap());
+        return;
+    }
+
+    // Stage timing histograms
+    if (subcmd == "metrics") {
+        if (!StageMetrics::enabled()) {
+            Serial.println("Metrics disabled (build with -DMETRICS_ENABLED=1)");
+            return;
+        }
+
+        Serial.println("\n========================================");
+        Serial.println("Stage Timings (us)");
+        Serial.println("========================================");
+        Serial.printf("%-18s %7s %8s %8s %8s %8s\n", "Stage", "Count", "Min", "p50", "p95", "Max");
+        for (uint8_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+            StageMetrics::Summary s;
+            StageMetrics::summarize((MetricStage)i, s);
+            Serial.printf("%-18s %7lu %8lu %8lu %8lu %8lu\n",
+                          StageMetrics::stageName((MetricStage)i),
+                          (unsigned long)s.count, (unsigned long)s.min_us,
+                          (unsigned long)s.p50_us, (unsigned long)s.p95_us,
+                          (unsigned long)s.max_us);
+        }
+        Serial.println("========================================\n");
+        return;
+    }
+
+    if (subcmd == "metrics reset") {
+        StageMetrics::reset();
+        LOG_INFO("CMD", "Stage metrics reset");
+        Serial.println("✅ Metrics cleared");
+        return;
+    }
+
+    // Boot stage timings
+    if (subcmd == "boot") {
+        Serial.println("\n========================================");
+        Serial.println("Boot Stages (ms since power-on)");
+        Serial.println("========================================");
+        Serial.printf("%-12s %8s %8s %5s\n", "Stage", "Start", "Time", "Core");
+        for (uint8_t i = 0; i < BootProfile::STAGE_COUNT; i++) {
+            BootProfile::Entry e;
+            if (!BootProfile::get((BootProfile::Stage)i, e)) {
+                continue;
+            }
+            if (e.done) {
+                Serial.printf("%-12s %8lu %8lu %5u\n", BootProfile::stageName((BootProfile::Stage)i),
+                              (unsigned long)e.start_ms, (unsigned long)(e.end_ms - e.start_ms), e.core);
+            } else {
+                Serial.printf("%-12s %8lu %8s %5u\n", BootProfile::stageName((BootProfile::Stage)i),
+                              (unsigned long)e.start_ms, "running", e.core);
+            }
+        }
+        Serial.println("========================================\n");
+        return;
+    }
+
+    // On-device benchmark (runs on the NFC worker)
+    if (subcmd == "bench" || subcmd.startsWith("bench ")) {
+        runBench(subcmd.substring(5));
+        return;
+    }
+
+    // Binary frame protocol for host tools
+    if (subcmd == "binary" || subcmd.startsWith("binary ")) {
+        long baud = subcmd.length() > 7 ? subcmd.substring(7).toInt() : 0;
+        if (baud < 0) {
+            Serial.println("❌ Invalid baud rate");
+            return;
+        }
+
+        Serial.println("Binary frame mode (send CMD_TEXT to leave)");
+        Serial.flush();
+        _frames.begin((uint32_t)baud);
         return;
     }
 
@@ -506,6 +761,108 @@ void SerialCommander::handleSystemCommands(const String& subcmd) {
     Serial.println("  system restart   - Restart ESP32");
     Serial.println("  system format    - Format LittleFS (WARNING!)");
     Serial.println("  system heap      - Show free heap");
+    Serial.println("  system metrics   - Show stage timings (metrics reset to clear)");
+    Serial.println("  system boot      - Show boot stage timings");
+    Serial.println("  system bench     - Benchmark [scenarios] [iterations] [write]");
+    Serial.println("  system binary    - Binary frame mode [baud]");
+}
+
+// ============================================
+// BENCHMARK
+// ============================================
+
+void SerialCommander::runBench(const String& args) {
+    if (!_jobs) {
+        Serial.println("❌ Job engine not available");
+        return;
+    }
+
+    // Tokens: a number is the iteration count, "write" allows write
+    // scenarios, everything else is a scenario or group name
+    NFCJobEngine::JobRequest req;
+    req.type = NFCJobEngine::JOB_BENCH;
+    req.timeout_sec = NFCBench::DEFAULT_TIMEOUT_SEC;
+    req.bench.iterations = NFCBench::DEFAULT_ITERATIONS;
+    req.bench.timeout_sec = NFCBench::DEFAULT_TIMEOUT_SEC;
+    req.bench.allow_write = false;
+
+    String list;
+    String rest = args;
+    rest.trim();
+    while (rest.length() > 0) {
+        int space = rest.indexOf(' ');
+        String token = space < 0 ? rest : rest.substring(0, space);
+        rest = space < 0 ? "" : rest.substring(space + 1);
+        rest.trim();
+
+        if (token == "write") {
+            req.bench.allow_write = true;
+        } else if (token.length() > 0 && isDigit(token[0])) {
+            req.bench.iterations = constrain(token.toInt(), 1, (int)NFCBench::MAX_ITERATIONS);
+        } else {
+            list += token;
+            list += ',';
+        }
+    }
+
+    if (list.isEmpty()) {
+        list = "storage";
+    }
+    if (!NFCBench::parseScenarios(list, req.bench.scenarios) || req.bench.scenarios == 0) {
+        Serial.printf("❌ Unknown scenario in '%s'\n", list.c_str());
+        Serial.println("Scenarios: all, storage, srix, mifare, or names (e.g. srix_read,backup)");
+        return;
+    }
+
+    uint32_t id = _jobs->submit(req);
+    if (id == NFCJobEngine::INVALID_JOB_ID) {
+        Serial.println("❌ Job queue full, try again later");
+        return;
+    }
+
+    LOG_INFO("CMD", "Benchmark job %u submitted (%u iterations)", id, req.bench.iterations);
+    Serial.printf("Benchmark running (job %u)...\n", id);
+
+    JsonDocument status;
+    String result;
+    for (;;) {
+        status.clear();
+        if (!_jobs->getJob(id, status, result)) {
+            Serial.println("❌ Benchmark job lost");
+            return;
+        }
+        if (status["state"] == "done") {
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(BENCH_POLL_MS));
+    }
+
+    JsonDocument report;
+    if (deserializeJson(report, result)) {
+        Serial.println("❌ Invalid benchmark report");
+        return;
+    }
+
+    Serial.println("\n========================================");
+    Serial.printf("Benchmark: %s\n", report["message"] | "");
+    Serial.println("========================================");
+    Serial.printf("%-22s %4s %9s %9s %9s %9s\n", "Scenario", "OK", "ops/s", "p50 us", "p95 us", "Max us");
+    for (JsonObject r : report["results"].as<JsonArray>()) {
+        if (r["skipped"].is<const char*>()) {
+            Serial.printf("%-22s skipped: %s\n", r["name"] | "", r["skipped"] | "");
+            continue;
+        }
+        Serial.printf("%-22s %4u %9.1f %9lu %9lu %9lu\n",
+                      r["name"] | "", (unsigned)(r["ok"] | 0), r["ops_per_sec"] | 0.0f,
+                      (unsigned long)(r["p50_us"] | 0UL), (unsigned long)(r["p95_us"] | 0UL),
+                      (unsigned long)(r["max_us"] | 0UL));
+    }
+    Serial.println("========================================");
+
+    // Raw report on one line for scripts
+    Serial.print("BENCH ");
+    Serial.println(result);
+    Serial.println();
 }
 
 // ============================================
@@ -534,13 +891,21 @@ void SerialCommander::showHelp() {
     Serial.println("  nfc mifare_write     - Write Mifare tag");
     Serial.println("  nfc save <file>      - Save dump to file");
     Serial.println("  nfc load <file.ext>  - Load dump from file");
+    Serial.println("  nfc convert <file>   - Convert dump text <-> .nfcb");
     Serial.println("  nfc wait [seconds]   - Wait for tag");
+    Serial.println("  nfc keycache [clear] - Show/clear Mifare key cache");
+    Serial.println("  nfc catalog [rebuild]- Show/rebuild dump catalog");
+    Serial.println("  nfc batch <srix|mifare> [all] [nfcb] [n] - Batch scan (stop/status)");
     
     Serial.println("\nSystem Commands:");
     Serial.println("  system info          - System information");
     Serial.println("  system restart       - Restart ESP32");
     Serial.println("  system format        - Format filesystem");
     Serial.println("  system heap          - Show free heap");
+    Serial.println("  system metrics [reset] - Stage timing histograms");
+    Serial.println("  system boot          - Boot stage timings");
+    Serial.println("  system bench [scen] [n] [write] - Benchmarks (storage default)");
+    Serial.println("  system binary [baud] - Binary frame mode (host tools)");
     
     Serial.println("\nGeneral:");
     Serial.println("  clear                - Clear terminal");
@@ -563,6 +928,11 @@ NFCManager::Protocol SerialCommander::detectProtocolFromExtension(const String&
         filenameWithoutExt = filename.substring(0, filename.length() - EXT_LEN_MFC);
         return NFCManager::PROTOCOL_MIFARE_CLASSIC;
     }
+    else if (NFCDumpFile::isBinaryName(filename)) {
+        // Binary container: protocol comes from the file header
+        filenameWithoutExt = filename;
+        return _nfc.detectFileProtocol(filename);
+    }
     else {
         // Unknown or missing extension
         filenameWithoutExt = filename;
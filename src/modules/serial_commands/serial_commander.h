@@ -3,9 +3,12 @@
 #include <Arduino.h>
 #include "modules/wifi/wifi_manager.h"
 #include "modules/rfid/nfc_manager.h"
+#include "serial_frame_protocol.h"
 #include "config.h"
 #include "logger.h"
 
+class NFCJobEngine;
+
 /**
  * @brief Command-line interface handler for serial communication
  * 
@@ -20,6 +23,8 @@
  * 
  * Implementation Notes:
  * - Commands are case-insensitive
+ * - "sys binary [baud]" switches to SerialFrameProtocol (COBS/CRC frames)
+ *   until the host sends CMD_TEXT
  * - Can be temporarily disabled during long operations (e.g., WiFi scan)
  * - Uses references to WiFiManager and NFCManager (not owned)
  */
@@ -63,6 +68,24 @@ public:
      */
     bool isEnabled() const { return _enabled; }
 
+    /**
+     * @brief Attach the NFC job engine (needed by "system bench")
+     * @param jobs Job engine, nullptr to detach
+     *
+     * Benchmarks run on the NFC worker: this task's 4KB stack is too
+     * small to run them inline.
+     */
+    void setJobEngine(NFCJobEngine* jobs) { _jobs = jobs; _frames.setJobEngine(jobs); }
+
+    /**
+     * @brief Delay between handleCommands() calls
+     * @return Short interval in binary frame mode (job events, throughput),
+     *         TEXT_POLL_INTERVAL_MS otherwise
+     */
+    uint32_t pollIntervalMs() const {
+        return _frames.isActive() ? BINARY_POLL_INTERVAL_MS : TEXT_POLL_INTERVAL_MS;
+    }
+
 private:
     // ============================================
     // CONSTANTS
@@ -73,6 +96,7 @@ private:
     static constexpr size_t CMD_OFFSET_LOAD = 5;      // Length of "load "
     static constexpr size_t CMD_OFFSET_WAIT = 5;      // Length of "wait "
     static constexpr size_t CMD_OFFSET_ADD = 4;       // Length of "add "
+    static constexpr size_t CMD_OFFSET_CONVERT = 8;   // Length of "convert "
     
     // File extension lengths
     static constexpr size_t EXT_LEN_SRIX = 5;         // ".srix"
@@ -88,6 +112,9 @@ private:
     static constexpr uint32_t DEFAULT_MIFARE_READ_TIMEOUT_SEC = 10;  // 10 seconds
     static constexpr uint32_t DEFAULT_MIFARE_UID_TIMEOUT_SEC = 5;    // 5 seconds
     static constexpr uint32_t DEFAULT_MIFARE_WRITE_TIMEOUT_SEC = 20; // 20 seconds
+    static constexpr uint32_t BENCH_POLL_MS = 250;                   // Job status poll interval
+    static constexpr uint32_t TEXT_POLL_INTERVAL_MS = 50;            // Serial task delay (text)
+    static constexpr uint32_t BINARY_POLL_INTERVAL_MS = 2;           // Serial task delay (frames)
     
     // System operation delays
     static constexpr uint32_t RESTART_DELAY_MS = 2000;     // 2 second countdown
@@ -104,6 +131,8 @@ private:
     WiFiManager& _wifi;      // Reference to WiFi manager
     NFCManager& _nfc;        // Reference to NFC manager
     bool _enabled;           // Command processing enabled flag
+    NFCJobEngine* _jobs;     // NFC job engine (not owned, may be nullptr)
+    SerialFrameProtocol _frames;  // Binary frame mode ("sys binary")
 
     // ============================================
     // COMMAND HANDLERS
@@ -135,9 +164,30 @@ private:
      * - save <filename>: Save tag data to file
      * - load <filename.ext>: Load tag data from file
      * - wait [seconds]: Wait for SRIX tag detection
+     * - batch <srix|mifare> [all] [nfcb] [n] / batch stop / batch status
      */
     void handleNfcCommands(const String& subcmd);
 
+    /**
+     * @brief Refuse an NFC command that shares the reader or dump with jobs
+     * @param cmd NFC subcommand
+     * @return true if the command must not run now (message already printed)
+     *
+     * Reads, writes, load/save, wait, convert and catalog rebuild call
+     * NFCManager directly; like the web handlers they wait for the job
+     * engine to go idle.
+     */
+    bool refuseWhileJobRunning(const String& cmd);
+
+    /**
+     * @brief Submit a batch scan job ("nfc batch <srix|mifare> [all] [nfcb] [n]")
+     * @param args Protocol, "all" (no dedupe), "nfcb", max tag count
+     *
+     * Returns once queued: per-tag results arrive as [BATCH] log lines,
+     * "nfc batch stop" ends the run.
+     */
+    void startBatch(const String& args);
+
     /**
      * @brief Handle system-related commands
      * @param subcmd Subcommand and arguments
@@ -147,9 +197,22 @@ private:
      * - restart/reboot: Restart ESP32
      * - format: Format LittleFS (requires confirmation)
      * - heap: Show free heap memory
+     * - metrics [reset]: Show/clear stage timing histograms
+     * - boot: Show boot stage timings
+     * - bench [scenarios] [iterations] [write]: Run benchmark job
+     * - binary [baud]: Switch to binary frame mode
      */
     void handleSystemCommands(const String& subcmd);
 
+    /**
+     * @brief Submit a benchmark job, wait for it and print the report
+     * @param args Scenario names/groups, iteration count, "write"
+     *
+     * Prints a summary table followed by one "BENCH {...}" line holding
+     * the raw JSON report, for scripts capturing the serial output.
+     */
+    void runBench(const String& args);
+
     /**
      * @brief Display command reference
      * 
@@ -166,6 +229,7 @@ private:
      * @brief Detect NFC protocol from file extension
      * @param filename Filename with extension (e.g., "tag.srix")
      * @param[out] filenameWithoutExt Filename with extension removed
+     *             (.nfcb names keep their extension: the tools key on it)
      * @return Detected protocol or PROTOCOL_UNKNOWN
      */
     NFCManager::Protocol detectProtocolFromExtension(
@@ -0,0 +1,389 @@
+#include "serial_frame_protocol.h"
+#include "modules/webserver/nfc_job_engine.h"
+#include <esp_rom_crc.h>
+
+SerialFrameProtocol::SerialFrameProtocol(NFCManager& nfc)
+    : _nfc(nfc), _jobs(nullptr), _active(false), _rx_len(0), _rx_overflow(false), _tx_lock(nullptr)
+{
+    memset(_pending, 0, sizeof(_pending));
+}
+
+// ============================================
+// MODE SWITCH
+// ============================================
+
+void SerialFrameProtocol::begin(uint32_t baud) {
+    if (!_tx_lock) {
+        _tx_lock = xSemaphoreCreateMutexStatic(&_tx_lock_buffer);
+    }
+
+    LOG_INFO("FRAME", "Binary framed mode on (%lu baud)", (unsigned long)(baud ? baud : SERIAL_BAUD_RATE));
+    Logger::flush();
+
+    if (baud) {
+        Serial.flush();
+        Serial.updateBaudRate(baud);
+    }
+
+    _rx_len = 0;
+    _rx_overflow = false;
+    _active = true;
+    Logger::setSerialSink(onLogLine, this);
+}
+
+void SerialFrameProtocol::end() {
+    Logger::flush();
+    Logger::setSerialSink(nullptr, nullptr);
+    _active = false;
+    memset(_pending, 0, sizeof(_pending));
+
+    Serial.flush();
+    Serial.updateBaudRate(SERIAL_BAUD_RATE);
+    LOG_INFO("FRAME", "Back to text commands");
+}
+
+// ============================================
+// RECEIVE
+// ============================================
+
+void SerialFrameProtocol::poll() {
+    size_t budget = RX_BYTES_PER_POLL;
+
+    while (_active && budget-- > 0 && Serial.available()) {
+        uint8_t byte = Serial.read();
+
+        if (byte != 0x00) {
+            if (_rx_len < sizeof(_rx)) {
+                _rx[_rx_len++] = byte;
+            } else {
+                _rx_overflow = true;
+            }
+            continue;
+        }
+
+        // Delimiter: one complete frame (or nothing between two delimiters)
+        size_t encoded = _rx_len;
+        bool overflow = _rx_overflow;
+        _rx_len = 0;
+        _rx_overflow = false;
+
+        if (encoded == 0) {
+            continue;
+        }
+        if (overflow) {
+            LOG_WARN("FRAME", "Frame too long, dropped");
+            continue;
+        }
+
+        size_t len = cobsDecode(_rx, encoded);
+        if (len < HEADER_SIZE + CRC_SIZE) {
+            LOG_WARN("FRAME", "Malformed frame (%u bytes)", (unsigned)encoded);
+            continue;
+        }
+
+        size_t body = len - CRC_SIZE;
+        uint32_t crc = _rx[body] | (_rx[body + 1] << 8) | (_rx[body + 2] << 16) | ((uint32_t)_rx[body + 3] << 24);
+        if (esp_rom_crc32_le(0, _rx, body) != crc) {
+            LOG_WARN("FRAME", "CRC mismatch, frame dropped");
+            continue;
+        }
+
+        handleFrame(_rx[0], _rx[1], _rx + HEADER_SIZE, body - HEADER_SIZE);
+    }
+
+    if (_active) {
+        pollJobs();
+    }
+}
+
+// ============================================
+// COMMAND HANDLERS
+// ============================================
+
+void SerialFrameProtocol::handleFrame(uint8_t type, uint8_t seq, const uint8_t* data, size_t len) {
+    LOG_DEBUG("FRAME", "Command 0x%02X seq %u (%u bytes)", type, seq, (unsigned)len);
+
+    switch (type) {
+        case CMD_PING:
+            payload()[0] = PROTOCOL_VERSION;
+            put16(payload() + 1, MAX_PAYLOAD);
+            send(RSP_OK, seq, 3);
+            break;
+
+        case CMD_JOB:
+            handleJob(seq, data, len);
+            break;
+
+        case CMD_LOAD:
+        case CMD_SAVE: {
+            String filename;
+            filename.reserve(len);
+            for (size_t i = 0; i < len; i++) filename += (char)data[i];
+            filename.trim();
+
+            if (filename.isEmpty()) {
+                sendError(seq, ERR_BAD_PAYLOAD, "Missing filename");
+            } else if (type == CMD_LOAD) {
+                handleLoad(seq, filename);
+            } else {
+                handleSave(seq, filename);
+            }
+            break;
+        }
+
+        case CMD_DUMP:
+            handleDump(seq);
+            break;
+
+        case CMD_TEXT:
+            sendOk(seq);
+            end();
+            break;
+
+        default:
+            sendError(seq, ERR_UNKNOWN_COMMAND, "Unknown command");
+            break;
+    }
+}
+
+void SerialFrameProtocol::handleJob(uint8_t seq, const uint8_t* data, size_t len) {
+    if (!_jobs) {
+        sendError(seq, ERR_NO_ENGINE, "Job engine not available");
+        return;
+    }
+
+    // Benchmarks and batch scans take options: text commands or web API
+    if (len < 2 || data[0] >= NFCJobEngine::JOB_TYPE_COUNT ||
+        data[0] == NFCJobEngine::JOB_BENCH || data[0] == NFCJobEngine::JOB_BATCH_SCAN) {
+        sendError(seq, ERR_BAD_PAYLOAD, "Unsupported job type");
+        return;
+    }
+
+    PendingJob* slot = nullptr;
+    for (uint8_t i = 0; i < MAX_PENDING_JOBS && !slot; i++) {
+        if (_pending[i].id == 0) slot = &_pending[i];
+    }
+    if (!slot) {
+        sendError(seq, ERR_QUEUE_FULL, "Too many pending jobs");
+        return;
+    }
+
+    NFCJobEngine::JobRequest req;
+    req.type = (NFCJobEngine::JobType)data[0];
+    req.timeout_sec = data[1] ? data[1] : NFCManager::DEFAULT_READ_TIMEOUT_SEC;
+
+    uint32_t id = _jobs->submit(req);
+    if (id == NFCJobEngine::INVALID_JOB_ID) {
+        sendError(seq, ERR_QUEUE_FULL, "NFC job queue full");
+        return;
+    }
+
+    slot->id = id;
+    slot->seq = seq;
+
+    LOG_INFO("FRAME", "Job %u (%s) queued", id, NFCJobEngine::typeToString(req.type));
+    put32(payload(), id);
+    send(RSP_ACCEPTED, seq, 4);
+}
+
+void SerialFrameProtocol::handleLoad(uint8_t seq, const String& filename) {
+    // Loading replaces the dump a running job reads or writes
+    if (_jobs && _jobs->isBusy()) {
+        sendError(seq, ERR_BUSY, "NFC job running");
+        return;
+    }
+
+    NFCManager::Result result = _nfc.load(filename, _nfc.detectFileProtocol(filename));
+    if (!result.success) {
+        sendError(seq, ERR_FAILED, result.message.c_str());
+        return;
+    }
+
+    const NFCManager::TagInfo& tag = _nfc.currentTag();
+    uint8_t* p = payload();
+    p[0] = tag.protocol;
+    p[1] = tag.uid_length;
+    memcpy(p + 2, tag.uid, tag.uid_length);
+    put16(p + 2 + tag.uid_length, tag.size);
+    send(RSP_OK, seq, 4 + tag.uid_length);
+}
+
+void SerialFrameProtocol::handleSave(uint8_t seq, const String& filename) {
+    if (_jobs && _jobs->isBusy()) {
+        sendError(seq, ERR_BUSY, "NFC job running");
+        return;
+    }
+
+    NFCManager::Result result = _nfc.save(filename);
+    if (!result.success) {
+        sendError(seq, ERR_FAILED, result.message.c_str());
+        return;
+    }
+
+    size_t len = min((size_t)result.message.length(), MAX_PAYLOAD);
+    memcpy(payload(), result.message.c_str(), len);
+    send(RSP_OK, seq, len);
+}
+
+void SerialFrameProtocol::handleDump(uint8_t seq) {
+    if (!_nfc.hasValidData()) {
+        sendError(seq, ERR_NO_DATA, "No data loaded");
+        return;
+    }
+    // Same rule as /api/nfc/current/raw: a job may swap the dump mid-transfer
+    if (_jobs && _jobs->isBusy()) {
+        sendError(seq, ERR_BUSY, "NFC job running");
+        return;
+    }
+
+    const NFCManager::TagInfo& tag = _nfc.currentTag();
+    const uint8_t* data = _nfc.getTagDataPointer(tag);
+    size_t size = _nfc.getTagDataSize(tag);
+
+    uint8_t* p = payload();
+    p[0] = tag.protocol;
+    p[1] = tag.uid_length;
+    memcpy(p + 2, tag.uid, tag.uid_length);
+    put16(p + 2 + tag.uid_length, size);
+    put32(p + 4 + tag.uid_length, esp_rom_crc32_le(0, data, size));
+    send(RSP_DUMP, seq, 8 + tag.uid_length);
+
+    // Raw bytes, no hex
+    for (size_t offset = 0; offset < size; offset += DATA_CHUNK) {
+        size_t chunk = min(size - offset, DATA_CHUNK);
+        put16(p, offset);
+        memcpy(p + 2, data + offset, chunk);
+        send(RSP_DATA, seq, 2 + chunk);
+    }
+
+    sendOk(seq);
+}
+
+void SerialFrameProtocol::pollJobs() {
+    if (!_jobs) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < MAX_PENDING_JOBS; i++) {
+        PendingJob& job = _pending[i];
+        if (job.id == 0) {
+            continue;
+        }
+
+        JsonDocument status;
+        String result;
+        if (!_jobs->getJob(job.id, status, result)) {
+            LOG_WARN("FRAME", "Job %u lost before completion", job.id);
+            sendError(job.seq, ERR_JOB_LOST, "Job result recycled");
+            job.id = 0;
+            continue;
+        }
+        if (status["state"] != "done") {
+            continue;
+        }
+
+        // Only the success flag is needed from the stored result
+        JsonDocument filter;
+        filter["success"] = true;
+        JsonDocument summary;
+        deserializeJson(summary, result, DeserializationOption::Filter(filter));
+
+        uint8_t flags = (summary["success"] | false) ? JOB_FLAG_SUCCESS : 0;
+        size_t len = result.length();
+        if (len > MAX_PAYLOAD - 5) {
+            len = MAX_PAYLOAD - 5;
+            flags |= JOB_FLAG_TRUNCATED;
+        }
+
+        uint8_t* p = payload();
+        put32(p, job.id);
+        p[4] = flags;
+        memcpy(p + 5, result.c_str(), len);
+        send(EVT_JOB, job.seq, 5 + len);
+
+        job.id = 0;
+    }
+}
+
+// ============================================
+// FRAMING
+// ============================================
+
+void SerialFrameProtocol::sendError(uint8_t seq, ErrorCode code, const char* message) {
+    size_t len = min(strlen(message), MAX_PAYLOAD - 1);
+    payload()[0] = (uint8_t)code;
+    memcpy(payload() + 1, message, len);
+    send(RSP_ERROR, seq, 1 + len);
+}
+
+void SerialFrameProtocol::sendFrame(uint8_t* frame, uint8_t type, uint8_t seq, size_t len) {
+    frame[0] = type;
+    frame[1] = seq;
+    size_t body = HEADER_SIZE + len;
+    put32(frame + body, esp_rom_crc32_le(0, frame, body));
+
+    xSemaphoreTake(_tx_lock, portMAX_DELAY);
+    writeCobs(frame, body + CRC_SIZE);
+    xSemaphoreGive(_tx_lock);
+}
+
+void SerialFrameProtocol::writeCobs(const uint8_t* data, size_t len) {
+    Serial.write((uint8_t)0x00);
+
+    // Each block: code byte (distance to the next zero, max 0xFF) + non-zero run
+    size_t start = 0;
+    while (true) {
+        size_t run = 0;
+        while (start + run < len && data[start + run] != 0x00 && run < 0xFE) {
+            run++;
+        }
+
+        Serial.write((uint8_t)(run + 1));
+        Serial.write(data + start, run);
+        start += run;
+
+        if (start >= len) {
+            break;
+        }
+        if (run < 0xFE) {
+            start++;                        // Skip the zero the code byte stands for
+            if (start == len) {
+                Serial.write((uint8_t)0x01); // Trailing zero
+                break;
+            }
+        }
+    }
+
+    Serial.write((uint8_t)0x00);
+}
+
+size_t SerialFrameProtocol::cobsDecode(uint8_t* data, size_t len) {
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < len) {
+        uint8_t code = data[in++];
+        if (code == 0x00 || in + code - 1 > len) {
+            return 0;
+        }
+
+        for (uint8_t i = 1; i < code; i++) {
+            data[out++] = data[in++];
+        }
+        if (code < 0xFF && in < len) {
+            data[out++] = 0x00;
+        }
+    }
+
+    return out;
+}
+
+void SerialFrameProtocol::onLogLine(const char* line, size_t len, void* context) {
+    SerialFrameProtocol* self = (SerialFrameProtocol*)context;
+    if (len > LOG_PAYLOAD_MAX) {
+        len = LOG_PAYLOAD_MAX;
+    }
+
+    memcpy(self->_log_tx + HEADER_SIZE, line, len);
+    self->sendFrame(self->_log_tx, EVT_LOG, 0, len);
+}
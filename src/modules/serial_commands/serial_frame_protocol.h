@@ -0,0 +1,244 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "modules/rfid/nfc_manager.h"
+#include "config.h"
+#include "logger.h"
+
+class NFCJobEngine;
+
+/**
+ * @brief Binary framed serial protocol for host tooling
+ *
+ * Replaces the text command line while active, so scripts exchange
+ * checked binary frames instead of scraping human-readable output.
+ *
+ * Framing:
+ * - Frame = type (u8), seq (u8), payload, CRC-32 (zlib, LE) over type..payload
+ * - COBS encoded, 0x00 before and after every frame: a host resyncs on
+ *   the next delimiter after noise or a reset
+ * - Integers little-endian, strings UTF-8 without terminator
+ * - Replies echo the command's seq; EVT_JOB carries the seq of the
+ *   CMD_JOB that queued it, EVT_LOG uses seq 0
+ *
+ * Commands (host -> device):
+ * - CMD_PING  {}                           -> RSP_OK {version u8, max_payload u16}
+ * - CMD_JOB   {type u8, timeout_sec u8}    -> RSP_ACCEPTED {job_id u32}, later EVT_JOB
+ *             (NFCJobEngine::JobType, tag read/write/compare jobs only)
+ * - CMD_LOAD  {filename}                   -> RSP_OK {protocol u8, uid_len u8, uid, size u16}
+ * - CMD_SAVE  {filename}                   -> RSP_OK {message}
+ * - CMD_DUMP  {}                           -> RSP_DUMP {protocol u8, uid_len u8, uid, size u16, crc32 u32},
+ *                                             RSP_DATA {offset u16, bytes} x N, RSP_OK {}
+ * - CMD_TEXT  {}                           -> RSP_OK {}, back to text commands and SERIAL_BAUD_RATE
+ *
+ * Events (device -> host):
+ * - EVT_JOB   {job_id u32, flags u8, result JSON}  Job finished (JOB_FLAG_*)
+ * - EVT_LOG   {line}                               Every log line, in band
+ *
+ * Errors: RSP_ERROR {code i8, message} (ERR_*).
+ * CMD_LOAD, CMD_SAVE and CMD_DUMP answer ERR_BUSY while a job is queued
+ * or running.
+ *
+ * Thread Safety:
+ * - poll() runs on the serial command task (commands, job completions)
+ * - Log frames are written by the logger's drain task with their own
+ *   buffer; a mutex keeps frames from interleaving on the UART
+ *
+ * Usage:
+ * @code
+ * SerialFrameProtocol frames(nfcMgr);
+ * frames.setJobEngine(jobs);
+ * frames.begin(921600);       // "sys binary 921600"
+ * for (;;) { frames.poll(); vTaskDelay(1); }
+ * @endcode
+ */
+class SerialFrameProtocol {
+public:
+    // ============================================
+    // FRAME TYPES
+    // ============================================
+
+    enum FrameType : uint8_t {
+        // Host -> device
+        CMD_PING = 0x01,
+        CMD_JOB = 0x02,
+        CMD_LOAD = 0x03,
+        CMD_SAVE = 0x04,
+        CMD_DUMP = 0x05,
+        CMD_TEXT = 0x0F,
+
+        // Device -> host
+        RSP_OK = 0x80,
+        RSP_ERROR = 0x81,
+        RSP_ACCEPTED = 0x82,
+        RSP_DUMP = 0x83,
+        RSP_DATA = 0x84,
+        EVT_JOB = 0x90,
+        EVT_LOG = 0x91
+    };
+
+    /**
+     * @brief RSP_ERROR codes
+     */
+    enum ErrorCode : int8_t {
+        ERR_UNKNOWN_COMMAND = -1,   ///< Frame type not handled
+        ERR_BAD_PAYLOAD = -2,       ///< Payload too short or out of range
+        ERR_NO_ENGINE = -3,         ///< No NFC job engine attached
+        ERR_QUEUE_FULL = -4,        ///< Job table/queue full or too many pending jobs
+        ERR_BUSY = -5,              ///< A job may replace the dump
+        ERR_NO_DATA = -6,           ///< No dump loaded
+        ERR_FAILED = -7,            ///< Operation failed (message has details)
+        ERR_JOB_LOST = -8           ///< Job recycled before its result was sent
+    };
+
+    // EVT_JOB flags
+    static constexpr uint8_t JOB_FLAG_SUCCESS = 0x01;           // Result "success" was true
+    static constexpr uint8_t JOB_FLAG_TRUNCATED = 0x02;         // Result JSON cut at MAX_PAYLOAD
+
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr uint8_t PROTOCOL_VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 2;                    // type + seq
+    static constexpr size_t CRC_SIZE = 4;                       // CRC-32
+    static constexpr size_t MAX_PAYLOAD = 2048;                 // Half a Mifare 4K dump per RSP_DATA
+    static constexpr size_t DATA_CHUNK = MAX_PAYLOAD - 2;       // RSP_DATA bytes after the offset
+    static constexpr size_t RX_FRAME_MAX = 320;                 // Encoded command frame (filenames)
+    static constexpr size_t LOG_PAYLOAD_MAX = 256;              // Longest log line sent
+    static constexpr uint8_t MAX_PENDING_JOBS = 4;              // Jobs awaiting EVT_JOB
+    static constexpr size_t RX_BYTES_PER_POLL = 512;            // Bound one poll() call
+
+    // ============================================
+    // PUBLIC METHODS
+    // ============================================
+
+    /**
+     * @brief Construct protocol handler
+     * @param nfc NFC manager for load/save/dump
+     */
+    explicit SerialFrameProtocol(NFCManager& nfc);
+
+    /**
+     * @brief Job engine used by CMD_JOB (nullptr: CMD_JOB fails)
+     */
+    void setJobEngine(NFCJobEngine* jobs) { _jobs = jobs; }
+
+    /**
+     * @brief Switch Serial to framed mode
+     * @param baud New baud rate (0: keep current)
+     *
+     * Log output moves in band (EVT_LOG) until end().
+     */
+    void begin(uint32_t baud = 0);
+
+    /**
+     * @brief Return to plain text output at SERIAL_BAUD_RATE
+     */
+    void end();
+
+    /**
+     * @brief Check if framed mode is active
+     */
+    bool isActive() const { return _active; }
+
+    /**
+     * @brief Handle received frames and send finished job events
+     *
+     * Call from the serial command task. Non-blocking unless a reply
+     * fills the UART TX buffer.
+     */
+    void poll();
+
+private:
+    // ============================================
+    // TYPES
+    // ============================================
+
+    struct PendingJob {
+        uint32_t id;                // NFCJobEngine job id (0 = free)
+        uint8_t seq;                // seq of the CMD_JOB frame
+    };
+
+    // ============================================
+    // MEMBER VARIABLES
+    // ============================================
+
+    NFCManager& _nfc;                           // Reference to NFC manager
+    NFCJobEngine* _jobs;                        // Job engine (not owned, may be nullptr)
+    volatile bool _active;                      // Framed mode on
+    PendingJob _pending[MAX_PENDING_JOBS];      // Jobs awaiting EVT_JOB
+
+    uint8_t _rx[RX_FRAME_MAX];                  // Encoded bytes up to the next delimiter
+    size_t _rx_len;                             // Bytes in _rx
+    bool _rx_overflow;                          // Frame too long: drop until next delimiter
+
+    uint8_t _tx[HEADER_SIZE + MAX_PAYLOAD + CRC_SIZE];      // Replies (serial task only)
+    uint8_t _log_tx[HEADER_SIZE + LOG_PAYLOAD_MAX + CRC_SIZE]; // EVT_LOG (drain task only)
+    SemaphoreHandle_t _tx_lock;                 // One frame on the UART at a time
+    StaticSemaphore_t _tx_lock_buffer;          // Mutex control block
+
+    // ============================================
+    // COMMAND HANDLERS
+    // ============================================
+
+    /**
+     * @brief Dispatch one decoded, CRC-checked frame
+     */
+    void handleFrame(uint8_t type, uint8_t seq, const uint8_t* payload, size_t len);
+
+    void handleJob(uint8_t seq, const uint8_t* payload, size_t len);
+    void handleLoad(uint8_t seq, const String& filename);
+    void handleSave(uint8_t seq, const String& filename);
+    void handleDump(uint8_t seq);
+
+    /**
+     * @brief Send EVT_JOB for every pending job that finished
+     */
+    void pollJobs();
+
+    // ============================================
+    // FRAMING
+    // ============================================
+
+    /**
+     * @brief Payload area of the reply buffer
+     */
+    uint8_t* payload() { return _tx + HEADER_SIZE; }
+
+    /**
+     * @brief Send the reply buffer (payload already in place)
+     */
+    void send(uint8_t type, uint8_t seq, size_t len) { sendFrame(_tx, type, seq, len); }
+
+    void sendOk(uint8_t seq) { send(RSP_OK, seq, 0); }
+    void sendError(uint8_t seq, ErrorCode code, const char* message);
+
+    /**
+     * @brief Add header and CRC, COBS-encode and write one frame
+     * @param frame Buffer with the payload at frame + HEADER_SIZE and
+     *        CRC_SIZE spare bytes after it
+     */
+    void sendFrame(uint8_t* frame, uint8_t type, uint8_t seq, size_t len);
+
+    /**
+     * @brief Write COBS encoding of data, framed by delimiters (lock held)
+     */
+    static void writeCobs(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Decode a COBS block in place
+     * @return Decoded length, 0 if malformed
+     */
+    static size_t cobsDecode(uint8_t* data, size_t len);
+
+    /**
+     * @brief Logger serial sink: one EVT_LOG frame per line
+     */
+    static void onLogLine(const char* line, size_t len, void* context);
+
+    static void put16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+    static void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(p + 2, v >> 16); }
+};
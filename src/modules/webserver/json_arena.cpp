@@ -0,0 +1,81 @@
+#include "json_arena.h"
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+JsonArena::JsonArena(uint8_t* buffer, size_t size)
+    : _buffer(buffer), _size(size), _top(0), _peak(0), _live(0), _overflows(0)
+{
+}
+
+// ============================================
+// ALLOCATOR
+// ============================================
+
+void* JsonArena::allocate(size_t size) {
+    size_t needed = HEADER_SIZE + align(size);
+
+    if (_size - _top < needed) {
+        _overflows++;
+        LOG_DEBUG("JSON", "Arena full (%u/%u bytes), %u bytes from heap",
+                  (unsigned)_top, (unsigned)_size, (unsigned)size);
+        return malloc(size);
+    }
+
+    void* ptr = _buffer + _top + HEADER_SIZE;
+    blockSize(ptr) = align(size);
+    _top += needed;
+    _live++;
+    if (_top > _peak) _peak = _top;
+    return ptr;
+}
+
+void JsonArena::deallocate(void* ptr) {
+    if (!ptr) return;
+
+    if (!owns(ptr)) {
+        free(ptr);
+        return;
+    }
+
+    // Newest block: give its space back right away
+    if (isTop(ptr)) {
+        _top = ((uint8_t*)ptr - HEADER_SIZE) - _buffer;
+    }
+
+    if (--_live == 0) {
+        _top = 0;
+    }
+}
+
+void* JsonArena::reallocate(void* ptr, size_t new_size) {
+    if (!ptr) return allocate(new_size);
+
+    if (!owns(ptr)) {
+        return realloc(ptr, new_size);
+    }
+
+    size_t old_size = blockSize(ptr);
+    size_t aligned = align(new_size);
+
+    // Newest block: grow or shrink in place
+    if (isTop(ptr)) {
+        size_t start = (uint8_t*)ptr - _buffer;
+        if (start + aligned <= _size) {
+            blockSize(ptr) = aligned;
+            _top = start + aligned;
+            if (_top > _peak) _peak = _top;
+            return ptr;
+        }
+    } else if (aligned <= old_size) {
+        return ptr;
+    }
+
+    void* moved = allocate(new_size);
+    if (!moved) return nullptr;
+
+    memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+    deallocate(ptr);
+    return moved;
+}
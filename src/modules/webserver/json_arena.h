@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "logger.h"
+
+/**
+ * @brief JsonArena - ArduinoJson allocator over a preallocated buffer
+ *
+ * A default JsonDocument takes its slot pools and strings from the heap
+ * and gives them back when it is destroyed. On a device that runs for
+ * weeks these short-lived blocks, mixed with longer-lived ones, fragment
+ * the heap until a large allocation (e.g. a task stack) fails.
+ *
+ * Architecture:
+ * - Bump allocator over a fixed buffer, 8-byte aligned blocks with a
+ *   small size header
+ * - Freeing or growing the newest block happens in place; the arena
+ *   rewinds to empty as soon as every block is released, so each
+ *   document starts from a clean buffer
+ * - Requests that do not fit fall back to the heap (counted), so an
+ *   unusually large document still works, just not allocation-free
+ *
+ * Thread Safety:
+ * - None: one arena per task. Documents sharing an arena may nest
+ *   (e.g. request and response document in one handler).
+ *
+ * Usage:
+ * @code
+ * static StaticJsonArena<4096> arena;
+ * JsonDocument doc(&arena);
+ * doc["success"] = true;
+ * @endcode
+ */
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    /**
+     * @brief Bind the arena to a buffer
+     * @param buffer Storage (8-byte aligned)
+     * @param size Storage size in bytes
+     */
+    JsonArena(uint8_t* buffer, size_t size);
+
+    // ArduinoJson::Allocator
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t new_size) override;
+
+    size_t capacity() const { return _size; }
+    size_t used() const { return _top; }
+    size_t peak() const { return _peak; }               ///< Highest fill level seen
+    uint32_t overflows() const { return _overflows; }   ///< Blocks served from the heap
+
+private:
+    static constexpr size_t ALIGNMENT = 8;
+    static constexpr size_t HEADER_SIZE = ALIGNMENT;     // Keeps payloads aligned
+
+    static size_t align(size_t size) { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+    bool owns(const void* ptr) const {
+        return (const uint8_t*)ptr >= _buffer && (const uint8_t*)ptr < _buffer + _size;
+    }
+    static size_t& blockSize(void* ptr) { return *(size_t*)((uint8_t*)ptr - HEADER_SIZE); }
+    bool isTop(void* ptr) { return (uint8_t*)ptr + blockSize(ptr) == _buffer + _top; }
+
+    uint8_t* _buffer;           // Arena storage
+    size_t _size;               // Storage size
+    size_t _top;                // Bump offset
+    size_t _peak;               // Highest _top
+    uint16_t _live;             // Arena blocks not yet freed
+    uint32_t _overflows;        // Heap fallbacks
+};
+
+/**
+ * @brief JsonArena with its own storage (place in static memory or a member)
+ */
+template <size_t N>
+class StaticJsonArena : public JsonArena {
+public:
+    StaticJsonArena() : JsonArena(_storage, N) {}
+
+private:
+    alignas(8) uint8_t _storage[N];
+};
@@ -0,0 +1,92 @@
+#include "json_response.h"
+#include <stage_metrics.h>
+
+// ============================================
+// HELPERS
+// ============================================
+
+namespace {
+
+/**
+ * @brief Print adapter that forwards only the first `limit` bytes
+ *
+ * Used to serialize an object without its closing brace so another
+ * member can be appended behind it.
+ */
+class TruncatingPrint : public Print {
+public:
+    TruncatingPrint(Print& out, size_t limit) : _out(out), _left(limit) {}
+
+    size_t write(uint8_t c) override {
+        if (_left == 0) return 1;
+        _left--;
+        return _out.write(c);
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        size_t n = size < _left ? size : _left;
+        if (n > 0) {
+            _out.write(buffer, n);
+            _left -= n;
+        }
+        return size;
+    }
+
+private:
+    Print& _out;
+    size_t _left;
+};
+
+} // namespace
+
+// ============================================
+// SEND
+// ============================================
+
+void JsonResponse::send(AsyncWebServerRequest* request, int code, const JsonDocument& doc) {
+    METRIC_SCOPE(METRIC_JSON_SERIALIZE);
+
+    size_t length = measureJson(doc);
+    size_t buffer_size = length < MIN_BUFFER_SIZE ? MIN_BUFFER_SIZE : length;
+
+    AsyncResponseStream* res = request->beginResponseStream(CONTENT_TYPE, buffer_size);
+    res->setCode(code);
+    serializeJson(doc, *res);
+    request->send(res);
+}
+
+void JsonResponse::send(AsyncWebServerRequest* request, int code, const JsonDocument& doc,
+                        const char* key, const String& raw) {
+    if (raw.length() == 0) {
+        send(request, code, doc);
+        return;
+    }
+
+    METRIC_SCOPE(METRIC_JSON_SERIALIZE);
+
+    // {"a":1} + ,"key": + raw  ->  {"a":1,"key":raw}
+    size_t length = measureJson(doc);
+    size_t key_len = strlen(key);
+    size_t buffer_size = length + key_len + raw.length() + 4;
+
+    AsyncResponseStream* res = request->beginResponseStream(CONTENT_TYPE, buffer_size);
+    res->setCode(code);
+
+    if (length >= 2) {
+        TruncatingPrint head(*res, length - 1);
+        serializeJson(doc, head);
+        if (length > 2) res->write(',');
+    } else {
+        res->write('{');
+    }
+
+    res->write('"');
+    res->write((const uint8_t*)key, key_len);
+    res->write((const uint8_t*)"\":", 2);
+    res->write((const uint8_t*)raw.c_str(), raw.length());
+    res->write('}');
+
+    LOG_DEBUG("WEB", "JSON reply with raw '%s': %u bytes",
+              key, (unsigned)(length + key_len + raw.length() + 4));
+    request->send(res);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <ArduinoJson.h>
+#include "logger.h"
+
+/**
+ * @brief JsonResponse - Serialize a JsonDocument straight into the response
+ *
+ * Replaces the serializeJson(doc, String) + request->send(code, type, String)
+ * pattern, which keeps the document, the output String and the response's
+ * own copy of it alive at the same time until the handler returns.
+ *
+ * Architecture:
+ * - measureJson() sizes an AsyncResponseStream up front, so the stream
+ *   buffer is allocated once at its final size (no growth reallocations)
+ * - The document is serialized into the stream; no intermediate String
+ * - A pre-serialized fragment (e.g. a stored job result) can be spliced in
+ *   as a raw member without parsing it or copying it into the document
+ *
+ * Peak heap per reply (n = serialized size):
+ *   before: document + n (String) + n (response copy)
+ *   after:  document + n (stream buffer)
+ *
+ * Usage:
+ * @code
+ * JsonDocument doc;
+ * doc["success"] = true;
+ * JsonResponse::send(request, 200, doc);
+ * @endcode
+ */
+class JsonResponse {
+public:
+    /**
+     * @brief Send a document as application/json
+     * @param request HTTP request
+     * @param code HTTP status code
+     * @param doc Document to serialize
+     */
+    static void send(AsyncWebServerRequest* request, int code, const JsonDocument& doc);
+
+    /**
+     * @brief Send a document with one extra pre-serialized member
+     * @param request HTTP request
+     * @param code HTTP status code
+     * @param doc Top-level object (must not contain key)
+     * @param key Member name for the raw fragment
+     * @param raw Valid JSON value, written verbatim (empty: member omitted)
+     */
+    static void send(AsyncWebServerRequest* request, int code, const JsonDocument& doc,
+                     const char* key, const String& raw);
+
+private:
+    static constexpr const char* CONTENT_TYPE = "application/json";
+    static constexpr size_t MIN_BUFFER_SIZE = 64;             // Floor for tiny replies
+};
@@ -0,0 +1,930 @@
+#include "nfc_job_engine.h"
+#include <stage_metrics.h>
+
+// ============================================
+// JOB TYPE NAMES
+// ============================================
+
+// Indexed by JobType - keep in sync with the enum
+static const char* const JOB_TYPE_NAMES[NFCJobEngine::JOB_TYPE_COUNT] = {
+    "srix_read",
+    "srix_write",
+    "srix_compare",
+    "srix_write_selective",
+    "mifare_read",
+    "mifare_read_uid",
+    "mifare_write",
+    "mifare_clone",
+    "mifare_compare",
+    "mifare_write_selective",
+    "srix_write_changes",
+    "mifare_write_changes",
+    "bench",
+    "batch_scan"
+};
+
+// ============================================
+// HELPERS
+// ============================================
+
+namespace {
+
+/**
+ * @brief Print adapter that appends to a String
+ *
+ * serializeJson(doc, String&) resets the String to null first, which
+ * frees its buffer; appending through Print keeps the reserved capacity.
+ */
+class StringAppender : public Print {
+public:
+    explicit StringAppender(String& out) : _out(out) {}
+
+    size_t write(uint8_t c) override {
+        return _out.concat((char)c) ? 1 : 0;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        return _out.concat((const char*)buffer, size) ? size : 0;
+    }
+
+private:
+    String& _out;
+};
+
+} // namespace
+
+// ============================================
+// CONSTRUCTOR AND SETUP
+// ============================================
+
+// Shared by every engine: job ids are unique across readers
+std::atomic<uint32_t> NFCJobEngine::_next_id(1);
+
+NFCJobEngine::NFCJobEngine(NFCManager& nfc)
+    : _nfc(nfc), _queue(nullptr), _lock(nullptr), _worker(nullptr),
+      _sink(nullptr), _sink_context(nullptr), _running_id(INVALID_JOB_ID), _last_progress_ms(0),
+      _led(nullptr), _bench(nfc)
+{
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        _jobs[i].id = INVALID_JOB_ID;
+        _jobs[i].state = JOB_STATE_FREE;
+    }
+}
+
+bool NFCJobEngine::begin() {
+    if (_worker) {
+        return true;
+    }
+
+    if (!_queue) {
+        _queue = xQueueCreateStatic(MAX_JOBS, sizeof(uint8_t), _queue_storage, &_queue_buffer);
+    }
+    if (!_lock) {
+        _lock = xSemaphoreCreateMutexStatic(&_lock_buffer);
+    }
+
+    if (!_queue || !_lock) {
+        LOG_ERROR("NFC-JOB", "Failed to create job queue/mutex");
+        return false;
+    }
+
+    // Size the reusable buffers once, while the heap is still unfragmented
+    bool reserved = _result.reserve(RESULT_RESERVE_BYTES) &&
+                    _done_event.reserve(RESULT_RESERVE_BYTES + EVENT_BUFFER_SIZE);
+    _active.blocks.reserve(MAX_BLOCK_LIST);
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        _jobs[i].request.blocks.reserve(MAX_BLOCK_LIST);
+        reserved = _jobs[i].result_json.reserve(RESULT_RESERVE_BYTES) && reserved;
+    }
+    if (!reserved) {
+        LOG_WARN("NFC-JOB", "Could not reserve result buffers, results will allocate per job");
+    }
+
+    // Static stack: task creation cannot fail on a fragmented heap
+    const NFCReaderConfig& reader = _nfc.reader();
+    char name[16];
+    snprintf(name, sizeof(name), reader.id ? "NFCWorker%u" : "NFCWorker", reader.id);
+    _worker = xTaskCreateStaticPinnedToCore(
+        workerTask,
+        name,
+        WORKER_STACK_SIZE,
+        this,
+        WORKER_PRIORITY,
+        _stack,
+        &_task_buffer,
+        reader.core
+    );
+
+    if (!_worker) {
+        LOG_ERROR("NFC-JOB", "Failed to create NFC worker task");
+        return false;
+    }
+
+    if (!NFCProgress::addListener(onProgress, this)) {
+        LOG_WARN("NFC-JOB", "No progress listener slot left, reader %u jobs report no progress", reader.id);
+    }
+
+    LOG_INFO("NFC-JOB", "NFC worker for reader %u started on core %u (%d job slots, %u bytes static)",
+             reader.id, reader.core, MAX_JOBS, (unsigned)staticFootprint());
+    return true;
+}
+
+// ============================================
+// PUBLIC API
+// ============================================
+
+uint32_t NFCJobEngine::submit(const JobRequest& req) {
+    if (!_worker || req.type >= JOB_TYPE_COUNT) {
+        return INVALID_JOB_ID;
+    }
+
+    if (xSemaphoreTake(_lock, LOCK_TIMEOUT_TICKS) != pdTRUE) {
+        LOG_WARN("NFC-JOB", "Job table busy, submit rejected");
+        return INVALID_JOB_ID;
+    }
+
+    int slot = allocateSlot();
+    if (slot < 0) {
+        xSemaphoreGive(_lock);
+        LOG_WARN("NFC-JOB", "Job queue full, submit rejected");
+        return INVALID_JOB_ID;
+    }
+
+    Job& job = _jobs[slot];
+    job.id = _next_id.fetch_add(1);
+    if (job.id == INVALID_JOB_ID) {
+        job.id = _next_id.fetch_add(1);     // Wrapped around
+    }
+    job.state = JOB_STATE_QUEUED;
+    job.request = req;
+    job.queued_at = millis();
+    job.started_at = 0;
+    job.finished_at = 0;
+    recycleResult(job.result_json);
+
+    uint32_t id = job.id;
+    uint8_t index = (uint8_t)slot;
+
+    // Queue has MAX_JOBS entries, one per slot: cannot overflow
+    if (xQueueSend(_queue, &index, 0) != pdTRUE) {
+        job.id = INVALID_JOB_ID;
+        job.state = JOB_STATE_FREE;
+        xSemaphoreGive(_lock);
+        LOG_ERROR("NFC-JOB", "Failed to enqueue job");
+        return INVALID_JOB_ID;
+    }
+
+    xSemaphoreGive(_lock);
+
+    LOG_INFO("NFC-JOB", "Job %u queued on reader %u: %s (timeout: %ds, blocks: %d)",
+             id, _nfc.reader().id, typeToString(req.type), req.timeout_sec, req.blocks.size());
+    publishJob(id, req.type, JOB_STATE_QUEUED, nullptr);
+    return id;
+}
+
+bool NFCJobEngine::getJob(uint32_t id, JsonDocument& out, String& result) {
+    if (!_lock || id == INVALID_JOB_ID) {
+        return false;
+    }
+
+    if (xSemaphoreTake(_lock, LOCK_TIMEOUT_TICKS) != pdTRUE) {
+        return false;
+    }
+
+    int slot = findSlot(id);
+    if (slot < 0) {
+        xSemaphoreGive(_lock);
+        return false;
+    }
+
+    // Copy out under lock, build JSON after releasing it
+    JobType type = _jobs[slot].request.type;
+    JobState state = _jobs[slot].state;
+    unsigned long queued_at = _jobs[slot].queued_at;
+    unsigned long started_at = _jobs[slot].started_at;
+    unsigned long finished_at = _jobs[slot].finished_at;
+    result = (state == JOB_STATE_DONE) ? _jobs[slot].result_json : String();
+
+    xSemaphoreGive(_lock);
+
+    out["job_id"] = id;
+    out["reader"] = _nfc.reader().id;
+    out["type"] = typeToString(type);
+    out["state"] = stateToString(state);
+
+    unsigned long now = millis();
+    if (state == JOB_STATE_QUEUED) {
+        out["elapsed_ms"] = now - queued_at;
+    } else if (state == JOB_STATE_RUNNING) {
+        out["elapsed_ms"] = now - started_at;
+    } else {
+        out["elapsed_ms"] = finished_at - started_at;
+    }
+
+    return true;
+}
+
+bool NFCJobEngine::isBusy() {
+    if (!_lock || xSemaphoreTake(_lock, LOCK_TIMEOUT_TICKS) != pdTRUE) {
+        return false;
+    }
+
+    bool busy = hasPendingJob();
+    xSemaphoreGive(_lock);
+    return busy;
+}
+
+bool NFCJobEngine::copyCurrentTagTo(NFCManager& target) {
+    if (!_lock || xSemaphoreTake(_lock, LOCK_TIMEOUT_TICKS) != pdTRUE) {
+        return false;
+    }
+
+    // Holding _lock keeps the worker from starting a job that replaces the dump
+    bool copied = !hasPendingJob() && _nfc.hasValidData();
+    if (copied) {
+        target.restoreCurrentTag(_nfc.currentTag());
+    }
+
+    xSemaphoreGive(_lock);
+    return copied;
+}
+
+bool NFCJobEngine::hasPendingJob() const {
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        if (_jobs[i].state == JOB_STATE_QUEUED || _jobs[i].state == JOB_STATE_RUNNING) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void NFCJobEngine::setEventSink(EventSink sink, void* context) {
+    _sink_context = context;
+    _sink = sink;
+}
+
+const char* NFCJobEngine::typeToString(JobType type) {
+    if (type >= JOB_TYPE_COUNT) {
+        return "unknown";
+    }
+    return JOB_TYPE_NAMES[type];
+}
+
+bool NFCJobEngine::typeFromString(const String& name, JobType& type) {
+    for (uint8_t i = 0; i < JOB_TYPE_COUNT; i++) {
+        if (name == JOB_TYPE_NAMES[i]) {
+            type = (JobType)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* NFCJobEngine::stateToString(JobState state) {
+    switch (state) {
+        case JOB_STATE_QUEUED:  return "queued";
+        case JOB_STATE_RUNNING: return "running";
+        case JOB_STATE_DONE:    return "done";
+        default:                return "free";
+    }
+}
+
+// ============================================
+// WORKER
+// ============================================
+
+void NFCJobEngine::workerTask(void* parameter) {
+    NFCJobEngine* engine = (NFCJobEngine*)parameter;
+    engine->workerLoop();
+    vTaskDelete(NULL); // Not reached
+}
+
+void NFCJobEngine::workerLoop() {
+    // NFC operations can block for minutes: never feed the task watchdog
+    if (esp_task_wdt_status(NULL) == ESP_OK) {
+        esp_task_wdt_delete(NULL);
+        LOG_DEBUG("NFC-JOB", "Worker removed from watchdog timer");
+    }
+
+    uint8_t index;
+    for (;;) {
+        if (xQueueReceive(_queue, &index, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        // Claim job and copy parameters
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        Job& job = _jobs[index];
+        job.state = JOB_STATE_RUNNING;
+        job.started_at = millis();
+        uint32_t id = job.id;
+        _active = job.request;              // Copies into reserved capacity
+        xSemaphoreGive(_lock);
+
+        LOG_INFO("NFC-JOB", "Job %u started: %s", id, typeToString(_active.type));
+        _running_id = id;
+        _last_progress_ms = 0;
+        publishJob(id, _active.type, JOB_STATE_RUNNING, nullptr);
+
+        uint32_t overflows = _arena.overflows();
+        bool success;
+        {
+            JsonDocument doc(&_arena);
+            execute(_active, doc);
+            success = doc["success"].as<bool>();
+
+            METRIC_SCOPE(METRIC_JSON_SERIALIZE);
+            recycleResult(_result);
+            _result.reserve(measureJson(doc));
+            StringAppender out(_result);
+            serializeJson(doc, out);
+        }
+        _running_id = INVALID_JOB_ID;
+
+        if (_arena.overflows() != overflows) {
+            LOG_WARN("NFC-JOB", "Job %u result exceeded arena (%u bytes), used heap",
+                     id, (unsigned)RESULT_ARENA_SIZE);
+        }
+
+        // Store result (slot cannot be recycled while RUNNING)
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        job.result_json = _result;
+        job.finished_at = millis();
+        job.state = JOB_STATE_DONE;
+        unsigned long duration = job.finished_at - job.started_at;
+        xSemaphoreGive(_lock);
+
+        LOG_INFO("NFC-JOB", "Job %u done in %lums - success: %d", id, duration, success);
+        publishJob(id, _active.type, JOB_STATE_DONE, _result.c_str());
+        checkHeap();
+    }
+}
+
+// ============================================
+// PUSH EVENTS
+// ============================================
+
+void NFCJobEngine::onProgress(const NFCProgress::Event& event, void* context) {
+    NFCJobEngine* engine = (NFCJobEngine*)context;
+
+    // Every engine listens: keep only what this reader's worker reports
+    if (!engine->_sink || xTaskGetCurrentTaskHandle() != engine->_worker) {
+        return;
+    }
+
+    char json[EVENT_BUFFER_SIZE];
+    uint8_t reader = engine->_nfc.reader().id;
+
+    if (event.type == NFCProgress::EVENT_AUTH) {
+        char key[12] = "";
+        if (event.ok) {
+            snprintf(key, sizeof(key), ",\"key\":\"%c\"", event.key_type);
+        }
+        snprintf(json, sizeof(json),
+                 "{\"job_id\":%u,\"reader\":%u,\"sector\":%u,\"ok\":%s%s,\"attempts\":%u}",
+                 engine->_running_id, reader, event.index, event.ok ? "true" : "false",
+                 key, event.attempts);
+        engine->_sink("auth", json, engine->_sink_context);
+        return;
+    }
+
+    // Throttle successful block events, always forward last/failed ones
+    unsigned long now = millis();
+    bool last = (event.index >= event.total);
+    if (event.type == NFCProgress::EVENT_BLOCK && event.ok && !last &&
+        (now - engine->_last_progress_ms) < PROGRESS_MIN_INTERVAL_MS) {
+        return;
+    }
+    engine->_last_progress_ms = now;
+
+    snprintf(json, sizeof(json),
+             "{\"job_id\":%u,\"reader\":%u,\"unit\":\"%s\",\"op\":\"%s\",\"index\":%u,\"total\":%u,\"ok\":%s}",
+             engine->_running_id, reader,
+             (event.type == NFCProgress::EVENT_SECTOR) ? "sector" : "block",
+             NFCProgress::opToString(event.op), event.index, event.total,
+             event.ok ? "true" : "false");
+    engine->_sink("progress", json, engine->_sink_context);
+}
+
+void NFCJobEngine::onBatchEvent(const NFCManager::BatchEvent& event, void* context) {
+    NFCJobEngine* engine = (NFCJobEngine*)context;
+
+    if (engine->_led) {
+        switch (event.status) {
+            case NFCManager::BATCH_SAVED:     engine->_led->doubleBlink(); break;
+            case NFCManager::BATCH_DUPLICATE: engine->_led->tripleBlink(); break;
+            case NFCManager::BATCH_REMOVED:   engine->_led->heartbeat();   break;
+            default:                          engine->_led->fastBlink();   break;
+        }
+    }
+
+    if (!engine->_sink) {
+        return;
+    }
+
+    char uid[NFCManager::MAX_UID_LENGTH * 3] = "";
+    const char* type = "";
+    if (event.tag) {
+        size_t len = 0;
+        for (uint8_t i = 0; i < event.tag->uid_length && len < sizeof(uid); i++) {
+            len += snprintf(uid + len, sizeof(uid) - len, i ? ":%02X" : "%02X", event.tag->uid[i]);
+        }
+        type = event.tag->name();
+    }
+
+    NFCManager::BatchStats stats = engine->_nfc.batchStats();
+    char json[BATCH_EVENT_SIZE];
+    snprintf(json, sizeof(json),
+             "{\"job_id\":%u,\"reader\":%u,\"index\":%u,\"status\":\"%s\",\"uid\":\"%s\",\"tag\":\"%s\","
+             "\"path\":\"%s\",\"read_ms\":%lu,\"cycle_ms\":%lu,"
+             "\"saved\":%u,\"duplicates\":%u,\"failed\":%u}",
+             engine->_running_id, engine->_nfc.reader().id, event.index, NFCManager::batchStatusToString(event.status),
+             uid, type, event.path, (unsigned long)event.read_ms, (unsigned long)event.cycle_ms,
+             stats.saved, stats.duplicates, stats.failed);
+    engine->_sink("batch", json, engine->_sink_context);
+}
+
+void NFCJobEngine::publishJob(uint32_t id, JobType type, JobState state, const char* result_json) {
+    if (!_sink) {
+        return;
+    }
+
+    char json[EVENT_BUFFER_SIZE];
+    snprintf(json, sizeof(json), "{\"job_id\":%u,\"reader\":%u,\"type\":\"%s\",\"state\":\"%s\"%s",
+             id, _nfc.reader().id, typeToString(type), stateToString(state), result_json ? ",\"result\":" : "}");
+
+    if (!result_json) {
+        _sink("job", json, _sink_context);
+        return;
+    }
+
+    // {"job_id":..,"state":"done","result":<result>}
+    recycleResult(_done_event);
+    _done_event.reserve(strlen(json) + strlen(result_json) + 1);
+    _done_event.concat(json);
+    _done_event.concat(result_json);
+    _done_event.concat('}');
+    _sink("job", _done_event.c_str(), _sink_context);
+}
+
+void NFCJobEngine::execute(const JobRequest& req, JsonDocument& doc) {
+    // Cross-reader pipeline: write what another reader read or loaded
+    if (req.source && req.source != this) {
+        // The source may have started a job since submit: never copy a dump mid-replace
+        if (!req.source->copyCurrentTagTo(_nfc)) {
+            doc["success"] = false;
+            doc["message"] = "Source reader busy or has no data";
+            doc["code"] = -1;
+            return;
+        }
+        LOG_INFO("NFC-JOB", "Reader %u: using current tag of reader %u",
+                 _nfc.reader().id, req.source->nfc().reader().id);
+    }
+
+    switch (req.type) {
+        case JOB_SRIX_READ:
+        case JOB_MIFARE_READ:
+        case JOB_MIFARE_READ_UID:
+            runRead(req, doc);
+            break;
+
+        case JOB_SRIX_WRITE:
+        case JOB_MIFARE_WRITE:
+            runWrite(req, doc);
+            break;
+
+        case JOB_SRIX_COMPARE:
+        case JOB_MIFARE_COMPARE:
+            runCompare(req, doc);
+            break;
+
+        case JOB_SRIX_WRITE_SELECTIVE:
+        case JOB_MIFARE_WRITE_SELECTIVE:
+            runWriteSelective(req, doc);
+            break;
+
+        case JOB_SRIX_WRITE_CHANGES:
+        case JOB_MIFARE_WRITE_CHANGES:
+            runWriteChanges(req, doc);
+            break;
+
+        case JOB_MIFARE_CLONE:
+            runClone(req, doc);
+            break;
+
+        case JOB_BENCH:
+            runBench(req, doc);
+            break;
+
+        case JOB_BATCH_SCAN:
+            runBatchScan(req, doc);
+            break;
+
+        default:
+            doc["success"] = false;
+            doc["message"] = "Unknown job type";
+            break;
+    }
+}
+
+// ============================================
+// JOB IMPLEMENTATIONS
+// ============================================
+
+void NFCJobEngine::runRead(const JobRequest& req, JsonDocument& doc) {
+    NFCManager::TagInfo tagInfo;
+    NFCManager::Result result;
+
+    if (req.type == JOB_SRIX_READ) {
+        result = _nfc.readSRIX(tagInfo, req.timeout_sec);
+    } else if (req.type == JOB_MIFARE_READ_UID) {
+        result = _nfc.readMifareUID(tagInfo, req.timeout_sec);
+    } else {
+        result = _nfc.readMifare(tagInfo, req.timeout_sec);
+    }
+
+    doc["success"] = result.success;
+    doc["message"] = result.message;
+
+    if (!result.success) {
+        LOG_WARN("NFC-JOB", "Read failed: %s", result.message.c_str());
+        return;
+    }
+
+    doc["protocol"] = tagInfo.name();
+    doc["uid"] = _nfc.uidToString(tagInfo.uid, tagInfo.uid_length);
+
+    // UID-only read: no dump data
+    if (req.type == JOB_MIFARE_READ_UID) {
+        return;
+    }
+
+    size_t dumpSize = _nfc.getTagDataSize(tagInfo);
+    doc["size"] = dumpSize;
+
+    if (req.type == JOB_MIFARE_READ) {
+        doc["sectors"] = NFCManager::tagTypeInfo(tagInfo.type).sectors;
+        addKeySearchStats(doc);
+    }
+
+    // Generate hex dump preview (first 64 bytes)
+    const uint8_t* dumpData = _nfc.getTagDataPointer(tagInfo);
+    String dumpHex = "";
+    for (size_t i = 0; i < DUMP_PREVIEW_BYTES && i < dumpSize; i++) {
+        char hex[3];
+        sprintf(hex, "%02X", dumpData[i]);
+        dumpHex += hex;
+    }
+    doc["dump"] = dumpHex;
+}
+
+void NFCJobEngine::runWrite(const JobRequest& req, JsonDocument& doc) {
+    if (!_nfc.hasValidData()) {
+        doc["success"] = false;
+        doc["message"] = "No data to write";
+        doc["code"] = -1;
+        return;
+    }
+
+    // Write uses the dump held by NFCManager (no copy)
+    const NFCManager::TagInfo& tagInfo = _nfc.currentTag();
+    NFCManager::Result result;
+
+    if (req.type == JOB_SRIX_WRITE) {
+        result = _nfc.writeSRIX(tagInfo, req.timeout_sec);
+    } else {
+        result = _nfc.writeMifare(tagInfo, req.timeout_sec);
+    }
+
+    doc["success"] = result.success;
+    doc["message"] = result.message;
+    doc["code"] = result.code;
+
+    if (req.type == JOB_MIFARE_WRITE) {
+        addSectorWriteStats(doc);
+    }
+}
+
+void NFCJobEngine::runCompare(const JobRequest& req, JsonDocument& doc) {
+    if (!_nfc.hasValidData()) {
+        doc["success"] = false;
+        doc["message"] = "No loaded dump to compare";
+        return;
+    }
+
+    // Loaded dump stays current: the tag is read into physicalTag only
+    const NFCManager::TagInfo& loadedTag = _nfc.currentTag();
+    NFCManager::Protocol expected = (req.type == JOB_SRIX_COMPARE) ?
+        NFCManager::PROTOCOL_SRIX : NFCManager::PROTOCOL_MIFARE_CLASSIC;
+    if (loadedTag.protocol != expected) {
+        doc["success"] = false;
+        doc["message"] = "Loaded dump is " + _nfc.protocolToString(loadedTag.protocol);
+        return;
+    }
+
+    NFCManager::TagInfo physicalTag;
+    NFCManager::Result result = _nfc.compareWithTag(physicalTag, req.timeout_sec);
+
+    if (!result.success) {
+        doc["success"] = false;
+        doc["message"] = result.message;
+        if (result.code == -4) {
+            doc["identical"] = false;
+            doc["size_mismatch"] = true;
+        }
+        LOG_WARN("NFC-JOB", "Compare failed: %s", result.message.c_str());
+        return;
+    }
+
+    doc["success"] = true;
+    doc["message"] = "Tag read successfully";
+
+    // Physical tag info
+    doc["physical_uid"] = _nfc.uidToString(physicalTag.uid, physicalTag.uid_length);
+    doc["physical_protocol"] = physicalTag.name();
+
+    // Loaded dump info
+    doc["loaded_uid"] = _nfc.uidToString(loadedTag.uid, loadedTag.uid_length);
+
+    compareTagData(_nfc.getLastDiff(), _nfc.getTagDataPointer(loadedTag),
+                   _nfc.getTagDataPointer(physicalTag), doc);
+
+    LOG_INFO("NFC-JOB", "Compare completed - identical: %d", doc["identical"].as<bool>());
+}
+
+void NFCJobEngine::runWriteSelective(const JobRequest& req, JsonDocument& doc) {
+    if (!_nfc.hasValidData()) {
+        doc["success"] = false;
+        doc["message"] = "No data loaded";
+        doc["code"] = -1;
+        return;
+    }
+
+    // No block list: write what the last compare found
+    if (req.blocks.empty()) {
+        uint16_t count = _nfc.getLastDiff().writableCount();
+        NFCManager::Result result = _nfc.writeChangedBlocks();
+
+        doc["success"] = result.success;
+        doc["message"] = result.message;
+        doc["code"] = result.code;
+        doc["blocks_count"] = result.success ? count : 0;
+        if (req.type == JOB_MIFARE_WRITE_SELECTIVE && count > 0) {
+            addSectorWriteStats(doc);
+        }
+        return;
+    }
+
+    NFCManager::Result result;
+    if (req.type == JOB_SRIX_WRITE_SELECTIVE) {
+        result = _nfc.writeSRIXBlocksSelective(req.blocks);
+    } else {
+        result = _nfc.writeMifareBlocksSelective(req.blocks);
+    }
+
+    doc["success"] = result.success;
+    doc["message"] = result.message;
+    doc["code"] = result.code;
+    doc["blocks_count"] = req.blocks.size();
+
+    if (req.type == JOB_MIFARE_WRITE_SELECTIVE) {
+        addSectorWriteStats(doc);
+    }
+}
+
+void NFCJobEngine::runWriteChanges(const JobRequest& req, JsonDocument& doc) {
+    if (!_nfc.hasValidData()) {
+        doc["success"] = false;
+        doc["message"] = "No data loaded";
+        doc["code"] = -1;
+        return;
+    }
+
+    NFCManager::Protocol expected = (req.type == JOB_SRIX_WRITE_CHANGES) ?
+        NFCManager::PROTOCOL_SRIX : NFCManager::PROTOCOL_MIFARE_CLASSIC;
+    if (_nfc.currentTag().protocol != expected) {
+        doc["success"] = false;
+        doc["message"] = "Loaded dump is " + _nfc.protocolToString(_nfc.currentTag().protocol);
+        doc["code"] = -1;
+        return;
+    }
+
+    // Compare and write in one pass: the block list never leaves the device
+    NFCManager::TagInfo physicalTag;
+    NFCManager::Result result = _nfc.compareWithTag(physicalTag, req.timeout_sec);
+    if (!result.success) {
+        doc["success"] = false;
+        doc["message"] = result.message;
+        doc["code"] = result.code;
+        return;
+    }
+
+    const NFCDumpDiff& diff = _nfc.getLastDiff();
+    uint16_t differences = diff.dirtyCount();
+    uint16_t writable = diff.writableCount();
+    doc["total_differences"] = differences;
+    doc["skipped_protected"] = differences - writable;
+    doc["unread_blocks"] = diff.unknownCount();           // Partial Mifare read: left untouched
+
+    result = _nfc.writeChangedBlocks();
+    doc["success"] = result.success;
+    doc["message"] = result.message;
+    doc["code"] = result.code;
+    doc["blocks_count"] = result.success ? writable : 0;
+    if (req.type == JOB_MIFARE_WRITE_CHANGES && writable > 0) {
+        addSectorWriteStats(doc);
+    }
+
+    LOG_INFO("NFC-JOB", "Write changes: %d differences, %d written",
+             differences, result.success ? writable : 0);
+}
+
+void NFCJobEngine::runClone(const JobRequest& req, JsonDocument& doc) {
+    if (!_nfc.hasValidData()) {
+        doc["success"] = false;
+        doc["message"] = "No UID to clone (load/read first)";
+        doc["code"] = -1;
+        return;
+    }
+
+    NFCManager::Result result = _nfc.cloneMifareUID(_nfc.currentTag(), req.timeout_sec);
+
+    doc["success"] = result.success;
+    doc["message"] = result.message;
+    doc["code"] = result.code;
+}
+
+void NFCJobEngine::runBench(const JobRequest& req, JsonDocument& doc) {
+    NFCBench::Options options = req.bench;
+    options.timeout_sec = req.timeout_sec;
+
+    if (!_bench.run(options, doc)) {
+        LOG_WARN("NFC-JOB", "Benchmark not run: %s", doc["message"].as<const char*>());
+    }
+}
+
+void NFCJobEngine::runBatchScan(const JobRequest& req, JsonDocument& doc) {
+    LedPattern previous = _led ? _led->getCurrentPattern() : LedPattern::OFF;
+    if (_led) {
+        _led->heartbeat();
+    }
+
+    NFCManager::Result result = _nfc.runBatch(req.batch, onBatchEvent, this);
+
+    if (_led) {
+        _led->setPattern(previous);
+    }
+
+    NFCManager::BatchStats stats = _nfc.batchStats();
+    doc["success"] = result.success;
+    doc["message"] = result.message;
+    doc["protocol"] = _nfc.protocolToString(req.batch.protocol);
+    doc["tags"] = stats.tags;
+    doc["saved"] = stats.saved;
+    doc["duplicates"] = stats.duplicates;
+    doc["failed"] = stats.failed;
+    doc["elapsed_ms"] = stats.elapsed_ms;
+    doc["tags_per_min"] = stats.elapsed_ms ? stats.tags * 60000.0f / stats.elapsed_ms : 0.0f;
+}
+
+// ============================================
+// HELPER FUNCTIONS
+// ============================================
+
+int NFCJobEngine::findSlot(uint32_t id) const {
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        if (_jobs[i].state != JOB_STATE_FREE && _jobs[i].id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int NFCJobEngine::allocateSlot() {
+    int oldest_done = -1;
+
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        if (_jobs[i].state == JOB_STATE_FREE) {
+            return i;
+        }
+        if (_jobs[i].state == JOB_STATE_DONE &&
+            (oldest_done < 0 || _jobs[i].finished_at < _jobs[oldest_done].finished_at)) {
+            oldest_done = i;
+        }
+    }
+
+    if (oldest_done >= 0) {
+        LOG_DEBUG("NFC-JOB", "Recycling finished job %u", _jobs[oldest_done].id);
+        recycleResult(_jobs[oldest_done].result_json);
+    }
+
+    return oldest_done;
+}
+
+void NFCJobEngine::recycleResult(String& json) {
+    if (json.length() <= RESULT_KEEP_BYTES) {
+        json = "";              // Keeps the buffer
+        return;
+    }
+
+    // One oversized result (e.g. 4K compare) must not pin its buffer forever
+    json = String();
+    json.reserve(RESULT_RESERVE_BYTES);
+}
+
+void NFCJobEngine::checkHeap() {
+    uint32_t free_heap = ESP.getFreeHeap();
+
+    if (free_heap < HEAP_CRITICAL_THRESHOLD) {
+        LOG_CRITICAL("NFC-JOB", "Free heap critical: %u bytes", free_heap);
+    } else if (free_heap < HEAP_WARNING_THRESHOLD) {
+        LOG_WARN("NFC-JOB", "Free heap low: %u bytes", free_heap);
+    }
+}
+
+void NFCJobEngine::addSectorWriteStats(JsonDocument& doc) {
+    uint8_t count = 0;
+    const MifareTool::SectorWriteStats* stats = _nfc.getMifareWriteStats(count);
+    if (!stats || count == 0) return;
+
+    JsonArray sectors = doc["sectors"].to<JsonArray>();
+    for (uint8_t i = 0; i < count; i++) {
+        JsonObject entry = sectors.add<JsonObject>();
+        entry["sector"] = stats[i].sector;
+        entry["written"] = stats[i].written;
+        entry["skipped"] = stats[i].skipped;
+        entry["elapsed_us"] = stats[i].elapsed_us;
+        entry["result"] = stats[i].result;
+    }
+}
+
+void NFCJobEngine::addKeySearchStats(JsonDocument& doc) {
+    const MifareTool::KeySearchStats* stats = _nfc.getMifareKeyStats();
+    if (!stats) return;
+
+    JsonObject keys = doc["keys"].to<JsonObject>();
+    keys["tried"] = stats->keys_tried;
+    keys["tried_total"] = stats->plan_keys_tried;
+    keys["elapsed_ms"] = stats->elapsed_ms;
+    keys["per_sec"] = stats->keys_per_sec;
+    keys["readers"] = stats->readers;
+    keys["sectors_local"] = stats->sectors_local;
+    keys["sectors_remote"] = stats->sectors_remote;
+}
+
+void NFCJobEngine::compareTagData(
+    const NFCDumpDiff& diff,
+    const uint8_t* loadedData,
+    const uint8_t* physicalData,
+    JsonDocument& responseDoc)
+{
+    uint8_t block_size = diff.blockSize();
+    bool is_mifare = (block_size == NFCManager::MIFARE_BLOCK_SIZE);
+
+    // Array of differences: only dirty blocks are visited
+    JsonArray differences = responseDoc["differences"].to<JsonArray>();
+
+    for (int16_t block = diff.nextDirty(0); block >= 0; block = diff.nextDirty(block + 1)) {
+        JsonObject entry = differences.add<JsonObject>();
+        entry["block"] = block;
+
+        // Hex with spaces between bytes
+        char loadedHex[NFCManager::MIFARE_BLOCK_SIZE * 3];
+        char physicalHex[NFCManager::MIFARE_BLOCK_SIZE * 3];
+        const uint8_t* loaded = loadedData + block * block_size;
+        const uint8_t* physical = physicalData + block * block_size;
+        for (uint8_t b = 0; b < block_size; b++) {
+            snprintf(loadedHex + b * 3, 4, b < block_size - 1 ? "%02X " : "%02X", loaded[b]);
+            snprintf(physicalHex + b * 3, 4, b < block_size - 1 ? "%02X " : "%02X", physical[b]);
+        }
+        entry["loaded"] = loadedHex;
+        entry["physical"] = physicalHex;
+
+        // Protected blocks are reported but skipped by write-selective
+        if (is_mifare && diff.isProtected(block)) {
+            entry["warning"] = (block == 0) ? "Block 0 (UID) - will be skipped" :
+                                              "Sector trailer (keys) - will be skipped";
+        }
+
+        LOG_DEBUG("NFC-JOB", "Block %d different: %s -> %s%s",
+                 block, physicalHex, loadedHex,
+                 diff.isProtected(block) ? " [PROTECTED]" : "");
+    }
+
+    uint16_t totalDifferences = diff.dirtyCount();
+    responseDoc["identical"] = (totalDifferences == 0 && !diff.partial());
+    responseDoc["partial"] = diff.partial();
+    responseDoc["unread_blocks"] = diff.unknownCount();
+    responseDoc["total_differences"] = totalDifferences;
+    responseDoc["writable_blocks"] = diff.writableCount();
+    responseDoc["total_blocks"] = diff.blockCount();
+    responseDoc["block_size"] = block_size;
+    responseDoc["dirty_bitmap"] = diff.bitmapToHex();
+
+    if (totalDifferences == 0) {
+        LOG_INFO("NFC-JOB", "Tags are identical (%d blocks)", diff.blockCount());
+    } else {
+        LOG_INFO("NFC-JOB", "Tags differ: %d/%d blocks different",
+                totalDifferences, diff.blockCount());
+    }
+}
@@ -0,0 +1,429 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include <atomic>
+#include <esp_task_wdt.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "modules/rfid/nfc_manager.h"
+#include "modules/rfid/nfc_progress.h"
+#include "modules/bench/nfc_bench.h"
+#include "modules/led/led_manager.h"
+#include "json_arena.h"
+#include "logger.h"
+
+/**
+ * @brief NFCJobEngine - Persistent NFC worker with a FIFO job queue
+ *
+ * Architecture:
+ * - One engine per reader: a long-lived FreeRTOS task, pinned to the
+ *   reader's core (NFCReaderConfig::core), owns that PN532 for web jobs
+ * - Engines of different readers run jobs in parallel; job ids are unique
+ *   across engines, and a job may take its data from another reader's
+ *   current tag (JobRequest::source: read on one reader, write on the other)
+ * - Web handlers submit a job and return immediately with a job id
+ * - Clients poll the job table for state and the final JSON result
+ * - Optional event sink receives job state changes and NFC progress
+ *   (per-block/per-sector, Mifare auth results) for a push channel
+ * - Batch scan jobs hold the worker until NFCManager::stopBatch() (or a
+ *   stop condition); other jobs queue behind them. Per-tag results go to
+ *   the sink as "batch" events, with LED feedback when a LedManager is set
+ * - Nothing in the AsyncTCP callbacks waits on NFC hardware anymore
+ *
+ * Memory:
+ * - Worker stack, TCB, queue and mutex are members, handed to the
+ *   *CreateStatic* APIs in begin(); the web handler keeps its engines in
+ *   static storage, so none of this comes from the heap
+ * - Result documents use a preallocated JsonArena; result strings and
+ *   block lists keep their capacity across jobs
+ * - Event payloads are formatted into stack buffers (no JsonDocument)
+ * - After the first jobs have sized the buffers, running a job does not
+ *   touch the heap beyond transient Result messages
+ *
+ * Job Lifecycle:
+ *   FREE → QUEUED (submit) → RUNNING (worker) → DONE (result stored)
+ *   DONE slots are recycled oldest-first when the table is full.
+ *
+ * Thread Safety:
+ * - Job table is guarded by a FreeRTOS mutex
+ * - Results are stored pre-serialized so readers only copy a String
+ *
+ * Usage:
+ * @code
+ * NFCJobEngine jobs(nfcMgr);
+ * jobs.begin();
+ * NFCJobEngine::JobRequest req = {NFCJobEngine::JOB_SRIX_READ, 10, {}};
+ * uint32_t id = jobs.submit(req);
+ * JsonDocument status;
+ * String result;
+ * jobs.getJob(id, status, result);
+ * @endcode
+ */
+class NFCJobEngine {
+public:
+    // ============================================
+    // TYPES
+    // ============================================
+
+    /**
+     * @brief Supported NFC job types
+     */
+    enum JobType : uint8_t {
+        JOB_SRIX_READ = 0,
+        JOB_SRIX_WRITE,
+        JOB_SRIX_COMPARE,
+        JOB_SRIX_WRITE_SELECTIVE,
+        JOB_MIFARE_READ,
+        JOB_MIFARE_READ_UID,
+        JOB_MIFARE_WRITE,
+        JOB_MIFARE_CLONE,
+        JOB_MIFARE_COMPARE,
+        JOB_MIFARE_WRITE_SELECTIVE,
+        JOB_SRIX_WRITE_CHANGES,         ///< Compare + write changed blocks in one job
+        JOB_MIFARE_WRITE_CHANGES,       ///< Compare + write changed blocks in one job
+        JOB_BENCH,                      ///< Benchmark run (NFCBench)
+        JOB_BATCH_SCAN,                 ///< Continuous scan/save loop (NFCManager::runBatch)
+        JOB_TYPE_COUNT
+    };
+
+    /**
+     * @brief Job slot state
+     */
+    enum JobState : uint8_t {
+        JOB_STATE_FREE = 0,     ///< Slot unused
+        JOB_STATE_QUEUED,       ///< Waiting for worker
+        JOB_STATE_RUNNING,      ///< Worker executing
+        JOB_STATE_DONE          ///< Result available
+    };
+
+    /**
+     * @brief Job submission parameters
+     */
+    struct JobRequest {
+        JobType type;                   ///< Operation to perform
+        int timeout_sec;                ///< Tag detection timeout (seconds)
+        std::vector<uint8_t> blocks;    ///< Block list (selective writes; empty = last compare's dirty blocks)
+        NFCBench::Options bench = {};   ///< Scenarios/iterations (JOB_BENCH only)
+        NFCManager::BatchOptions batch = {};  ///< Protocol/dedupe/format (JOB_BATCH_SCAN only)
+        NFCJobEngine* source = nullptr; ///< Copy this reader's current tag first (nullptr = own)
+    };
+
+    /**
+     * @brief Event sink for push notifications
+     * @param event Event name: "job", "progress", "auth" or "batch"
+     * @param json Serialized JSON payload (valid during the call only)
+     * @param context Opaque pointer given to setEventSink()
+     *
+     * Called from the worker task (progress, job start/done) and from
+     * submit() (job queued). Must not block.
+     */
+    typedef void (*EventSink)(const char* event, const char* json, void* context);
+
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr uint8_t MAX_JOBS = 6;                     // Job table slots (queued + finished)
+    static constexpr uint32_t WORKER_STACK_SIZE = 16384;       // 16KB
+    static constexpr uint8_t WORKER_PRIORITY = 1;              // FreeRTOS task priority
+    static constexpr TickType_t LOCK_TIMEOUT_TICKS = pdMS_TO_TICKS(100); // Mutex wait for readers
+    static constexpr size_t DUMP_PREVIEW_BYTES = 64;           // First 64 bytes for preview
+    static constexpr uint32_t INVALID_JOB_ID = 0;              // Returned when submit fails
+    static constexpr uint32_t PROGRESS_MIN_INTERVAL_MS = 150;  // Block progress throttle for sink
+    static constexpr size_t RESULT_ARENA_SIZE = 12288;         // 12KB: Mifare 1K compare fits
+    static constexpr size_t RESULT_RESERVE_BYTES = 1024;       // Initial capacity per stored result
+    static constexpr size_t RESULT_KEEP_BYTES = 4096;          // Larger result buffers are released
+    static constexpr size_t MAX_BLOCK_LIST = 256;              // Mifare 4K block count
+    static constexpr size_t EVENT_BUFFER_SIZE = 192;           // Progress/auth/job event payload
+    static constexpr size_t BATCH_EVENT_SIZE = 320;            // Batch event payload (path + UID)
+
+    // ============================================
+    // PUBLIC METHODS
+    // ============================================
+
+    /**
+     * @brief Construct job engine
+     * @param nfc Reference to NFCManager used by the worker
+     */
+    explicit NFCJobEngine(NFCManager& nfc);
+
+    /**
+     * @brief Create job queue, mutex and worker task (static storage)
+     * @return true if worker is running
+     *
+     * The worker is pinned to the reader's core. Also reserves the
+     * per-slot result and block list buffers.
+     */
+    bool begin();
+
+    /**
+     * @brief Queue a job for the worker
+     * @param req Job parameters
+     * @return Job id (>0) or INVALID_JOB_ID if the table/queue is full
+     *
+     * Never blocks: safe to call from AsyncTCP callbacks.
+     */
+    uint32_t submit(const JobRequest& req);
+
+    /**
+     * @brief Fill JSON document with job status, copy out the result
+     * @param id Job id returned by submit()
+     * @param out Output document: {job_id, reader, type, state, elapsed_ms}
+     * @param result Serialized result when DONE, empty otherwise
+     * @return false if job id is unknown (never existed or recycled)
+     *
+     * The result stays pre-serialized so callers can stream it as a raw
+     * "result" member instead of copying it through a JsonDocument.
+     */
+    bool getJob(uint32_t id, JsonDocument& out, String& result);
+
+    /**
+     * @brief Check if a job is queued or running
+     * @return true if worker has pending work
+     */
+    bool isBusy();
+
+    /**
+     * @brief Copy the current tag into another reader's manager
+     * @param target Manager of the reader that runs the job
+     * @return false if a job is queued/running here or no dump is loaded
+     *
+     * Copies under the table lock, so this worker cannot start a job that
+     * replaces the dump halfway through.
+     */
+    bool copyCurrentTagTo(NFCManager& target);
+
+    /**
+     * @brief Install push event sink (nullptr to remove)
+     * @param sink Callback receiving job/progress/auth events
+     * @param context Opaque pointer passed back to sink
+     */
+    void setEventSink(EventSink sink, void* context);
+
+    /**
+     * @brief LED used for batch scan feedback (nullptr: none)
+     *
+     * Waiting: heartbeat, saved: double blink, duplicate: triple blink,
+     * failure: fast blink. The previous pattern is restored afterwards.
+     */
+    void setLedManager(LedManager* led) { _led = led; }
+
+    /**
+     * @brief Convert job type to API string (e.g. "srix_read")
+     */
+    static const char* typeToString(JobType type);
+
+    /**
+     * @brief Parse API job type string
+     * @param name Type string (e.g. "mifare_write")
+     * @param type Output job type
+     * @return true if name is a known job type
+     */
+    static bool typeFromString(const String& name, JobType& type);
+
+    /**
+     * @brief Convert job state to API string (e.g. "running")
+     */
+    static const char* stateToString(JobState state);
+
+    /**
+     * @brief NFC manager (reader) this engine's worker drives
+     */
+    NFCManager& nfc() const { return _nfc; }
+
+    /**
+     * @brief Result arena of the worker (fill level, peak, heap fallbacks)
+     */
+    const JsonArena& resultArena() const { return _arena; }
+
+    /**
+     * @brief Bytes of static storage held by the engine (stack, arena, table)
+     */
+    static constexpr size_t staticFootprint() { return sizeof(NFCJobEngine); }
+
+private:
+    // ============================================
+    // JOB SLOT
+    // ============================================
+
+    struct Job {
+        uint32_t id;                    // Unique job id (0 = none)
+        JobState state;                 // Current state
+        JobRequest request;             // Submitted parameters
+        unsigned long queued_at;        // millis() at submit
+        unsigned long started_at;       // millis() when worker picked it up
+        unsigned long finished_at;      // millis() when result stored
+        String result_json;             // Serialized result (valid when DONE)
+    };
+
+    // ============================================
+    // MEMBER VARIABLES
+    // ============================================
+
+    NFCManager& _nfc;                   // Reference to NFC manager
+    Job _jobs[MAX_JOBS];                // Job table
+    QueueHandle_t _queue;               // Slot indexes waiting for worker
+    SemaphoreHandle_t _lock;            // Guards _jobs
+    TaskHandle_t _worker;               // Worker task handle
+    EventSink _sink;                    // Push channel (nullptr = none)
+    void* _sink_context;                // Sink context
+    volatile uint32_t _running_id;      // Job currently on the worker (0 = none)
+    unsigned long _last_progress_ms;    // Last forwarded block event (throttle)
+    LedManager* _led;                   // Batch scan feedback (nullptr = none)
+
+    // Static pools (no heap for the worker's lifetime)
+    StackType_t _stack[WORKER_STACK_SIZE];          // Worker stack (bytes on ESP-IDF)
+    StaticTask_t _task_buffer;                      // Worker TCB
+    uint8_t _queue_storage[MAX_JOBS];               // One slot index per job
+    StaticQueue_t _queue_buffer;                    // Queue control block
+    StaticSemaphore_t _lock_buffer;                 // Mutex control block
+    StaticJsonArena<RESULT_ARENA_SIZE> _arena;      // Result documents (worker only)
+    JobRequest _active;                             // Running job (capacity kept)
+    String _result;                                 // Running job's serialized result
+    String _done_event;                             // "job" done payload (result embedded)
+    NFCBench _bench;                                // Benchmark runner (JOB_BENCH)
+
+    static std::atomic<uint32_t> _next_id;          // Next job id (shared by all readers)
+
+    // ============================================
+    // WORKER
+    // ============================================
+
+    /**
+     * @brief FreeRTOS entry point (parameter = NFCJobEngine*)
+     */
+    static void workerTask(void* parameter);
+
+    /**
+     * @brief Worker main loop: wait on queue, execute, store result
+     */
+    void workerLoop();
+
+    /**
+     * @brief Run one job and populate its JSON result
+     * @param req Job parameters
+     * @param doc Output result document (same shape as the legacy endpoints)
+     */
+    void execute(const JobRequest& req, JsonDocument& doc);
+
+    /**
+     * @brief Check the table for QUEUED/RUNNING jobs (caller holds _lock)
+     */
+    bool hasPendingJob() const;
+
+    // ============================================
+    // PUSH EVENTS
+    // ============================================
+
+    /**
+     * @brief NFCProgress listener (parameter = NFCJobEngine*)
+     *
+     * Tags events with the running job id and reader, forwards them to the
+     * sink. Events from other tasks (other readers' workers) are dropped.
+     * Successful block events are throttled to PROGRESS_MIN_INTERVAL_MS.
+     */
+    static void onProgress(const NFCProgress::Event& event, void* context);
+
+    /**
+     * @brief NFCManager batch listener (parameter = NFCJobEngine*)
+     *
+     * Forwards every tag as a "batch" event and drives the LED.
+     */
+    static void onBatchEvent(const NFCManager::BatchEvent& event, void* context);
+
+    /**
+     * @brief Send a "job" event to the sink
+     * @param id Job id
+     * @param type Job type
+     * @param state New state
+     * @param result_json Serialized result (DONE only, may be nullptr)
+     *
+     * With a result the payload is assembled in _done_event, so only the
+     * worker may pass one.
+     */
+    void publishJob(uint32_t id, JobType type, JobState state, const char* result_json);
+
+    // ============================================
+    // JOB IMPLEMENTATIONS
+    // ============================================
+
+    void runRead(const JobRequest& req, JsonDocument& doc);
+    void runWrite(const JobRequest& req, JsonDocument& doc);
+    void runCompare(const JobRequest& req, JsonDocument& doc);
+    void runWriteSelective(const JobRequest& req, JsonDocument& doc);
+    void runWriteChanges(const JobRequest& req, JsonDocument& doc);
+    void runClone(const JobRequest& req, JsonDocument& doc);
+    void runBench(const JobRequest& req, JsonDocument& doc);
+    void runBatchScan(const JobRequest& req, JsonDocument& doc);
+
+    // ============================================
+    // HELPER FUNCTIONS
+    // ============================================
+
+    /**
+     * @brief Find slot index by job id (caller must hold _lock)
+     * @return Slot index or -1
+     */
+    int findSlot(uint32_t id) const;
+
+    /**
+     * @brief Pick a free slot, recycling the oldest DONE one (caller must hold _lock)
+     * @return Slot index or -1 if all slots are queued/running
+     */
+    int allocateSlot();
+
+    /**
+     * @brief Empty a result buffer for reuse
+     *
+     * Keeps the allocation unless it grew past RESULT_KEEP_BYTES, in
+     * which case it is released and re-reserved at RESULT_RESERVE_BYTES.
+     */
+    static void recycleResult(String& json);
+
+    /**
+     * @brief Log free heap after a job against HEAP_WARNING/CRITICAL_THRESHOLD
+     */
+    static void checkHeap();
+
+    /**
+     * @brief Add per-sector results of the last Mifare write
+     * @param doc Job result document
+     *
+     * Adds sectors: array of {sector, written, skipped, elapsed_us, result}.
+     */
+    void addSectorWriteStats(JsonDocument& doc);
+
+    /**
+     * @brief Add key search totals of the last full Mifare read
+     * @param doc Job result document
+     *
+     * Adds keys: {tried, tried_total, elapsed_ms, per_sec, readers,
+     * sectors_local, sectors_remote}. tried_total and per_sec count
+     * every reader that shared the card.
+     */
+    void addKeySearchStats(JsonDocument& doc);
+
+    /**
+     * @brief Report a compare result from its dirty-block bitmap
+     * @param diff Diff computed by NFCManager::compareWithTag()
+     * @param loadedData Pointer to loaded dump data
+     * @param physicalData Pointer to physical tag data
+     * @param responseDoc JSON document to populate with results
+     *
+     * Populates responseDoc with:
+     * - identical: boolean
+     * - total_blocks, block_size, total_differences, writable_blocks: number
+     * - dirty_bitmap: hex, 1 bit per block (block 0 = LSB of first byte)
+     * - differences: array of {block, loaded, physical, warning?}
+     *
+     * Only dirty blocks are visited (bitmap scan), none are re-compared.
+     */
+    void compareTagData(
+        const NFCDumpDiff& diff,
+        const uint8_t* loadedData,
+        const uint8_t* physicalData,
+        JsonDocument& responseDoc);
+};
@@ -0,0 +1,28 @@
+#include "web_assets.h"
+
+void WebAssets::send(AsyncWebServerRequest* request, const char* content_type,
+                     const uint8_t* data, size_t size, const char* etag, const char* hash) {
+    const char* cache = isVersioned(request, hash) ? CACHE_IMMUTABLE : CACHE_REVALIDATE;
+
+    // Header may hold a list or a weak validator: W/"...", "..."
+    if (request->hasHeader("If-None-Match") &&
+        request->header("If-None-Match").indexOf(etag) >= 0) {
+        LOG_DEBUG("WEB", "304 Not Modified: %s", request->url().c_str());
+        AsyncWebServerResponse* res = request->beginResponse(HTTP_NOT_MODIFIED);
+        res->addHeader("ETag", etag);
+        res->addHeader("Cache-Control", cache);
+        request->send(res);
+        return;
+    }
+
+    AsyncWebServerResponse* res = request->beginResponse(HTTP_OK, content_type, data, size);
+    res->addHeader("Content-Encoding", "gzip");
+    res->addHeader("ETag", etag);
+    res->addHeader("Cache-Control", cache);
+    request->send(res);
+}
+
+bool WebAssets::isVersioned(AsyncWebServerRequest* request, const char* hash) {
+    // A stale ?v= must not be pinned for a year under the new content
+    return hash && request->hasParam("v") && request->getParam("v")->value() == hash;
+}
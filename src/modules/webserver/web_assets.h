@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "logger.h"
+
+/**
+ * @brief WebAssets - Serve the gzipped PROGMEM assets with HTTP caching
+ *
+ * Features:
+ * - ETag per asset (content hash emitted by gen_webfiles.py)
+ * - If-None-Match answered with 304, no body sent
+ * - Versioned URLs (?v=<hash>, rewritten into the pages at build time)
+ *   are cached as immutable; unversioned requests revalidate every time
+ *
+ * Usage:
+ * @code
+ * WebAssets::send(request, "text/css", style_web, style_web_size,
+ *                 style_web_etag, style_web_hash);
+ * @endcode
+ */
+class WebAssets {
+public:
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr int HTTP_OK = 200;
+    static constexpr int HTTP_NOT_MODIFIED = 304;
+    static constexpr const char* CACHE_IMMUTABLE = "max-age=31536000, immutable";
+    static constexpr const char* CACHE_REVALIDATE = "no-cache";  // Always revalidate (304)
+
+    /**
+     * @brief Send an asset, or 304 if the client copy is current
+     * @param request HTTP request
+     * @param content_type MIME type
+     * @param data Gzipped asset (PROGMEM)
+     * @param size Asset size
+     * @param etag Quoted ETag
+     * @param hash URL version hash (nullptr: asset is never versioned, e.g. pages)
+     */
+    static void send(AsyncWebServerRequest* request, const char* content_type,
+                     const uint8_t* data, size_t size, const char* etag, const char* hash = nullptr);
+
+private:
+    static bool isVersioned(AsyncWebServerRequest* request, const char* hash);
+};
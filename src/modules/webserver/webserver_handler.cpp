@@ -2,15 +2,26 @@
 #include "webFiles.h"
 #include "modules/wifi/wifi_manager.h"
 #include "webserver_handler_nfc.h"
+#include "zip_stream.h"
+#include "web_assets.h"
+#include "json_response.h"
+#include "modules/boot/boot_profile.h"
+#include <stage_metrics.h>
 #include <LittleFS.h>
 #include <ArduinoJson.h>
+#include <memory>
+#include <new>
+
+// NFC handler (job engine with worker stack and arenas) in .bss, not one
+// large heap block at boot
+alignas(WebServerHandlerNFC) static uint8_t s_nfc_handler_storage[sizeof(WebServerHandlerNFC)];
 
 // ============================================
 // CONSTRUCTOR
 // ============================================
 
 WebServerHandler::WebServerHandler(AsyncWebServer& server, WiFiManager& wifiMgr, NFCManager& nfc)
-    : _server(server), _wifiMgr(wifiMgr), _nfc(nfc), _nfcHandler(nullptr) 
+    : _server(server), _wifiMgr(wifiMgr), _nfc(nfc), _nfcHandler(nullptr), _logEvents("/api/logs")
 {
     LOG_DEBUG("WEB", "WebServerHandler instance created");
 }
@@ -26,19 +37,33 @@ void WebServerHandler::begin() {
     setupRoutes();
     
     // Initialize NFC-specific routes (separate module)
-    _nfcHandler = new WebServerHandlerNFC(_server, _nfc, _loginHandler);
-    if (_nfcHandler) {
+    if (!_nfcHandler) {
+        _nfcHandler = new (s_nfc_handler_storage) WebServerHandlerNFC(_server, _nfc, _loginHandler);
         _nfcHandler->setupRoutes();
         LOG_DEBUG("WEB", "NFC routes registered");
-    } else {
-        LOG_ERROR("WEB", "Failed to allocate NFC handler");
     }
     
-    // Start AsyncWebServer
+    LOG_INFO("WEB", "Routes registered, waiting for network");
+}
+
+void WebServerHandler::listen() {
+    if (_listening) {
+        return;
+    }
+
     _server.begin();
+    _listening = true;
     LOG_INFO("WEB", "Web server started on port %d", WEB_SERVER_PORT);
 }
 
+bool WebServerHandler::addReader(NFCManager& nfc) {
+    return _nfcHandler ? _nfcHandler->addReader(nfc) : false;
+}
+
+NFCJobEngine* WebServerHandler::jobs(uint8_t reader) {
+    return _nfcHandler ? _nfcHandler->jobs(reader) : nullptr;
+}
+
 // ============================================
 // ROUTE REGISTRATION
 // ============================================
@@ -50,16 +75,12 @@ void WebServerHandler::setupRoutes() {
     
     _server.on("/style.css", HTTP_GET, [](AsyncWebServerRequest *request) {
         LOG_DEBUG("WEB", "Serving style.css (gzipped)");
-        auto *res = request->beginResponse(HTTP_OK, "text/css", style_web, style_web_size);
-        res->addHeader("Content-Encoding", "gzip");
-        request->send(res);
+        WebAssets::send(request, "text/css", style_web, style_web_size, style_web_etag, style_web_hash);
     });
 
     _server.on("/app.js", HTTP_GET, [](AsyncWebServerRequest *request) {
         LOG_DEBUG("WEB", "Serving app.js (gzipped)");
-        auto *res = request->beginResponse(HTTP_OK, "application/javascript", app_web, app_web_size);
-        res->addHeader("Content-Encoding", "gzip");
-        request->send(res);
+        WebAssets::send(request, "application/javascript", app_web, app_web_size, app_web_etag, app_web_hash);
     });
 
     // ===== AUTHENTICATION ROUTES =====
@@ -87,9 +108,7 @@ void WebServerHandler::setupRoutes() {
         }
 
         LOG_DEBUG("WEB", "Serving main page (index.html)");
-        auto *res = request->beginResponse(HTTP_OK, "text/html", index_web, index_web_size);
-        res->addHeader("Content-Encoding", "gzip");
-        request->send(res);
+        WebAssets::send(request, "text/html", index_web, index_web_size, index_web_etag);
     });
 
     // ===== FILE EDITOR API (PROTECTED) =====
@@ -104,15 +123,38 @@ void WebServerHandler::setupRoutes() {
         handleReadFile(request);
     });
 
-    // PUT /api/files/update - Update file content from editor
-    _server.on("/api/files/update", HTTP_PUT, [this](AsyncWebServerRequest *request) {
-        if (!_loginHandler.isAuthenticated(request)) {
-            LOG_WARN("WEB", "Unauthorized access to /api/files/update");
-            request->send(HTTP_UNAUTHORIZED, "application/json", "{\"error\":\"Unauthorized\"}");
-            return;
+    // PUT /api/files/update?path= - Update file content from editor (raw body, streamed)
+    _server.on("/api/files/update", HTTP_PUT,
+        // Final callback - called after the whole body was written
+        [this](AsyncWebServerRequest *request) {
+            if (!_loginHandler.isAuthenticated(request)) {
+                LOG_WARN("WEB", "Unauthorized access to /api/files/update");
+                request->send(HTTP_UNAUTHORIZED, "application/json", "{\"error\":\"Unauthorized\"}");
+                return;
+            }
+            handleUpdateFile(request);
+        },
+        nullptr,
+        // Body callback - called for each body chunk
+        [this](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            if (!_loginHandler.isAuthenticated(request)) {
+                return;
+            }
+            if (index == 0) {
+                if (!request->hasParam("path", false)) {
+                    setUploadResult(request, HTTP_BAD_REQUEST, "Missing path parameter");
+                    return;
+                }
+                String path = request->getParam("path", false)->value();
+                if (!path.startsWith("/")) path = "/" + path;
+                beginUpload(request, path, total);
+            }
+            writeUpload(request, data, len);
+            if (index + len >= total) {
+                endUpload(request);
+            }
         }
-        handleUpdateFile(request);
-    });
+    );
 
     // ===== FILE MANAGER API (PROTECTED) =====
     
@@ -180,7 +222,11 @@ void WebServerHandler::setupRoutes() {
     _server.on("/upload", HTTP_POST,
         // Final callback - called after all chunks received
         [this](AsyncWebServerRequest *request) {
-            request->send(HTTP_OK, "application/json", "{\"success\":true}");
+            if (!_loginHandler.isAuthenticated(request)) {
+                request->send(HTTP_UNAUTHORIZED, "application/json", "{\"error\":\"Unauthorized\"}");
+                return;
+            }
+            sendUploadResult(request);
         },
         // Chunk callback - called for each data chunk
         [this](AsyncWebServerRequest *request, String filename, size_t index,
@@ -206,6 +252,27 @@ void WebServerHandler::setupRoutes() {
         handleStatus(request);
     });
 
+    // GET /api/metrics - Per-stage timing histograms and boot timings (?reset=1 clears histograms)
+    _server.on("/api/metrics", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (!_loginHandler.isAuthenticated(request)) {
+            LOG_WARN("WEB", "Unauthorized access to /api/metrics");
+            request->send(HTTP_UNAUTHORIZED, "application/json", "{\"error\":\"Unauthorized\"}");
+            return;
+        }
+        handleMetrics(request);
+    });
+
+    // GET /api/logs - Live log stream (Server-Sent Events, event "log")
+    _logEvents.setFilter([this](AsyncWebServerRequest *request) {
+        if (!_loginHandler.isAuthenticated(request)) {
+            LOG_WARN("WEB", "Unauthorized access to /api/logs");
+            return false;
+        }
+        return true;
+    });
+    _server.addHandler(&_logEvents);
+    Logger::setStreamSink(onLogLine, this);
+
     // POST /api/wifi/add - Add WiFi credentials
     _server.on("/api/wifi/add", HTTP_POST, [this](AsyncWebServerRequest *request) {
         if (!_loginHandler.isAuthenticated(request)) {
@@ -256,6 +323,26 @@ void WebServerHandler::setupRoutes() {
         handleBackup(request);
     });
 
+    // POST /api/restore - Restore backup ZIP (multipart/form-data, unpacked while streaming)
+    _server.on("/api/restore", HTTP_POST,
+        [this](AsyncWebServerRequest *request) {
+            if (!_loginHandler.isAuthenticated(request)) {
+                LOG_WARN("WEB", "Unauthorized access to /api/restore");
+                request->send(HTTP_UNAUTHORIZED, "application/json", "{\"error\":\"Unauthorized\"}");
+                return;
+            }
+            sendUploadResult(request);
+        },
+        [this](AsyncWebServerRequest *request, String filename, size_t index,
+               uint8_t *data, size_t len, bool final) {
+            if (!_loginHandler.isAuthenticated(request)) {
+                LOG_WARN("WEB", "Unauthorized restore attempt");
+                return;
+            }
+            handleRestore(request, index, data, len, final);
+        }
+    );
+
     // ===== 404 HANDLER =====
     _server.onNotFound([](AsyncWebServerRequest *request) {
         LOG_WARN("WEB", "404 Not Found: %s", request->url().c_str());
@@ -277,9 +364,7 @@ void WebServerHandler::handleLoginPage(AsyncWebServerRequest *request) {
     }
 
     LOG_DEBUG("WEB", "Serving login page");
-    auto *res = request->beginResponse(HTTP_OK, "text/html", login_web, login_web_size);
-    res->addHeader("Content-Encoding", "gzip");
-    request->send(res);
+    WebAssets::send(request, "text/html", login_web, login_web_size, login_web_etag);
 }
 
 void WebServerHandler::handleLoginPost(AsyncWebServerRequest *request) {
@@ -343,12 +428,12 @@ void WebServerHandler::handleListFiles(AsyncWebServerRequest *request) {
     }
 
     LOG_DEBUG("WEB", "Listing files in: %s", path.c_str());
-    String json = listDirectoryJson(path);
-    request->send(HTTP_OK, "application/json", json);
+    JsonDocument doc;
+    listDirectory(path, doc);
+    JsonResponse::send(request, HTTP_OK, doc);
 }
 
-String WebServerHandler::listDirectoryJson(const String& path) {
-    JsonDocument doc;
+void WebServerHandler::listDirectory(const String& path, JsonDocument& doc) {
     JsonArray files = doc["files"].to<JsonArray>();
 
     // Open directory in read mode
@@ -359,10 +444,7 @@ String WebServerHandler::listDirectoryJson(const String& path) {
         // Return empty list with storage info
         doc["total"] = LittleFS.totalBytes();
         doc["used"] = LittleFS.usedBytes();
-        
-        String output;
-        serializeJson(doc, output);
-        return output;
+        return;
     }
 
     LOG_DEBUG("WEB", "Scanning directory: %s", path.c_str());
@@ -403,13 +485,7 @@ String WebServerHandler::listDirectoryJson(const String& path) {
     doc["total"] = LittleFS.totalBytes();
     doc["used"] = LittleFS.usedBytes();
 
-    // Pre-allocate memory to avoid reallocation
-    String output;
-    output.reserve(files.size() * 80 + 100);
-    serializeJson(doc, output);
-
-    LOG_DEBUG("WEB", "Listed %d files, JSON size: %d bytes", files.size(), output.length());
-    return output;
+    LOG_DEBUG("WEB", "Listed %d files", files.size());
 }
 
 void WebServerHandler::handleCreateFile(AsyncWebServerRequest *request) {
@@ -447,6 +523,7 @@ void WebServerHandler::handleCreateFile(AsyncWebServerRequest *request) {
     }
 
     file.close();
+    _nfc.onFileChanged(filename);
     LOG_INFO("WEB", "File created successfully: %s", filename.c_str());
     request->send(HTTP_OK, "application/json", "{\"success\":true}");
 }
@@ -496,6 +573,7 @@ void WebServerHandler::handleDeleteFile(AsyncWebServerRequest *request) {
 
     // Try to remove as file first
     if (LittleFS.remove(path)) {
+        _nfc.onFileRemoved(path);
         LOG_INFO("WEB", "File deleted successfully: %s", path.c_str());
         request->send(HTTP_OK, "application/json", "{\"success\":true}");
         return;
@@ -503,6 +581,7 @@ void WebServerHandler::handleDeleteFile(AsyncWebServerRequest *request) {
 
     // If failed, try to remove as directory
     if (LittleFS.rmdir(path)) {
+        _nfc.onFileRemoved(path);
         LOG_INFO("WEB", "Directory deleted successfully: %s", path.c_str());
         request->send(HTTP_OK, "application/json", "{\"success\":true}");
         return;
@@ -544,6 +623,7 @@ void WebServerHandler::handleRenameFile(AsyncWebServerRequest *request) {
     LOG_INFO("WEB", "Renaming: %s -> %s", oldPath.c_str(), newPath.c_str());
 
     if (LittleFS.rename(oldPath, newPath)) {
+        _nfc.onFileRenamed(oldPath, newPath);
         LOG_INFO("WEB", "Rename successful");
         request->send(HTTP_OK, "application/json", "{\"success\":true}");
     } else {
@@ -600,31 +680,254 @@ void WebServerHandler::handleUpload(AsyncWebServerRequest *request, String filen
         String fullPath = targetPath + filename;
         LOG_INFO("WEB", "Upload started: %s", fullPath.c_str());
 
-        _uploadFile = LittleFS.open(fullPath, FILE_WRITE);
-        if (!_uploadFile) {
-            LOG_ERROR("WEB", "Failed to open file for upload: %s", fullPath.c_str());
+        beginUpload(request, fullPath, request->contentLength());
+    }
+
+    // Write data chunk straight to flash
+    writeUpload(request, data, len);
+
+    // Final chunk - close file
+    if (final) {
+        endUpload(request);
+        LOG_INFO("WEB", "Upload complete: %s (%d bytes total)", filename.c_str(), index + len);
+    }
+}
+
+void WebServerHandler::handleRestore(AsyncWebServerRequest *request, size_t index,
+                                     uint8_t *data, size_t len, bool final) {
+    if (index == 0) {
+        LOG_INFO("WEB", "Backup restore started (%d bytes)", request->contentLength());
+
+        if (!claimUpload(request)) {
+            setUploadResult(request, HTTP_CONFLICT, "Another upload is in progress");
             return;
         }
+
+        // The catalog is derived data: rebuilt entry by entry as dumps land
+        _upload.restore = new ZipRestore("/", NFC_CATALOG_FILE);
+        _upload.restore->onFile([this](const String& path) {
+            _nfc.onFileChanged(path);
+        });
+    }
+
+    writeUpload(request, data, len);
+
+    if (final) {
+        endUpload(request);
     }
+}
+
+// ============================================
+// STREAMED UPLOAD HELPERS
+// ============================================
 
-    // Write data chunk
-    if (_uploadFile && len > 0) {
-        size_t written = _uploadFile.write(data, len);
-        if (written != len) {
-            LOG_ERROR("WEB", "Write error: expected %d, wrote %d bytes", len, written);
+bool WebServerHandler::claimUpload(AsyncWebServerRequest *request) {
+    if (_upload.owner && !ownsUpload(request)) {
+        if (millis() - _upload.last_activity < UPLOAD_STALE_MS) {
+            LOG_WARN("WEB", "Upload rejected: another upload is in progress");
+            return false;
         }
+
+        // Previous client went quiet mid-transfer: drop its partial file
+        abandonUpload("stale");
     }
 
-    // Final chunk - close file
-    if (final) {
-        if (_uploadFile) {
-            _uploadFile.flush();
-            _uploadFile.close();
+    UploadResult* result = uploadResult(request);
+    if (!result) {
+        LOG_ERROR("WEB", "Upload rejected: out of memory");
+        return false;
+    }
+
+    if (++_upload.next_id == 0) {
+        _upload.next_id = 1;
+    }
+    uint32_t id = _upload.next_id;
+    result->upload_id = id;
+
+    // Fires for every closed connection: only acts if this claim still holds the slot
+    request->onDisconnect([this, id]() {
+        if (_upload.owner == id) {
+            abandonUpload("client disconnected");
         }
-        LOG_INFO("WEB", "Upload complete: %s (%d bytes total)", filename.c_str(), index + len);
+    });
+
+    _upload.owner = id;
+    _upload.file = File();
+    _upload.path = "";
+    _upload.restore = nullptr;
+    _upload.bytes = 0;
+    _upload.last_activity = millis();
+    _upload.failed = false;
+    _upload.error = "";
+    return true;
+}
+
+bool WebServerHandler::ownsUpload(AsyncWebServerRequest *request) const {
+    const UploadResult* result = (const UploadResult*)request->_tempObject;
+    return _upload.owner != 0 && result && result->upload_id == _upload.owner;
+}
+
+void WebServerHandler::abandonUpload(const char* reason) {
+    LOG_WARN("WEB", "Abandoning upload (%s): %s", reason,
+             _upload.restore ? "restore" : _upload.path.c_str());
+    if (_upload.file) {
+        _upload.file.close();
+        LittleFS.remove(_upload.path);
+    }
+    delete _upload.restore;
+    _upload.restore = nullptr;
+    _upload.owner = 0;
+}
+
+void WebServerHandler::beginUpload(AsyncWebServerRequest *request, const String& path, size_t total) {
+    if (!claimUpload(request)) {
+        setUploadResult(request, HTTP_CONFLICT, "Another upload is in progress");
+        return;
+    }
+
+    _upload.path = path;
+
+    // Space check up front: a replaced file gives its space back
+    size_t available = LittleFS.totalBytes() - LittleFS.usedBytes();
+    if (LittleFS.exists(path)) {
+        File existing = LittleFS.open(path, FILE_READ);
+        if (existing) {
+            available += existing.size();
+            existing.close();
+        }
+    }
+
+    // Failures here leave the existing file untouched and release the slot
+    if (total > available) {
+        LOG_ERROR("WEB", "Upload too large: %d bytes (free: %d)", total, available);
+        setUploadResult(request, HTTP_INSUFFICIENT_STORAGE, "Not enough free space");
+        _upload.owner = 0;
+        return;
+    }
+
+    _upload.file = LittleFS.open(path, FILE_WRITE);
+    if (!_upload.file) {
+        LOG_ERROR("WEB", "Failed to open file for upload: %s", path.c_str());
+        setUploadResult(request, HTTP_INTERNAL_ERROR, "Failed to open file");
+        _upload.owner = 0;
     }
 }
 
+void WebServerHandler::writeUpload(AsyncWebServerRequest *request, const uint8_t *data, size_t len) {
+    if (!ownsUpload(request) || _upload.failed || len == 0) {
+        return;
+    }
+
+    _upload.last_activity = millis();
+    _upload.bytes += len;
+
+    if (_upload.restore) {
+        if (!_upload.restore->write(data, len)) {
+            _upload.failed = true;
+            _upload.error = _upload.restore->error();
+        }
+        return;
+    }
+
+    size_t written = _upload.file.write(data, len);
+    if (written != len) {
+        LOG_ERROR("WEB", "Write error: expected %d, wrote %d bytes", len, written);
+        _upload.failed = true;
+        _upload.error = "Write failed (filesystem full?)";
+    }
+}
+
+void WebServerHandler::endUpload(AsyncWebServerRequest *request) {
+    if (!ownsUpload(request)) {
+        return;
+    }
+
+    UploadResult* result = nullptr;
+
+    if (_upload.restore) {
+        if (!_upload.restore->finish() && !_upload.failed) {
+            _upload.failed = true;
+            _upload.error = _upload.restore->error();
+        }
+        setUploadResult(request, _upload.failed ? HTTP_BAD_REQUEST : HTTP_OK, _upload.error);
+        result = (UploadResult*)request->_tempObject;
+        if (result) {
+            result->bytes = _upload.restore->bytesRestored();
+            result->files = _upload.restore->filesRestored();
+            result->skipped = _upload.restore->entriesSkipped();
+        }
+        delete _upload.restore;
+        _upload.restore = nullptr;
+    } else {
+        if (_upload.file) {
+            _upload.file.flush();
+            _upload.file.close();
+        }
+
+        if (_upload.failed) {
+            LittleFS.remove(_upload.path);
+        } else {
+            _nfc.onFileChanged(_upload.path);
+        }
+
+        setUploadResult(request, _upload.failed ? HTTP_INTERNAL_ERROR : HTTP_OK, _upload.error);
+        result = (UploadResult*)request->_tempObject;
+        if (result) {
+            result->bytes = _upload.bytes;
+        }
+    }
+
+    _upload.owner = 0;
+}
+
+WebServerHandler::UploadResult* WebServerHandler::uploadResult(AsyncWebServerRequest *request) {
+    UploadResult* result = (UploadResult*)request->_tempObject;
+    if (!result) {
+        result = (UploadResult*)calloc(1, sizeof(UploadResult));
+        request->_tempObject = result;
+    }
+    return result;
+}
+
+void WebServerHandler::setUploadResult(AsyncWebServerRequest *request, int status, const String& error) {
+    UploadResult* result = uploadResult(request);
+    if (!result) {
+        return;
+    }
+
+    // First failure wins
+    if (result->status != 0 && result->status != HTTP_OK) {
+        return;
+    }
+
+    result->status = status;
+    strlcpy(result->error, error.c_str(), sizeof(result->error));
+}
+
+void WebServerHandler::sendUploadResult(AsyncWebServerRequest *request) {
+    const UploadResult* result = (const UploadResult*)request->_tempObject;
+
+    if (!result) {
+        LOG_WARN("WEB", "Upload request without data");
+        request->send(HTTP_BAD_REQUEST, "application/json", "{\"error\":\"No data received\"}");
+        return;
+    }
+
+    JsonDocument doc;
+    if (result->status == HTTP_OK) {
+        doc["success"] = true;
+    } else {
+        doc["error"] = result->error;
+    }
+    doc["bytes"] = result->bytes;
+    if (result->files || result->skipped) {
+        doc["files"] = result->files;
+        doc["skipped"] = result->skipped;
+    }
+
+    JsonResponse::send(request, result->status, doc);
+}
+
 // ============================================
 // FILE EDITOR API HANDLERS
 // ============================================
@@ -699,50 +1002,36 @@ void WebServerHandler::handleReadFile(AsyncWebServerRequest *request) {
     doc["size"] = content.length();
     doc["content"] = content;
 
-    String output;
-    // Pre-allocate memory: path (100) + size (10) + content (2x for JSON escaping) + overhead (200)
-    size_t estimatedSize = 300 + (fileSize * 2);
-    output.reserve(estimatedSize);
-    serializeJson(doc, output);
+    // Content is copied into the document: drop the read buffer first
+    content = String();
 
-    LOG_DEBUG("WEB", "JSON response size: %d bytes", output.length());
-
-    // Send response with explicit Content-Length
-    AsyncWebServerResponse *response = request->beginResponse(HTTP_OK, "application/json", output);
-    response->addHeader("Content-Length", String(output.length()));
-    request->send(response);
+    // Stream buffer is sized by measureJson (escaped length), no String copy
+    JsonResponse::send(request, HTTP_OK, doc);
 
     LOG_INFO("WEB", "File read successfully: %s", path.c_str());
 }
 
 void WebServerHandler::handleUpdateFile(AsyncWebServerRequest *request) {
-    // Validate required parameters
-    if (!request->hasParam("path", true) || !request->hasParam("content", true)) {
-        LOG_WARN("WEB", "Update file request missing parameters");
-        request->send(HTTP_BAD_REQUEST, "application/json", "{\"error\":\"Missing parameters\"}");
+    // Body already streamed to the file by the body callback
+    if (request->_tempObject) {
+        sendUploadResult(request);
+        return;
+    }
+
+    // No body chunks: empty content (or missing path)
+    if (!request->hasParam("path", false)) {
+        LOG_WARN("WEB", "Update file request missing 'path' parameter");
+        request->send(HTTP_BAD_REQUEST, "application/json", "{\"error\":\"Missing path parameter\"}");
         return;
     }
 
-    String path = request->getParam("path", true)->value();
-    String content = request->getParam("content", true)->value();
+    String path = request->getParam("path", false)->value();
 
     // Ensure path starts with /
     if (!path.startsWith("/")) {
         path = "/" + path;
     }
 
-    LOG_INFO("WEB", "Updating file: %s (%d bytes)", path.c_str(), content.length());
-
-    // Check size limit
-    if (content.length() > MAX_FILE_WRITE_SIZE) {
-        LOG_ERROR("WEB", "Content too large: %d bytes (max: %d)", 
-                 content.length(), MAX_FILE_WRITE_SIZE);
-        request->send(HTTP_PAYLOAD_TOO_LARGE, "application/json", 
-                     "{\"error\":\"Content too large (max 100KB)\"}");
-        return;
-    }
-
-    // Open file for writing (overwrites existing content)
     File file = LittleFS.open(path, FILE_WRITE);
     if (!file) {
         LOG_ERROR("WEB", "Failed to open file for writing: %s", path.c_str());
@@ -750,10 +1039,10 @@ void WebServerHandler::handleUpdateFile(AsyncWebServerRequest *request) {
         return;
     }
 
-    file.print(content);
     file.close();
+    _nfc.onFileChanged(path);
 
-    LOG_INFO("WEB", "File updated successfully: %s", path.c_str());
+    LOG_INFO("WEB", "File truncated: %s", path.c_str());
     request->send(HTTP_OK, "application/json", "{\"success\":true}");
 }
 // ============================================
@@ -772,6 +1061,7 @@ void WebServerHandler::handleStatus(AsyncWebServerRequest *request) {
     // Hardware information
     doc["chipModel"] = ESP.getChipModel();
     doc["freeHeap"] = ESP.getFreeHeap();
+    doc["logDropped"] = Logger::droppedCount();
     
     // System uptime (in seconds)
     doc["uptime"] = millis() / 1000;
@@ -787,11 +1077,37 @@ void WebServerHandler::handleStatus(AsyncWebServerRequest *request) {
         doc["debugMode"] = false;
     #endif
 
-    String output;
-    serializeJson(doc, output);
-    
-    LOG_DEBUG("WEB", "Status response: %d bytes", output.length());
-    request->send(HTTP_OK, "application/json", output);
+    JsonResponse::send(request, HTTP_OK, doc);
+}
+
+void WebServerHandler::handleMetrics(AsyncWebServerRequest *request) {
+    JsonDocument doc;
+    doc["enabled"] = StageMetrics::enabled();
+    doc["cpuMhz"] = ESP.getCpuFreqMHz();
+
+    JsonArray stages = doc["stages"].to<JsonArray>();
+    for (uint8_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        StageMetrics::Summary s;
+        StageMetrics::summarize((MetricStage)i, s);
+
+        JsonObject stage = stages.add<JsonObject>();
+        stage["name"] = StageMetrics::stageName((MetricStage)i);
+        stage["count"] = s.count;
+        stage["min_us"] = s.min_us;
+        stage["p50_us"] = s.p50_us;
+        stage["p95_us"] = s.p95_us;
+        stage["max_us"] = s.max_us;
+        stage["mean_us"] = s.mean_us;
+    }
+
+    BootProfile::toJson(doc["boot"].to<JsonObject>());
+
+    if (request->hasParam("reset") && request->getParam("reset")->value() == "1") {
+        StageMetrics::reset();
+        LOG_INFO("WEB", "Stage metrics reset");
+    }
+
+    JsonResponse::send(request, HTTP_OK, doc);
 }
 
 void WebServerHandler::handleWifiAdd(AsyncWebServerRequest *request) {
@@ -843,9 +1159,18 @@ void WebServerHandler::handleReboot(AsyncWebServerRequest *request) {
     delay(REBOOT_DELAY_MS);
     
     LOG_CRITICAL("WEB", "Rebooting system now");
+    Logger::flush();
     ESP.restart();
 }
 
+void WebServerHandler::onLogLine(const char* line, size_t len, void* context) {
+    WebServerHandler* self = (WebServerHandler*)context;
+    if (self->_logEvents.count() == 0) {
+        return;
+    }
+    self->_logEvents.send(line, "log", millis());
+}
+
 void WebServerHandler::handleFormat(AsyncWebServerRequest *request) {
     LOG_CRITICAL("WEB", "Filesystem format requested");
     
@@ -864,80 +1189,6 @@ void WebServerHandler::handleFormat(AsyncWebServerRequest *request) {
 // ZIP BACKUP IMPLEMENTATION
 // ============================================
 
-/**
- * @brief Write 32-bit unsigned integer in little-endian format
- * @param stream Output stream
- * @param value Value to write
- */
-void writeUInt32LE(File& file, uint32_t value) {
-    file.write((uint8_t)(value & 0xFF));
-    file.write((uint8_t)((value >> 8) & 0xFF));
-    file.write((uint8_t)((value >> 16) & 0xFF));
-    file.write((uint8_t)((value >> 24) & 0xFF));
-}
-
-/**
- * @brief Write 16-bit unsigned integer in little-endian format
- * @param stream Output stream
- * @param value Value to write
- */
-void writeUInt16LE(File& file, uint16_t value) {
-    file.write((uint8_t)(value & 0xFF));
-    file.write((uint8_t)((value >> 8) & 0xFF));
-}
-
-/**
- * @brief Calculate CRC32 checksum for ZIP format
- * @param data Data buffer
- * @param length Buffer length
- * @return CRC32 checksum
- * 
- * Uses standard CRC32 polynomial (0xEDB88320) as per ZIP specification
- */
-uint32_t calculateCRC32(const uint8_t* data, size_t length) {
-    uint32_t crc = 0xFFFFFFFF;
-    
-    for (size_t i = 0; i < length; i++) {
-        crc ^= data[i];
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
-        }
-    }
-    
-    return ~crc;
-}
-
-/**
- * @brief File information structure for ZIP backup
- */
-struct FileInfo {
-    String path;          // Path in ZIP archive (without leading /)
-    uint32_t offset;      // Offset in ZIP file
-    uint32_t size;        // File size in bytes
-    uint32_t crc;         // CRC32 checksum
-    bool isDir;           // True if directory
-};
-
-// Task to clean up temporary backup file after transfer completes
-void cleanupBackupTask(void* parameter) {
-    String* tempPath = (String*)parameter;
-    
-    // Wait 20 seconds to ensure file transfer is complete
-    // Even on slow connections, 30KB should transfer in <30s
-    delay(TIMEOUT_DELETE_TEMP_ZIP);
-    
-    if (LittleFS.exists(*tempPath)) {
-        if (LittleFS.remove(*tempPath)) {
-            LOG_INFO("WEB", "Temporary backup file deleted: %s", tempPath->c_str());
-        } else {
-            LOG_WARN("WEB", "Failed to delete temporary backup file: %s", tempPath->c_str());
-        }
-    }
-    
-    delete tempPath; // Free allocated string
-    vTaskDelete(NULL); // Terminate cleanup task
-}
-
 void WebServerHandler::handleBackup(AsyncWebServerRequest *request) {
     LOG_INFO("WEB", "Full filesystem backup requested");
 
@@ -947,240 +1198,23 @@ void WebServerHandler::handleBackup(AsyncWebServerRequest *request) {
         zipFilename = request->getParam("filename")->value();
     }
 
-    // Define temporary file path
-    String tempPath = "/temp_backup.zip";
-    
-    LOG_INFO("WEB", "Creating backup: %s (temp: %s)", zipFilename.c_str(), tempPath.c_str());
-
-    // Open temporary file for writing
-    File backupFile = LittleFS.open(tempPath, FILE_WRITE);
-    if (!backupFile) {
-        LOG_ERROR("WEB", "Failed to create temporary backup file");
-        request->send(HTTP_INTERNAL_ERROR, "application/json", 
-                     "{\"error\":\"Failed to create backup file\"}");
-        return;
+    // Leftover from firmware that staged the archive on flash
+    if (LittleFS.exists(LEGACY_BACKUP_TEMP_PATH)) {
+        LittleFS.remove(LEGACY_BACKUP_TEMP_PATH);
     }
 
-    // Use vector for dynamic file list (no fixed limit)
-    std::vector<FileInfo> fileInfos;
-    uint32_t currentOffset = 0;
-
-    // Recursive directory processing lambda
-    std::function<void(const String&)> processDirectory;
-    processDirectory = [&](const String& path) {
-        File dir = LittleFS.open(path);
-        if (!dir || !dir.isDirectory()) {
-            LOG_WARN("WEB", "Failed to open directory: %s", path.c_str());
-            return;
-        }
-
-        LOG_DEBUG("WEB", "Processing directory: %s", path.c_str());
-
-        File file = dir.openNextFile();
-        while (file) {
-            // Yield to other tasks to prevent watchdog timeout
-            delay(1);
-            // Build full path (handles both ESP32 Core 2.x and 3.x)
-            String fileName = String(file.name());
-            String fullPath;
-            
-            if (fileName.startsWith("/")) {
-                // Core 2.x style - already absolute path
-                fullPath = fileName;
-            } else {
-                // Core 3.x style - relative path, need to construct full path
-                fullPath = path;
-                if (!fullPath.endsWith("/")) fullPath += "/";
-                fullPath += fileName;
-            }
-
-            // Skip hidden files, system files, and the temp backup itself
-            if (fileName.startsWith(".") || fullPath.endsWith("/.keep") || 
-                fullPath.endsWith("/temp_backup.zip") || fullPath == "/temp_backup.zip") {
-                file = dir.openNextFile();
-                continue;
-            }
-
-            if (file.isDirectory()) {
-                // Process directory
-                LOG_DEBUG("WEB", "Adding directory: %s", fullPath.c_str());
-
-                // Normalize path for ZIP (remove leading /, add trailing /)
-                String zipPath = fullPath;
-                if (zipPath.startsWith("/")) zipPath = zipPath.substring(1);
-                if (!zipPath.endsWith("/")) zipPath += "/";
-
-                // Save directory info
-                FileInfo info;
-                info.path = zipPath;
-                info.offset = currentOffset;
-                info.size = 0;
-                info.crc = 0;
-                info.isDir = true;
-                fileInfos.push_back(info);
-
-                // Write ZIP Local File Header for directory
-                writeUInt32LE(backupFile, ZIP_LOCAL_HEADER_SIG);
-                writeUInt16LE(backupFile, ZIP_VERSION);           // Version needed to extract
-                writeUInt16LE(backupFile, 0);                     // General purpose bit flag
-                writeUInt16LE(backupFile, 0);                     // Compression method (0 = stored)
-                writeUInt16LE(backupFile, 0);                     // Last mod file time
-                writeUInt16LE(backupFile, 0);                     // Last mod file date
-                writeUInt32LE(backupFile, 0);                     // CRC-32
-                writeUInt32LE(backupFile, 0);                     // Compressed size
-                writeUInt32LE(backupFile, 0);                     // Uncompressed size
-                writeUInt16LE(backupFile, zipPath.length());      // Filename length
-                writeUInt16LE(backupFile, 0);                     // Extra field length
-                backupFile.print(zipPath);
-
-                currentOffset += ZIP_LOCAL_HEADER_SIZE + zipPath.length();
-
-                // Close current file before recursing (prevents file descriptor exhaustion)
-                file.close();
-                
-                // Recurse into subdirectory
-                processDirectory(fullPath);
-                
-                // Reopen directory to continue iteration
-                file = dir.openNextFile();
-                continue;
-            }
-
-            // Process regular file
-            size_t fileSize = file.size();
-
-            // Skip files that are too large (memory constraint)
-            if (fileSize > MAX_BACKUP_FILE_SIZE) {
-                LOG_WARN("WEB", "Skipping large file: %s (%d bytes)", fullPath.c_str(), fileSize);
-                file = dir.openNextFile();
-                continue;
-            }
-
-            LOG_DEBUG("WEB", "Adding file: %s (%d bytes)", fullPath.c_str(), fileSize);
-
-            // Normalize path for ZIP (remove leading /)
-            String zipPath = fullPath;
-            if (zipPath.startsWith("/")) zipPath = zipPath.substring(1);
-
-            // Read file content into buffer
-            uint8_t* buffer = new uint8_t[fileSize];
-            if (!buffer) {
-                LOG_ERROR("WEB", "Memory allocation failed for file: %s", fullPath.c_str());
-                file = dir.openNextFile();
-                continue;
-            }
+    // Entry list is built now, data is pulled by the response as the socket drains
+    std::shared_ptr<ZipStream> zip = std::make_shared<ZipStream>("/");
+    if (zip->entryCount() == 0) {
+        LOG_WARN("WEB", "Backup: filesystem is empty");
+    }
 
-            file.read(buffer, fileSize);
-            file.close(); // Close immediately after reading
-
-            // Calculate CRC32 checksum
-            uint32_t crc = calculateCRC32(buffer, fileSize);
-
-            // Save file info for Central Directory
-            FileInfo info;
-            info.path = zipPath;
-            info.offset = currentOffset;
-            info.size = fileSize;
-            info.crc = crc;
-            info.isDir = false;
-            fileInfos.push_back(info);
-
-            // Write ZIP Local File Header for file
-            writeUInt32LE(backupFile, ZIP_LOCAL_HEADER_SIG);
-            writeUInt16LE(backupFile, ZIP_VERSION);           // Version needed
-            writeUInt16LE(backupFile, 0);                     // Flags
-            writeUInt16LE(backupFile, 0);                     // Compression (0 = stored)
-            writeUInt16LE(backupFile, 0);                     // Time
-            writeUInt16LE(backupFile, 0);                     // Date
-            writeUInt32LE(backupFile, crc);                   // CRC-32
-            writeUInt32LE(backupFile, fileSize);              // Compressed size
-            writeUInt32LE(backupFile, fileSize);              // Uncompressed size
-            writeUInt16LE(backupFile, zipPath.length());      // Filename length
-            writeUInt16LE(backupFile, 0);                     // Extra field length
-            backupFile.print(zipPath);                       // Filename
-            backupFile.write(buffer, fileSize);              // File content
-
-            currentOffset += ZIP_LOCAL_HEADER_SIZE + zipPath.length() + fileSize;
-
-            delete[] buffer;
-            file = dir.openNextFile();
-        }
+    LOG_INFO("WEB", "Streaming backup: %s (%d entries)", zipFilename.c_str(), (int)zip->entryCount());
 
-        dir.close(); // Important: close directory when done
-    };
-
-    // Start recursive processing from root
-    processDirectory("/");
-
-    LOG_INFO("WEB", "Processed %d entries, writing Central Directory", fileInfos.size());
-
-    // ==========================================
-    // WRITE CENTRAL DIRECTORY
-    // ==========================================
-
-    uint32_t centralDirStart = currentOffset;
-    uint32_t centralDirSize = 0;
-
-    for (const auto& info : fileInfos) {
-        // Write Central Directory File Header
-        writeUInt32LE(backupFile, ZIP_CENTRAL_HEADER_SIG);
-        writeUInt16LE(backupFile, ZIP_VERSION);           // Version made by
-        writeUInt16LE(backupFile, ZIP_VERSION);           // Version needed to extract
-        writeUInt16LE(backupFile, 0);                     // General purpose bit flag
-        writeUInt16LE(backupFile, 0);                     // Compression method
-        writeUInt16LE(backupFile, 0);                     // Last mod file time
-        writeUInt16LE(backupFile, 0);                     // Last mod file date
-        writeUInt32LE(backupFile, info.crc);              // CRC-32
-        writeUInt32LE(backupFile, info.size);             // Compressed size
-        writeUInt32LE(backupFile, info.size);             // Uncompressed size
-        writeUInt16LE(backupFile, info.path.length());    // Filename length
-        writeUInt16LE(backupFile, 0);                     // Extra field length
-        writeUInt16LE(backupFile, 0);                     // File comment length
-        writeUInt16LE(backupFile, 0);                     // Disk number start
-        writeUInt16LE(backupFile, 0);                     // Internal file attributes
-        writeUInt32LE(backupFile, info.isDir ? 0x10 : 0); // External file attributes (0x10 = directory)
-        writeUInt32LE(backupFile, info.offset);           // Relative offset of local header
-        backupFile.print(info.path);                     // Filename
-
-        centralDirSize += ZIP_CENTRAL_HEADER_SIZE + info.path.length();
-    }
-
-    LOG_DEBUG("WEB", "Central Directory size: %d bytes", centralDirSize);
-
-    // ==========================================
-    // WRITE END OF CENTRAL DIRECTORY RECORD
-    // ==========================================
-
-    writeUInt32LE(backupFile, ZIP_END_CENTRAL_SIG);
-    writeUInt16LE(backupFile, 0);                     // Number of this disk
-    writeUInt16LE(backupFile, 0);                     // Disk where central directory starts
-    writeUInt16LE(backupFile, fileInfos.size());      // Number of entries on this disk
-    writeUInt16LE(backupFile, fileInfos.size());      // Total number of entries
-    writeUInt32LE(backupFile, centralDirSize);        // Size of central directory
-    writeUInt32LE(backupFile, centralDirStart);       // Offset of central directory
-    writeUInt16LE(backupFile, 0);                     // Comment length
-
-    // Close backup file
-    backupFile.close();
-
-    LOG_INFO("WEB", "Backup complete: %d entries, %d bytes total", 
-             fileInfos.size(), currentOffset + centralDirSize);
-
-    // Send file to client with custom filename
-    AsyncWebServerResponse *response = request->beginResponse(LittleFS, tempPath, "application/zip", true);
+    AsyncWebServerResponse *response = request->beginChunkedResponse("application/zip",
+        [zip](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+            return zip->read(buffer, maxLen);
+        });
     response->addHeader("Content-Disposition", "attachment; filename=\"" + zipFilename + "\"");
     request->send(response);
-    
-    LOG_INFO("WEB", "Backup file sent to client, scheduling cleanup");
-    
-    // Schedule cleanup task to delete temp file after transfer completes
-    String* pathCopy = new String(tempPath); // Allocate on heap for task
-    xTaskCreate(
-        cleanupBackupTask,    // Task function
-        "BackupCleanup",      // Task name
-        2048,                 // Small stack
-        (void*)pathCopy,      // Pass path as parameter
-        1,                    // Low priority
-        NULL                  // No handle needed
-    );
 }
@@ -7,6 +7,7 @@
 #include <vector>
 #include <functional>
 #include "login_handler.h"
+#include "zip_restore.h"
 #include "logger.h"
 #include "config.h"
 
@@ -14,6 +15,7 @@
 class WiFiManager;
 class NFCManager;
 class WebServerHandlerNFC;
+class NFCJobEngine;
 
 /**
  * @brief Main HTTP web server handler for NFC Tool web interface
@@ -40,9 +42,6 @@ class WebServerHandlerNFC;
  * - DEBUG_SKIP_AUTH flag for development (unsafe for production)
  */
 
-// Backup cleanup timeout (place BEFORE class definition)
-constexpr uint32_t TIMEOUT_DELETE_TEMP_ZIP = 20000;  // 20 seconds
-
 class WebServerHandler {
 public:
     /**
@@ -54,13 +53,37 @@ public:
     explicit WebServerHandler(AsyncWebServer& server, WiFiManager& wifiMgr, NFCManager& nfc);
 
     /**
-     * @brief Initialize web server and register all routes
+     * @brief Register all routes and start the NFC job engines
      * 
-     * Call this after LittleFS.begin() and WiFi initialization.
-     * Sets up all HTTP routes and starts the AsyncWebServer.
+     * Call this after LittleFS.begin(). Does not need the network:
+     * listen() opens the port once WiFi (STA or AP) is up.
      */
     void begin();
 
+    /**
+     * @brief Start the AsyncWebServer (call after begin() and WiFi setup)
+     * 
+     * No-op if already listening.
+     */
+    void listen();
+
+    /**
+     * @brief Check if the server is accepting connections
+     */
+    bool isListening() const { return _listening; }
+
+    /**
+     * @brief Add another PN532 reader to the NFC API (call after begin())
+     * @param nfc NFC manager of the reader
+     * @return false before begin() or if the reader could not be added
+     */
+    bool addReader(NFCManager& nfc);
+
+    /**
+     * @brief NFC job engine of a reader (nullptr before begin() or if unknown)
+     */
+    NFCJobEngine* jobs(uint8_t reader = 0);
+
 private:
     // ============================================
     // CONSTANTS
@@ -68,20 +91,14 @@ private:
     
     // File size limits
     static constexpr size_t MAX_FILE_READ_SIZE = 20000;      // 20KB max for editor
-    static constexpr size_t MAX_FILE_WRITE_SIZE = 102400;    // 100KB max for uploads
-    static constexpr size_t MAX_BACKUP_FILE_SIZE = 25000;    // 25KB max per file in ZIP
+    static constexpr uint32_t UPLOAD_STALE_MS = 30000;       // Idle upload is abandoned after 30s
     
     // Memory safety thresholds
     static constexpr size_t HEAP_SAFETY_MULTIPLIER = 3;      // Need 3x file size in RAM
     static constexpr size_t HEAP_SAFETY_MARGIN = 10000;      // 10KB safety margin
     
-    // Zip backup constants
-    static constexpr uint32_t ZIP_LOCAL_HEADER_SIG = 0x04034b50;
-    static constexpr uint32_t ZIP_CENTRAL_HEADER_SIG = 0x02014b50;
-    static constexpr uint32_t ZIP_END_CENTRAL_SIG = 0x06054b50;
-    static constexpr uint16_t ZIP_VERSION = 20;
-    static constexpr size_t ZIP_LOCAL_HEADER_SIZE = 30;
-    static constexpr size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+    // Backup archive staged on flash by older firmware (removed on sight)
+    static constexpr const char* LEGACY_BACKUP_TEMP_PATH = "/temp_backup.zip";
 
     // HTTP status codes (for clarity)
     static constexpr int HTTP_OK = 200;
@@ -89,6 +106,7 @@ private:
     static constexpr int HTTP_BAD_REQUEST = 400;
     static constexpr int HTTP_UNAUTHORIZED = 401;
     static constexpr int HTTP_NOT_FOUND = 404;
+    static constexpr int HTTP_CONFLICT = 409;
     static constexpr int HTTP_PAYLOAD_TOO_LARGE = 413;
     static constexpr int HTTP_INTERNAL_ERROR = 500;
     static constexpr int HTTP_INSUFFICIENT_STORAGE = 507;
@@ -105,8 +123,42 @@ private:
     LoginHandler _loginHandler;           // Authentication handler
     NFCManager& _nfc;                     // Reference to NFC manager
     WebServerHandlerNFC* _nfcHandler;     // NFC-specific route handler
+    AsyncEventSource _logEvents;          // Live log stream (/api/logs)
     bool _loggedIn = false;               // Legacy flag (deprecated, use LoginHandler)
-    File _uploadFile;                     // Current upload file handle
+    volatile bool _listening = false;     // listen() called
+
+    /**
+     * @brief Streamed upload in progress (one at a time)
+     */
+    struct UploadState {
+        uint32_t owner;                   // Upload id of the writing request (0 = idle)
+        uint32_t next_id;                 // Last id handed out
+        File file;                        // Target file (plain upload)
+        String path;                      // Target path (plain upload)
+        ZipRestore* restore;              // Archive being unpacked (restore)
+        uint32_t bytes;                   // Payload bytes received
+        uint32_t last_activity;           // millis() of the last chunk
+        bool failed;
+        String error;
+    };
+
+    /**
+     * @brief Upload outcome, kept in request->_tempObject until the reply
+     * 
+     * Plain struct: the request releases _tempObject with free(). The
+     * upload id identifies the owner: a request pointer can be reused by
+     * the next request once the previous one is freed.
+     */
+    struct UploadResult {
+        uint32_t upload_id;               // Claim of this request (0 = never claimed)
+        int status;                       // HTTP status to send
+        uint32_t bytes;                   // Bytes written
+        uint16_t files;                   // Files restored (restore)
+        uint16_t skipped;                 // Entries skipped (restore)
+        char error[64];                   // Empty on success
+    };
+
+    UploadState _upload = {0, 0, File(), "", nullptr, 0, 0, false, ""};
 
     // ============================================
     // ROUTE SETUP
@@ -116,14 +168,14 @@ private:
      * @brief Register all HTTP routes with server
      * 
      * Routes are organized into sections:
-     * - Static assets: /style.css, /app.js (gzipped)
+     * - Static assets: /style.css, /app.js (gzipped, ETag/304, ?v=<hash> immutable)
      * - Authentication: /login (GET/POST), /logout
      * - Main interface: / (requires auth)
      * - File manager API: /api/files/* (CRUD operations)
      * - File editor API: /api/files/read, /api/files/update
      * - Upload/download: /upload, /download
      * - Settings API: /api/status, /api/wifi/*, /api/reboot, /api/format
-     * - Backup: /api/backup (full filesystem ZIP)
+     * - Backup: /api/backup (full filesystem ZIP), /api/restore (ZIP upload)
      * - 404 handler
      */
     void setupRoutes();
@@ -214,6 +266,77 @@ private:
     void handleUpload(AsyncWebServerRequest *request, String filename,
                      size_t index, uint8_t *data, size_t len, bool final);
 
+    /**
+     * @brief Restore a backup ZIP (multipart/form-data) chunk by chunk
+     * @param request HTTP request
+     * @param index Current byte offset
+     * @param data Chunk data buffer
+     * @param len Chunk length
+     * @param final True if last chunk
+     * 
+     * Entries are unpacked to LittleFS as they arrive (see ZipRestore).
+     * The dump catalog is kept in sync, its own file is never restored.
+     */
+    void handleRestore(AsyncWebServerRequest *request, size_t index,
+                      uint8_t *data, size_t len, bool final);
+
+    // ============================================
+    // STREAMED UPLOAD HELPERS
+    // ============================================
+
+    /**
+     * @brief Claim the upload slot for a request
+     * @return false if another live upload holds it
+     * 
+     * Uploads idle for UPLOAD_STALE_MS (client gone) are abandoned, and
+     * a claimed upload is abandoned as soon as its client disconnects.
+     */
+    bool claimUpload(AsyncWebServerRequest *request);
+
+    /**
+     * @brief Check if request holds the upload slot
+     */
+    bool ownsUpload(AsyncWebServerRequest *request) const;
+
+    /**
+     * @brief Drop the upload in progress (partial file removed)
+     */
+    void abandonUpload(const char* reason);
+
+    /**
+     * @brief Start a plain file upload
+     * @param request HTTP request
+     * @param path Target path
+     * @param total Expected size (0 = unknown), checked against free space
+     */
+    void beginUpload(AsyncWebServerRequest *request, const String& path, size_t total);
+
+    /**
+     * @brief Write a chunk to the upload owned by request
+     */
+    void writeUpload(AsyncWebServerRequest *request, const uint8_t *data, size_t len);
+
+    /**
+     * @brief Close the upload, release the slot and record the result
+     */
+    void endUpload(AsyncWebServerRequest *request);
+
+    /**
+     * @brief Result in request->_tempObject, allocated on first use
+     * @return nullptr if out of memory
+     */
+    UploadResult* uploadResult(AsyncWebServerRequest *request);
+
+    /**
+     * @brief Record a result in request->_tempObject
+     */
+    void setUploadResult(AsyncWebServerRequest *request, int status, const String& error);
+
+    /**
+     * @brief Send the JSON reply for a recorded upload result
+     */
+    void sendUploadResult(AsyncWebServerRequest *request);
+
     // ============================================
     // FILE EDITOR API HANDLERS
     // ============================================
@@ -228,10 +351,12 @@ private:
     void handleReadFile(AsyncWebServerRequest *request);
 
     /**
-     * @brief Update file content from editor
-     * @param request HTTP request with POST data (path, content)
+     * @brief Reply to an editor save (PUT ?path=, raw body)
+     * @param request HTTP request
      * 
-     * Limited to MAX_FILE_WRITE_SIZE to prevent OOM
+     * The body is streamed to the file by the body callback
+     * (beginUpload/writeUpload/endUpload); this only sends the result
+     * and handles an empty body (truncate).
      */
     void handleUpdateFile(AsyncWebServerRequest *request);
 
@@ -247,6 +372,14 @@ private:
      */
     void handleStatus(AsyncWebServerRequest *request);
 
+    /**
+     * @brief Get per-stage timing histograms
+     * @param request HTTP request (?reset=1 clears the counters after reading)
+     *
+     * Returns JSON with count, min, p50, p95, max and mean (µs) per stage.
+     */
+    void handleMetrics(AsyncWebServerRequest *request);
+
     /**
      * @brief Add WiFi credentials
      * @param request HTTP request with POST data (ssid, pass)
@@ -267,6 +400,16 @@ private:
      */
     void handleReboot(AsyncWebServerRequest *request);
 
+    /**
+     * @brief Logger stream sink: forward a log line to /api/logs clients
+     * @param line Formatted log line
+     * @param len Line length
+     * @param context Pointer to WebServerHandler instance
+     *
+     * Runs on the logger drain task. No-op without connected clients.
+     */
+    static void onLogLine(const char* line, size_t len, void* context);
+
     /**
      * @brief Format LittleFS filesystem
      * @param request HTTP request
@@ -283,14 +426,13 @@ private:
      * @brief Generate and download full filesystem backup as ZIP
      * @param request HTTP request with optional ?filename= parameter
      * 
-     * Creates ZIP archive with entire LittleFS contents.
-     * Uses streaming response to avoid RAM constraints.
+     * Streams a ZIP archive of the entire LittleFS contents as a chunked
+     * response (see ZipStream): no temp file, no per-file buffering.
      * 
      * Implementation details:
-     * - Recursively walks directory tree
-     * - Skips files > MAX_BACKUP_FILE_SIZE
+     * - Recursively walks directory tree (names only, up front)
      * - Skips hidden files (starts with .)
-     * - Generates standard ZIP format (no compression)
+     * - Generates standard ZIP format (no compression, data descriptors)
      * - Includes central directory and end-of-central-directory records
      */
     void handleBackup(AsyncWebServerRequest *request);
@@ -300,11 +442,11 @@ private:
     // ============================================
     
     /**
-     * @brief Generate JSON list of directory contents
+     * @brief Fill a JSON document with directory contents
      * @param path Directory path to list
-     * @return JSON string with files array and storage info
+     * @param doc Output document: files array and storage info
      */
-    String listDirectoryJson(const String& path);
+    void listDirectory(const String& path, JsonDocument& doc);
 
     /**
      * @brief Check if user is authenticated (deprecated)
@@ -4,168 +4,11 @@
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
 #include <vector>
-#include <esp_task_wdt.h>
 #include "modules/rfid/nfc_manager.h"
+#include "nfc_job_engine.h"
 #include "login_handler.h"
 #include "logger.h"
 
-// ============================================
-// ASYNC TASK DATA STRUCTURES
-// ============================================
-
-/**
- * @brief Data structure for SRIX read task (FreeRTOS)
- * 
- * Contains all parameters and results for non-blocking NFC read operation.
- * Task runs on Core 1 to avoid blocking the web server on Core 0.
- */
-struct nfcReadTaskSRIXData {
-    NFCManager* nfc;                  // Pointer to NFC manager instance
-    int timeout_sec;                  // Read timeout in seconds
-    NFCManager::TagInfo tagInfo;      // Output: tag information
-    NFCManager::Result result;        // Output: operation result
-    bool completed;                   // Flag: task completed
-    volatile bool running;            // Flag: task currently executing
-};
-
-/**
- * @brief Data structure for SRIX write task (FreeRTOS)
- * 
- * Full tag write can take 90+ seconds (128 blocks with delays).
- */
-struct nfcWriteTaskSRIXData {
-    NFCManager* nfc;                  // Pointer to NFC manager instance
-    NFCManager::TagInfo tagInfo;      // Input: tag data to write
-    int timeoutsec;                   // Write timeout in seconds
-    NFCManager::Result result;        // Output: operation result
-    bool completed;                   // Flag: task completed
-    volatile bool running;            // Flag: task currently executing
-};
-
-/**
- * @brief Data structure for SRIX selective write task (FreeRTOS)
- * 
- * Writes only specified blocks instead of entire tag.
- * Estimated time: ~2.5s per block.
- */
-struct nfcWriteSelectiveTaskSRIXData {
-    NFCManager* nfc;                  // Pointer to NFC manager instance
-    std::vector<uint8_t> block_numbers; // Blocks to write (0-127)
-    NFCManager::Result result;        // Output: operation result
-    bool completed;                   // Flag: task completed
-    volatile bool running;            // Flag: task currently executing
-};
-
-/**
- * @brief Data structure for Mifare read task (FreeRTOS)
- * 
- * Supports both full dump and UID-only read modes.
- */
-struct nfcReadTaskMifareData {
-    NFCManager* nfc;                  // Pointer to NFC manager instance
-    int timeout_sec;                  // Read timeout in seconds
-    bool uid_only;                    // true = UID only, false = full dump
-    NFCManager::TagInfo tagInfo;      // Output: tag information
-    NFCManager::Result result;        // Output: operation result
-    bool completed;                   // Flag: task completed
-    volatile bool running;            // Flag: task currently executing
-};
-
-/**
- * @brief Data structure for Mifare write task (FreeRTOS)
- * 
- * Full Mifare 1K write: 16 sectors with authentication ≈ 30+ seconds.
- */
-struct nfcWriteTaskMifareData {
-    NFCManager* nfc;                  // Pointer to NFC manager instance
-    NFCManager::TagInfo tagInfo;      // Input: tag data to write
-    int timeout_sec;                  // Write timeout in seconds
-    NFCManager::Result result;        // Output: operation result
-    bool completed;                   // Flag: task completed
-    volatile bool running;            // Flag: task currently executing
-};
-
-/**
- * @brief Data structure for Mifare UID clone task (FreeRTOS)
- * 
- * Clones only the UID to a magic card (Gen2/CUID).
- */
-struct nfcCloneTaskMifareData {
-    NFCManager* nfc;                  // Pointer to NFC manager instance
-    NFCManager::TagInfo tagInfo;      // Input: tag with UID to clone
-    int timeout_sec;                  // Clone timeout in seconds
-    NFCManager::Result result;        // Output: operation result
-    bool completed;                   // Flag: task completed
-    volatile bool running;            // Flag: task currently executing
-};
-
-/**
- * @brief Data structure for Mifare selective write task (FreeRTOS)
- * 
- * Writes only specified blocks instead of entire tag.
- */
-struct nfcWriteSelectiveTaskMifareData {
-    NFCManager* nfc;                  // Pointer to NFC manager instance
-    std::vector<uint8_t> block_numbers; // Blocks to write
-    NFCManager::Result result;        // Output: operation result
-    bool completed;                   // Flag: task completed
-    volatile bool running;            // Flag: task currently executing
-};
-
-// ============================================
-// TASK FUNCTION DECLARATIONS
-// ============================================
-
-/**
- * @brief FreeRTOS task for SRIX read operation
- * @param parameter Pointer to nfcReadTaskSRIXData structure
- * 
- * Runs on Core 1, self-deletes on completion.
- */
-void nfcReadTaskSRIX(void* parameter);
-
-/**
- * @brief FreeRTOS task for SRIX write operation
- * @param parameter Pointer to nfcWriteTaskSRIXData structure
- * 
- * Auto-cleanup: deletes data structure on completion.
- */
-void nfcWriteTaskSRIX(void* parameter);
-
-/**
- * @brief FreeRTOS task for SRIX selective write operation
- * @param parameter Pointer to nfcWriteSelectiveTaskSRIXData structure
- */
-void nfcWriteSelectiveTaskSRIX(void* parameter);
-
-/**
- * @brief FreeRTOS task for Mifare read operation
- * @param parameter Pointer to nfcReadTaskMifareData structure
- */
-void nfcReadTaskMifare(void* parameter);
-
-/**
- * @brief FreeRTOS task for Mifare write operation
- * @param parameter Pointer to nfcWriteTaskMifareData structure
- * 
- * Auto-cleanup: deletes data structure on completion.
- */
-void nfcWriteTaskMifare(void* parameter);
-
-/**
- * @brief FreeRTOS task for Mifare UID clone operation
- * @param parameter Pointer to nfcCloneTaskMifareData structure
- * 
- * Auto-cleanup: deletes data structure on completion.
- */
-void nfcCloneTaskMifare(void* parameter);
-
-/**
- * @brief FreeRTOS task for Mifare selective write operation
- * @param parameter Pointer to nfcWriteSelectiveTaskMifareData structure
- */
-void nfcWriteSelectiveTaskMifare(void* parameter);
-
 // ============================================
 // WEB SERVER HANDLER CLASS
 // ============================================
@@ -176,25 +19,23 @@ void nfcWriteSelectiveTaskMifare(void* parameter);
  * Architecture:
  * - Separated from main WebServerHandler for modularity
  * - Supports both SRIX (ISO 15693) and Mifare Classic protocols
- * - Uses FreeRTOS tasks on Core 1 for non-blocking operations
+ * - Tag operations run as jobs on the persistent NFCJobEngine worker
+ *   (one engine per PN532 reader, selected with {"reader": N})
  * - All routes require authentication via LoginHandler
  * 
  * Route Categories:
- * 1. SRIX API: read, write, compare, write-selective
- * 2. Mifare API: read, read-uid, write, clone, compare, write-selective
- * 3. Unified API: save, load, list, delete, status (protocol-agnostic)
- * 4. Static Files: nfc-tab.html, nfc-app.js (frontend assets)
+ * 1. Job API: POST /api/nfc/jobs (submit), GET /api/nfc/jobs?id= (status),
+ *    GET /api/nfc/events (Server-Sent Events: job, progress, auth)
+ * 2. SRIX API: read, write, compare, write-selective, write-changes (submit a job)
+ * 3. Mifare API: read, read-uid, write, clone, compare, write-selective, write-changes (submit a job)
+ * 4. Unified API: save, load, list, delete, convert, status, current/raw (protocol-agnostic)
+ * 5. Static Files: nfc-tab.html, nfc-app.js (frontend assets)
  * 
- * Task Management:
- * - Long-running operations execute on Core 1 via FreeRTOS tasks
- * - Web server polls task completion with watchdog resets
- * - Automatic cleanup for completed tasks
- * - Timeout protection prevents indefinite blocking
- * 
- * Memory Safety:
- * - Task data structures allocated on heap, not stack
- * - Proper cleanup on timeout or completion
- * - Watchdog timer management to prevent resets
+ * Job Flow:
+ * - Handlers validate input, queue a job and reply 202 {job_id} at once
+ * - Clients follow /api/nfc/events for live progress and completion,
+ *   with GET /api/nfc/jobs?id= as polling fallback
+ * - AsyncTCP callbacks never wait on NFC hardware
  */
 class WebServerHandlerNFC {
 public:
@@ -213,51 +54,57 @@ public:
      */
     void setupRoutes();
 
+    /**
+     * @brief Add a second PN532 reader with its own job engine and worker
+     * @param nfc NFC manager of the reader (already begun)
+     * @return false if NFC_READER_COUNT engines exist or the worker failed to start
+     *
+     * Call after setupRoutes(). Jobs pick the reader with {"reader": N}.
+     */
+    bool addReader(NFCManager& nfc);
+
+    /**
+     * @brief Job engine of a reader (for the serial commander)
+     * @param reader Reader index (0 = primary)
+     * @return nullptr if the reader does not exist
+     */
+    NFCJobEngine* jobs(uint8_t reader = 0) { return reader < _reader_count ? _engines[reader] : nullptr; }
+
 private:
     // ============================================
     // CONSTANTS
     // ============================================
     
-    // Timing constants for task polling
-    static constexpr uint32_t POLL_INTERVAL_MS = 50;           // Standard polling interval
-    static constexpr uint32_t POLL_INTERVAL_SLOW_MS = 100;     // Slow polling for writes
-    static constexpr uint32_t POLL_INTERVAL_VERY_SLOW_MS = 500; // Very slow for long operations
-    static constexpr uint32_t TASK_CLEANUP_DELAY_MS = 100;     // Delay before task cleanup
+    // Timing constants
     static constexpr uint32_t REBOOT_DELAY_MS = 1000;          // Delay before system reboot
     
-    // Timeout margins (added to user-specified timeouts)
-    static constexpr uint32_t TIMEOUT_MARGIN_READ_MS = 2000;   // 2s margin for reads
-    static constexpr uint32_t TIMEOUT_MARGIN_WRITE_MS = 5000;  // 5s margin for writes
-    static constexpr uint32_t SRIX_FULL_WRITE_EXTRA_MS = 90000; // 90s extra for SRIX full write
-    static constexpr uint32_t MIFARE_FULL_WRITE_EXTRA_MS = 40000; // 40s extra for Mifare write
-    static constexpr uint32_t SELECTIVE_WRITE_EXTRA_MS = 10000; // 10s extra for selective write
-    
-    // Retry limits for task completion waiting
-    static constexpr int MAX_RETRIES_STANDARD = 10;            // Standard retry count
-    static constexpr int MAX_RETRIES_LONG_OP = 30;             // For long operations
-    static constexpr int MAX_RETRIES_VERY_LONG_OP = 50;        // For very long operations
-    
-    // Task configuration
-    static constexpr uint32_t TASK_STACK_SIZE_SMALL = 8192;    // 8KB for simple tasks
-    static constexpr uint32_t TASK_STACK_SIZE_MEDIUM = 10240;  // 10KB for Mifare (auth)
-    static constexpr uint32_t TASK_STACK_SIZE_LARGE = 16384;   // 16KB for selective writes
-    static constexpr uint8_t TASK_PRIORITY = 1;                // FreeRTOS task priority
-    static constexpr uint8_t TASK_CORE_ID = 1;                 // Core 1 (opposite of web server)
-    
     // Block limits
     static constexpr uint8_t SRIX_MAX_BLOCK = 127;             // SRIX block range: 0-127
-    
-    // Estimated timing for selective writes
-    static constexpr uint32_t MS_PER_BLOCK_SRIX = 2600;        // ~2.6s per SRIX block
-    
-    // Dump preview size
-    static constexpr size_t DUMP_PREVIEW_BYTES = 64;           // First 64 bytes for preview
+
+    // Memory
+    static constexpr size_t REQUEST_ARENA_SIZE = 4096;         // Job submit/status documents
     
     // HTTP status codes
     static constexpr int HTTP_OK = 200;
+    static constexpr int HTTP_ACCEPTED = 202;
+    static constexpr int HTTP_PARTIAL_CONTENT = 206;
     static constexpr int HTTP_BAD_REQUEST = 400;
     static constexpr int HTTP_UNAUTHORIZED = 401;
+    static constexpr int HTTP_NOT_FOUND = 404;
+    static constexpr int HTTP_CONFLICT = 409;
+    static constexpr int HTTP_RANGE_NOT_SATISFIABLE = 416;
     static constexpr int HTTP_INTERNAL_ERROR = 500;
+    static constexpr int HTTP_SERVICE_UNAVAILABLE = 503;
+
+    // ============================================
+    // TYPES
+    // ============================================
+
+    enum RangeResult : uint8_t {
+        RANGE_NONE = 0,       // No (usable) Range header: full body
+        RANGE_OK,             // Serve [start, end]
+        RANGE_INVALID         // Unsatisfiable: 416
+    };
 
     // ============================================
     // MEMBER VARIABLES
@@ -266,130 +113,108 @@ private:
     AsyncWebServer& _server;          // Reference to web server
     NFCManager& _nfc;                 // Reference to NFC manager
     LoginHandler& _loginHandler;      // Reference to authentication handler
+    NFCJobEngine _jobs;               // Persistent NFC worker + job queue (reader 0)
+    NFCJobEngine* _engines[NFC_MAX_READERS]; // Engine per reader (_engines[0] = &_jobs)
+    uint8_t _reader_count;            // Engines in use
+    AsyncEventSource _events;         // SSE push channel (/api/nfc/events)
+    StaticJsonArena<REQUEST_ARENA_SIZE> _arena; // Job API documents (AsyncTCP task only)
 
     // ============================================
-    // SRIX HANDLERS (ISO 15693)
+    // JOB HANDLERS
     // ============================================
     
     /**
-     * @brief Handle SRIX tag read request
+     * @brief Handle generic job submission (POST /api/nfc/jobs)
      * @param request HTTP request
      * @param data JSON body data
      * @param len Data length
      * 
-     * JSON input: {timeout: seconds}
-     * JSON output: {success, message, protocol, uid, size, dump}
+     * JSON input: {type: "srix_read"|"mifare_write"|..., timeout: seconds, blocks: [..],
+     *              reader: N, source: N}
+     * JSON output (202): {success, job_id, reader, type, state}
      */
-    void handleSRIXRead(AsyncWebServerRequest* request, uint8_t* data, size_t len);
+    void handleJobSubmit(AsyncWebServerRequest* request, uint8_t* data, size_t len);
 
     /**
-     * @brief Handle SRIX tag write request
+     * @brief Handle job status poll (GET /api/nfc/jobs?id=N)
      * @param request HTTP request
-     * @param data JSON body data
-     * @param len Data length
      * 
-     * Writes loaded data to physical tag. Can take 90+ seconds for full write.
-     * JSON input: {timeout: seconds}
+     * JSON output: {job_id, type, state, elapsed_ms, result}
+     * result is only present once state is "done" and has the same
+     * fields the blocking endpoints used to return. Ids are unique
+     * across readers, so every engine is searched.
      */
-    void handleSRIXWrite(AsyncWebServerRequest* request, uint8_t* data, size_t len);
+    void handleJobStatus(AsyncWebServerRequest* request);
 
     /**
-     * @brief Wait for SRIX tag presence (polling)
+     * @brief Validate body and queue a job of the given type
      * @param request HTTP request
+     * @param type Job type to queue
+     * @param doc Parsed JSON body (timeout, blocks)
      * 
-     * Blocks until tag detected or timeout.
+     * Shared by /api/nfc/jobs and the per-protocol endpoints.
+     * "reader" picks the engine (default 0). "source" runs the job on the
+     * dump loaded on another reader (cross-reader clone/write).
+     * Replies 202 with job id, 400 on invalid input or unknown reader,
+     * 409 if the source reader is busy, 503 if queue is full.
      */
-    void handleSRIXWait(AsyncWebServerRequest* request);
+    void submitJob(AsyncWebServerRequest* request, NFCJobEngine::JobType type, JsonDocument& doc);
 
     /**
-     * @brief Compare loaded dump with physical tag
-     * @param request HTTP request
-     * @param data JSON body data
-     * @param len Data length
-     * 
-     * Reads physical tag and compares with loaded data.
-     * Returns block-by-block differences.
-     */
-    void handleSRIXCompare(AsyncWebServerRequest* request, uint8_t* data, size_t len);
-
-    /**
-     * @brief Write only specified blocks to tag
-     * @param request HTTP request
-     * @param data JSON body data
-     * @param len Data length
-     * 
-     * JSON input: {blocks: [array of block numbers 0-127]}
-     * Estimated time: ~2.6s per block.
-     */
-    void handleSRIXWriteSelective(AsyncWebServerRequest* request, uint8_t* data, size_t len);
-
-    // ============================================
-    // MIFARE HANDLERS
-    // ============================================
-    
-    /**
-     * @brief Handle Mifare tag full dump read
+     * @brief Parse body and queue a job (per-protocol endpoints)
      * @param request HTTP request
+     * @param type Job type to queue
      * @param data JSON body data
      * @param len Data length
-     * 
-     * Performs full sector read with authentication.
-     * JSON input: {timeout: seconds}
      */
-    void handleMifareRead(AsyncWebServerRequest* request, uint8_t* data, size_t len);
+    void submitJob(AsyncWebServerRequest* request, NFCJobEngine::JobType type, uint8_t* data, size_t len);
 
     /**
-     * @brief Handle Mifare UID-only read
+     * @brief Engine selected by the "reader" parameter (query or form body)
      * @param request HTTP request
-     * @param data JSON body data
-     * @param len Data length
-     * 
-     * Fast UID read without authentication or dump.
-     * JSON input: {timeout: seconds}
+     * @return Engine (default reader 0), nullptr after replying 400 for an
+     *         unknown reader
+     *
+     * Same reader numbering as submitJob() for the non-job endpoints.
      */
-    void handleMifareReadUID(AsyncWebServerRequest* request, uint8_t* data, size_t len);
+    NFCJobEngine* readerEngine(AsyncWebServerRequest* request);
 
     /**
-     * @brief Handle Mifare tag write request
-     * @param request HTTP request
-     * @param data JSON body data
-     * @param len Data length
+     * @brief Job engine event sink: forward event to SSE clients
+     * @param event SSE event name ("job", "progress", "auth", "batch")
+     * @param json Serialized JSON payload
+     * @param context Pointer to WebServerHandlerNFC instance
      * 
-     * Writes loaded data to physical tag with authentication.
-     * Mifare 1K: ~30+ seconds for 16 sectors.
+     * No-op when no browser is connected to /api/nfc/events.
      */
-    void handleMifareWrite(AsyncWebServerRequest* request, uint8_t* data, size_t len);
+    static void onJobEvent(const char* event, const char* json, void* context);
 
     /**
-     * @brief Handle Mifare UID clone request
+     * @brief Stop a running batch scan (POST /api/nfc/batch/stop)
      * @param request HTTP request
-     * @param data JSON body data
-     * @param len Data length
      * 
-     * Clones UID to magic card (Gen2/CUID).
-     * Requires compatible writable card.
+     * JSON output: {success, message, running}. The batch job finishes
+     * within one detection slice and reports its totals as its result.
+     * Optional reader=N.
      */
-    void handleMifareClone(AsyncWebServerRequest* request, uint8_t* data, size_t len);
+    void handleBatchStop(AsyncWebServerRequest* request);
 
     /**
-     * @brief Compare loaded Mifare dump with physical tag
+     * @brief Live batch scan counters (GET /api/nfc/batch)
      * @param request HTTP request
-     * @param data JSON body data
-     * @param len Data length
      * 
-     * Reads physical tag and compares with loaded data.
+     * JSON output: {success, reader, running, tags, saved, duplicates, failed, elapsed_ms}
+     * Optional ?reader=N.
      */
-    void handleMifareCompare(AsyncWebServerRequest* request, uint8_t* data, size_t len);
+    void handleBatchStatus(AsyncWebServerRequest* request);
 
     /**
-     * @brief Write only specified blocks to Mifare tag
+     * @brief Wait for SRIX tag presence (polling)
      * @param request HTTP request
-     * @param data JSON body data
-     * @param len Data length
      * 
-     * JSON input: {blocks: [array of block numbers]}
+     * Blocks until tag detected or timeout.
      */
-    void handleMifareWriteSelective(AsyncWebServerRequest* request, uint8_t* data, size_t len);
+    void handleSRIXWait(AsyncWebServerRequest* request);
 
     // ============================================
     // UNIFIED HANDLERS (PROTOCOL-AGNOSTIC)
@@ -399,7 +224,7 @@ private:
      * @brief Save current tag dump to LittleFS
      * @param request HTTP request with ?filename= parameter
      * 
-     * Saves as .srix or .mfc depending on protocol.
+     * Saves as .srix or .mfc depending on protocol (.nfcb if requested).
      */
     void handleSave(AsyncWebServerRequest* request);
 
@@ -407,7 +232,7 @@ private:
      * @brief Load tag dump from LittleFS
      * @param request HTTP request with ?filename= parameter
      * 
-     * Loads .srix or .mfc file into memory.
+     * Loads .srix, .mfc or .nfcb file into memory.
      */
     void handleLoad(AsyncWebServerRequest* request);
 
@@ -415,7 +240,8 @@ private:
      * @brief List all saved tag dumps
      * @param request HTTP request
      * 
-     * Returns JSON array of filenames with metadata.
+     * Returns JSON array of filenames with metadata (UID, size, mtime, CRC)
+     * from the dump catalog. Query: protocol, uid, offset, limit, rebuild=1.
      */
     void handleList(AsyncWebServerRequest* request);
 
@@ -425,52 +251,60 @@ private:
      */
     void handleDelete(AsyncWebServerRequest* request);
 
+    /**
+     * @brief Convert dump between text (.srix/.mfc) and binary (.nfcb)
+     * @param request HTTP request with filename= POST parameter
+     * 
+     * Writes the converted copy next to the source file.
+     */
+    void handleConvert(AsyncWebServerRequest* request);
+
     /**
      * @brief Get NFC system status
      * @param request HTTP request
      * 
-     * Returns: ready, srix_hw, has_data, protocol, uid.
+     * Returns: reader, ready, srix_hw, has_data, busy, readers, protocol, uid
+     * for ?reader=N (default 0).
      */
     void handleStatus(AsyncWebServerRequest* request);
 
+    /**
+     * @brief Download the loaded dump as raw bytes (GET /api/nfc/current/raw)
+     * @param request HTTP request (optional single "Range: bytes=" header, ?reader=N)
+     * 
+     * Streams straight from the in-memory dump, no hex encoding.
+     * Headers: X-NFC-Protocol, X-NFC-UID, X-NFC-CRC32 (whole dump), Accept-Ranges.
+     * Replies 200 / 206 (range) / 416 (unsatisfiable range),
+     * 404 if nothing is loaded, 503 while a job may replace the dump.
+     */
+    void handleRawDump(AsyncWebServerRequest* request);
+
+    /**
+     * @brief Parse a single-range "bytes=" header
+     * @param header Range header value
+     * @param size Resource size
+     * @param start First byte (output)
+     * @param end Last byte, inclusive (output)
+     * @return RANGE_NONE (serve everything), RANGE_OK or RANGE_INVALID
+     * 
+     * Multi-range and non-byte units are ignored (full response); a
+     * non-numeric position ("bytes=abc-") is RANGE_INVALID.
+     */
+    static RangeResult parseRange(const String& header, size_t size, size_t& start, size_t& end);
+
     // ============================================
     // STATIC FILE HANDLERS
     // ============================================
     
     /**
-     * @brief Serve NFC tab HTML (gzipped)
+     * @brief Serve NFC tab HTML (gzipped, cached via WebAssets)
      * @param request HTTP request
      */
     void handleNFCTabHTML(AsyncWebServerRequest* request);
 
     /**
-     * @brief Serve NFC app JavaScript (gzipped)
+     * @brief Serve NFC app JavaScript (gzipped, cached via WebAssets)
      * @param request HTTP request
      */
     void handleNFCAppJS(AsyncWebServerRequest* request);
-
-    // ============================================
-    // HELPER FUNCTIONS
-    // ============================================
-    
-    /**
-     * @brief Compare two tag dumps and generate difference report
-     * @param loadedData Pointer to loaded dump data
-     * @param loadedSize Size of loaded dump
-     * @param physicalData Pointer to physical tag data
-     * @param physicalSize Size of physical tag data
-     * @param responseDoc JSON document to populate with results
-     * 
-     * Populates responseDoc with:
-     * - identical: boolean
-     * - total_blocks: number
-     * - different_blocks: number
-     * - differences: array of {block, loaded, physical}
-     */
-    void compareTagData(
-        const uint8_t* loadedData,
-        size_t loadedSize,
-        const uint8_t* physicalData,
-        size_t physicalSize,
-        JsonDocument& responseDoc);
 };
@@ -0,0 +1,303 @@
+#include "zip_restore.h"
+#include <esp_rom_crc.h>
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+ZipRestore::ZipRestore(const String& root, const char* skip)
+    : _root(root), _skip(skip), _state(STATE_SIGNATURE), _failed(false),
+      _header_len(0), _name_len(0), _flags(0), _method(0), _extra_len(0), _size(0),
+      _crc_expected(0), _remaining(0), _writing(false), _discard(false),
+      _crc(0), _entry_bytes(0), _buffered(0), _tail_len(0),
+      _files(0), _skipped(0), _bytes(0)
+{
+    if (!_root.endsWith("/")) _root += "/";
+    _name[0] = '\0';
+}
+
+ZipRestore::~ZipRestore() {
+    // Upload aborted mid-entry: drop the partial file
+    if (_file) {
+        _file.close();
+        LittleFS.remove(_path);
+    }
+}
+
+// ============================================
+// STREAMING
+// ============================================
+
+bool ZipRestore::write(const uint8_t* data, size_t len) {
+    size_t pos = 0;
+
+    while (pos < len && !_failed && _state != STATE_DONE) {
+        switch (_state) {
+            case STATE_SIGNATURE: {
+                pos += collect(data + pos, len - pos, 4);
+                if (_header_len < 4) break;
+
+                uint32_t sig = le32(_header);
+                _header_len = 0;
+
+                if (sig == LOCAL_HEADER_SIG) {
+                    _state = STATE_HEADER;
+                } else if (sig == CENTRAL_HEADER_SIG || sig == END_CENTRAL_SIG) {
+                    _state = STATE_DONE;
+                } else {
+                    fail("Not a ZIP archive or unsupported layout");
+                }
+                break;
+            }
+
+            case STATE_HEADER: {
+                pos += collect(data + pos, len - pos, LOCAL_HEADER_SIZE);
+                if (_header_len < LOCAL_HEADER_SIZE) break;
+
+                _flags = le16(_header + 2);
+                _method = le16(_header + 4);
+                _crc_expected = le32(_header + 10);
+                _size = le32(_header + 14);
+                _name_len = le16(_header + 22);
+                _extra_len = le16(_header + 24);
+                _header_len = 0;
+
+                if (_name_len == 0 || _name_len > MAX_PATH_LEN) {
+                    fail("Invalid entry name length");
+                    break;
+                }
+                _remaining = _name_len;
+                _state = STATE_NAME;
+                break;
+            }
+
+            case STATE_NAME: {
+                size_t n = _remaining < len - pos ? _remaining : len - pos;
+                memcpy(_name + (_name_len - _remaining), data + pos, n);
+                pos += n;
+                _remaining -= n;
+
+                if (_remaining == 0) {
+                    _name[_name_len] = '\0';
+                    _remaining = _extra_len;
+                    _state = STATE_EXTRA;
+                }
+                break;
+            }
+
+            case STATE_EXTRA: {
+                size_t n = _remaining < len - pos ? _remaining : len - pos;
+                pos += n;
+                _remaining -= n;
+
+                if (_remaining == 0) {
+                    beginEntry();
+                }
+                break;
+            }
+
+            case STATE_DATA: {
+                size_t n = _remaining < len - pos ? _remaining : len - pos;
+                emit(data + pos, n);
+                pos += n;
+                _remaining -= n;
+
+                if (_remaining == 0) {
+                    if (_flags & FLAG_DATA_DESCRIPTOR) {
+                        _state = STATE_DESCRIPTOR;
+                    } else {
+                        endEntry(_crc_expected);
+                    }
+                }
+                break;
+            }
+
+            case STATE_DATA_SCAN: {
+                // Hold back the last 16 bytes until they can't be the descriptor
+                while (pos < len) {
+                    if (_tail_len == DESCRIPTOR_SIZE) {
+                        emit(_tail, 1);
+                        memmove(_tail, _tail + 1, DESCRIPTOR_SIZE - 1);
+                        _tail_len--;
+                    }
+                    _tail[_tail_len++] = data[pos++];
+
+                    if (_tail_len == DESCRIPTOR_SIZE && le32(_tail) == DATA_DESCRIPTOR_SIG &&
+                        le32(_tail + 8) == _entry_bytes && le32(_tail + 12) == _entry_bytes) {
+                        uint32_t crc = esp_rom_crc32_le(_crc, _buffer, _buffered);
+                        if (le32(_tail + 4) == crc) {
+                            _tail_len = 0;
+                            endEntry(crc);
+                            break;
+                        }
+                    }
+                }
+                break;
+            }
+
+            case STATE_DESCRIPTOR: {
+                // Signature is optional: 16 bytes with, 12 without
+                pos += collect(data + pos, len - pos, 4);
+                if (_header_len < 4) break;
+
+                size_t target = (le32(_header) == DATA_DESCRIPTOR_SIG) ? DESCRIPTOR_SIZE : DESCRIPTOR_SIZE - 4;
+                pos += collect(data + pos, len - pos, target);
+                if (_header_len < target) break;
+
+                endEntry(le32(_header + (target - 12)));
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    return !_failed;
+}
+
+bool ZipRestore::finish() {
+    if (!_failed && _state != STATE_DONE) {
+        fail("Archive truncated");
+    }
+
+    LOG_INFO("ZIP", "Restore %s: %u files, %lu bytes, %u skipped",
+             _failed ? "failed" : "complete", _files, (unsigned long)_bytes, _skipped);
+    return !_failed;
+}
+
+// ============================================
+// ENTRY HANDLING
+// ============================================
+
+size_t ZipRestore::collect(const uint8_t* data, size_t len, size_t target) {
+    size_t n = target - _header_len;
+    if (n > len) n = len;
+
+    memcpy(_header + _header_len, data, n);
+    _header_len += n;
+    return n;
+}
+
+void ZipRestore::beginEntry() {
+    String name = String(_name);
+    bool has_descriptor = (_flags & FLAG_DATA_DESCRIPTOR) && _size == 0;
+
+    _writing = false;
+    _discard = false;
+    _crc = 0;
+    _entry_bytes = 0;
+    _buffered = 0;
+    _tail_len = 0;
+    _remaining = _size;
+    _state = has_descriptor ? STATE_DATA_SCAN : STATE_DATA;
+
+    if (_method != METHOD_STORED || (_flags & FLAG_ENCRYPTED)) {
+        if (has_descriptor) {
+            fail("Compressed entry without size: " + name);
+            return;
+        }
+        LOG_WARN("ZIP", "Skipping compressed/encrypted entry: %s", _name);
+        _discard = true;
+        _skipped++;
+        return;
+    }
+
+    // No absolute paths, no escaping the restore root
+    if (name.startsWith("/") || name.indexOf("..") >= 0 || name.indexOf('\\') >= 0) {
+        LOG_WARN("ZIP", "Skipping unsafe entry: %s", _name);
+        _skipped++;
+        return;
+    }
+
+    _path = _root + name;
+
+    if (name.endsWith("/")) {
+        String dir = _path.substring(0, _path.length() - 1);
+        if (!LittleFS.exists(dir) && !LittleFS.mkdir(dir)) {
+            LOG_WARN("ZIP", "Failed to create directory: %s", dir.c_str());
+        }
+        return;
+    }
+
+    if (_skip && _path == _skip) {
+        LOG_DEBUG("ZIP", "Not restoring %s", _path.c_str());
+        _skipped++;
+        return;
+    }
+
+    _file = LittleFS.open(_path, FILE_WRITE, true);
+    if (!_file) {
+        fail("Failed to create " + _path);
+        return;
+    }
+    _writing = true;
+}
+
+void ZipRestore::endEntry(uint32_t expected_crc) {
+    flush();
+
+    if (_file) {
+        _file.close();
+    }
+
+    if (!_failed && _writing) {
+        if (_crc != expected_crc) {
+            LittleFS.remove(_path);
+            fail("CRC mismatch: " + _path);
+        } else {
+            _files++;
+            _bytes += _entry_bytes;
+            LOG_DEBUG("ZIP", "Restored %s (%lu bytes)", _path.c_str(), (unsigned long)_entry_bytes);
+            if (_on_file) _on_file(_path);
+        }
+    }
+
+    _writing = false;
+    _discard = false;
+    _header_len = 0;
+    _state = STATE_SIGNATURE;
+}
+
+void ZipRestore::emit(const uint8_t* data, size_t len) {
+    _entry_bytes += len;
+    if (_discard) return;
+
+    while (len > 0) {
+        size_t n = WRITE_BUFFER_SIZE - _buffered;
+        if (n > len) n = len;
+
+        memcpy(_buffer + _buffered, data, n);
+        _buffered += n;
+        data += n;
+        len -= n;
+
+        if (_buffered == WRITE_BUFFER_SIZE) {
+            flush();
+        }
+    }
+}
+
+void ZipRestore::flush() {
+    if (_buffered == 0 || _discard) return;
+
+    _crc = esp_rom_crc32_le(_crc, _buffer, _buffered);
+
+    if (_file && _file.write(_buffer, _buffered) != _buffered) {
+        fail("Write failed (filesystem full?): " + _path);
+    }
+    _buffered = 0;
+}
+
+void ZipRestore::fail(const String& message) {
+    if (_failed) return;
+
+    _failed = true;
+    _error = message;
+    LOG_ERROR("ZIP", "Restore failed: %s", message.c_str());
+
+    if (_file) {
+        _file.close();
+        LittleFS.remove(_path);
+    }
+}
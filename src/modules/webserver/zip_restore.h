@@ -0,0 +1,151 @@
+#pragma once
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <functional>
+#include "logger.h"
+
+/**
+ * @brief ZipRestore - Push-based ZIP extractor for streamed uploads
+ *
+ * Architecture:
+ * - write() is fed the archive chunk by chunk as it arrives from the
+ *   socket; entries are unpacked to LittleFS as soon as their bytes
+ *   arrive, nothing is staged on flash or in RAM
+ * - Parses local headers only (no seeking to the central directory);
+ *   parsing stops at the first central directory record
+ * - Stored entries only: compressed entries are skipped when their
+ *   size is known, otherwise the restore fails
+ * - Entries with a data descriptor and no size in the local header
+ *   (as written by ZipStream) end where a descriptor signature is
+ *   followed by the running CRC32 and byte count
+ * - CRC32 verified for every file; a mismatch deletes the file and
+ *   fails the restore (truncated or corrupt upload)
+ *
+ * Usage:
+ * @code
+ * ZipRestore zip("/");
+ * zip.write(chunk, len);      // repeat per chunk
+ * bool ok = zip.finish();
+ * @endcode
+ */
+class ZipRestore {
+public:
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr uint32_t LOCAL_HEADER_SIG = 0x04034b50;
+    static constexpr uint32_t CENTRAL_HEADER_SIG = 0x02014b50;
+    static constexpr uint32_t END_CENTRAL_SIG = 0x06054b50;
+    static constexpr uint32_t DATA_DESCRIPTOR_SIG = 0x08074b50;
+    static constexpr uint16_t FLAG_ENCRYPTED = 0x0001;
+    static constexpr uint16_t FLAG_DATA_DESCRIPTOR = 0x0008;
+    static constexpr uint16_t METHOD_STORED = 0;
+    static constexpr size_t LOCAL_HEADER_SIZE = 26;          // After the signature
+    static constexpr size_t DESCRIPTOR_SIZE = 16;            // With signature
+    static constexpr size_t MAX_PATH_LEN = 255;
+    static constexpr size_t WRITE_BUFFER_SIZE = 512;         // Bytes batched per file write
+
+    /**
+     * @brief Callback for every file restored
+     */
+    using FileCallback = std::function<void(const String& path)>;
+
+    /**
+     * @brief Prepare a restore below root
+     * @param root Destination folder (with trailing '/')
+     * @param skip Full path never written (nullptr: none)
+     */
+    explicit ZipRestore(const String& root = "/", const char* skip = nullptr);
+    ~ZipRestore();
+
+    /**
+     * @brief Feed the next part of the archive
+     * @param data Chunk
+     * @param len Chunk length
+     * @return false once the restore has failed
+     */
+    bool write(const uint8_t* data, size_t len);
+
+    /**
+     * @brief End of upload
+     * @return true if the archive ended on its central directory
+     */
+    bool finish();
+
+    void onFile(FileCallback callback) { _on_file = callback; }
+
+    bool failed() const { return _failed; }
+    const String& error() const { return _error; }
+    uint16_t filesRestored() const { return _files; }
+    uint16_t entriesSkipped() const { return _skipped; }
+    uint32_t bytesRestored() const { return _bytes; }
+
+private:
+    // ============================================
+    // TYPES
+    // ============================================
+
+    enum State : uint8_t {
+        STATE_SIGNATURE = 0,
+        STATE_HEADER,
+        STATE_NAME,
+        STATE_EXTRA,
+        STATE_DATA,             // Known size
+        STATE_DATA_SCAN,        // Size only in the trailing descriptor
+        STATE_DESCRIPTOR,       // Descriptor after known-size data
+        STATE_DONE
+    };
+
+    // ============================================
+    // HELPERS
+    // ============================================
+
+    size_t collect(const uint8_t* data, size_t len, size_t target);
+    void beginEntry();
+    void endEntry(uint32_t expected_crc);
+    void emit(const uint8_t* data, size_t len);
+    void flush();
+    void fail(const String& message);
+    static uint16_t le16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+    static uint32_t le32(const uint8_t* p) { return le16(p) | ((uint32_t)le16(p + 2) << 16); }
+
+    // ============================================
+    // STATE
+    // ============================================
+
+    String _root;
+    const char* _skip;
+    FileCallback _on_file;
+    State _state;
+    bool _failed;
+    String _error;
+
+    uint8_t _header[LOCAL_HEADER_SIZE];      // Signature / local header / descriptor bytes
+    size_t _header_len;
+    char _name[MAX_PATH_LEN + 1];
+    size_t _name_len;
+
+    uint16_t _flags;
+    uint16_t _method;
+    uint16_t _extra_len;
+    uint32_t _size;                          // Stored size from the local header
+    uint32_t _crc_expected;
+    uint32_t _remaining;                     // Bytes left in the current state
+    bool _writing;                           // Entry goes to _file
+    bool _discard;                           // Entry skipped unchecked (compressed)
+
+    File _file;
+    String _path;
+    uint32_t _crc;                           // CRC32 of bytes flushed so far
+    uint32_t _entry_bytes;
+    uint8_t _buffer[WRITE_BUFFER_SIZE];      // Pending file bytes
+    size_t _buffered;
+    uint8_t _tail[DESCRIPTOR_SIZE];          // Held back while scanning for a descriptor
+    size_t _tail_len;
+
+    uint16_t _files;
+    uint16_t _skipped;
+    uint32_t _bytes;
+};
@@ -0,0 +1,255 @@
+#include "zip_stream.h"
+#include <esp_rom_crc.h>
+
+// ============================================
+// CONSTRUCTOR
+// ============================================
+
+ZipStream::ZipStream(const String& root, const char* skip)
+    : _index(0), _state(STATE_LOCAL_HEADER), _offset(0),
+      _central_start(0), _central_size(0), _staged(0), _staged_pos(0)
+{
+    collect(root, skip);
+    LOG_DEBUG("ZIP", "Archive entries: %d", (int)_entries.size());
+}
+
+ZipStream::~ZipStream() {
+    if (_file) {
+        _file.close();
+    }
+}
+
+// ============================================
+// STREAMING
+// ============================================
+
+size_t ZipStream::read(uint8_t* buffer, size_t max_len) {
+    size_t written = 0;
+
+    while (written < max_len && _state != STATE_DONE) {
+        // Pending header bytes go out first
+        if (_staged_pos < _staged) {
+            size_t n = _staged - _staged_pos;
+            if (n > max_len - written) n = max_len - written;
+
+            memcpy(buffer + written, _staging + _staged_pos, n);
+            _staged_pos += n;
+            _offset += n;
+            written += n;
+            continue;
+        }
+
+        switch (_state) {
+            case STATE_LOCAL_HEADER: {
+                if (_index >= _entries.size()) {
+                    _central_start = _offset;
+                    _index = 0;
+                    _state = STATE_CENTRAL;
+                    break;
+                }
+
+                Entry& entry = _entries[_index];
+                entry.offset = _offset;
+                stageLocalHeader(entry);
+
+                if (entry.is_dir) {
+                    _index++;
+                    break;
+                }
+
+                _file = LittleFS.open("/" + entry.path, FILE_READ);
+                if (!_file) {
+                    LOG_WARN("ZIP", "Cannot open /%s, stored empty", entry.path.c_str());
+                }
+                _state = STATE_FILE_DATA;
+                break;
+            }
+
+            case STATE_FILE_DATA: {
+                Entry& entry = _entries[_index];
+                size_t n = _file ? _file.read(buffer + written, max_len - written) : 0;
+
+                if (n > 0) {
+                    entry.crc = esp_rom_crc32_le(entry.crc, buffer + written, n);
+                    entry.size += n;
+                    _offset += n;
+                    written += n;
+                    break;
+                }
+
+                // EOF (or read error): close and emit the real CRC/size
+                if (_file) {
+                    _file.close();
+                }
+                stageDescriptor(entry);
+                _state = STATE_DESCRIPTOR;
+                break;
+            }
+
+            case STATE_DESCRIPTOR:
+                _index++;
+                _state = STATE_LOCAL_HEADER;
+                break;
+
+            case STATE_CENTRAL:
+                if (_index >= _entries.size()) {
+                    _central_size = _offset - _central_start;
+                    stageEnd();
+                    _state = STATE_END;
+                    break;
+                }
+                stageCentralHeader(_entries[_index]);
+                _index++;
+                break;
+
+            case STATE_END:
+                _state = STATE_DONE;
+                LOG_INFO("ZIP", "Archive complete: %d entries, %lu bytes",
+                         (int)_entries.size(), (unsigned long)_offset);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return written;
+}
+
+// ============================================
+// ENTRY COLLECTION
+// ============================================
+
+void ZipStream::collect(const String& path, const char* skip) {
+    File dir = LittleFS.open(path);
+    if (!dir || !dir.isDirectory()) {
+        LOG_WARN("ZIP", "Failed to open directory: %s", path.c_str());
+        return;
+    }
+
+    File file = dir.openNextFile();
+    while (file) {
+        // Build full path (handles both ESP32 Core 2.x and 3.x)
+        String fileName = String(file.name());
+        String fullPath;
+
+        if (fileName.startsWith("/")) {
+            fullPath = fileName;
+        } else {
+            fullPath = path;
+            if (!fullPath.endsWith("/")) fullPath += "/";
+            fullPath += fileName;
+        }
+
+        bool is_dir = file.isDirectory();
+        file.close();
+
+        // Skip hidden files, placeholders and the excluded path
+        if (fileName.startsWith(".") || fullPath.endsWith("/.keep") ||
+            (skip && fullPath == skip)) {
+            file = dir.openNextFile();
+            continue;
+        }
+
+        String zipPath = fullPath.substring(1);
+        if (is_dir) zipPath += "/";
+
+        if (zipPath.length() > MAX_PATH_LEN || _entries.size() >= MAX_ENTRIES) {
+            LOG_WARN("ZIP", "Skipping entry: %s", fullPath.c_str());
+            file = dir.openNextFile();
+            continue;
+        }
+
+        Entry entry = {zipPath, 0, 0, 0, is_dir};
+        _entries.push_back(entry);
+
+        if (is_dir) {
+            collect(fullPath, skip);
+        }
+
+        file = dir.openNextFile();
+    }
+
+    dir.close();
+}
+
+// ============================================
+// RECORD STAGING
+// ============================================
+
+void ZipStream::stageLocalHeader(const Entry& entry) {
+    _staged = _staged_pos = 0;
+
+    put32(LOCAL_HEADER_SIG);
+    put16(VERSION);                                         // Version needed to extract
+    put16(entry.is_dir ? 0 : FLAG_DATA_DESCRIPTOR);         // General purpose bit flag
+    put16(0);                                               // Compression (0 = stored)
+    put16(0);                                               // Last mod file time
+    put16(0);                                               // Last mod file date
+    put32(0);                                               // CRC-32 (in descriptor)
+    put32(0);                                               // Compressed size
+    put32(0);                                               // Uncompressed size
+    put16(entry.path.length());                             // Filename length
+    put16(0);                                               // Extra field length
+    putPath(entry.path);
+}
+
+void ZipStream::stageDescriptor(const Entry& entry) {
+    _staged = _staged_pos = 0;
+
+    put32(DATA_DESCRIPTOR_SIG);
+    put32(entry.crc);                                       // CRC-32
+    put32(entry.size);                                      // Compressed size
+    put32(entry.size);                                      // Uncompressed size
+}
+
+void ZipStream::stageCentralHeader(const Entry& entry) {
+    _staged = _staged_pos = 0;
+
+    put32(CENTRAL_HEADER_SIG);
+    put16(VERSION);                                         // Version made by
+    put16(VERSION);                                         // Version needed to extract
+    put16(entry.is_dir ? 0 : FLAG_DATA_DESCRIPTOR);         // General purpose bit flag
+    put16(0);                                               // Compression method
+    put16(0);                                               // Last mod file time
+    put16(0);                                               // Last mod file date
+    put32(entry.crc);                                       // CRC-32
+    put32(entry.size);                                      // Compressed size
+    put32(entry.size);                                      // Uncompressed size
+    put16(entry.path.length());                             // Filename length
+    put16(0);                                               // Extra field length
+    put16(0);                                               // File comment length
+    put16(0);                                               // Disk number start
+    put16(0);                                               // Internal file attributes
+    put32(entry.is_dir ? 0x10 : 0);                         // External attributes (0x10 = directory)
+    put32(entry.offset);                                    // Relative offset of local header
+    putPath(entry.path);
+}
+
+void ZipStream::stageEnd() {
+    _staged = _staged_pos = 0;
+
+    put32(END_CENTRAL_SIG);
+    put16(0);                                               // Number of this disk
+    put16(0);                                               // Disk where central directory starts
+    put16(_entries.size());                                 // Entries on this disk
+    put16(_entries.size());                                 // Total entries
+    put32(_central_size);                                   // Size of central directory
+    put32(_central_start);                                  // Offset of central directory
+    put16(0);                                               // Comment length
+}
+
+void ZipStream::put16(uint16_t value) {
+    _staging[_staged++] = value & 0xFF;
+    _staging[_staged++] = (value >> 8) & 0xFF;
+}
+
+void ZipStream::put32(uint32_t value) {
+    put16(value & 0xFFFF);
+    put16(value >> 16);
+}
+
+void ZipStream::putPath(const String& path) {
+    memcpy(_staging + _staged, path.c_str(), path.length());
+    _staged += path.length();
+}
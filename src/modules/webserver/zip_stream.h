@@ -0,0 +1,124 @@
+#pragma once
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <vector>
+#include "logger.h"
+
+/**
+ * @brief ZipStream - Pull-based ZIP writer for chunked HTTP responses
+ *
+ * Architecture:
+ * - Constructor walks the filesystem and records entry names only
+ * - read() is called from the chunked response filler and emits the
+ *   archive incrementally: local header, file data, data descriptor,
+ *   then central directory and end record once all files are out
+ * - File data is copied straight from LittleFS into the caller's
+ *   buffer with a running CRC32; headers go through a small fixed
+ *   staging buffer, so RAM use does not depend on file sizes
+ *
+ * Archive Layout (stored, no compression):
+ *   [local header + name][data][descriptor] ... [central dir] [end record]
+ *   Local headers set flag bit 3: CRC and sizes follow in the data
+ *   descriptor, the central directory carries the final values.
+ *
+ * Usage:
+ * @code
+ * auto zip = std::make_shared<ZipStream>("/");
+ * request->beginChunkedResponse("application/zip",
+ *     [zip](uint8_t* buf, size_t max_len, size_t index) {
+ *         return zip->read(buf, max_len);
+ *     });
+ * @endcode
+ */
+class ZipStream {
+public:
+    // ============================================
+    // CONSTANTS
+    // ============================================
+
+    static constexpr uint32_t LOCAL_HEADER_SIG = 0x04034b50;
+    static constexpr uint32_t CENTRAL_HEADER_SIG = 0x02014b50;
+    static constexpr uint32_t END_CENTRAL_SIG = 0x06054b50;
+    static constexpr uint32_t DATA_DESCRIPTOR_SIG = 0x08074b50;
+    static constexpr uint16_t VERSION = 20;
+    static constexpr uint16_t FLAG_DATA_DESCRIPTOR = 0x0008;  // CRC/sizes after data
+    static constexpr size_t LOCAL_HEADER_SIZE = 30;
+    static constexpr size_t CENTRAL_HEADER_SIZE = 46;
+    static constexpr size_t DATA_DESCRIPTOR_SIZE = 16;
+    static constexpr size_t END_CENTRAL_SIZE = 22;
+    static constexpr size_t MAX_PATH_LEN = 255;               // Longer names are skipped
+    static constexpr size_t STAGING_SIZE = CENTRAL_HEADER_SIZE + MAX_PATH_LEN;
+    static constexpr uint16_t MAX_ENTRIES = 0xFFFF;           // No ZIP64
+
+    /**
+     * @brief Build the entry list for everything below root
+     * @param root Folder to archive (default: whole filesystem)
+     * @param skip Full path to leave out (nullptr: none)
+     */
+    explicit ZipStream(const String& root = "/", const char* skip = nullptr);
+    ~ZipStream();
+
+    /**
+     * @brief Produce the next part of the archive
+     * @param buffer Output buffer
+     * @param max_len Buffer size
+     * @return Bytes written (0 = archive complete)
+     */
+    size_t read(uint8_t* buffer, size_t max_len);
+
+    size_t entryCount() const { return _entries.size(); }
+    uint32_t bytesWritten() const { return _offset; }
+    bool done() const { return _state == STATE_DONE; }
+
+private:
+    // ============================================
+    // TYPES
+    // ============================================
+
+    enum State : uint8_t {
+        STATE_LOCAL_HEADER = 0,
+        STATE_FILE_DATA,
+        STATE_DESCRIPTOR,
+        STATE_CENTRAL,
+        STATE_END,
+        STATE_DONE
+    };
+
+    struct Entry {
+        String path;          // Path in archive (no leading /, dirs end with /)
+        uint32_t offset;      // Offset of local header
+        uint32_t size;        // Bytes stored
+        uint32_t crc;         // CRC32 of stored bytes
+        bool is_dir;
+    };
+
+    // ============================================
+    // HELPERS
+    // ============================================
+
+    void collect(const String& path, const char* skip);
+    void stageLocalHeader(const Entry& entry);
+    void stageDescriptor(const Entry& entry);
+    void stageCentralHeader(const Entry& entry);
+    void stageEnd();
+    void put16(uint16_t value);
+    void put32(uint32_t value);
+    void putPath(const String& path);
+
+    // ============================================
+    // STATE
+    // ============================================
+
+    std::vector<Entry> _entries;
+    size_t _index;                       // Current entry
+    State _state;
+    File _file;                          // File being streamed
+    uint32_t _offset;                    // Archive bytes emitted so far
+    uint32_t _central_start;
+    uint32_t _central_size;
+
+    uint8_t _staging[STAGING_SIZE];      // Pending header bytes
+    size_t _staged;
+    size_t _staged_pos;
+};
@@ -490,6 +490,48 @@ btnBackup.addEventListener('click', async () => {
     }
 });
 
+// Restore LittleFS from a backup ZIP
+const btnRestore = document.getElementById('btn-restore');
+const restoreInput = document.getElementById('restore-input');
+btnRestore.addEventListener('click', () => restoreInput.click());
+restoreInput.addEventListener('change', async (e) => {
+    const file = e.target.files[0];
+    if (!file) return;
+
+    const confirmRestore = confirm(`Restore "${file.name}"? Existing files with the same name will be overwritten.`);
+    if (!confirmRestore) {
+        restoreInput.value = '';
+        return;
+    }
+
+    const formData = new FormData();
+    formData.append('file', file);
+
+    try {
+        btnRestore.disabled = true;
+        btnRestore.textContent = '⏳ Restoring...';
+
+        const response = await fetch('/api/restore', { method: 'POST', body: formData });
+        const data = await response.json();
+
+        if (response.ok && data.success) {
+            alert(`Restored ${data.files} file(s)` +
+                  (data.skipped ? `, ${data.skipped} skipped` : '') +
+                  '. Reboot the device to apply restored settings.');
+            refreshFiles();
+        } else {
+            alert('Restore failed: ' + (data.error || response.status));
+        }
+    } catch (error) {
+        console.error('Restore error:', error);
+        alert('Restore error');
+    }
+
+    btnRestore.disabled = false;
+    btnRestore.textContent = 'RESTORE BACKUP';
+    restoreInput.value = '';
+});
+
 // Reboot device
 btnReboot.addEventListener('click', () => {
   openModal(
@@ -803,13 +845,11 @@ async function saveFile() {
     if (!confirmSave) return;
     
     try {
-        const formData = new FormData();
-        formData.append('path', currentFilePath);
-        formData.append('content', editorTextarea.value);
-        
-        const response = await fetch('/api/files/update', {
+        // Raw body: streamed to flash on the device (octet-stream is never parsed as form data)
+        const response = await fetch(`/api/files/update?path=${encodeURIComponent(currentFilePath)}`, {
             method: 'PUT',
-            body: formData
+            headers: { 'Content-Type': 'application/octet-stream' },
+            body: editorTextarea.value
         });
         
         if (response.ok) {
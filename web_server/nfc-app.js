@@ -8,11 +8,18 @@ const NFCModule = {
     currentAction: 'read', // read, load, settings
     currentTag: null,
     loadedFile: null,
+    browseOffset: 0,            // Files already listed in the browser
+    browsePageSize: 50,         // Files per /api/nfc/list page
     settings: {
         readTimeout: 10,
         writeTimeout: 10,
         waitTimeout: 5
     },
+    jobPollInterval: 500,       // ms between job status polls (no event stream)
+    jobPollFallback: 5000,      // ms between safety polls while event stream is up
+    events: null,               // EventSource on /api/nfc/events
+    eventsConnected: false,
+    jobWaiters: {},             // job_id -> resolve(result)
 
     async init() {
         if (this.initialized) return;
@@ -22,6 +29,7 @@ const NFCModule = {
         this.setupEventListeners();
         this.loadSettings();
         this.updateNFCStatus();
+        this.connectEvents();
         
         this.initialized = true;
         console.log('[NFC] Module initialized');
@@ -86,6 +94,16 @@ const NFCModule = {
             browseBtn.addEventListener('click', () => this.handleBrowse());
         }
 
+        const browseMoreBtn = document.getElementById('nfc-browse-more-btn');
+        if (browseMoreBtn) {
+            browseMoreBtn.addEventListener('click', () => this.fetchFileList(true));
+        }
+
+        const browseUidFilter = document.getElementById('nfc-browse-uid-filter');
+        if (browseUidFilter) {
+            browseUidFilter.addEventListener('change', () => this.fetchFileList(false));
+        }
+
         const fullWriteBtn = document.getElementById('nfc-full-write-btn');
         if (fullWriteBtn) {
             fullWriteBtn.addEventListener('click', () => this.handleFullWrite());
@@ -178,6 +196,133 @@ const NFCModule = {
         }
     },
 
+    // ==================== JOB API ====================
+
+    /**
+     * Open the Server-Sent Events stream. The browser reconnects
+     * on its own; while disconnected runJob() falls back to polling.
+     */
+    connectEvents() {
+        if (this.events || typeof EventSource === 'undefined') return;
+
+        this.events = new EventSource('/api/nfc/events');
+
+        this.events.onopen = () => {
+            this.eventsConnected = true;
+            console.log('[NFC] Event stream connected');
+        };
+
+        this.events.onerror = () => {
+            this.eventsConnected = false;
+        };
+
+        this.events.addEventListener('job', (e) => this.onJobEvent(JSON.parse(e.data)));
+        this.events.addEventListener('progress', (e) => this.onProgressEvent(JSON.parse(e.data)));
+        this.events.addEventListener('auth', (e) => this.onAuthEvent(JSON.parse(e.data)));
+    },
+
+    onJobEvent(job) {
+        if (job.state === 'running') {
+            this.showProgress(`${job.type.replace(/_/g, ' ').toUpperCase()}...`, 0);
+        } else if (job.state === 'done') {
+            this.hideProgress();
+            const waiter = this.jobWaiters[job.job_id];
+            if (waiter) waiter(job.result);
+        }
+    },
+
+    onProgressEvent(p) {
+        const percent = p.total ? Math.round((p.index * 100) / p.total) : 0;
+        this.showProgress(`${p.op.toUpperCase()} ${p.unit} ${p.index}/${p.total}`, percent);
+
+        if (!p.ok) {
+            this.logConsole(`⚠️ ${p.op} failed at ${p.unit} ${p.index}/${p.total}`, 'warning');
+        } else if (p.unit === 'sector') {
+            this.logConsole(`Sector ${p.index}/${p.total} ${p.op} OK`, 'info');
+        }
+    },
+
+    onAuthEvent(a) {
+        if (a.ok) {
+            this.logConsole(`Sector ${a.sector}: Key ${a.key} OK (${a.attempts} tries)`, 'info');
+        } else {
+            this.logConsole(`Sector ${a.sector}: auth failed (${a.attempts} keys)`, 'warning');
+        }
+    },
+
+    showProgress(label, percent) {
+        const box = document.getElementById('nfc-progress');
+        if (!box) return;
+        box.style.display = 'flex';
+        document.getElementById('nfc-progress-label').textContent = label;
+        document.getElementById('nfc-progress-fill').style.width = `${percent}%`;
+    },
+
+    hideProgress() {
+        const box = document.getElementById('nfc-progress');
+        if (box) box.style.display = 'none';
+    },
+
+    /**
+     * Resolve with the job result when its "done" event arrives,
+     * or with null after timeoutMs.
+     */
+    waitForJobEvent(jobId, timeoutMs) {
+        return new Promise((resolve) => {
+            const timer = setTimeout(() => {
+                delete this.jobWaiters[jobId];
+                resolve(null);
+            }, timeoutMs);
+
+            this.jobWaiters[jobId] = (result) => {
+                clearTimeout(timer);
+                delete this.jobWaiters[jobId];
+                resolve(result);
+            };
+        });
+    },
+
+    /**
+     * Submit a job to the NFC worker and wait for its result.
+     * Completion comes from the event stream; the status endpoint
+     * is polled as fallback (slowly while the stream is up).
+     * Returns the job result ({success, message, ...}) or the
+     * submit error if the job could not be queued.
+     */
+    async runJob(type, params = {}) {
+        const response = await fetch('/api/nfc/jobs', {
+            method: 'POST',
+            headers: { 'Content-Type': 'application/json' },
+            body: JSON.stringify(Object.assign({ type }, params))
+        });
+
+        const submitted = await response.json();
+        if (!submitted.success) {
+            return submitted;
+        }
+
+        console.log(`[NFC] Job #${submitted.job_id} queued (${type})`);
+
+        while (true) {
+            const wait = this.eventsConnected ? this.jobPollFallback : this.jobPollInterval;
+            const pushed = await this.waitForJobEvent(submitted.job_id, wait);
+            if (pushed) {
+                return pushed;
+            }
+
+            const statusResponse = await fetch(`/api/nfc/jobs?id=${submitted.job_id}`);
+            const status = await statusResponse.json();
+
+            if (!status.success) {
+                throw new Error(status.message || 'Job status unavailable');
+            }
+            if (status.state === 'done') {
+                this.hideProgress();
+                return status.result;
+            }
+        }
+    },
+
     // ==================== READ ACTIONS ====================
 
     async handleRead() {
@@ -195,25 +340,19 @@ const NFCModule = {
         this.logConsole(`Reading ${this.currentProtocol.toUpperCase()} tag (timeout: ${this.settings.readTimeout}s)...`, 'info');
 
         try {
-            let endpoint;
+            let jobType;
             if (protocol === 'srix') {
-                endpoint = '/api/nfc/srix/read';
+                jobType = 'srix_read';
             } else if (protocol === 'mifare') {
-                endpoint = '/api/nfc/mifare/read';
+                jobType = 'mifare_read';
             } else {
                 throw new Error('Unknown protocol');
             }
             
-            const response = await fetch(endpoint, {
-                method: 'POST',
-                headers: { 'Content-Type': 'application/json' },
-                body: JSON.stringify({ 
-                    timeout: this.settings.readTimeout
-                })
+            const data = await this.runJob(jobType, {
+                timeout: this.settings.readTimeout
             });
 
-            const data = await response.json();
-
             if (data.success) {
                 this.currentTag = data;
                 this.displayTagInfo(data);
@@ -318,13 +457,7 @@ const NFCModule = {
         this.showLoading('Reading UID...');
         
         try {
-            const response = await fetch('/api/nfc/mifare/read-uid', {
-                method: 'POST',
-                headers: { 'Content-Type': 'application/json' },
-                body: JSON.stringify({ timeout })
-            });
-            
-            const data = await response.json();
+            const data = await this.runJob('mifare_read_uid', { timeout });
             
             if (data.success) {
                 this.showSuccess(`UID: ${data.uid}`);
@@ -356,34 +489,65 @@ const NFCModule = {
             }
 
             fileBrowser.style.display = 'block';
-            
-            // Reset state
-            fileListDiv.innerHTML = '<div class="loading">Loading files...</div>';
+            this.fetchFileList(false);
+    },
+
+    async fetchFileList(append) {
+            const fileListDiv = document.getElementById('nfc-file-list');
+            const moreBtn = document.getElementById('nfc-browse-more-btn');
+            const uidFilter = document.getElementById('nfc-browse-uid-filter');
+
+            if (!fileListDiv) {
+                return;
+            }
+
+            if (!append) {
+                // Reset state
+                this.browseOffset = 0;
+                fileListDiv.innerHTML = '<div class="loading">Loading files...</div>';
+                this.logConsole('Fetching file list...', 'info');
+            }
 
-            this.logConsole('Fetching file list...', 'info');
+            let url = `/api/nfc/list?protocol=${this.currentProtocol}` +
+                      `&offset=${this.browseOffset}&limit=${this.browsePageSize}`;
+
+            // UID filter: served from the dump catalog, no file is opened
+            if (uidFilter && uidFilter.checked) {
+                if (!this.currentTag || !this.currentTag.uid) {
+                    uidFilter.checked = false;
+                    this.logConsole('Read a tag first to filter by UID', 'warning');
+                } else {
+                    url += `&uid=${encodeURIComponent(this.currentTag.uid)}`;
+                }
+            }
 
             try {
-                const response = await fetch(`/api/nfc/list?protocol=${this.currentProtocol}`);
+                const response = await fetch(url);
                 const data = await response.json();
                 
-                console.log('[handleBrowse] Received data:', data);
+                console.log('[fetchFileList] Received data:', data);
                 
                 if (data.success && data.files && data.files.length > 0) {
                     // Rendering in displayFileList
-                    this.displayFileList(data.files);
-                    this.logConsole(`Found ${data.files.length} file(s)`, 'success');
-                } else {
+                    this.displayFileList(data.files, append);
+                    this.browseOffset += data.files.length;
+                    this.logConsole(`Listed ${this.browseOffset} of ${data.total} file(s)`, 'success');
+                } else if (!append) {
                     fileListDiv.innerHTML = '<div class="loading">No files found</div>';
                     this.logConsole('No files found', 'info');
                 }
+
+                if (moreBtn) {
+                    moreBtn.style.display = (data.total > this.browseOffset) ? 'block' : 'none';
+                }
             } catch (error) {
-                console.error('[handleBrowse] Error:', error);
+                console.error('[fetchFileList] Error:', error);
                 fileListDiv.innerHTML = '<div class="loading">Error loading files</div>';
                 this.logConsole(`❌ Error: ${error.message}`, 'error');
             }
     },
 
-    displayFileList(files) {
+    displayFileList(files, append) {
         const fileListDiv = document.getElementById('nfc-file-list');
         
         if (!fileListDiv) {
@@ -391,7 +555,9 @@ const NFCModule = {
             return;
         }
         
-        fileListDiv.innerHTML = '';
+        if (!append) {
+            fileListDiv.innerHTML = '';
+        }
         
         files.forEach((file) => {
             const item = document.createElement('div');
@@ -399,6 +565,7 @@ const NFCModule = {
             
             item.innerHTML = `
                 <span class="file-name">${file.name}</span>
+                <span class="file-uid">${file.uid || ''}</span>
                 <span class="file-ext">${file.ext}</span>
                 <div class="file-actions">
                     <button class="btn-icon load-btn" title="Load">📂</button>
@@ -474,7 +641,7 @@ const NFCModule = {
 
             if (data.success) {
                 this.logConsole(`✅ File deleted`, 'success');
-                this.handleBrowse(); // Refresh list
+                this.fetchFileList(false); // Refresh list
             } else {
                 this.logConsole(`❌ ${data.message}`, 'error');
                 alert('Delete failed: ' + data.message);
@@ -503,26 +670,19 @@ const NFCModule = {
         this.logConsole('Writing full data to tag...', 'info');
 
         try {
-            let endpoint;
+            let jobType;
             if (protocol === 'srix') {
-                endpoint = '/api/nfc/srix/write';
+                jobType = 'srix_write';
             } else if (protocol === 'mifare') {
-                endpoint = '/api/nfc/mifare/write';
+                jobType = 'mifare_write';
             } else {
                 throw new Error('Unknown protocol');
             }
             
-            const response = await fetch(endpoint, {
-                method: 'POST',
-                headers: { 'Content-Type': 'application/json' },
-                body: JSON.stringify({ 
-                    timeout: this.settings.writeTimeout,
-                    mode: 'full'
-                })
+            const data = await this.runJob(jobType, {
+                timeout: this.settings.writeTimeout
             });
 
-            const data = await response.json();
-
             if (data.success) {
                 this.logConsole(`✅ ${data.message}`, 'success');
                 alert('Full write successful!');
@@ -560,22 +720,16 @@ const NFCModule = {
 
         try {
             // Step 2: Call API
-            let compareEndpoint;
+            let compareJob;
             if (protocol === 'srix') {
-                compareEndpoint = '/api/nfc/srix/compare';
+                compareJob = 'srix_compare';
             } else if (protocol === 'mifare') {
-                compareEndpoint = '/api/nfc/mifare/compare';
+                compareJob = 'mifare_compare';
             } else {
                 throw new Error('Unknown protocol');
             }
             
-            const response = await fetch(compareEndpoint, {
-                method: 'POST',
-                headers: { 'Content-Type': 'application/json' },
-                body: JSON.stringify({ timeout: this.settings.readTimeout })
-            });
-
-            const data = await response.json();
+            const data = await this.runJob(compareJob, { timeout: this.settings.readTimeout });
 
             if (!data.success) {
                 this.logConsole(data.message, 'error');
@@ -621,18 +775,17 @@ const NFCModule = {
             this.logConsole('Starting selective write...', 'info');
             writeBtn.textContent = 'WRITING...';
 
-            // Filter blocks: remove those with warnings (Block 0, sector trailer)
-            const blocksToWrite = differences
-                .filter(diff => !diff.warning) //Escludi blocchi con warning
-                .map(diff => diff.block);
+            // The device keeps the compare bitmap: protected blocks (Block 0,
+            // sector trailers) are already excluded server-side
+            const writableBlocks = data.writable_blocks ?? differences.filter(diff => !diff.warning).length;
 
             // Show filtered block info
-            const skippedBlocks = differences.length - blocksToWrite.length;
+            const skippedBlocks = totalDifferences - writableBlocks;
             if (skippedBlocks > 0) {
                 this.logConsole(`⚠️ Skipping ${skippedBlocks} protected blocks (UID/Sector Trailers)`, 'warning');
             }
             
-            if (blocksToWrite.length === 0) {
+            if (writableBlocks === 0) {
                 this.logConsole('⚠️ All differences are in protected blocks - nothing to write', 'warning');
                 alert('⚠️ All differences are in protected blocks (UID or sector trailers).\n\nNothing to write.');
                 writeBtn.disabled = false;
@@ -640,30 +793,25 @@ const NFCModule = {
                 return;
             }
 
-            this.logConsole(`Writing ${blocksToWrite.length} blocks...`, 'info');
+            this.logConsole(`Writing ${writableBlocks} blocks...`, 'info');
 
-            // Determine selective write endpoints
-            let writeEndpoint;
+            // Determine selective write job
+            let writeJob;
             if (protocol === 'srix') {
-                writeEndpoint = '/api/nfc/srix/write-selective';
+                writeJob = 'srix_write_selective';
             } else if (protocol === 'mifare') {
-                writeEndpoint = '/api/nfc/mifare/write-selective';
+                writeJob = 'mifare_write_selective';
             } else {
                 throw new Error('Unknown protocol');
             }
 
             try {
-                const writeResponse = await fetch(writeEndpoint, {
-                    method: 'POST',
-                    headers: { 'Content-Type': 'application/json' },
-                    body: JSON.stringify({ blocks: blocksToWrite })
-                });
-
-                const writeData = await writeResponse.json();
+                // No block list: the device writes the dirty blocks of this compare
+                const writeData = await this.runJob(writeJob, {});
 
                 if (writeData.success) {
                     this.logConsole(`✅ ${writeData.message}`, 'success');
-                    alert(`✅ SUCCESS!\n\n${writeData.message}\n\nBlocks written: ${writeData.blocks_count || blocksToWrite.length}`);
+                    alert(`✅ SUCCESS!\n\n${writeData.message}\n\nBlocks written: ${writeData.blocks_count ?? writableBlocks}`);
                 } else {
                     this.logConsole(`❌ ${writeData.message}`, 'error');
                     alert(`❌ FAILED\n\n${writeData.message}`);